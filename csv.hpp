@@ -0,0 +1,661 @@
+#ifndef SLAW_CSV_H
+#define SLAW_CSV_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * Computes the prefix XOR of a 16-bit mask. Bit `i` of the result is the XOR
+ * of bits 0 to `i` of the input.
+ * Applied to the mask of quote characters of a block, the result has a bit
+ * set for every character that lies between an opening and a closing quote.
+ */
+constexpr u32
+prefix_xor(u32 mask)
+{
+	mask ^= mask << 1;
+	mask ^= mask << 2;
+	mask ^= mask << 4;
+	mask ^= mask << 8;
+
+	return mask & 0xFFFF;
+}
+
+/**
+ * Parses a decimal integer with an optional sign.
+ * Returns false if the text is not a valid integer.
+ * Values that do not fit in 64 bits wrap around.
+ */
+inline bool
+parse_integer(StringView text, i64 &out)
+{
+	usize i = 0;
+	bool negative = false;
+
+	if (text.size > 0 && (text[0] == '-' || text[0] == '+'))
+	{
+		negative = text[0] == '-';
+		i++;
+	}
+
+	if (i == text.size)
+	{
+		return false;
+	}
+
+	u64 value = 0;
+
+	for (; i < text.size; i++)
+	{
+		u8 digit = text[i] - '0';
+
+		if (digit > 9)
+		{
+			return false;
+		}
+
+		value = value * 10 + digit;
+	}
+
+	out = negative ? 0 - value : value;
+	return true;
+}
+
+/**
+ * Parses a decimal floating point number with an optional sign, fraction
+ * and exponent, like "-12.5e3".
+ * Returns false if the text is not a valid number.
+ *
+ * Numbers with at most 15 significant digits and a decimal exponent of at
+ * most 22 in magnitude are converted exactly, because both the digits and
+ * the power of ten are exact doubles and a single multiplication or division
+ * rounds correctly. Other numbers may be off by a few units in the last
+ * place.
+ */
+inline bool
+parse_float(StringView text, f64 &out)
+{
+	// The powers of ten that can be represented exactly as a double.
+
+	constexpr const f64 exact_powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+		1e22
+	};
+
+	usize i = 0;
+	bool negative = false;
+
+	if (text.size > 0 && (text[0] == '-' || text[0] == '+'))
+	{
+		negative = text[0] == '-';
+		i++;
+	}
+
+	// Accumulate up to 19 significant digits into an integer and keep
+	// track of the decimal exponent.
+
+	u64 digits = 0;
+	usize significant = 0;
+	i32 exponent = 0;
+	bool any_digits = false;
+	bool seen_point = false;
+
+	for (; i < text.size; i++)
+	{
+		char c = text[i];
+
+		if (c == '.' && !seen_point)
+		{
+			seen_point = true;
+			continue;
+		}
+
+		u8 digit = c - '0';
+
+		if (digit > 9)
+		{
+			break;
+		}
+
+		any_digits = true;
+
+		if (significant < 19)
+		{
+			if (digits != 0 || digit != 0)
+			{
+				significant++;
+			}
+
+			digits = digits * 10 + digit;
+			exponent -= seen_point;
+		}
+		else
+		{
+			exponent += !seen_point;
+		}
+	}
+
+	if (!any_digits)
+	{
+		return false;
+	}
+
+	// Parse the exponent. It saturates instead of wrapping around, so
+	// huge exponents like "1e99999999999" cannot turn into small ones.
+
+	i64 scale = exponent;
+
+	if (i < text.size && (text[i] == 'e' || text[i] == 'E'))
+	{
+		i++;
+		bool negative_exponent = false;
+
+		if (i < text.size && (text[i] == '-' || text[i] == '+'))
+		{
+			negative_exponent = text[i] == '-';
+			i++;
+		}
+
+		if (i == text.size)
+		{
+			return false;
+		}
+
+		i64 e = 0;
+
+		for (; i < text.size; i++)
+		{
+			u8 digit = text[i] - '0';
+
+			if (digit > 9)
+			{
+				return false;
+			}
+
+			e = min(e * 10 + digit, (i64) 1000000);
+		}
+
+		scale += negative_exponent ? -e : e;
+	}
+
+	if (i != text.size)
+	{
+		return false;
+	}
+
+	// Whatever the 19 significant digits are, results scaled by more
+	// than 10^400 overflow and results scaled by less than 10^-400
+	// underflow, so they are returned directly. This also bounds the
+	// scaling loops below.
+
+	if (digits != 0 && scale > 400)
+	{
+		out = negative ? -Infinity64 : Infinity64;
+		return true;
+	}
+
+	if (digits == 0 || scale < -400)
+	{
+		out = negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	exponent = (i32) scale;
+
+	// Scale the digits by the decimal exponent.
+
+	f64 value = digits;
+
+	while (exponent > 22)
+	{
+		value *= 1e22;
+		exponent -= 22;
+	}
+
+	while (exponent < -22)
+	{
+		value /= 1e22;
+		exponent += 22;
+	}
+
+	if (exponent >= 0)
+	{
+		value *= exact_powers[exponent];
+	}
+	else
+	{
+		value /= exact_powers[-exponent];
+	}
+
+	out = negative ? -value : value;
+	return true;
+}
+}; // namespace slaw::detail
+
+/**
+ * Reader for comma-separated values (RFC 4180).
+ * Yields the document one row at a time. The fields of a row are views into
+ * the input, so reading a row does not allocate any memory per field.
+ *
+ * Example:
+ *
+ *     slaw::CsvReader reader(text);
+ *     slaw::Vector<f64> prices;
+ *
+ *     while (reader.next_row())
+ *     {
+ *         slaw::StringView name = reader.fields[0];
+ *         reader.parse_field(1, prices);
+ *     }
+ *
+ * The input is scanned 16 bytes at a time. For each block, bitmasks of the
+ * quotes, delimiters and newlines are extracted. The prefix XOR of the
+ * quote mask marks the bytes that are inside quoted fields, so delimiters
+ * and newlines inside quotes are skipped without looking at them one by one.
+ *
+ * Fields may be quoted with '"'. Quotes inside quoted fields are escaped by
+ * doubling them. Rows may end with "\n" or "\r\n".
+ *
+ * The reader can also be fed a document in chunks, e.g. as it arrives over
+ * the network, using `feed()` and `finish()`.
+ */
+struct CsvReader
+{
+	// The text that is being read.
+	StringView input;
+
+	// Holds the input when the document is fed in chunks.
+	String stream_buffer;
+
+	// Whether `input` holds the end of the document.
+	// If not, rows that are cut off at the end of the input are not
+	// returned until more input is fed.
+	bool complete;
+
+	// The character that separates the fields of a row.
+	char delimiter;
+
+	// The fields of the current row. The views stay valid until the next
+	// call to `next_row()` or `feed()`.
+	Vector<StringView> fields;
+
+	// Holds the contents of quoted fields with escaped quotes, which cannot
+	// point into the input directly.
+	String unescaped;
+
+	// The offset of the first character of the current row.
+	usize row_start = 0;
+
+	// The offset of the first character of the current field.
+	usize field_start = 0;
+
+	// The offset of the block that `pending` belongs to.
+	usize block = 0;
+
+	// The delimiters and newlines in the current block that have not been
+	// handled yet. Bit `i` represents the byte at offset `block + i`.
+	u32 pending = 0;
+
+	// The offset of the next block to scan.
+	usize next_block = 0;
+
+	// Whether the previous block ended inside a quoted field.
+	bool in_quotes = false;
+
+	/**
+	 * Constructs a reader over an entire document.
+	 * The text is not copied and must outlive the reader.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	CsvReader(StringView input, char delimiter = ',')
+		: input(input), complete(true), delimiter(delimiter) {}
+
+	/**
+	 * Constructs a reader that is fed its input in chunks through
+	 * `feed()`. Call `finish()` after the last chunk.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	CsvReader(char delimiter = ',')
+		: complete(false), delimiter(delimiter) {}
+
+	/**
+	 * Appends a chunk of text to the input.
+	 * The rows that have already been read are discarded, and the views of
+	 * the current row are invalidated.
+	 *
+	 * - Time complexity: O(n), where n is the size of the chunk plus the
+	 *   size of the unread input.
+	 * - Space complexity: O(n).
+	 */
+	void
+	feed(StringView chunk)
+	{
+		// Move the unread input to the front of the buffer.
+
+		usize unread = input.size - row_start;
+
+		for (usize i = 0; i < unread; i++)
+		{
+			stream_buffer.data[i] = stream_buffer.data[row_start + i];
+		}
+
+		stream_buffer.size = unread;
+
+		// Append the chunk.
+
+		stream_buffer.reserve(chunk.size);
+
+		for (usize i = 0; i < chunk.size; i++)
+		{
+			stream_buffer.data[unread + i] = chunk[i];
+		}
+
+		stream_buffer.size += chunk.size;
+		input = StringView(stream_buffer);
+
+		// Scan the unread row again from its start.
+
+		rewind(0);
+	}
+
+	/**
+	 * Marks the end of the document after the last chunk has been fed.
+	 * The row at the end of the input is returned even if it does not end
+	 * with a newline.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	void
+	finish()
+	{
+		complete = true;
+
+		// The row at the end of the input was only scanned up to its
+		// last delimiter. Scan it again, now that we know it is the last.
+
+		rewind(row_start);
+	}
+
+	/**
+	 * Reads the next row into `fields`.
+	 * Returns false if there are no more complete rows.
+	 *
+	 * - Time complexity: O(n), where n is the length of the row.
+	 * - Space complexity: O(1) on average.
+	 */
+	bool
+	next_row()
+	{
+		fields.size = 0;
+
+		while (true)
+		{
+			// Scan blocks until we find a delimiter or a newline.
+
+			while (pending == 0)
+			{
+				if (next_block >= input.size)
+				{
+					return end_of_input();
+				}
+
+				scan_block();
+			}
+
+			usize structural = block + ctz(pending);
+			pending &= pending - 1;
+
+			fields.push_back(input.substr(field_start,
+				structural - field_start));
+			field_start = structural + 1;
+
+			if (input[structural] == '\n')
+			{
+				finish_row(field_start);
+				return true;
+			}
+		}
+	}
+
+	/**
+	 * Parses a field of the current row as a number and appends it to a
+	 * vector. Integer vectors accept decimal integers, floating point
+	 * vectors accept decimal numbers with an optional exponent.
+	 * Returns false, without appending anything, if the row has no such
+	 * field or if the field is not a valid number.
+	 *
+	 * - Time complexity: O(n), where n is the length of the field.
+	 * - Space complexity: O(1) on average.
+	 */
+	template <typename T>
+	bool
+	parse_field(usize column, Vector<T> &out)
+	const
+	{
+		static_assert(is_integer<T>() || is_float<T>(),
+			"Expected a vector of integers or floating point numbers.");
+
+		if (column >= fields.size)
+		{
+			return false;
+		}
+
+		if constexpr (is_integer<T>())
+		{
+			i64 value;
+
+			if (!detail::parse_integer(fields[column], value))
+			{
+				return false;
+			}
+
+			out.push_back(value);
+		}
+		else
+		{
+			f64 value;
+
+			if (!detail::parse_float(fields[column], value))
+			{
+				return false;
+			}
+
+			out.push_back(value);
+		}
+
+		return true;
+	}
+
+	/**
+	 * Computes the masks of the next block of 16 bytes and adds its
+	 * delimiters and newlines that are outside of quotes to `pending`.
+	 */
+	void
+	scan_block()
+	{
+		block = next_block;
+		next_block += 16;
+
+		u8x16 v;
+
+		if (block + 16 <= input.size)
+		{
+			v = simd::load<u8x16>(input.data + block);
+		}
+		else
+		{
+			// Copy the last partial block into a zeroed buffer, so we
+			// do not read past the end of the input.
+
+			char tail[16] = {};
+
+			for (usize i = block; i < input.size; i++)
+			{
+				tail[i - block] = input[i];
+			}
+
+			v = simd::load<u8x16>(tail);
+		}
+
+		u32 quotes = simd::bitmask((u8x16) (v == simd::splat<u8x16>('"')));
+		u32 delimiters = simd::bitmask(
+			(u8x16) (v == simd::splat<u8x16>(delimiter)));
+		u32 newlines = simd::bitmask(
+			(u8x16) (v == simd::splat<u8x16>('\n')));
+
+		// Mark the bytes inside quotes. If the previous block ended
+		// inside quotes, everything up to the next quote is inside
+		// quotes as well, so we invert the mask.
+
+		u32 quoted = detail::prefix_xor(quotes);
+
+		if (in_quotes)
+		{
+			quoted ^= 0xFFFF;
+		}
+
+		in_quotes = quoted >> 15;
+
+		// Ignore the zero bytes past the end of the input.
+
+		u32 valid = 0xFFFF;
+
+		if (input.size - block < 16)
+		{
+			valid = (1 << (input.size - block)) - 1;
+		}
+
+		pending = (delimiters | newlines) & ~quoted & valid;
+	}
+
+	/**
+	 * Handles the end of the input.
+	 * Returns true if the last row has to be returned.
+	 */
+	bool
+	end_of_input()
+	{
+		if (!complete)
+		{
+			// The current row might continue in the next chunk.
+			// Scan it again from the start once more input arrives.
+
+			fields.size = 0;
+			rewind(row_start);
+			next_block = input.size;
+			return false;
+		}
+
+		// The document is complete. A row without a trailing newline is
+		// still a row, but an empty line at the end is not.
+
+		if (field_start >= input.size && fields.size == 0)
+		{
+			return false;
+		}
+
+		fields.push_back(input.substr(field_start,
+			input.size - field_start));
+		field_start = input.size + 1;
+		finish_row(input.size);
+
+		return true;
+	}
+
+	/**
+	 * Restarts scanning at the given offset, which must be the start of a
+	 * row.
+	 */
+	void
+	rewind(usize offset)
+	{
+		row_start = offset;
+		field_start = offset;
+		next_block = offset;
+		pending = 0;
+		in_quotes = false;
+	}
+
+	/**
+	 * Post-processes the fields of the row that was just read: strips the
+	 * carriage return of "\r\n" line endings and removes the quotes of
+	 * quoted fields.
+	 */
+	void
+	finish_row(usize next_row_start)
+	{
+		usize row_size = next_row_start - row_start;
+		row_start = next_row_start;
+
+		StringView &last = fields.back();
+
+		if (last.size > 0 && last[last.size - 1] == '\r')
+		{
+			last.size--;
+		}
+
+		// Make sure `unescaped` can hold all fields of this row, so it
+		// does not reallocate while we point views into it.
+
+		unescaped.size = 0;
+		bool reserved = false;
+
+		for (usize i = 0; i < fields.size; i++)
+		{
+			StringView &field = fields[i];
+
+			if (field.size < 2 || field[0] != '"'
+				|| field[field.size - 1] != '"')
+			{
+				continue;
+			}
+
+			field = field.substr(1, field.size - 2);
+
+			if (field.index_of("\"\"") == -1)
+			{
+				continue;
+			}
+
+			if (!reserved)
+			{
+				unescaped.reserve(row_size);
+				reserved = true;
+			}
+
+			// Copy the field without the escaping quotes.
+
+			char *start = unescaped.data + unescaped.size;
+
+			for (usize j = 0; j < field.size; j++)
+			{
+				unescaped.data[unescaped.size++] = field[j];
+
+				if (field[j] == '"')
+				{
+					j++;
+				}
+			}
+
+			field = StringView(start,
+				unescaped.data + unescaped.size - start);
+		}
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
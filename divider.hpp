@@ -0,0 +1,394 @@
+#ifndef SLAW_DIVIDER_H
+#define SLAW_DIVIDER_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+
+// Division by invariant integers: a divisor that is known only at run time,
+// but used for many divisions, is turned once into a magic multiplier and a
+// shift, after which each division is a multiplication and a few cheap
+// operations, like libdivide does. The methods are those of Granlund and
+// Montgomery, "Division by Invariant Integers using Multiplication" (1994).
+//
+// Integer division is among the slowest scalar instructions, and WASM has
+// no SIMD integer division at all, while the multiplications vectorise. For
+// divisors known at compile time, the compiler does the same by itself, so
+// a `Divider` only pays off for divisors that are not.
+//
+//     slaw::Divider<u32> by(width);
+//
+//     for (usize i = 0; i < count; i++)
+//     {
+//         rows[i] = by.divide(offsets[i]);
+//     }
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * Returns the upper half of the full product of two 32 or 64-bit integers.
+ * On WASM, the 64-bit product is assembled from 32-bit halves, since there
+ * is no 128-bit multiplication.
+ */
+template <typename T>
+constexpr inline T
+multiply_high(T a, T b)
+{
+	if constexpr (sizeof(T) == 4)
+	{
+		// The product of two 32-bit integers fits in 64 bits, with
+		// sign extension for signed integers.
+
+		if constexpr (is_unsigned_integer<T>())
+		{
+			return (T) ((u64) a * b >> 32);
+		}
+		else
+		{
+			return (T) ((i64) a * b >> 32);
+		}
+	}
+	else
+	{
+#if defined(__SIZEOF_INT128__) && !defined(__wasm__)
+		if constexpr (is_unsigned_integer<T>())
+		{
+			return (T) ((unsigned __int128) a * b >> 64);
+		}
+		else
+		{
+			return (T) ((__int128) a * b >> 64);
+		}
+#else
+		u64 high = 0;
+		u64 low = 0;
+		multiply_wide((u64) a, (u64) b, high, low);
+
+		// The signed product differs from the unsigned product of
+		// the same bits by 2^64 times each negative factor's partner.
+
+		if constexpr (is_signed_integer<T>())
+		{
+			high -= a < 0 ? (u64) b : 0;
+			high -= b < 0 ? (u64) a : 0;
+		}
+
+		return (T) high;
+#endif
+	}
+}
+
+/**
+ * Returns the quotient of the 128-bit number `high * 2^64 + low` and a
+ * 64-bit divisor, by long division. `high` must be less than the divisor,
+ * so the quotient fits in 64 bits.
+ *
+ * - Time complexity: O(1), 64 steps.
+ * - Space complexity: O(1).
+ */
+constexpr inline u64
+divide_wide(u64 high, u64 low, u64 divisor)
+{
+	u64 quotient = 0;
+
+	for (i32 i = 63; i >= 0; i--)
+	{
+		// The remainder can exceed 64 bits for one step, when its
+		// top bit is shifted out, in which case it certainly exceeds
+		// the divisor.
+
+		bool carry = high >> 63;
+		high = high << 1 | (low >> i & 1);
+		quotient <<= 1;
+
+		if (carry || high >= divisor)
+		{
+			high -= divisor;
+			quotient |= 1;
+		}
+	}
+
+	return quotient;
+}
+}; // namespace slaw::detail
+
+/**
+ * Divides 32 or 64-bit integers by a divisor that is fixed at run time, with
+ * a multiplication instead of a division instruction. The quotients and
+ * remainders are those of the `/` and `%` operators, truncated towards zero.
+ *
+ * Both signednesses use a single, branch-free sequence for every divisor,
+ * so the SIMD versions can divide all lanes at once:
+ *
+ * - Unsigned: with l = ceil(log2(d)) and a magic number
+ *   m = floor(2^N (2^l - d) / d) + 1, where N is the width of the type,
+ *   the quotient is `(t + ((n - t) >> min(l, 1))) >> max(l - 1, 0)`, where
+ *   `t` is the upper half of `m * n`.
+ * - Signed: with l = max(ceil(log2(|d|)), 1) and the magic number
+ *   m = floor(2^(N + l - 1) / |d|) + 1 - 2^N, the quotient of |d| rounded
+ *   towards minus infinity is `(n + upper half of m * n) >> (l - 1)`,
+ *   to which 1 is added for negative `n`, and the sign of `d` is applied.
+ *
+ * The divisor must not be zero. Dividing the minimum value of a signed type
+ * by -1 wraps around to the minimum value.
+ */
+template <typename T>
+struct Divider
+{
+	static_assert(is_integer<T>() && (sizeof(T) == 4 || sizeof(T) == 8),
+		"Type is not a 32 or 64-bit integer type.");
+
+	using Unsigned = typename simd::detail::simd_unsigned_integer_of_impl<
+		sizeof(T)>::type;
+
+	// The number of bits of the type.
+	static const constexpr u32 bits = sizeof(T) * 8;
+
+	// The divisor.
+	T divisor;
+
+	// The magic number, which the numerators are multiplied by.
+	T multiplier;
+
+	// For unsigned types, the shift of the difference between the
+	// numerator and the product, which is 0 or 1. Unused for signed types.
+	u32 pre_shift;
+
+	// The shift of the final quotient.
+	u32 post_shift;
+
+	// -1 if the divisor is negative, 0 otherwise.
+	T divisor_sign;
+
+	/**
+	 * Computes the magic number and shifts for a divisor.
+	 *
+	 * - Time complexity: O(1) for 32-bit types, 64 steps of long division
+	 *   for 64-bit types.
+	 * - Space complexity: O(1).
+	 */
+	constexpr
+	Divider(T divisor)
+		: divisor(divisor), multiplier(0), pre_shift(0), post_shift(0),
+		  divisor_sign(0)
+	{
+		if constexpr (is_unsigned_integer<T>())
+		{
+			// l = ceil(log2(d)), so 2^(l - 1) < d <= 2^l.
+
+			u32 l = divisor == 1 ? 0 : bits - clz((T) (divisor - 1));
+
+			// floor(2^N (2^l - d) / d): the numerator is below
+			// 2^N d, so the quotient fits in N bits.
+
+			Unsigned excess = l == bits ? 0 - divisor
+				: ((Unsigned) 1 << l) - divisor;
+
+			if constexpr (sizeof(T) == 4)
+			{
+				multiplier = (T) (((u64) excess << 32) / divisor + 1);
+			}
+			else
+			{
+				multiplier = detail::divide_wide(excess, 0, divisor) + 1;
+			}
+
+			pre_shift = min(l, 1u);
+			post_shift = l == 0 ? 0 : l - 1;
+		}
+		else
+		{
+			divisor_sign = divisor < 0 ? -1 : 0;
+			Unsigned magnitude = divisor < 0 ? 0 - (Unsigned) divisor
+				: (Unsigned) divisor;
+
+			// l = max(ceil(log2(|d|)), 1). The magic number is taken
+			// modulo 2^N, which turns floor(2^(N + l - 1) / |d|) + 1
+			// into the signed value of the formula. For |d| = 1, the
+			// quotient 2^N itself wraps to 0.
+
+			u32 l = magnitude <= 2 ? 1
+				: bits - clz((Unsigned) (magnitude - 1));
+			Unsigned quotient = 0;
+
+			if constexpr (sizeof(T) == 4)
+			{
+				quotient = (Unsigned) (((u64) 1 << (31 + l)) / magnitude);
+			}
+			else if (magnitude != 1)
+			{
+				quotient = detail::divide_wide((u64) 1 << (l - 1), 0,
+					magnitude);
+			}
+
+			multiplier = (T) (quotient + 1);
+			post_shift = l - 1;
+		}
+	}
+
+	/**
+	 * Returns the quotient of a number and the divisor, rounded towards
+	 * zero.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	constexpr T
+	divide(T numerator) const
+	{
+		if constexpr (is_unsigned_integer<T>())
+		{
+			T t = detail::multiply_high(multiplier, numerator);
+			return (t + ((numerator - t) >> pre_shift)) >> post_shift;
+		}
+		else
+		{
+			// The sums are taken in unsigned arithmetic, since they
+			// wrap around for divisors of 1 and -1.
+
+			T q = (T) ((Unsigned) numerator
+				+ (Unsigned) detail::multiply_high(multiplier, numerator));
+			q = (T) ((Unsigned) (q >> post_shift)
+				- (Unsigned) (numerator >> (bits - 1)));
+
+			return (T) (((Unsigned) q ^ divisor_sign) - divisor_sign);
+		}
+	}
+
+	/**
+	 * Returns the remainder of a number divided by the divisor, with the
+	 * sign of the number, like the `%` operator.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	constexpr T
+	modulo(T numerator) const
+	{
+		return (T) ((Unsigned) numerator
+			- (Unsigned) divide(numerator) * (Unsigned) divisor);
+	}
+};
+
+namespace simd
+{
+namespace detail
+{
+/**
+ * Returns the upper halves of the full products of the elements of a
+ * 32-bit integer SIMD vector and a scalar. Compiles to two `extmul`
+ * instructions and a shuffle, or natively to a shift, two `pmuludq` (or
+ * `pmuldq` with SSE4.1 for `i32x4`) and a shuffle.
+ */
+template <typename T>
+inline T
+multiply_high(const T &v, simd_element_type_of<T> m)
+{
+	T ms = splat<T>(m);
+
+#ifndef __wasm_simd128__
+#if defined(__SSE4_1__)
+	constexpr bool native = true;
+#elif defined(__SSE2__)
+	constexpr bool native = is_same<T, u32x4>();
+#else
+	constexpr bool native = false;
+#endif
+
+	// SSE has no 64-bit lane multiplication, but multiplies the even
+	// lanes into 64-bit products. The odd lanes are shifted into place.
+
+	if constexpr (native)
+	{
+		T odd = (T) ((u64x2) v >> 32);
+		T even_products;
+		T odd_products;
+
+		if constexpr (is_same<T, u32x4>())
+		{
+			even_products = (T) __builtin_ia32_pmuludq128((i32x4) v,
+				(i32x4) ms);
+			odd_products = (T) __builtin_ia32_pmuludq128((i32x4) odd,
+				(i32x4) ms);
+		}
+		else
+		{
+			even_products = (T) __builtin_ia32_pmuldq128(v, ms);
+			odd_products = (T) __builtin_ia32_pmuldq128(odd, ms);
+		}
+
+		return shuffle<1, 5, 3, 7>(even_products, odd_products);
+	}
+#endif
+
+	simd_widen_of<T> low = extend_low(v) * extend_low(ms);
+	simd_widen_of<T> high = extend_high(v) * extend_high(ms);
+
+	return shuffle<1, 3, 5, 7>((T) low, (T) high);
+}
+}; // namespace slaw::simd::detail
+
+/**
+ * Divides each element of a `u32x4` vector by the divisor of a `Divider`,
+ * rounded towards zero.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+inline u32x4
+divide(const u32x4 &v, const Divider<u32> &divider)
+{
+	u32x4 t = detail::multiply_high(v, divider.multiplier);
+	return (t + ((v - t) >> divider.pre_shift)) >> divider.post_shift;
+}
+
+/**
+ * Divides each element of an `i32x4` vector by the divisor of a `Divider`,
+ * rounded towards zero.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+inline i32x4
+divide(const i32x4 &v, const Divider<i32> &divider)
+{
+	i32x4 q = (i32x4) ((u32x4) v
+		+ (u32x4) detail::multiply_high(v, divider.multiplier));
+	q = (i32x4) ((u32x4) (q >> divider.post_shift) - (u32x4) (v >> 31));
+
+	return (i32x4) (((u32x4) q ^ divider.divisor_sign)
+		- divider.divisor_sign);
+}
+
+/**
+ * Returns the remainders of the elements of a `u32x4` vector divided by
+ * the divisor of a `Divider`.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+inline u32x4
+modulo(const u32x4 &v, const Divider<u32> &divider)
+{
+	return v - divide(v, divider) * divider.divisor;
+}
+
+/**
+ * Returns the remainders of the elements of an `i32x4` vector divided by
+ * the divisor of a `Divider`, with the signs of the elements.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+inline i32x4
+modulo(const i32x4 &v, const Divider<i32> &divider)
+{
+	return (i32x4) ((u32x4) v
+		- (u32x4) divide(v, divider) * (u32) divider.divisor);
+}
+}; // namespace slaw::simd
+}; // namespace slaw
+
+#endif
@@ -0,0 +1,546 @@
+#ifndef SLAW_ENCODING_H
+#define SLAW_ENCODING_H
+
+#include "types.hpp"
+#include "simd.hpp"
+
+/**
+ * This namespace contains functions to encode binary data as base64 text and
+ * to decode base64 text back into binary data (RFC 4648).
+ *
+ * All functions write into buffers provided by the caller and never allocate
+ * memory. Use `encoded_size()` and `max_decoded_size()` to find out how large
+ * these buffers have to be.
+ */
+namespace slaw::base64
+{
+/**
+ * The alphabets that can be used for base64 encoding.
+ * They only differ in the characters used for the values 62 and 63.
+ */
+enum class Alphabet
+{
+	// The standard alphabet, using '+' and '/'.
+	Standard,
+
+	// The URL and filename safe alphabet, using '-' and '_'.
+	Url
+};
+
+namespace detail
+{
+/**
+ * Returns the character that represents the value 62 in a given alphabet.
+ */
+constexpr char
+char_62(Alphabet alphabet)
+{
+	return alphabet == Alphabet::Standard ? '+' : '-';
+}
+
+/**
+ * Returns the character that represents the value 63 in a given alphabet.
+ */
+constexpr char
+char_63(Alphabet alphabet)
+{
+	return alphabet == Alphabet::Standard ? '/' : '_';
+}
+
+/**
+ * Returns the character that represents a 6-bit value.
+ */
+constexpr char
+encode_char(u8 value, Alphabet alphabet)
+{
+	if (value < 26)
+	{
+		return 'A' + value;
+	}
+
+	if (value < 52)
+	{
+		return 'a' + value - 26;
+	}
+
+	if (value < 62)
+	{
+		return '0' + value - 52;
+	}
+
+	return value == 62 ? char_62(alphabet) : char_63(alphabet);
+}
+
+/**
+ * Returns the 6-bit value that a character represents,
+ * or -1 if the character is not part of the alphabet.
+ */
+constexpr i32
+decode_char(char c, Alphabet alphabet)
+{
+	if (c >= 'A' && c <= 'Z')
+	{
+		return c - 'A';
+	}
+
+	if (c >= 'a' && c <= 'z')
+	{
+		return c - 'a' + 26;
+	}
+
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0' + 52;
+	}
+
+	if (c == char_62(alphabet))
+	{
+		return 62;
+	}
+
+	if (c == char_63(alphabet))
+	{
+		return 63;
+	}
+
+	return -1;
+}
+
+/**
+ * Encodes the first 12 bytes of a SIMD vector into 16 base64 characters.
+ *
+ * The bytes of each 3-byte group [a, b, c] are first shuffled into the
+ * 32-bit lane [b, a, c, b]. In this order, each of the four 6-bit fields
+ * is a contiguous run of bits in the lane, and can be moved into its own
+ * byte with a shift and a mask.
+ *
+ * The 6-bit values are then mapped to characters by adding an offset that
+ * depends on the range the value falls into. The range is found with four
+ * compares and the offset with a single swizzle into `offsets`.
+ */
+inline u8x16
+encode_block(u8x16 in, u8x16 offsets)
+{
+	u32x4 x = (u32x4) __builtin_shufflevector(in, in,
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+	u8x16 values = (u8x16) (((x >> 10) & 0x0000003F)
+		| ((x << 4) & 0x00003F00)
+		| ((x >> 6) & 0x003F0000)
+		| ((x << 8) & 0x3F000000));
+
+	// Each compare yields -1 for the values that are in the range or
+	// above it, so subtracting them counts the number of ranges below.
+
+	u8x16 range = (u8x16) {}
+		- (u8x16) (values >= 26) - (u8x16) (values >= 52)
+		- (u8x16) (values >= 62) - (u8x16) (values >= 63);
+
+	return values + simd::swizzle(offsets, range);
+}
+
+/**
+ * Decodes 16 base64 characters into 12 bytes, which are stored in the
+ * first 12 bytes of `out`. The remaining bytes of `out` are set to 0.
+ * Returns false if any of the characters is not part of the alphabet.
+ */
+inline bool
+decode_block(u8x16 in, Alphabet alphabet, u8x16 &out)
+{
+	// Classify the characters and validate them.
+
+	u8x16 upper = simd::in_range(in, 'A', 'Z');
+	u8x16 lower = simd::in_range(in, 'a', 'z');
+	u8x16 digit = simd::in_range(in, '0', '9');
+	u8x16 is_62 = (u8x16) (in == simd::splat<u8x16>(char_62(alphabet)));
+	u8x16 is_63 = (u8x16) (in == simd::splat<u8x16>(char_63(alphabet)));
+
+	u8x16 valid = upper | lower | digit | is_62 | is_63;
+
+	if (simd::bitmask(valid) != 0xFFFF)
+	{
+		return false;
+	}
+
+	// Map the characters to their 6-bit values by adding the offset of
+	// their class. The offsets wrap around, e.g. 'A' + 191 = 0.
+
+	u8x16 values = in
+		+ (upper & (u8) (0 - 'A'))
+		+ (lower & (u8) (26 - 'a'))
+		+ (digit & (u8) (52 - '0'))
+		+ (is_62 & (u8) (62 - char_62(alphabet)))
+		+ (is_63 & (u8) (63 - char_63(alphabet)));
+
+	// Merge the four 6-bit values of each lane into a 24-bit value,
+	// with the first value in the most significant bits.
+
+	u32x4 x = (u32x4) values;
+	u32x4 merged = ((x & 0x0000003F) << 18)
+		| ((x & 0x00003F00) << 4)
+		| ((x & 0x003F0000) >> 10)
+		| (x >> 24);
+
+	// Reverse the order of the three bytes of each lane and pack the
+	// lanes together. Indices 16 and above select from the zero vector.
+
+	out = __builtin_shufflevector((u8x16) merged, (u8x16) {},
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 16, 16, 16, 16);
+
+	return true;
+}
+}; // namespace slaw::base64::detail
+
+/**
+ * Returns the number of characters needed to encode a given number of bytes.
+ * Without padding, the last group of characters is not padded with '='.
+ */
+constexpr usize
+encoded_size(usize size, bool pad = true)
+{
+	if (pad)
+	{
+		return (size + 2) / 3 * 4;
+	}
+
+	return size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+/**
+ * Returns the maximum number of bytes that a given number of base64
+ * characters decodes into. The actual number of bytes is smaller if the
+ * input is padded.
+ */
+constexpr usize
+max_decoded_size(usize size)
+{
+	return size / 4 * 3 + (size % 4 == 0 ? 0 : size % 4 - 1);
+}
+
+/**
+ * Encodes binary data as base64 text.
+ * The output buffer must hold at least `encoded_size(size, pad)` characters.
+ * Returns the number of characters written.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline usize
+encode(char *out, const u8 *in, usize size,
+	Alphabet alphabet = Alphabet::Standard, bool pad = true)
+{
+	// The offsets that map each range of 6-bit values to its characters.
+	// Range 0 holds 'A'..'Z', range 1 'a'..'z', range 2 '0'..'9', range 3
+	// the character for 62 and range 4 the character for 63.
+
+	const u8x16 offsets = {
+		'A', 'a' - 26, (u8) ('0' - 52),
+		(u8) (detail::char_62(alphabet) - 62),
+		(u8) (detail::char_63(alphabet) - 63)
+	};
+
+	usize i = 0;
+	usize o = 0;
+
+	// Encode 12 bytes at a time. Each iteration loads 16 bytes, so we stop
+	// while there are still at least 16 bytes left.
+
+	for (; i + 16 <= size; i += 12, o += 16)
+	{
+		u8x16 block = simd::load<u8x16>(in + i);
+		simd::store(out + o, detail::encode_block(block, offsets));
+	}
+
+	// Encode the remaining bytes 3 at a time.
+
+	for (; i + 3 <= size; i += 3, o += 4)
+	{
+		u32 group = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+
+		out[o]     = detail::encode_char(group >> 18, alphabet);
+		out[o + 1] = detail::encode_char(group >> 12 & 0x3F, alphabet);
+		out[o + 2] = detail::encode_char(group >> 6 & 0x3F, alphabet);
+		out[o + 3] = detail::encode_char(group & 0x3F, alphabet);
+	}
+
+	// Encode the final group of 1 or 2 bytes.
+
+	if (i < size)
+	{
+		u32 group = in[i] << 16;
+
+		if (i + 1 < size)
+		{
+			group |= in[i + 1] << 8;
+		}
+
+		out[o++] = detail::encode_char(group >> 18, alphabet);
+		out[o++] = detail::encode_char(group >> 12 & 0x3F, alphabet);
+
+		if (i + 1 < size)
+		{
+			out[o++] = detail::encode_char(group >> 6 & 0x3F,
+				alphabet);
+		}
+		else if (pad)
+		{
+			out[o++] = '=';
+		}
+
+		if (pad)
+		{
+			out[o++] = '=';
+		}
+	}
+
+	return o;
+}
+
+/**
+ * Decodes base64 text into binary data.
+ * Both padded and unpadded input is accepted.
+ * The output buffer must hold at least `max_decoded_size(size)` bytes.
+ * Returns the number of bytes written, or -1 if the input is not valid
+ * base64 text in the given alphabet.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline isize
+decode(u8 *out, const char *in, usize size,
+	Alphabet alphabet = Alphabet::Standard)
+{
+	// Strip the padding.
+
+	if (size % 4 == 0)
+	{
+		for (usize i = 0; i < 2 && size > 0 && in[size - 1] == '='; i++)
+		{
+			size--;
+		}
+	}
+
+	// A single character cannot encode a full byte.
+
+	if (size % 4 == 1)
+	{
+		return -1;
+	}
+
+	usize i = 0;
+	usize o = 0;
+
+	// Decode 16 characters at a time. Each iteration stores 16 bytes,
+	// of which 12 are valid, so we keep a margin of 16 characters at the
+	// end to make sure the store stays within the output buffer.
+
+	for (; i + 32 <= size; i += 16, o += 12)
+	{
+		u8x16 block;
+
+		if (!detail::decode_block(simd::load<u8x16>(in + i), alphabet,
+			block))
+		{
+			return -1;
+		}
+
+		simd::store(out + o, block);
+	}
+
+	// Decode the remaining characters 4 at a time.
+
+	for (; i < size; i += 4)
+	{
+		usize group_size = min(size - i, (usize) 4);
+		u32 group = 0;
+
+		for (usize j = 0; j < group_size; j++)
+		{
+			i32 value = detail::decode_char(in[i + j], alphabet);
+
+			if (value < 0)
+			{
+				return -1;
+			}
+
+			group |= value << (18 - 6 * j);
+		}
+
+		// A group of n characters encodes n - 1 bytes.
+
+		for (usize j = 0; j < group_size - 1; j++)
+		{
+			out[o++] = group >> (16 - 8 * j);
+		}
+	}
+
+	return o;
+}
+}; // namespace slaw::base64
+
+/**
+ * This namespace contains functions to encode binary data as hexadecimal
+ * text and to decode hexadecimal text back into binary data.
+ *
+ * All functions write into buffers provided by the caller and never allocate
+ * memory. Encoding writes two characters per byte.
+ */
+namespace slaw::hex
+{
+/**
+ * Encodes binary data as hexadecimal text.
+ * The output buffer must hold at least `2 * size` characters.
+ * Returns the number of characters written.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline usize
+encode(char *out, const u8 *in, usize size, bool uppercase = false)
+{
+	const char *digits = uppercase
+		? "0123456789ABCDEF" : "0123456789abcdef";
+	const u8x16 lookup = simd::load<u8x16>(digits);
+
+	usize i = 0;
+
+	// Encode 16 bytes at a time. The high and low nibbles are looked up
+	// separately and interleaved into two blocks of 16 characters.
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 block = simd::load<u8x16>(in + i);
+		u8x16 high = simd::swizzle(lookup, block >> 4);
+		u8x16 low = simd::swizzle(lookup, block & 0x0F);
+
+		simd::store(out + 2 * i, __builtin_shufflevector(high, low,
+			0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23));
+		simd::store(out + 2 * i + 16, __builtin_shufflevector(high, low,
+			8, 24, 9, 25, 10, 26, 11, 27,
+			12, 28, 13, 29, 14, 30, 15, 31));
+	}
+
+	for (; i < size; i++)
+	{
+		out[2 * i] = digits[in[i] >> 4];
+		out[2 * i + 1] = digits[in[i] & 0x0F];
+	}
+
+	return 2 * size;
+}
+
+namespace detail
+{
+/**
+ * Converts 16 hexadecimal characters to their 4-bit values.
+ * Both lowercase and uppercase digits are accepted.
+ * Returns false if any of the characters is not a hexadecimal digit.
+ */
+inline bool
+decode_nibbles(u8x16 in, u8x16 &out)
+{
+	u8x16 digit = simd::in_range(in, '0', '9');
+	u8x16 lower = simd::in_range(in, 'a', 'f');
+	u8x16 upper = simd::in_range(in, 'A', 'F');
+
+	if (simd::bitmask(digit | lower | upper) != 0xFFFF)
+	{
+		return false;
+	}
+
+	out = in
+		+ (digit & (u8) (0 - '0'))
+		+ (lower & (u8) (10 - 'a'))
+		+ (upper & (u8) (10 - 'A'));
+
+	return true;
+}
+
+/**
+ * Returns the 4-bit value of a hexadecimal digit,
+ * or -1 if the character is not a hexadecimal digit.
+ */
+constexpr i32
+decode_nibble(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+
+	if (c >= 'a' && c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+
+	if (c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+}; // namespace slaw::hex::detail
+
+/**
+ * Decodes hexadecimal text into binary data.
+ * Both lowercase and uppercase digits are accepted.
+ * The output buffer must hold at least `size / 2` bytes.
+ * Returns the number of bytes written, or -1 if the input has an odd length
+ * or contains a character that is not a hexadecimal digit.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline isize
+decode(u8 *out, const char *in, usize size)
+{
+	if (size % 2 != 0)
+	{
+		return -1;
+	}
+
+	usize i = 0;
+
+	// Decode 32 characters into 16 bytes at a time. The even characters
+	// hold the high nibbles and the odd characters hold the low nibbles.
+
+	for (; i + 32 <= size; i += 32)
+	{
+		u8x16 a;
+		u8x16 b;
+
+		if (!detail::decode_nibbles(simd::load<u8x16>(in + i), a)
+			|| !detail::decode_nibbles(simd::load<u8x16>(in + i + 16), b))
+		{
+			return -1;
+		}
+
+		u8x16 high = __builtin_shufflevector(a, b,
+			0, 2, 4, 6, 8, 10, 12, 14,
+			16, 18, 20, 22, 24, 26, 28, 30);
+		u8x16 low = __builtin_shufflevector(a, b,
+			1, 3, 5, 7, 9, 11, 13, 15,
+			17, 19, 21, 23, 25, 27, 29, 31);
+
+		simd::store(out + i / 2, (u8x16) ((high << 4) | low));
+	}
+
+	for (; i < size; i += 2)
+	{
+		i32 high = detail::decode_nibble(in[i]);
+		i32 low = detail::decode_nibble(in[i + 1]);
+
+		if (high < 0 || low < 0)
+		{
+			return -1;
+		}
+
+		out[i / 2] = high << 4 | low;
+	}
+
+	return size / 2;
+}
+}; // namespace slaw::hex
+
+#endif
\ No newline at end of file
@@ -0,0 +1,533 @@
+#ifndef SLAW_GAP_BUFFER_H
+#define SLAW_GAP_BUFFER_H
+
+#include "types.hpp"
+#include "util.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * Copies bytes to a lower address. The ranges may overlap.
+ * Copies 16 bytes at a time.
+ */
+inline void
+copy_bytes_forward(char *dst, const char *src, usize size)
+{
+	usize i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		simd::store(dst + i, simd::load<u8x16>(src + i));
+	}
+
+	for (; i < size; i++)
+	{
+		dst[i] = src[i];
+	}
+}
+
+/**
+ * Copies bytes to a higher address. The ranges may overlap.
+ * Copies 16 bytes at a time, starting at the end.
+ */
+inline void
+copy_bytes_backward(char *dst, const char *src, usize size)
+{
+	usize i = size;
+
+	for (; i >= 16; i -= 16)
+	{
+		simd::store(dst + i - 16, simd::load<u8x16>(src + i - 16));
+	}
+
+	while (i > 0)
+	{
+		i--;
+		dst[i] = src[i];
+	}
+}
+}; // namespace slaw::detail
+
+/**
+ * Text buffer for editing around a cursor.
+ *
+ * The text is stored in a single array with a gap in it, at the cursor.
+ * Inserting or erasing at the cursor only moves the edges of the gap, so
+ * typing and deleting characters are O(1). Moving the cursor moves the gap,
+ * which copies the bytes between the old and the new position in bulk.
+ * When the gap is used up, the array grows geometrically.
+ *
+ * The text can be read as two spans, the part before the gap and the part
+ * after it, without copying.
+ *
+ * The start offsets of lines are cached. Edits only invalidate the cached
+ * lines after the edit, and lookups scan for newlines from the last valid
+ * cached line on, 16 bytes at a time.
+ */
+struct GapBuffer
+{
+	// The minimum size of the gap after the array grows.
+	static const constexpr usize min_gap_size = 64;
+
+	// The array holding the text and the gap.
+	char *data;
+
+	// The size of the array.
+	usize capacity;
+
+	// The index of the first byte of the gap. This is the cursor.
+	usize gap_start;
+
+	// The index of the first byte after the gap.
+	usize gap_end;
+
+	// The cached start offsets of lines. Entry `i` is the offset at which
+	// line `i` starts. Lines after the last entry have not been scanned
+	// since the last edit before them.
+	Vector<usize> line_starts;
+
+	/**
+	 * Constructs an empty gap buffer with a given initial capacity.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(n).
+	 */
+	GapBuffer(usize initial_capacity = min_gap_size)
+		: data(new char[max(initial_capacity, min_gap_size)]),
+		  capacity(max(initial_capacity, min_gap_size)),
+		  gap_start(0), gap_end(capacity)
+	{
+		line_starts.push_back(0);
+	}
+
+	/**
+	 * Constructs a gap buffer holding a copy of a text, with the cursor
+	 * at the end.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	GapBuffer(StringView text)
+		: GapBuffer(text.size + min_gap_size)
+	{
+		insert(text);
+	}
+
+	GapBuffer(const GapBuffer &) = delete;
+
+	GapBuffer &
+	operator=(const GapBuffer &) = delete;
+
+	/**
+	 * Frees the array.
+	 */
+	~GapBuffer()
+	{
+		delete[] data;
+	}
+
+	/**
+	 * Returns the number of bytes of text.
+	 */
+	usize
+	size()
+	const
+	{
+		return capacity - (gap_end - gap_start);
+	}
+
+	/**
+	 * Returns the position of the cursor.
+	 */
+	usize
+	cursor()
+	const
+	{
+		return gap_start;
+	}
+
+	/**
+	 * Returns the byte at a given offset of the text.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the offset is greater than or equal to the size of the
+	 * text, BEHAVIOUR IS UNDEFINED.
+	 */
+	char
+	operator[](usize pos)
+	const
+	{
+		return pos < gap_start ? data[pos]
+			: data[pos + (gap_end - gap_start)];
+	}
+
+	/**
+	 * Returns a view of the text before the gap.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	StringView
+	before_gap()
+	const
+	{
+		return StringView(data, gap_start);
+	}
+
+	/**
+	 * Returns a view of the text after the gap.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	StringView
+	after_gap()
+	const
+	{
+		return StringView(data + gap_end, capacity - gap_end);
+	}
+
+	/**
+	 * Moves the cursor to a given offset, by moving the bytes in between
+	 * from one side of the gap to the other.
+	 *
+	 * - Time complexity: O(d), where d is the distance moved.
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the offset is greater than the size of the text,
+	 * BEHAVIOUR IS UNDEFINED.
+	 */
+	void
+	move_cursor(usize pos)
+	{
+		if (pos < gap_start)
+		{
+			// Move the bytes in [pos, gap_start) to the end of the gap.
+
+			usize count = gap_start - pos;
+			detail::copy_bytes_backward(data + gap_end - count,
+				data + pos, count);
+			gap_start -= count;
+			gap_end -= count;
+		}
+		else if (pos > gap_start)
+		{
+			// Move the bytes after the gap to its start.
+
+			usize count = pos - gap_start;
+			detail::copy_bytes_forward(data + gap_start, data + gap_end,
+				count);
+			gap_start += count;
+			gap_end += count;
+		}
+	}
+
+	/**
+	 * Inserts a text at the cursor. The cursor ends up after the text.
+	 *
+	 * - Time complexity: O(m) on average, where m is the size of the text.
+	 * - Space complexity: O(m) on average.
+	 */
+	void
+	insert(StringView text)
+	{
+		reserve(text.size);
+		invalidate_lines(gap_start);
+
+		for (usize i = 0; i < text.size; i++)
+		{
+			data[gap_start + i] = text[i];
+		}
+
+		gap_start += text.size;
+	}
+
+	/**
+	 * Inserts a character at the cursor. The cursor ends up after it.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1) on average.
+	 */
+	void
+	insert(char c)
+	{
+		insert(StringView(&c, 1));
+	}
+
+	/**
+	 * Inserts a text at a given offset. The cursor ends up after the text.
+	 *
+	 * - Time complexity: O(d + m), where d is the distance from the cursor
+	 *   and m is the size of the text.
+	 * - Space complexity: O(m) on average.
+	 */
+	void
+	insert(usize pos, StringView text)
+	{
+		move_cursor(pos);
+		insert(text);
+	}
+
+	/**
+	 * Erases up to a given number of bytes before the cursor, like the
+	 * backspace key.
+	 *
+	 * - Time complexity: O(log l), where l is the number of cached lines.
+	 * - Space complexity: O(1).
+	 */
+	void
+	erase_before(usize count)
+	{
+		count = min(count, gap_start);
+		gap_start -= count;
+		invalidate_lines(gap_start);
+	}
+
+	/**
+	 * Erases up to a given number of bytes after the cursor, like the
+	 * delete key.
+	 *
+	 * - Time complexity: O(log l), where l is the number of cached lines.
+	 * - Space complexity: O(1).
+	 */
+	void
+	erase_after(usize count)
+	{
+		count = min(count, capacity - gap_end);
+		gap_end += count;
+		invalidate_lines(gap_start);
+	}
+
+	/**
+	 * Erases a given number of bytes starting at a given offset. The cursor
+	 * ends up at that offset.
+	 * The range is clamped to the end of the text.
+	 *
+	 * - Time complexity: O(d), where d is the distance from the cursor.
+	 * - Space complexity: O(1).
+	 */
+	void
+	erase(usize pos, usize length)
+	{
+		move_cursor(pos);
+		erase_after(length);
+	}
+
+	/**
+	 * Makes sure the gap can hold a given number of bytes. If it cannot,
+	 * the array grows to at least twice its size.
+	 *
+	 * - Time complexity: O(n) if the array grows, O(1) otherwise.
+	 * - Space complexity: O(n) if the array grows, O(1) otherwise.
+	 */
+	void
+	reserve(usize extra_size)
+	{
+		if (gap_end - gap_start >= extra_size)
+		{
+			return;
+		}
+
+		usize after = capacity - gap_end;
+		usize new_capacity = max(capacity * 2,
+			size() + extra_size + min_gap_size);
+		char *new_data = new char[new_capacity];
+
+		detail::copy_bytes_forward(new_data, data, gap_start);
+		detail::copy_bytes_forward(new_data + new_capacity - after,
+			data + gap_end, after);
+
+		delete[] data;
+		data = new_data;
+		capacity = new_capacity;
+		gap_end = new_capacity - after;
+	}
+
+	/**
+	 * Creates a string holding a copy of the text.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_string()
+	const
+	{
+		String out(max(size(), String::min_capacity));
+		detail::copy_bytes_forward(out.data, data, gap_start);
+		detail::copy_bytes_forward(out.data + gap_start, data + gap_end,
+			capacity - gap_end);
+		out.size = size();
+		return out;
+	}
+
+	/**
+	 * Returns the number of lines in the text, which is one more than the
+	 * number of newlines.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	usize
+	line_count()
+	const
+	{
+		StringView before = before_gap();
+		StringView after = after_gap();
+
+		return 1 + detail::count_byte(before.data, before.size, '\n')
+			+ detail::count_byte(after.data, after.size, '\n');
+	}
+
+	/**
+	 * Returns the offset at which a line starts.
+	 * If the line is past the last line, the size of the text is returned.
+	 *
+	 * - Time complexity: O(1) if the line is cached, otherwise O(k), where
+	 *   k is the distance from the last cached line.
+	 * - Space complexity: O(1) on average.
+	 */
+	usize
+	line_start(usize line)
+	{
+		while (line_starts.size <= line)
+		{
+			if (!scan_next_line())
+			{
+				return size();
+			}
+		}
+
+		return line_starts[line];
+	}
+
+	/**
+	 * Returns the line that holds the byte at a given offset.
+	 *
+	 * - Time complexity: O(log l) if the offset is before the last cached
+	 *   line, otherwise O(k), where k is the distance from it.
+	 * - Space complexity: O(1) on average.
+	 */
+	usize
+	line_of(usize pos)
+	{
+		while (line_starts[line_starts.size - 1] < pos && scan_next_line())
+		{
+		}
+
+		// Find the last line that starts at or before the offset.
+
+		usize low = 0;
+		usize high = line_starts.size;
+
+		while (high - low > 1)
+		{
+			usize mid = low + (high - low) / 2;
+
+			if (line_starts[mid] <= pos)
+			{
+				low = mid;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		return low;
+	}
+
+	/**
+	 * Forgets the cached lines that start after a given offset, because
+	 * the text at that offset changed.
+	 */
+	void
+	invalidate_lines(usize pos)
+	{
+		// Line 0 always starts at 0, so at least one entry is kept.
+
+		usize low = 1;
+		usize high = line_starts.size;
+
+		while (low < high)
+		{
+			usize mid = low + (high - low) / 2;
+
+			if (line_starts[mid] <= pos)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		line_starts.size = low;
+	}
+
+	/**
+	 * Finds the start of the line after the last cached line and adds it
+	 * to the cache. Returns false if the last cached line is the last line
+	 * of the text.
+	 */
+	bool
+	scan_next_line()
+	{
+		usize from = line_starts[line_starts.size - 1];
+		isize newline = -1;
+
+		// Search the part before the gap first, then the part after it.
+
+		if (from < gap_start)
+		{
+			newline = find_newline(data + from, gap_start - from);
+
+			if (newline != -1)
+			{
+				newline += from;
+			}
+		}
+
+		if (newline == -1)
+		{
+			usize start = max(from, gap_start);
+			isize found = find_newline(data + start
+				+ (gap_end - gap_start), size() - start);
+
+			if (found != -1)
+			{
+				newline = start + found;
+			}
+		}
+
+		if (newline == -1)
+		{
+			return false;
+		}
+
+		line_starts.push_back(newline + 1);
+		return true;
+	}
+
+	/**
+	 * Returns the index of the first newline in a buffer, or -1.
+	 */
+	static isize
+	find_newline(const char *str, usize size)
+	{
+		return detail::find_nth_byte(str, size, '\n', 1);
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+#ifndef SLAW_HTML_H
+#define SLAW_HTML_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * Returns a mask of the bytes of a vector that have to be escaped in HTML.
+ */
+inline u8x16
+html_special_mask(u8x16 v)
+{
+	return (u8x16) (v == simd::splat<u8x16>('&'))
+		| (u8x16) (v == simd::splat<u8x16>('<'))
+		| (u8x16) (v == simd::splat<u8x16>('>'))
+		| (u8x16) (v == simd::splat<u8x16>('"'))
+		| (u8x16) (v == simd::splat<u8x16>('\''));
+}
+
+/**
+ * Returns the entity that replaces a character in HTML, or nullptr if the
+ * character does not have to be escaped.
+ */
+constexpr const char *
+html_entity(char c)
+{
+	switch (c)
+	{
+	case '&':  return "&amp;";
+	case '<':  return "&lt;";
+	case '>':  return "&gt;";
+	case '"':  return "&quot;";
+	case '\'': return "&#39;";
+	default:   return nullptr;
+	}
+}
+
+/**
+ * Returns the number of characters that escaping a character adds.
+ */
+constexpr usize
+html_entity_extra(char c)
+{
+	switch (c)
+	{
+	case '&':  return 4;
+	case '<':  return 3;
+	case '>':  return 3;
+	case '"':  return 5;
+	case '\'': return 4;
+	default:   return 0;
+	}
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns the size of a text after escaping it with `escape_html()`.
+ * Each block of 16 characters is compared against the special characters
+ * once, and the number of matches of each kind is counted with a popcount
+ * of the resulting masks.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline usize
+escaped_html_size(StringView text)
+{
+	usize extra = 0;
+	usize i = 0;
+
+	for (; i + 16 <= text.size; i += 16)
+	{
+		u8x16 v = simd::load<u8x16>(text.data + i);
+		u8x16 special = detail::html_special_mask(v);
+
+		if (simd::bitmask(special) == 0)
+		{
+			continue;
+		}
+
+		// Every entity adds at least 3 characters. Ampersands and
+		// apostrophes add one more, quotes two more.
+
+		u32 amp_or_apos = simd::bitmask(
+			(u8x16) (v == simd::splat<u8x16>('&'))
+			| (u8x16) (v == simd::splat<u8x16>('\'')));
+		u32 quot = simd::bitmask((u8x16) (v == simd::splat<u8x16>('"')));
+
+		extra += 3 * popcnt(simd::bitmask(special)) + popcnt(amp_or_apos)
+			+ 2 * popcnt(quot);
+	}
+
+	for (; i < text.size; i++)
+	{
+		extra += detail::html_entity_extra(text[i]);
+	}
+
+	return text.size + extra;
+}
+
+/**
+ * Escapes a text for use in HTML text content and quoted attribute values,
+ * by replacing `&`, `<`, `>`, `"` and `'` with character references.
+ * The output buffer must hold at least `escaped_html_size(text)` characters.
+ * Returns the number of characters written.
+ *
+ * The text is scanned 16 characters at a time. Blocks without special
+ * characters are copied with a single store, and runs of ordinary characters
+ * in between special characters are copied without being inspected again.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+inline usize
+escape_html(char *out, StringView text)
+{
+	usize read = 0;
+	usize write = 0;
+
+	for (; read + 16 <= text.size; read += 16)
+	{
+		u8x16 v = simd::load<u8x16>(text.data + read);
+		u32 special = simd::bitmask(detail::html_special_mask(v));
+
+		if (special == 0)
+		{
+			// The output has room for at least as many characters as
+			// are left in the input, so the whole block fits.
+
+			simd::store(out + write, v);
+			write += 16;
+			continue;
+		}
+
+		usize copied = 0;
+
+		while (special)
+		{
+			usize j = ctz(special);
+			special &= special - 1;
+
+			if (read + copied + 16 <= text.size)
+			{
+				// Copy the run before the special character with one
+				// store. The store may write past the run, which is
+				// overwritten afterwards. There are at least 16
+				// characters left in the input, so there is room for
+				// 16 more in the output.
+
+				simd::store(out + write,
+					simd::load<u8x16>(text.data + read + copied));
+				write += j - copied;
+				copied = j;
+			}
+
+			while (copied < j)
+			{
+				out[write++] = text[read + copied++];
+			}
+
+			const char *entity = detail::html_entity(text[read + j]);
+
+			while (*entity)
+			{
+				out[write++] = *entity++;
+			}
+
+			copied = j + 1;
+		}
+
+		if (read + copied + 16 <= text.size)
+		{
+			simd::store(out + write,
+				simd::load<u8x16>(text.data + read + copied));
+			write += 16 - copied;
+			copied = 16;
+		}
+
+		while (copied < 16)
+		{
+			out[write++] = text[read + copied++];
+		}
+	}
+
+	for (; read < text.size; read++)
+	{
+		const char *entity = detail::html_entity(text[read]);
+
+		if (entity == nullptr)
+		{
+			out[write++] = text[read];
+			continue;
+		}
+
+		while (*entity)
+		{
+			out[write++] = *entity++;
+		}
+	}
+
+	return write;
+}
+
+/**
+ * Escapes a text for use in HTML and appends it to a string.
+ * The escaped size is computed first, so the string grows at most once per
+ * call. Like `reserve()`, it doubles its capacity rather than growing to
+ * the exact size, so appending many fragments to the same string only
+ * reallocates it a logarithmic number of times.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(n).
+ */
+inline void
+escape_html_append(String &out, StringView text)
+{
+	usize escaped_size = escaped_html_size(text);
+	out.reserve(escaped_size);
+	out.size += escape_html(out.data + out.size, text);
+}
+
+/**
+ * Creates a string holding a text escaped for use in HTML.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(n).
+ */
+inline String
+escape_html(StringView text)
+{
+	usize escaped_size = escaped_html_size(text);
+	String out(max(escaped_size, String::min_capacity));
+	out.size = escape_html(out.data, text);
+	return out;
+}
+}; // namespace slaw
+
+#endif
\ No newline at end of file
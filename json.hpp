@@ -0,0 +1,652 @@
+#ifndef SLAW_JSON_H
+#define SLAW_JSON_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "string.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * Returns the character that follows a backslash in the short escape
+ * sequence of a character, or 0 if the character has to be escaped as
+ * `\u00XX`.
+ */
+constexpr char
+json_short_escape(u8 c)
+{
+	switch (c)
+	{
+	case '"':  return '"';
+	case '\\': return '\\';
+	case '\b': return 'b';
+	case '\f': return 'f';
+	case '\n': return 'n';
+	case '\r': return 'r';
+	case '\t': return 't';
+	default:   return 0;
+	}
+}
+}; // namespace slaw::detail
+
+/**
+ * Streaming JSON serialiser.
+ * Appends JSON text to an internal buffer that is reused between documents.
+ * After the buffer has grown to fit the largest document, serialising a
+ * document of the same shape again does not allocate any memory.
+ *
+ * Example:
+ *
+ *     writer.reset();
+ *     writer.begin_object();
+ *     writer.key("x");
+ *     writer.value(12);
+ *     writer.key("tags");
+ *     writer.begin_array();
+ *     writer.value("a\nb");
+ *     writer.end_array();
+ *     writer.end_object();
+ *     slaw::print(writer.buffer); // {"x":12,"tags":["a\nb"]}
+ *
+ * The writer does not validate the structure of the document. Calling the
+ * builder functions in an order that does not form valid JSON results in
+ * invalid output. Objects and arrays can be nested at most 64 levels deep.
+ */
+struct JsonWriter
+{
+	// The JSON text that has been written so far.
+	// Can be handed to JavaScript directly, e.g. through `slaw::eval()`.
+	String buffer;
+
+	// A stack of bits, one per nesting level. The lowest bit belongs to
+	// the innermost object or array and is set once it holds an element,
+	// which means the next element has to be preceded by a comma.
+	u64 element_stack = 0;
+
+	// Whether a key was just written. The value that follows a key does
+	// not need a comma.
+	bool after_key = false;
+
+	// The maximum number of decimal places written for floating point
+	// values. Trailing zeroes are omitted. Cannot be more than 15.
+	usize precision = 6;
+
+	/**
+	 * Constructs a JSON writer with a given initial buffer capacity.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	JsonWriter(usize initial_capacity = String::min_capacity)
+		: buffer(initial_capacity) {}
+
+	/**
+	 * Discards the written text, so a new document can be written.
+	 * The buffer keeps its capacity, so no memory is freed or allocated.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	void
+	reset()
+	{
+		buffer.size = 0;
+		element_stack = 0;
+		after_key = false;
+	}
+
+	/**
+	 * Starts a new object.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	begin_object()
+	{
+		begin_value();
+		buffer.push_back('{');
+		element_stack <<= 1;
+	}
+
+	/**
+	 * Ends the innermost object.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	end_object()
+	{
+		buffer.push_back('}');
+		element_stack >>= 1;
+	}
+
+	/**
+	 * Starts a new array.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	begin_array()
+	{
+		begin_value();
+		buffer.push_back('[');
+		element_stack <<= 1;
+	}
+
+	/**
+	 * Ends the innermost array.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	end_array()
+	{
+		buffer.push_back(']');
+		element_stack >>= 1;
+	}
+
+	/**
+	 * Writes the key of the next member of the innermost object.
+	 * The key is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	key(const char *str, usize length)
+	{
+		begin_value();
+		write_string(str, length);
+		buffer.push_back(':');
+		after_key = true;
+	}
+
+	/**
+	 * Writes the key of the next member of the innermost object.
+	 * The key is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	key(const String &str)
+	{
+		key(str.data, str.size);
+	}
+
+	/**
+	 * Writes the key of the next member of the innermost object.
+	 * The key is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	template <usize N>
+	void
+	key(const char (&str)[N])
+	{
+		key(str, N - 1);
+	}
+
+	/**
+	 * Writes a string value. The string is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	value(const char *str, usize length)
+	{
+		begin_value();
+		write_string(str, length);
+	}
+
+	/**
+	 * Writes a string value. The string is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	value(const String &str)
+	{
+		value(str.data, str.size);
+	}
+
+	/**
+	 * Writes a string value. The string is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	template <usize N>
+	void
+	value(const char (&str)[N])
+	{
+		value(str, N - 1);
+	}
+
+	/**
+	 * Writes a boolean value.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	value(bool b)
+	{
+		begin_value();
+
+		if (b)
+		{
+			append("true", 4);
+		}
+		else
+		{
+			append("false", 5);
+		}
+	}
+
+	/**
+	 * Writes a null value.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	void
+	null()
+	{
+		begin_value();
+		append("null", 4);
+	}
+
+	/**
+	 * Writes an integer or floating point value.
+	 * Floating point values are written with at most `precision` decimal
+	 * places. NaN and infinities cannot be represented in JSON, they are
+	 * written as `null`.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1).
+	 */
+	template <typename T>
+	void
+	value(T n)
+	{
+		static_assert(is_integer<T>() || is_float<T>(),
+			"Expected an integer or floating point type.");
+
+		begin_value();
+
+		if constexpr (is_integer<T>())
+		{
+			write_integer(n);
+		}
+		else
+		{
+			write_float(n);
+		}
+	}
+
+	/**
+	 * Writes a piece of text that is already valid JSON, without escaping.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	raw(const char *json, usize length)
+	{
+		begin_value();
+		append(json, length);
+	}
+
+	/**
+	 * Appends characters to the buffer without any processing.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	append(const char *str, usize length)
+	{
+		buffer.reserve(length);
+
+		for (usize i = 0; i < length; i++)
+		{
+			buffer.data[buffer.size + i] = str[i];
+		}
+
+		buffer.size += length;
+	}
+
+	/**
+	 * Writes the separator that has to precede a new value, if any.
+	 */
+	void
+	begin_value()
+	{
+		if (after_key)
+		{
+			after_key = false;
+			return;
+		}
+
+		if (element_stack & 1)
+		{
+			buffer.push_back(',');
+		}
+
+		element_stack |= 1;
+	}
+
+	/**
+	 * Writes a quoted and escaped string.
+	 *
+	 * The string is scanned 16 bytes at a time. Each block is compared
+	 * against the characters that need escaping (quotes, backslashes and
+	 * control characters). Blocks that contain none of them are copied
+	 * with a single store. Otherwise, the clean bytes in front of the first
+	 * match are copied and the matched character is escaped.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	write_string(const char *str, usize length)
+	{
+		// Reserve enough space for the string and the two quotes.
+		// If the string does not contain any characters that need
+		// escaping, this is the only reservation we need.
+
+		buffer.reserve(length + 2);
+		buffer.data[buffer.size++] = '"';
+
+		const u8x16 quote = simd::splat<u8x16>('"');
+		const u8x16 backslash = simd::splat<u8x16>('\\');
+		const u8x16 space = simd::splat<u8x16>(' ');
+
+		usize i = 0;
+
+		while (i + 16 <= length)
+		{
+			u8x16 block = simd::load<u8x16>(str + i);
+			u8x16 needs_escape = (u8x16) (block == quote)
+				| (u8x16) (block == backslash)
+				| (u8x16) (block < space);
+
+			u32 mask = simd::bitmask(needs_escape);
+
+			if (mask == 0)
+			{
+				// Fast path: copy the entire block at once.
+
+				simd::store(buffer.data + buffer.size, block);
+				buffer.size += 16;
+				i += 16;
+				continue;
+			}
+
+			// Copy the clean bytes in front of the first character
+			// that needs escaping, then escape that character.
+
+			usize clean = ctz(mask);
+
+			simd::store(buffer.data + buffer.size, block);
+			buffer.size += clean;
+			i += clean;
+
+			write_escaped_char(str[i], length - i);
+			i++;
+		}
+
+		// Handle the remaining bytes one at a time.
+
+		for (; i < length; i++)
+		{
+			u8 c = str[i];
+
+			if (c == '"' || c == '\\' || c < ' ')
+			{
+				write_escaped_char(c, length - i);
+			}
+			else
+			{
+				buffer.data[buffer.size++] = c;
+			}
+		}
+
+		buffer.data[buffer.size++] = '"';
+	}
+
+	/**
+	 * Writes the escape sequence of a character.
+	 * Afterwards, reserves enough space for the rest of the string, which
+	 * is `remaining - 1` characters plus the closing quote.
+	 */
+	void
+	write_escaped_char(u8 c, usize remaining)
+	{
+		// The longest escape sequence is `\u00XX`, which replaces one
+		// character with six.
+
+		buffer.reserve(remaining + 6);
+
+		char *out = buffer.data + buffer.size;
+		char short_escape = detail::json_short_escape(c);
+
+		out[0] = '\\';
+
+		if (short_escape)
+		{
+			out[1] = short_escape;
+			buffer.size += 2;
+			return;
+		}
+
+		const char *hex = "0123456789abcdef";
+
+		out[1] = 'u';
+		out[2] = '0';
+		out[3] = '0';
+		out[4] = hex[c >> 4];
+		out[5] = hex[c & 0xF];
+		buffer.size += 6;
+	}
+
+	/**
+	 * Writes an integer without allocating any temporary strings.
+	 */
+	template <typename T>
+	void
+	write_integer(T n)
+	{
+		char digits[21];
+		char *end = digits + sizeof(digits);
+
+		// Negating the minimum value of a signed type overflows,
+		// so we compute the magnitude in the unsigned domain.
+
+		u64 magnitude = n;
+
+		if constexpr (is_signed_integer<T>())
+		{
+			if (n < 0)
+			{
+				magnitude = 0 - (u64) n;
+			}
+		}
+
+		char *start = detail::write_decimal_backwards(end, magnitude);
+
+		if constexpr (is_signed_integer<T>())
+		{
+			if (n < 0)
+			{
+				*--start = '-';
+			}
+		}
+
+		append(start, end - start);
+	}
+
+	/**
+	 * Writes a floating point number without allocating any temporary
+	 * strings. Numbers from 1e-6 up to 1e15 are written in positional
+	 * notation, all other numbers are written in scientific notation.
+	 */
+	template <typename T>
+	void
+	write_float(T f)
+	{
+		if (is_nan(f) || f == Infinity<T>() || f == -Infinity<T>())
+		{
+			append("null", 4);
+			return;
+		}
+
+		// Scale factor for the decimal places.
+
+		usize places = min(precision, (usize) 15);
+		f64 scale = 1;
+
+		for (usize i = 0; i < places; i++)
+		{
+			scale *= 10;
+		}
+
+		f64 x = f;
+
+		if (x < 0)
+		{
+			buffer.push_back('-');
+			x = -x;
+		}
+
+		// Normalise numbers outside of the positional range into the
+		// range [1, 10) and remember the decimal exponent.
+
+		i32 exponent = 0;
+
+		if (x != 0 && (x < 1e-6 || x >= 1e15))
+		{
+			exponent = normalise_decimal(x);
+		}
+
+		// Split the number into an integer part and a fractional part
+		// that is rounded to `precision` decimal places.
+
+		u64 integer_part = x;
+		u64 fraction = round((x - integer_part) * scale);
+
+		// Rounding can carry into the integer part, e.g. 0.9999999.
+
+		if (fraction >= scale)
+		{
+			integer_part++;
+			fraction -= scale;
+
+			if (exponent != 0 && integer_part == 10)
+			{
+				integer_part = 1;
+				exponent++;
+			}
+		}
+
+		write_integer(integer_part);
+
+		// Write the fractional part, without trailing zeroes.
+
+		if (fraction != 0)
+		{
+			while (fraction % 10 == 0)
+			{
+				fraction /= 10;
+				places--;
+			}
+
+			char digits[21];
+			char *end = digits + sizeof(digits);
+			char *start = detail::write_decimal_backwards(end,
+				fraction);
+
+			// Pad with leading zeroes, e.g. 0.05 has a fraction
+			// of 5 with two decimal places.
+
+			while (end - start < places)
+			{
+				*--start = '0';
+			}
+
+			*--start = '.';
+			append(start, end - start);
+		}
+
+		if (exponent != 0)
+		{
+			buffer.push_back('e');
+			write_integer(exponent);
+		}
+	}
+
+	/**
+	 * Scales a positive, finite number into the range [1, 10).
+	 * Returns the decimal exponent, such that the original number equals
+	 * `x * 10^exponent`.
+	 */
+	static i32
+	normalise_decimal(f64 &x)
+	{
+		// We multiply or divide by powers of ten from large to small,
+		// so the exponent is found in a logarithmic number of steps
+		// without calling into JavaScript for `log10()`.
+
+		constexpr const f64 powers[] = {
+			1e256, 1e128, 1e64, 1e32, 1e16, 1e8, 1e4, 1e2, 1e1
+		};
+
+		constexpr const i32 exponents[] = {
+			256, 128, 64, 32, 16, 8, 4, 2, 1
+		};
+
+		i32 exponent = 0;
+
+		for (usize i = 0; i < 9; i++)
+		{
+			if (x >= powers[i])
+			{
+				x /= powers[i];
+				exponent += exponents[i];
+			}
+		}
+
+		for (usize i = 0; i < 9; i++)
+		{
+			if (x * powers[i] < 10)
+			{
+				x *= powers[i];
+				exponent -= exponents[i];
+			}
+		}
+
+		// Subnormal numbers might still be below 1 after scaling.
+
+		while (x < 1)
+		{
+			x *= 10;
+			exponent--;
+		}
+
+		return exponent;
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "export.hpp"
 #include "types.hpp"
+#include "util.hpp"
 
 namespace slaw
 {
@@ -45,6 +46,19 @@ constexpr const f64 SQRT_2 = 1.41421356237309504880;
 // Equivalent to √0.5.
 constexpr const f64 INV_SQRT_2 = 0.70710678118654752440;
 
+/**
+ * The precision tiers of approximated mathematical functions.
+ * `Full` is accurate to a few units in the last place and handles special
+ * inputs such as infinities, NaNs and subnormal numbers. `Fast` is accurate
+ * to about five decimal digits, and is meant for graphics and audio code
+ * that does not need more.
+ */
+enum class Precision
+{
+	Fast,
+	Full
+};
+
 /**
  * Returns the minimum of two values.
  */
@@ -100,6 +114,14 @@ abs(T n)
 	// Note that the compiler will optimise away the `n < 0` branch
 	// for unsigned numbers.
 
+	// Floating point numbers have their sign bit cleared instead, so that
+	// -0 becomes 0, like with `f32.abs` and `f64.abs`.
+
+	if constexpr (is_float<T>())
+	{
+		return detail::stored_sign(n) ? -n : n;
+	}
+
 	if (n < 0)
 	{
 		return -n;
@@ -489,6 +511,93 @@ gcd(T a, T b)
 	}
 }
 
+namespace detail
+{
+/**
+ * Helper function for the ipow function. Raises a number to a non-negative
+ * power by repeated squaring.
+ */
+template <typename T>
+constexpr inline T
+ipow_impl(T base, u64 exponent)
+{
+	T result = 1;
+
+	while (exponent != 0)
+	{
+		if (exponent & 1)
+		{
+			result *= base;
+		}
+
+		// The last square is never used, so we skip it, which keeps
+		// it from overflowing at compile time.
+
+		exponent >>= 1;
+
+		if (exponent != 0)
+		{
+			base *= base;
+		}
+	}
+
+	return result;
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns a number raised to an integer power, by repeated squaring.
+ * Integer powers wrap around on overflow, like unsigned arithmetic does.
+ * A negative exponent returns `1 / ipow(base, -exponent)`, which truncates
+ * to 0 for integer bases other than 1 and -1.
+ *
+ * Unlike `pow()`, this needs no logarithm and never calls into JS, and it
+ * can be evaluated at compile time.
+ *
+ * - Time complexity: O(log n), where n is the magnitude of the exponent.
+ * - Space complexity: O(1).
+ * - Error: exact for integers. Floating point results round at each of
+ *   the at most 2 log2(n) multiplications, so they can be off by a few
+ *   ULPs for large exponents.
+ */
+template <typename T, typename E>
+constexpr inline T
+ipow(T base, E exponent)
+{
+	static_assert(is_integer<T>() || is_float<T>(),
+		"Type is not an integer or floating point type.");
+	static_assert(is_integer<E>(), "Exponent is not an integer type.");
+
+	// The magnitude of the exponent is taken in unsigned arithmetic, so
+	// the most negative exponent does not overflow.
+
+	bool negative = false;
+	u64 magnitude = (u64) exponent;
+
+	if constexpr (is_signed_integer<E>())
+	{
+		negative = exponent < 0;
+		magnitude = negative ? 0 - magnitude : magnitude;
+	}
+
+	T result = 0;
+
+	if constexpr (is_float<T>())
+	{
+		result = detail::ipow_impl(base, magnitude);
+	}
+	else if constexpr (sizeof(T) == 8)
+	{
+		result = (T) detail::ipow_impl((u64) base, magnitude);
+	}
+	else
+	{
+		result = (T) detail::ipow_impl((u32) base, magnitude);
+	}
+
+	return negative ? (T) 1 / result : result;
+}
+
 /**
  * Returns the square root of a number.
  */
@@ -500,38 +609,93 @@ sqrt(f64 n)
 
 	if (__builtin_is_constant_evaluated())
 	{
-		// We use Newton's method to find the square root.
-		// Newton's method is an iterative method to find the root of a
-		// given function. The formula for Newton's method is:
-		// x_{n+1} = x_n - f(x_n) / f'(x_n)
-		//
-		// Since x = √n, which can be rewritten to x^2 - n = 0,
-		// we can find the square root of n by finding the root of
-		// the equation x^2 - n = 0. Note that the derivative of this
-		// equation is 2x, which we will need in the formula for
-		// Newton's method.
+		if (is_nan(n) || n == 0 || n == Infinity64)
+		{
+			return n;
+		}
+
+		if (n < 0)
+		{
+			return NaN64;
+		}
+
+		// We compute the square root digit by digit, on the integer
+		// mantissa, so the result is rounded exactly like the f64.sqrt
+		// instruction rounds it. Tables generated at compile time then
+		// hold the same values as tables computed at run time.
 		//
-		// We will start with an initial guess of x = n / 2.
+		// First we write n as m * 2^e, where m is an integer in
+		// [2^52, 2^54) and e is even. Subnormal numbers are normalised.
+
+		u64 bits = detail::interpret_float_as_int(n);
+		u64 m = bits & 0xFFFFFFFFFFFFF;
+		i32 e = bits >> 52;
+
+		if (e == 0)
+		{
+			e = 1;
+		}
+		else
+		{
+			m |= 1ULL << 52;
+		}
 
-		f64 x = n / 2;
-		f64 delta = 1;
+		e -= 1075;
 
-		// Now we will do a couple of iterations.
-		// Note that we take f(x) = x^2 - n, and f'(x) = 2x.
-		// We will stop when the difference between the current guess
-		// and the previous guess is less than the smallest number
-		// that can be represented by an f64.
+		while (m < 1ULL << 52)
+		{
+			m <<= 1;
+			e--;
+		}
 
-		while (abs(delta) > Epsilon64)
+		if (e & 1)
 		{
-			f64 x_old = x;
-			x = x - (x * x - n) / (2 * x);
-			delta = x_old - x;
+			m <<= 1;
+			e--;
 		}
 
-		// The value of x will be the square root of n.
+		// The square root of m * 2^52 is in [2^52, 2^53), so it has the
+		// 53 bits of an f64 mantissa. Each step brings down the next
+		// two bits of m * 2^52 and finds the next bit of its root q.
+		// The remainder r = m * 2^52 - q^2 stays below 2q + 1.
 
-		return x;
+		u64 q = 0;
+		u64 r = 0;
+
+		for (i32 i = 52; i >= 0; i--)
+		{
+			u64 pair = 2 * i >= 52 ? (m >> (2 * i - 52)) & 3 : 0;
+			r = r << 2 | pair;
+
+			u64 trial = q << 2 | 1;
+			q <<= 1;
+
+			if (r >= trial)
+			{
+				r -= trial;
+				q |= 1;
+			}
+		}
+
+		// The root is above q + 1/2 exactly when r > q, since
+		// (q + 1/2)^2 = q^2 + q + 1/4. It is never exactly halfway.
+
+		i32 exponent = (e - 52) / 2;
+
+		if (r > q)
+		{
+			q++;
+		}
+
+		if (q == 1ULL << 53)
+		{
+			q >>= 1;
+			exponent++;
+		}
+
+		u64 biased_exponent = exponent + 1075;
+		return detail::interpret_int_as_float(
+			(i64) (biased_exponent << 52 | (q & 0xFFFFFFFFFFFFF)));
 	}
 
 	// If we are not interpreting this function at compile time,
@@ -556,522 +720,3815 @@ sqrt(f32 n)
 	return __builtin_sqrtf(n);
 }
 
+namespace detail
+{
+// The number of Newton steps of the fast tier of `rcp()` and `rsqrt()`.
+// The initial estimates are within 5% of the result, and every step
+// squares their relative error, to below 1e-5 after two steps.
+constexpr const usize RECIPROCAL_STEPS = 2;
+
 /**
- * Returns the natural logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns an approximation of 1 / x for a normal number x whose reciprocal
+ * is a normal number too, with `RECIPROCAL_STEPS` Newton steps.
  */
-IMPORT("ln")
-f64
-ln(f64 value);
+constexpr f64
+rcp_newton(f64 x)
+{
+	// Subtracting the bits of x from a constant negates its exponent and
+	// approximates the reciprocal of its mantissa. Each Newton step
+	// y += y * (1 - x * y) squares the relative error of y.
+
+	f64 y = interpret_int_as_float(
+		0x7FDE623822FC16E6 - interpret_float_as_int(x));
+
+	for (usize i = 0; i < RECIPROCAL_STEPS; i++)
+	{
+		y = y + y * (1 - x * y);
+	}
+
+	return y;
+}
 
 /**
- * Returns the natural logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns an approximation of 1 / √x for a positive normal number x, with
+ * `RECIPROCAL_STEPS` Newton steps.
  */
-inline f32
-ln(f32 value)
+constexpr f64
+rsqrt_newton(f64 x)
 {
-	return ln((f64) value);
+	// Halving the bits of x halves its exponent, which the constant then
+	// negates. Each Newton step y += y * (1 - x * y^2) / 2 about squares
+	// the relative error of y.
+
+	f64 y = interpret_int_as_float(
+		0x5FE6EB50C7B537A9 - (interpret_float_as_int(x) >> 1));
+
+	for (usize i = 0; i < RECIPROCAL_STEPS; i++)
+	{
+		y = y + y * (0.5 - 0.5 * (x * y) * y);
+	}
+
+	return y;
 }
+}; // namespace slaw::detail
 
 /**
- * Returns the natural logarithm of [ a floating point number plus one ]
- * (ln(1 + value)).
- * TODO: Make constexpr.
+ * Returns the reciprocal of a number, 1 / x.
+ * The full tier divides. The fast tier replaces the division with two
+ * Newton steps from a bit-level estimate, which take less than half the
+ * time of an f64 division.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 0.5 ULP. Fast tier: 7e-6 relative, for normal numbers whose
+ *   reciprocals are normal numbers too.
  */
-IMPORT("ln1p")
-f64
-ln1p(f64 value);
+template <Precision P = Precision::Full>
+constexpr f64
+rcp(f64 value)
+{
+	if constexpr (P == Precision::Fast)
+	{
+		return detail::rcp_newton(value);
+	}
+
+	return 1 / value;
+}
 
 /**
- * Returns the natural logarithm of [ a floating point number plus one ].
- * (ln(1 + value)).
- * TODO: Make constexpr.
+ * Returns the reciprocal of a number, 1 / x.
+ * Both tiers divide, since an f32 division is faster than the Newton steps
+ * that would replace it.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 0.5 ULP.
  */
-inline f32
-ln1p(f32 value)
+template <Precision P = Precision::Full>
+constexpr f32
+rcp(f32 value)
 {
-	return ln1p((f64) value);
+	return 1 / value;
 }
 
 /**
- * Returns the base-2 logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns the reciprocal square root of a number, 1 / √x.
+ * The full tier takes a square root and divides. The fast tier replaces
+ * both with two Newton steps from a bit-level estimate, which take a fifth
+ * of the time.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 1.5 ULP. Fast tier: 5e-6 relative, for positive normal numbers.
  */
-IMPORT("log2")
-f64
-log2(f64 value);
+template <Precision P = Precision::Full>
+constexpr f64
+rsqrt(f64 value)
+{
+	if constexpr (P == Precision::Fast)
+	{
+		return detail::rsqrt_newton(value);
+	}
+
+	return 1 / sqrt(value);
+}
 
 /**
- * Returns the base-2 logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns the reciprocal square root of a number, 1 / √x.
+ * The full tier takes a square root and divides. The fast tier replaces
+ * both with two Newton steps from a bit-level estimate, computed in f64,
+ * which take a third of the time.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 1.5 ULP. Fast tier: 5e-6 relative, for positive normal numbers.
  */
-inline f32
-log2(f32 value)
+template <Precision P = Precision::Full>
+constexpr f32
+rsqrt(f32 value)
 {
-	return log2((f64) value);
+	if constexpr (P == Precision::Fast)
+	{
+		return (f32) detail::rsqrt_newton(value);
+	}
+
+	return 1 / sqrt(value);
 }
 
+// The transcendental functions below are computed in the module by default,
+// with the range reductions and polynomials of fdlibm, so calls to them can
+// be inlined and evaluated at compile time. Defining `JS_MATH` makes them
+// call the functions of JS `Math` instead, through the imports of slaw.js,
+// except when they are evaluated at compile time.
+
+#ifdef JS_MATH
+#define SLAW_JS_MATH(call) \
+	if (!__builtin_is_constant_evaluated()) \
+	{ \
+		return call; \
+	}
+#else
+#define SLAW_JS_MATH(call)
+#endif
+
+namespace detail
+{
+// The JS `Math` functions, used instead of the in-module implementations
+// when `JS_MATH` is defined.
+
+IMPORT("ln") f64 js_ln(f64 value);
+IMPORT("ln1p") f64 js_ln1p(f64 value);
+IMPORT("log2") f64 js_log2(f64 value);
+IMPORT("log10") f64 js_log10(f64 value);
+IMPORT("exp") f64 js_exp(f64 value);
+IMPORT("expm1") f64 js_expm1(f64 value);
+IMPORT("pow") f64 js_pow(f64 x, f64 y);
+IMPORT("cos") f64 js_cos(f64 value);
+IMPORT("sin") f64 js_sin(f64 value);
+IMPORT("tan") f64 js_tan(f64 value);
+IMPORT("acos") f64 js_acos(f64 value);
+IMPORT("asin") f64 js_asin(f64 value);
+IMPORT("atan") f64 js_atan(f64 value);
+IMPORT("atan2") f64 js_atan2(f64 y, f64 x);
+IMPORT("cosh") f64 js_cosh(f64 value);
+IMPORT("sinh") f64 js_sinh(f64 value);
+IMPORT("tanh") f64 js_tanh(f64 value);
+IMPORT("acosh") f64 js_acosh(f64 value);
+IMPORT("asinh") f64 js_asinh(f64 value);
+IMPORT("atanh") f64 js_atanh(f64 value);
+IMPORT("cbrt") f64 js_cbrt(f64 value);
+IMPORT("hypot") f64 js_hypot(f64 x, f64 y);
+
 /**
- * Returns the base-10 logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns the upper 32 bits of a 64-bit floating point number: its sign,
+ * its exponent and the top 20 bits of its mantissa.
  */
-IMPORT("log10")
-f64
-log10(f64 value);
+constexpr u32
+high_word(f64 value)
+{
+	return (u64) interpret_float_as_int(value) >> 32;
+}
 
 /**
- * Returns the base-10 logarithm of a floating point number.
- * TODO: Make constexpr.
+ * Returns the lower 32 bits of the mantissa of a 64-bit floating point
+ * number.
  */
-inline f32
-log10(f32 value)
+constexpr u32
+low_word(f64 value)
 {
-	return log10((f64) value);
+	return (u32) interpret_float_as_int(value);
 }
 
 /**
- * Returns the base-2 logarithm of an integer,
- * rounded down to the nearest integer.
- * Zero and negative inputs evaluate to -1.
+ * Returns the 64-bit floating point number with the given upper and lower
+ * 32 bits.
  */
-template <typename T>
-constexpr inline T
-log2i(T value)
+constexpr f64
+from_words(u32 high, u32 low)
 {
-	if constexpr (is_signed_integer<T>())
-	{
-		// If the type is signed and the value is smaller than 1,
-		// the logarithm does not exist, and we return -1 to indicate
-		// that.
-
-		if (value <= 0)
-		{
-			return -1;
-		}
-	}
-
-	// Count the number of leading zeroes.
-	// This is the floored logarithm of the number.
-
-	return (sizeof(T) * 8 - 1) - clz(value);
+	return interpret_int_as_float((i64) ((u64) high << 32 | low));
 }
 
 /**
- * Returns the base-10 logarithm of an integer,
- * rounded down to the nearest integer.
- * Zero and negative inputs evaluate to -1.
+ * Returns `x * 2^n`, rounded once, also when the result is subnormal.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-template <typename T>
-constexpr inline T
-log10i(T value)
+constexpr f64
+scale_by_power_of_two(f64 x, i32 n)
 {
-	if constexpr (is_signed_integer<T>())
+	// 2^n itself may not be representable, so large scales are applied in
+	// steps. The steps towards subnormal numbers stop 53 bits early, so
+	// only the last multiplication rounds.
+
+	for (i32 i = 0; i < 2 && n > 1023; i++)
 	{
-		// If the type is signed and the value is smaller than 1,
-		// the logarithm does not exist, and we return -1 to indicate
-		// that.
+		x *= 0x1p1023;
+		n -= 1023;
+	}
 
-		if (value <= 0)
-		{
-			return -1;
-		}
+	for (i32 i = 0; i < 2 && n < -1022; i++)
+	{
+		x *= 0x1p-969;
+		n += 969;
 	}
 
-	T result = 0;
+	n = min(max(n, -1022), 1023);
+	return x * interpret_int_as_float((i64) (n + 1023) << 52);
+}
 
-	// Check in what range the number falls into, using binary search.
+/**
+ * Handles the inputs of logarithms that are not positive finite numbers.
+ * Returns true and stores the logarithm in `result` for them.
+ */
+constexpr bool
+log_special_case(f64 x, f64 &result)
+{
+	u64 bits = interpret_float_as_int(x);
 
-	if constexpr (sizeof(T) >= 8)
+	if (is_nan(x) || bits == 0x7FF0000000000000)
 	{
-		if (value >= 10000000000000000UL)
-		{
-			result += 16;
-			value /= 10000000000000000UL;
-		}
+		result = x;
+		return true;
 	}
 
-	if constexpr (sizeof(T) >= 4)
+	if (bits << 1 == 0)
 	{
-		if (value >= 100000000UL)
-		{
-			result += 8;
-			value /= 100000000UL;
-		}
+		result = -Infinity64;
+		return true;
 	}
 
-	if constexpr (sizeof(T) >= 2)
+	if (bits >> 63)
 	{
-		if (value >= 10000UL)
-		{
-			result += 4;
-			value /= 10000UL;
-		}
+		result = NaN64;
+		return true;
 	}
 
-	if (value >= 100UL)
-	{
-		result += 2;
-		value /= 100UL;
-	}
+	return false;
+}
 
-	if (value >= 10UL)
+/**
+ * Splits a positive, finite number into `2^k * (1 + f)`, where `1 + f` is
+ * in [√2/2, √2), and returns f.
+ */
+constexpr f64
+split_log_argument(f64 x, i32 &k)
+{
+	u32 high = high_word(x);
+	k = 0;
+
+	// Subnormal numbers are normalised first.
+
+	if (high < 0x00100000)
 	{
-		result += 1;
-		value /= 10UL;
+		k -= 54;
+		x *= 0x1p54;
+		high = high_word(x);
 	}
 
-	return result;
+	high += 0x3FF00000 - 0x3FE6A09E;
+	k += (i32) (high >> 20) - 0x3FF;
+	high = (high & 0x000FFFFF) + 0x3FE6A09E;
+
+	return from_words(high, low_word(x)) - 1;
 }
 
 /**
- * Returns the cosine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns the part of `ln(1 + f)` that is smaller than `f - f^2/2`, for
+ * `1 + f` in [√2/2, √2]. `half_square` must be `f^2/2`.
+ *
+ * With s = f / (2 + f), ln(1 + f) = 2s + 2s^3/3 + 2s^5/5 + ..., which is
+ * approximated by `2s + s * R(s^2)`, with a minimax polynomial R.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("cos")
-f64
-cos(f64 value);
+constexpr f64
+log_tail(f64 f, f64 half_square)
+{
+	constexpr f64 lg1 = 6.666666666666735130e-01;
+	constexpr f64 lg2 = 3.999999999940941908e-01;
+	constexpr f64 lg3 = 2.857142874366239149e-01;
+	constexpr f64 lg4 = 2.222219843214978396e-01;
+	constexpr f64 lg5 = 1.818357216161805012e-01;
+	constexpr f64 lg6 = 1.531383769920937332e-01;
+	constexpr f64 lg7 = 1.479819860511658591e-01;
+
+	f64 s = f / (2 + f);
+	f64 z = s * s;
+	f64 w = z * z;
+	f64 even = w * (lg2 + w * (lg4 + w * lg6));
+	f64 odd = z * (lg1 + w * (lg3 + w * (lg5 + w * lg7)));
+
+	return s * (half_square + odd + even);
+}
 
 /**
- * Returns the cosine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ * Splits a positive, finite number into `2^k * (1 + f)` like
+ * `split_log_argument()`, and returns ln(1 + f) to about 2^-36, which is
+ * enough for f32 results.
+ *
+ * This uses the shorter polynomial of the f32 fdlibm `logf()`, evaluated in
+ * f64, which costs the same as f32 arithmetic in WASM.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-cos(f32 value)
+constexpr f64
+log_single(f64 x, i32 &k)
 {
-	return cos((f64) value);
+	constexpr f64 lg1 = 6.66666626930236816406e-01;
+	constexpr f64 lg2 = 4.00009721517562866211e-01;
+	constexpr f64 lg3 = 2.84987866878509521484e-01;
+	constexpr f64 lg4 = 2.42790788412094116211e-01;
+
+	f64 f = split_log_argument(x, k);
+	f64 s = f / (2 + f);
+	f64 z = s * s;
+	f64 w = z * z;
+	f64 half_square = 0.5 * f * f;
+	f64 r = z * (lg1 + w * lg3) + w * (lg2 + w * lg4);
+
+	return f - (half_square - s * (half_square + r));
 }
 
 /**
- * Returns the sine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns the natural logarithm of a positive, finite number, accurate
+ * enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("sin")
-f64
-sin(f64 value);
+constexpr f64
+ln_single(f64 x)
+{
+	constexpr f64 ln2 = 6.93147180559945286227e-01;
+
+	i32 k = 0;
+	f64 y = log_single(x, k);
+	return k * ln2 + y;
+}
 
 /**
- * Returns the sine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns `ln(1 + x)`, for x > -1, accurate enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-sin(f32 value)
+constexpr f64
+ln1p_single(f64 x)
 {
-	return sin((f64) value);
+	// The rounding error of u = 1 + x is added back as
+	// ln(1 + x) - ln(u) ≈ (x - (u - 1)) / u.
+
+	f64 u = 1 + x;
+	return ln_single(u) + (x - (u - 1)) / u;
 }
+}; // namespace slaw::detail
 
 /**
- * Returns the tangent of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
- */
-IMPORT("tan")
-f64
-tan(f64 value);
+ * Returns the natural logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+ln(f64 value)
+{
+	SLAW_JS_MATH(detail::js_ln(value));
+
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return result;
+	}
+
+	// ln(x) = k * ln(2) + ln(1 + f), where the terms are added from the
+	// smallest to the largest.
+
+	i32 k = 0;
+	f64 f = detail::split_log_argument(value, k);
+	f64 half_square = 0.5 * f * f;
+	f64 dk = k;
+
+	return detail::log_tail(f, half_square) + dk * ln2_lo - half_square
+		+ f + dk * ln2_hi;
+}
+
+/**
+ * Returns the natural logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+ln(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_ln(value));
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return (f32) result;
+	}
+
+	return (f32) detail::ln_single(value);
+}
+
+/**
+ * Returns the natural logarithm of [ a floating point number plus one ]
+ * (ln(1 + value)).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+ln1p(f64 value)
+{
+	SLAW_JS_MATH(detail::js_ln1p(value));
+
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+
+	u32 high = detail::high_word(value);
+	i32 k = 1;
+	f64 f = 0;
+	f64 correction = 0;
+
+	if (high < 0x3FDA827A || high >> 31)
+	{
+		// 1 + x < √2.
+
+		if (high >= 0xBFF00000)
+		{
+			// x <= -1, or NaN.
+
+			return is_nan(value) ? value
+				: value == -1 ? -Infinity64 : NaN64;
+		}
+
+		if ((high & 0x7FFFFFFF) < 0x3CA00000)
+		{
+			// |x| < 2^-53.
+
+			return value;
+		}
+
+		if (high <= 0xBFD2BEC4)
+		{
+			// √2/2 <= 1 + x, so x is used as f directly.
+
+			k = 0;
+			f = value;
+		}
+	}
+	else if (high >= 0x7FF00000)
+	{
+		return value;
+	}
+
+	if (k != 0)
+	{
+		// 1 + x is split like in `ln()`, and the rounding error of
+		// 1 + x is added back as ln(1 + x) - ln(u) ≈ c / u.
+
+		f64 u = 1 + value;
+		u32 high_u = detail::high_word(u) + 0x3FF00000 - 0x3FE6A09E;
+		k = (i32) (high_u >> 20) - 0x3FF;
+
+		if (k < 54)
+		{
+			correction = k >= 2 ? 1 - (u - value) : value - (u - 1);
+			correction /= u;
+		}
+
+		high_u = (high_u & 0x000FFFFF) + 0x3FE6A09E;
+		f = detail::from_words(high_u, detail::low_word(u)) - 1;
+	}
+
+	f64 half_square = 0.5 * f * f;
+	f64 dk = k;
+
+	return detail::log_tail(f, half_square) + (dk * ln2_lo + correction)
+		- half_square + f + dk * ln2_hi;
+}
+
+/**
+ * Returns the natural logarithm of [ a floating point number plus one ].
+ * (ln(1 + value)).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+ln1p(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_ln1p(value));
+
+	if (is_nan(value) || value <= -1)
+	{
+		return is_nan(value) ? value
+			: value == -1 ? -Infinity32 : NaN32;
+	}
+
+	if (value == Infinity32 || abs(value) < 0x1p-25f)
+	{
+		return value;
+	}
+
+	return (f32) detail::ln1p_single(value);
+}
+
+/**
+ * Returns the base-2 logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+log2(f64 value)
+{
+	SLAW_JS_MATH(detail::js_log2(value));
+
+	constexpr f64 inv_ln2_hi = 1.44269504072144627571e+00;
+	constexpr f64 inv_ln2_lo = 1.67517131648865118353e-10;
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return result;
+	}
+
+	i32 k = 0;
+	f64 f = detail::split_log_argument(value, k);
+	f64 half_square = 0.5 * f * f;
+
+	// ln(1 + f) is computed as hi + lo, where hi has only 21 bits, so
+	// that hi * inv_ln2_hi is exact.
+
+	f64 hi = detail::from_words(detail::high_word(f - half_square), 0);
+	f64 lo = f - hi - half_square + detail::log_tail(f, half_square);
+
+	f64 value_hi = hi * inv_ln2_hi;
+	f64 value_lo = (lo + hi) * inv_ln2_lo + lo * inv_ln2_hi;
+
+	// k is added to the high part, and its rounding error to the low
+	// part.
+
+	f64 dk = k;
+	f64 sum = dk + value_hi;
+	value_lo += (dk - sum) + value_hi;
+
+	return value_lo + sum;
+}
+
+/**
+ * Returns the base-2 logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+log2(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_log2(value));
+
+	constexpr f64 inv_ln2 = 1.44269504088896338700e+00;
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return (f32) result;
+	}
+
+	// k is added last, so powers of two are exact.
+
+	i32 k = 0;
+	f64 y = detail::log_single(value, k);
+	return (f32) (k + y * inv_ln2);
+}
+
+/**
+ * Returns the base-10 logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+log10(f64 value)
+{
+	SLAW_JS_MATH(detail::js_log10(value));
+
+	constexpr f64 inv_ln10_hi = 4.34294481878168880939e-01;
+	constexpr f64 inv_ln10_lo = 2.50829467116452752298e-11;
+	constexpr f64 log10_2_hi = 3.01029995663611771306e-01;
+	constexpr f64 log10_2_lo = 3.69423907715893078616e-13;
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return result;
+	}
+
+	// This works like `log2()`.
+
+	i32 k = 0;
+	f64 f = detail::split_log_argument(value, k);
+	f64 half_square = 0.5 * f * f;
+
+	f64 hi = detail::from_words(detail::high_word(f - half_square), 0);
+	f64 lo = f - hi - half_square + detail::log_tail(f, half_square);
+
+	f64 dk = k;
+	f64 value_hi = hi * inv_ln10_hi;
+	f64 value_lo = dk * log10_2_lo + (lo + hi) * inv_ln10_lo
+		+ lo * inv_ln10_hi;
+
+	f64 y = dk * log10_2_hi;
+	f64 sum = y + value_hi;
+	value_lo += (y - sum) + value_hi;
+
+	return value_lo + sum;
+}
+
+/**
+ * Returns the base-10 logarithm of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+log10(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_log10(value));
+
+	constexpr f64 inv_ln10 = 4.34294481903251816668e-01;
+	constexpr f64 log10_2 = 3.01029995663981198017e-01;
+
+	f64 result = 0;
+
+	if (detail::log_special_case(value, result))
+	{
+		return (f32) result;
+	}
+
+	i32 k = 0;
+	f64 y = detail::log_single(value, k);
+	return (f32) (k * log10_2 + y * inv_ln10);
+}
+
+
+/**
+ * Returns the base-2 logarithm of an integer,
+ * rounded down to the nearest integer.
+ * Zero and negative inputs evaluate to -1.
+ */
+template <typename T>
+constexpr inline T
+log2i(T value)
+{
+	if constexpr (is_signed_integer<T>())
+	{
+		// If the type is signed and the value is smaller than 1,
+		// the logarithm does not exist, and we return -1 to indicate
+		// that.
+
+		if (value <= 0)
+		{
+			return -1;
+		}
+	}
+
+	// Count the number of leading zeroes.
+	// This is the floored logarithm of the number.
+
+	return (sizeof(T) * 8 - 1) - clz(value);
+}
+
+/**
+ * Returns the base-10 logarithm of an integer,
+ * rounded down to the nearest integer.
+ * Zero and negative inputs evaluate to -1.
+ */
+template <typename T>
+constexpr inline T
+log10i(T value)
+{
+	if constexpr (is_signed_integer<T>())
+	{
+		// If the type is signed and the value is smaller than 1,
+		// the logarithm does not exist, and we return -1 to indicate
+		// that.
+
+		if (value <= 0)
+		{
+			return -1;
+		}
+	}
+
+	T result = 0;
+
+	// Check in what range the number falls into, using binary search.
+
+	if constexpr (sizeof(T) >= 8)
+	{
+		if (value >= 10000000000000000UL)
+		{
+			result += 16;
+			value /= 10000000000000000UL;
+		}
+	}
+
+	if constexpr (sizeof(T) >= 4)
+	{
+		if (value >= 100000000UL)
+		{
+			result += 8;
+			value /= 100000000UL;
+		}
+	}
+
+	if constexpr (sizeof(T) >= 2)
+	{
+		if (value >= 10000UL)
+		{
+			result += 4;
+			value /= 10000UL;
+		}
+	}
+
+	if (value >= 100UL)
+	{
+		result += 2;
+		value /= 100UL;
+	}
+
+	if (value >= 10UL)
+	{
+		result += 1;
+		value /= 10UL;
+	}
+
+	return result;
+}
+
+
+namespace detail
+{
+/**
+ * Returns `e^x * 2^scale`, for a finite x whose result is not too far out
+ * of the range of an f64.
+ *
+ * x is reduced to `k * ln(2) + r`, with |r| <= ln(2)/2, and e^r is
+ * approximated by `1 + r + r * c / (2 - c)`, where c = r - r^2 * P(r^2)
+ * for a minimax polynomial P.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+exp_scaled(f64 x, i32 scale)
+{
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+	constexpr f64 inv_ln2 = 1.44269504088896338700e+00;
+	constexpr f64 p1 = 1.66666666666666019037e-01;
+	constexpr f64 p2 = -2.77777777770155933842e-03;
+	constexpr f64 p3 = 6.61375632143793436117e-05;
+	constexpr f64 p4 = -1.65339022054652515390e-06;
+	constexpr f64 p5 = 4.13813679705723846039e-08;
+
+	u32 high = high_word(x) & 0x7FFFFFFF;
+
+	if (high < 0x3E300000)
+	{
+		// |x| < 2^-28.
+
+		return scale_by_power_of_two(1 + x, scale);
+	}
+
+	i32 k = 0;
+	f64 hi = x;
+	f64 lo = 0;
+
+	if (high > 0x3FD62E42)
+	{
+		// |x| > ln(2)/2. k * ln2_hi is exact, because ln2_hi ends in
+		// 32 zero bits.
+
+		k = (i32) (inv_ln2 * x + (x < 0 ? -0.5 : 0.5));
+		hi = x - k * ln2_hi;
+		lo = k * ln2_lo;
+	}
+
+	f64 r = hi - lo;
+	f64 z = r * r;
+	f64 c = r - z * (p1 + z * (p2 + z * (p3 + z * (p4 + z * p5))));
+	f64 y = 1 + (r * c / (2 - c) - lo + hi);
+
+	return scale_by_power_of_two(y, k + scale);
+}
+
+/**
+ * Returns `e^r - 1`, for |r| <= ln(2)/2, to about 2^-30 relative, which is
+ * enough for f32 results.
+ *
+ * This is the approximation of `exp_scaled()`, with the shorter polynomial
+ * of the f32 fdlibm `expf()`, evaluated in f64.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+expm1_reduced_single(f64 r)
+{
+	constexpr f64 p1 = 1.66666254401206970215e-01;
+	constexpr f64 p2 = -2.76673329062759876251e-03;
+
+	f64 z = r * r;
+	f64 c = r - z * (p1 + z * p2);
+	return r + r * c / (2 - c);
+}
+
+/**
+ * Returns `e^x`, for |x| < 700, accurate enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+exp_single(f64 x)
+{
+	constexpr f64 ln2 = 6.93147180559945286227e-01;
+	constexpr f64 inv_ln2 = 1.44269504088896338700e+00;
+
+	i32 k = (i32) (inv_ln2 * x + (x < 0 ? -0.5 : 0.5));
+	f64 scale = interpret_int_as_float((i64) (k + 1023) << 52);
+
+	return (1 + expm1_reduced_single(x - k * ln2)) * scale;
+}
+
+/**
+ * Returns `e^x - 1`, for |x| < 700, accurate enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+expm1_single(f64 x)
+{
+	constexpr f64 half_ln2 = 3.46573590279972643113e-01;
+
+	// Beyond ln(2)/2, e^x - 1 loses at most 2 bits to cancellation.
+
+	return abs(x) <= half_ln2 ? expm1_reduced_single(x)
+		: exp_single(x) - 1;
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns the exponential of a floating point number (e^x).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+exp(f64 value)
+{
+	SLAW_JS_MATH(detail::js_exp(value));
+
+	if (is_nan(value))
+	{
+		return value;
+	}
+
+	if (value > 709.782712893383973096)
+	{
+		return Infinity64;
+	}
+
+	if (value < -745.13321910194110842)
+	{
+		return 0;
+	}
+
+	return detail::exp_scaled(value, 0);
+}
+
+/**
+ * Returns the exponential of a floating point number (e^x).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+exp(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_exp(value));
+
+	if (is_nan(value) || value > 89)
+	{
+		return is_nan(value) ? value : Infinity32;
+	}
+
+	if (value < -104)
+	{
+		return 0;
+	}
+
+	return (f32) detail::exp_single(value);
+}
+
+/**
+ * Returns the exponential of a floating point number, minus one (e^x - 1).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+expm1(f64 value)
+{
+	SLAW_JS_MATH(detail::js_expm1(value));
+
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+	constexpr f64 inv_ln2 = 1.44269504088896338700e+00;
+	constexpr f64 q1 = -3.33333333333331316428e-02;
+	constexpr f64 q2 = 1.58730158725481460165e-03;
+	constexpr f64 q3 = -7.93650757867487942473e-05;
+	constexpr f64 q4 = 4.00821782732936239552e-06;
+	constexpr f64 q5 = -2.01099218183624371326e-07;
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+	bool negative = detail::high_word(x) >> 31;
+
+	if (high >= 0x4043687A)
+	{
+		// |x| >= 56 * ln(2), so e^x is either huge or below the
+		// rounding error of 1.
+
+		if (is_nan(x))
+		{
+			return x;
+		}
+
+		if (negative)
+		{
+			return -1;
+		}
+
+		if (x > 7.09782712893383973096e+02)
+		{
+			return Infinity64;
+		}
+	}
+
+	// x = k * ln(2) + r, where r = hi - lo, rounded, and c is the rounding
+	// error of r.
+
+	i32 k = 0;
+	f64 c = 0;
+
+	if (high > 0x3FD62E42)
+	{
+		f64 hi = 0;
+		f64 lo = 0;
+
+		if (high < 0x3FF0A2B2)
+		{
+			k = negative ? -1 : 1;
+			hi = negative ? x + ln2_hi : x - ln2_hi;
+			lo = negative ? -ln2_lo : ln2_lo;
+		}
+		else
+		{
+			k = (i32) (inv_ln2 * x + (negative ? -0.5 : 0.5));
+			hi = x - k * ln2_hi;
+			lo = k * ln2_lo;
+		}
+
+		x = hi - lo;
+		c = (hi - x) - lo;
+	}
+	else if (high < 0x3C900000)
+	{
+		// |x| < 2^-54.
+
+		return x;
+	}
+
+	// e^r - 1 = r + r^2/2 + r^3 * R(r), with a rational R that is
+	// accurate to the last bits when r^2/2 is added last.
+
+	f64 half_x = 0.5 * x;
+	f64 half_square = x * half_x;
+	f64 r1 = 1 + half_square * (q1 + half_square * (q2 + half_square
+		* (q3 + half_square * (q4 + half_square * q5))));
+	f64 t = 3 - r1 * half_x;
+	f64 e = half_square * ((r1 - t) / (6 - x * t));
+
+	if (k == 0)
+	{
+		return x - (x * e - half_square);
+	}
+
+	// e^x - 1 = 2^k * (r - e + 1) - 1, where the last subtraction is done
+	// in the order that loses the fewest bits.
+
+	e = x * (e - c) - c;
+	e -= half_square;
+
+	if (k == -1)
+	{
+		return 0.5 * (x - e) - 0.5;
+	}
+
+	if (k == 1)
+	{
+		return x < -0.25 ? -2 * (e - (x + 0.5)) : 1 + 2 * (x - e);
+	}
+
+	if (k < 0 || k > 56)
+	{
+		return detail::scale_by_power_of_two(x - e + 1, k) - 1;
+	}
+
+	f64 two_to_minus_k = detail::interpret_int_as_float(
+		(i64) (0x3FF - k) << 52);
+	f64 y = k < 20 ? x - e + (1 - two_to_minus_k)
+		: x - (e + two_to_minus_k) + 1;
+
+	return detail::scale_by_power_of_two(y, k);
+}
+
+/**
+ * Returns the exponential of a floating point number, minus one (e^x - 1).
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+expm1(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_expm1(value));
+
+	if (is_nan(value) || value > 89)
+	{
+		return is_nan(value) ? value : Infinity32;
+	}
+
+	if (value < -20)
+	{
+		return -1;
+	}
+
+	if (abs(value) < 0x1p-25f)
+	{
+		return value;
+	}
+
+	return (f32) detail::expm1_single(value);
+}
+
+namespace detail
+{
+/**
+ * Returns whether an f64 is an integer: 0 if it is not, 1 if it is odd and
+ * 2 if it is even. Infinities are even.
+ */
+constexpr i32
+integer_parity(f64 y)
+{
+	u64 bits = interpret_float_as_int(y);
+	i32 exponent = (i32) (bits >> 52 & 0x7FF) - 0x3FF;
+
+	if (exponent >= 53)
+	{
+		return 2;
+	}
+
+	if (exponent < 0)
+	{
+		return 0;
+	}
+
+	u64 fraction_mask = 0xFFFFFFFFFFFFF >> exponent;
+
+	if (bits & fraction_mask)
+	{
+		return 0;
+	}
+
+	// The lowest integer bit is the implicit leading bit when the
+	// exponent is 0.
+
+	return exponent == 0 || (bits >> (52 - exponent) & 1) ? 1 : 2;
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns x raised to the power y.
+ *
+ * log2(x) is computed to about 70 bits as t1 + t2, multiplied by y in two
+ * parts, and 2 is raised to the product, like in fdlibm.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+pow(f64 x, f64 y)
+{
+	SLAW_JS_MATH(detail::js_pow(x, y));
+
+	constexpr f64 dp_h[] = { 0.0, 5.84962487220764160156e-01 };
+	constexpr f64 dp_l[] = { 0.0, 1.35003920212974897128e-08 };
+	constexpr f64 bp[] = { 1.0, 1.5 };
+	constexpr f64 l1 = 5.99999999999994648725e-01;
+	constexpr f64 l2 = 4.28571428578550184252e-01;
+	constexpr f64 l3 = 3.33333329818377432918e-01;
+	constexpr f64 l4 = 2.72728123808534006489e-01;
+	constexpr f64 l5 = 2.30660745775561754067e-01;
+	constexpr f64 l6 = 2.06975017800338417784e-01;
+	constexpr f64 p1 = 1.66666666666666019037e-01;
+	constexpr f64 p2 = -2.77777777770155933842e-03;
+	constexpr f64 p3 = 6.61375632143793436117e-05;
+	constexpr f64 p4 = -1.65339022054652515390e-06;
+	constexpr f64 p5 = 4.13813679705723846039e-08;
+	constexpr f64 lg2 = 6.93147180559945286227e-01;
+	constexpr f64 lg2_h = 6.93147182464599609375e-01;
+	constexpr f64 lg2_l = -1.90465429995776804525e-09;
+	constexpr f64 ovt = 8.0085662595372944372e-17;
+	constexpr f64 cp = 9.61796693925975554329e-01;
+	constexpr f64 cp_h = 9.61796700954437255859e-01;
+	constexpr f64 cp_l = -7.02846165095275826516e-09;
+	constexpr f64 ivln2 = 1.44269504088896338700e+00;
+	constexpr f64 ivln2_h = 1.44269502162933349609e+00;
+	constexpr f64 ivln2_l = 1.92596299112661746887e-08;
+
+	u32 hx = detail::high_word(x);
+	u32 hy = detail::high_word(y);
+	u32 lx = detail::low_word(x);
+	u32 ly = detail::low_word(y);
+	u32 ix = hx & 0x7FFFFFFF;
+	u32 iy = hy & 0x7FFFFFFF;
+	bool x_negative = hx >> 31;
+	bool y_negative = hy >> 31;
+
+	// x^0 = 1 and 1^y = 1, even for NaNs. Otherwise NaNs propagate.
+
+	if ((iy | ly) == 0 || x == 1)
+	{
+		return 1;
+	}
+
+	if (is_nan(x) || is_nan(y))
+	{
+		return x + y;
+	}
+
+	// The parity of y matters for negative x.
+
+	i32 y_parity = x_negative ? detail::integer_parity(y) : 0;
+
+	if (ly == 0)
+	{
+		if (iy == 0x7FF00000)
+		{
+			// y = ±∞.
+
+			if (x == -1)
+			{
+				return 1;
+			}
+
+			if (ix >= 0x3FF00000)
+			{
+				return y_negative ? 0 : y;
+			}
+
+			return y_negative ? -y : 0;
+		}
+
+		if (iy == 0x3FF00000)
+		{
+			return y_negative ? 1 / x : x;
+		}
+
+		if (hy == 0x40000000)
+		{
+			return x * x;
+		}
+
+		if (hy == 0x3FE00000 && !x_negative)
+		{
+			return sqrt(x);
+		}
+	}
+
+	f64 ax = abs(x);
+
+	if (lx == 0 && (ix == 0x7FF00000 || ix == 0 || ix == 0x3FF00000))
+	{
+		// x = ±0, ±∞ or -1.
+
+		f64 z = y_negative ? (ax == 0 ? Infinity64 : 1 / ax) : ax;
+
+		if (x_negative)
+		{
+			if (ix == 0x3FF00000 && y_parity == 0)
+			{
+				return NaN64;
+			}
+
+			if (y_parity == 1)
+			{
+				z = -z;
+			}
+		}
+
+		return z;
+	}
+
+	// The sign of the result.
+
+	f64 s = 1;
+
+	if (x_negative)
+	{
+		if (y_parity == 0)
+		{
+			return NaN64;
+		}
+
+		if (y_parity == 1)
+		{
+			s = -1;
+		}
+	}
+
+	f64 t1 = 0;
+	f64 t2 = 0;
+
+	if (iy > 0x41E00000)
+	{
+		// |y| > 2^31. The result overflows or underflows, unless x is
+		// very close to 1.
+
+		bool grows = ix >= 0x3FF00000 ? !y_negative : y_negative;
+
+		if (iy > 0x43F00000 || ix < 0x3FEFFFFF || ix > 0x3FF00000)
+		{
+			return grows ? s * Infinity64 : s * 0.0;
+		}
+
+		// |1 - x| <= 2^-20, so log(x) is approximated by
+		// t - t^2/2 + t^3/3 - t^4/4.
+
+		f64 t = ax - 1;
+		f64 w = (t * t) * (0.5 - t * (0.3333333333333333333333 - t * 0.25));
+		f64 u = ivln2_h * t;
+		f64 v = t * ivln2_l - w * ivln2;
+
+		t1 = detail::from_words(detail::high_word(u + v), 0);
+		t2 = v - (t1 - u);
+	}
+	else
+	{
+		i32 n = 0;
+
+		// Subnormal numbers are normalised first.
+
+		if (ix < 0x00100000)
+		{
+			ax *= 0x1p53;
+			n -= 53;
+			ix = detail::high_word(ax);
+		}
+
+		// ax = 2^n * m, with m in [1, √3) split into the intervals
+		// [1, √1.5) around 1 and [√1.5, √3) around 1.5, so that
+		// log2(m) = dp[k] + log2(m / bp[k]).
+
+		n += (i32) (ix >> 20) - 0x3FF;
+		u32 j = ix & 0x000FFFFF;
+		i32 k = 0;
+		ix = j | 0x3FF00000;
+
+		if (j <= 0x3988E)
+		{
+			k = 0;
+		}
+		else if (j < 0xBB67A)
+		{
+			k = 1;
+		}
+		else
+		{
+			k = 0;
+			n += 1;
+			ix -= 0x00100000;
+		}
+
+		ax = detail::from_words(ix, detail::low_word(ax));
+
+		// ss = s_h + s_l = (m - bp[k]) / (m + bp[k]).
+
+		f64 u = ax - bp[k];
+		f64 v = 1 / (ax + bp[k]);
+		f64 ss = u * v;
+		f64 s_h = detail::from_words(detail::high_word(ss), 0);
+		f64 t_h = detail::from_words(((ix >> 1) | 0x20000000) + 0x00080000
+			+ ((u32) k << 18), 0);
+		f64 t_l = ax - (t_h - bp[k]);
+		f64 s_l = v * ((u - s_h * t_h) - s_h * t_l);
+
+		// log(m / bp[k]) = 2s + 2s^3/3 + s^5 * L(s^2).
+
+		f64 s2 = ss * ss;
+		f64 r = s2 * s2 * (l1 + s2 * (l2 + s2 * (l3 + s2 * (l4 + s2
+			* (l5 + s2 * l6)))));
+		r += s_l * (s_h + ss);
+		s2 = s_h * s_h;
+		t_h = detail::from_words(detail::high_word(3.0 + s2 + r), 0);
+		t_l = r - ((t_h - 3.0) - s2);
+
+		// u + v = ss * (1 + ...), and log2(ax) = n + dp[k] + z_h + z_l,
+		// with z = (u + v) * 2 / (3 * ln(2)).
+
+		u = s_h * t_h;
+		v = s_l * t_h + t_l * ss;
+		f64 p_h = detail::from_words(detail::high_word(u + v), 0);
+		f64 p_l = v - (p_h - u);
+		f64 z_h = cp_h * p_h;
+		f64 z_l = cp_l * p_h + p_l * cp + dp_l[k];
+		f64 t = n;
+
+		t1 = detail::from_words(detail::high_word(((z_h + z_l) + dp_h[k])
+			+ t), 0);
+		t2 = z_l - (((t1 - t) - dp_h[k]) - z_h);
+	}
+
+	// y * log2(x) = p_h + p_l, where y is split so that y1 * t1 is exact.
+
+	f64 y1 = detail::from_words(detail::high_word(y), 0);
+	f64 p_l = (y - y1) * t1 + y * t2;
+	f64 p_h = y1 * t1;
+	f64 z = p_l + p_h;
+	i32 j = (i32) detail::high_word(z);
+	u32 i = detail::low_word(z);
+
+	if (j >= 0x40900000)
+	{
+		// z >= 1024.
+
+		if (((u32) (j - 0x40900000) | i) != 0 || p_l + ovt > z - p_h)
+		{
+			return s * Infinity64;
+		}
+	}
+	else if ((j & 0x7FFFFFFF) >= 0x4090CC00)
+	{
+		// z <= -1075.
+
+		if ((((u32) j - 0xC090CC00) | i) != 0 || p_l <= z - p_h)
+		{
+			return s * 0.0;
+		}
+	}
+
+	// 2^z = 2^n * 2^(z - n), where n is z rounded to an integer, taken
+	// from the bits of z.
+
+	i32 abs_j = j & 0x7FFFFFFF;
+	i32 k = (abs_j >> 20) - 0x3FF;
+	i32 n = 0;
+
+	if (abs_j > 0x3FE00000)
+	{
+		n = j + (0x00100000 >> (k + 1));
+		k = ((n & 0x7FFFFFFF) >> 20) - 0x3FF;
+		f64 t = detail::from_words((u32) n & ~(0x000FFFFF >> k), 0);
+		n = ((n & 0x000FFFFF) | 0x00100000) >> (20 - k);
+
+		if (j < 0)
+		{
+			n = -n;
+		}
+
+		p_h -= t;
+	}
+
+	// 2^(z - n) = e^((z - n) * ln(2)), like in `exp()`.
+
+	f64 t = detail::from_words(detail::high_word(p_l + p_h), 0);
+	f64 u = t * lg2_h;
+	f64 v = (p_l - (t - p_h)) * lg2 + t * lg2_l;
+	z = u + v;
+	f64 w = v - (z - u);
+	t = z * z;
+	t1 = z - t * (p1 + t * (p2 + t * (p3 + t * (p4 + t * p5))));
+	f64 r = (z * t1) / (t1 - 2) - (w + z * w);
+	z = 1 - (r - z);
+
+	return s * detail::scale_by_power_of_two(z, n);
+}
+
+/**
+ * Returns x raised to the power y.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+pow(f32 x, f32 y)
+{
+	SLAW_JS_MATH((f32) detail::js_pow(x, y));
+
+	f32 ax = abs(x);
+
+	// Zeros, infinities, NaNs and |x| = 1 follow the rules of the f64
+	// version, which returns exact results for them.
+
+	if (y == 0 || ax == 0 || ax == 1 || ax == Infinity32
+		|| abs(y) == Infinity32 || is_nan(x) || is_nan(y))
+	{
+		return (f32) pow((f64) x, (f64) y);
+	}
+
+	f64 sign = 1;
+
+	if (x < 0)
+	{
+		i32 parity = detail::integer_parity(y);
+
+		if (parity == 0)
+		{
+			return NaN32;
+		}
+
+		sign = parity == 1 ? -1 : 1;
+	}
+
+	f64 exponent = y * detail::ln_single(ax);
+
+	if (exponent > 89)
+	{
+		return (f32) (sign * Infinity64);
+	}
+
+	if (exponent < -104)
+	{
+		return (f32) (sign * 0.0);
+	}
+
+	return (f32) (sign * detail::exp_single(exponent));
+}
+
+namespace detail
+{
+// The first 1280 bits of 2/π after the binary point, 64 at a time. They
+// cover the largest exponent of an f64, plus the bits needed to reduce it.
+constexpr const u64 TWO_OVER_PI_BITS[] = {
+	0xA2F9836E4E441529, 0xFC2757D1F534DDC0, 0xDB6295993C439041,
+	0xFE5163ABDEBBC561, 0xB7246E3A424DD2E0, 0x06492EEA09D1921C,
+	0xFE1DEB1CB129A73E, 0xE88235F52EBB4484, 0xE99C7026B45F7E41,
+	0x3991D639835339F4, 0x9C845F8BBDF9283B, 0x1FF897FFDE05980F,
+	0xEF2F118B5A0A6D1F, 0x6D367ECF27CB09B7, 0x4F463F669E5FEA2D,
+	0x7527BAC7EBE5F17B, 0x3D0739F78A5292EA, 0x6BFB5FB11F8D5D08,
+	0x56033046FC7B6BAB, 0xF0CFBC209AF4361D
+};
+
+/**
+ * Returns 64 bits of 2/π, starting at a given bit after the binary point.
+ * Bit 1 is the first bit after the binary point. Bits before it are zero.
+ */
+constexpr inline u64
+two_over_pi_bits(i32 start)
+{
+	if (start <= -63)
+	{
+		return 0;
+	}
+
+	if (start < 1)
+	{
+		return two_over_pi_bits(1) >> (1 - start);
+	}
+
+	u32 word = (u32) (start - 1) / 64;
+	u32 shift = (u32) (start - 1) % 64;
+
+	if (shift == 0)
+	{
+		return TWO_OVER_PI_BITS[word];
+	}
+
+	return TWO_OVER_PI_BITS[word] << shift
+		| TWO_OVER_PI_BITS[word + 1] >> (64 - shift);
+}
+
+/**
+ * Multiplies two 64-bit numbers into a 128-bit product. Works on 32-bit
+ * halves, so it does not need 128-bit integers from the target.
+ */
+constexpr inline void
+multiply_wide(u64 a, u64 b, u64 &high, u64 &low)
+{
+	u64 a_low = a & 0xFFFFFFFF;
+	u64 a_high = a >> 32;
+	u64 b_low = b & 0xFFFFFFFF;
+	u64 b_high = b >> 32;
+
+	u64 low_low = a_low * b_low;
+	u64 low_high = a_low * b_high;
+	u64 high_low = a_high * b_low;
+	u64 middle = (low_low >> 32) + (low_high & 0xFFFFFFFF)
+		+ (high_low & 0xFFFFFFFF);
+
+	low = middle << 32 | (low_low & 0xFFFFFFFF);
+	high = a_high * b_high + (low_high >> 32) + (high_low >> 32)
+		+ (middle >> 32);
+}
+
+/**
+ * Returns `a * b`, and stores its rounding error in `error`, exactly. The
+ * magnitude of the factors must be below 2^995.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr inline f64
+two_product(f64 a, f64 b, f64 &error)
+{
+	f64 product = a * b;
+
+#if defined(__FMA__)
+	// Compilers may contract the split below into fused multiply-adds,
+	// which makes it inexact, so the fused multiply-add is used directly.
+
+	if (!__builtin_is_constant_evaluated())
+	{
+		error = __builtin_fma(a, b, -product);
+		return product;
+	}
+#endif
+
+	// Each factor is split into two halves of 26 bits, whose products are
+	// exact.
+
+	constexpr f64 splitter = 134217729.0;
+
+	f64 a_scaled = a * splitter;
+	f64 a_high = a_scaled - (a_scaled - a);
+	f64 a_low = a - a_high;
+	f64 b_scaled = b * splitter;
+	f64 b_high = b_scaled - (b_scaled - b);
+	f64 b_low = b - b_high;
+
+	error = ((a_high * b_high - product) + a_high * b_low
+		+ a_low * b_high) + a_low * b_low;
+	return product;
+}
+
+/**
+ * Reduces an angle of any size to `r` in [-π/4, π/4], where
+ * `x = j * π/2 + r`, and returns j modulo 4. `r` is returned as a sum
+ * `r_hi + r_lo`, accurate to about 85 bits. Infinities and NaNs give NaN.
+ *
+ * This is the Payne-Hanek reduction: x is multiplied by just the bits of
+ * 2/π that affect the last two bits of the integer part of x * 2/π and its
+ * fraction, in integer arithmetic. Smaller angles are reduced faster by
+ * subtracting multiples of a split π/2.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr inline i32
+reduce_half_pi(f64 x, f64 &r_hi, f64 &r_lo)
+{
+	u64 bits = interpret_float_as_int(x);
+	i32 biased_exponent = (i32) (bits >> 52 & 0x7FF);
+
+	if (biased_exponent == 0x7FF)
+	{
+		r_hi = x - x;
+		r_lo = 0;
+		return 0;
+	}
+
+	// x = m * 2^e, for a whole m. The bits of 2/π from 2^-(e - 1) on
+	// contribute to x * 2/π modulo 4. Bits before it only add multiples
+	// of 4, and bits 192 places after it are too small to matter.
+
+	u64 m = bits & 0xFFFFFFFFFFFFF;
+	i32 e = biased_exponent - 1075;
+
+	if (biased_exponent == 0)
+	{
+		e = -1074;
+	}
+	else
+	{
+		m |= (u64) 1 << 52;
+	}
+
+	u64 high_2 = 0, low_2 = 0, high_1 = 0, low_1 = 0;
+	u64 low_0 = m * two_over_pi_bits(e - 1);
+	multiply_wide(m, two_over_pi_bits(e + 63), high_1, low_1);
+	multiply_wide(m, two_over_pi_bits(e + 127), high_2, low_2);
+
+	// The product has its binary point 190 bits from the end, so the top
+	// word holds the integer part in its two highest bits. Anything above
+	// it is a multiple of 4.
+
+	u64 word_0 = low_2;
+	u64 word_1 = high_2 + low_1;
+	u64 carry = word_1 < low_1;
+	u64 word_2 = high_1 + low_0 + carry;
+
+	i32 j = (i32) (word_2 >> 62);
+	u64 fraction_hi = word_2 << 2 | word_1 >> 62;
+	u64 fraction_lo = word_1 << 2 | word_0 >> 62;
+
+	// A fraction of one half or more rounds j up and becomes negative.
+
+	bool negative = fraction_hi >> 63;
+
+	if (negative)
+	{
+		j++;
+		fraction_hi = ~fraction_hi;
+		fraction_lo = ~fraction_lo + 1;
+		fraction_hi += fraction_lo == 0;
+	}
+
+	// The fraction is normalised, and its top 85 bits converted exactly.
+
+	i32 scale = 0;
+
+	if (fraction_hi == 0)
+	{
+		fraction_hi = fraction_lo;
+		fraction_lo = 0;
+		scale = 64;
+	}
+
+	if (fraction_hi == 0)
+	{
+		r_hi = 0;
+		r_lo = 0;
+		return (x < 0 ? -j : j) & 3;
+	}
+
+	i32 zeroes = __builtin_clzll(fraction_hi);
+
+	if (zeroes > 0)
+	{
+		fraction_hi = fraction_hi << zeroes | fraction_lo >> (64 - zeroes);
+	}
+
+	fraction_lo <<= zeroes;
+	scale += zeroes;
+
+	f64 f_hi = (f64) (fraction_hi >> 11) * 0x1p-53;
+	f64 f_lo = (f64) ((fraction_hi & 0x7FF) << 21 | fraction_lo >> 43)
+		* 0x1p-85;
+
+	// r = f * π/2, with the rounding error of the product of the high parts
+	// recovered exactly.
+
+	constexpr f64 half_pi_hi = 1.5707963267948966;
+	constexpr f64 half_pi_lo = 6.123233995736766e-17;
+
+	f64 error = 0;
+	f64 product = two_product(f_hi, half_pi_hi, error);
+	error += f_hi * half_pi_lo + f_lo * half_pi_hi;
+
+	f64 sum = product + error;
+	f64 factor = interpret_int_as_float((i64) (1023 - scale) << 52);
+	f64 sign = negative != (x < 0) ? -1 : 1;
+
+	r_hi = sum * factor * sign;
+	r_lo = (error - (sum - product)) * factor * sign;
+	return (x < 0 ? -j : j) & 3;
+}
+}; // namespace slaw::detail
+
+namespace detail
+{
+/**
+ * Reduces a finite angle to `r` in about [-π/4, π/4], where
+ * `x = j * π/2 + r`, and returns j modulo 4. `r` is returned as a sum
+ * `r_hi + r_lo`.
+ *
+ * Angles below 2^20 * π/2 subtract j * π/2 in up to three steps, with π/2
+ * split into parts whose products with j are exact. Larger angles use
+ * `reduce_half_pi()`.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr i32
+reduce_angle(f64 x, f64 &r_hi, f64 &r_lo)
+{
+	constexpr f64 inv_half_pi = 6.36619772367581382433e-01;
+	constexpr f64 half_pi_1 = 1.57079632673412561417e+00;
+	constexpr f64 half_pi_1_tail = 6.07710050650619224932e-11;
+	constexpr f64 half_pi_2 = 6.07710050630396597660e-11;
+	constexpr f64 half_pi_2_tail = 2.02226624879595063154e-21;
+	constexpr f64 half_pi_3 = 2.02226624871116645580e-21;
+	constexpr f64 half_pi_3_tail = 8.47842766036889956997e-32;
+
+	u32 high = high_word(x) & 0x7FFFFFFF;
+
+	if (high >= 0x413921FB)
+	{
+		return reduce_half_pi(x, r_hi, r_lo);
+	}
+
+	// j is rounded to the nearest integer by adding and subtracting
+	// 1.5 * 2^52.
+
+	f64 fj = (x * inv_half_pi + 0x1.8p52) - 0x1.8p52;
+	i32 j = (i32) fj;
+
+	// The first step is accurate to about 85 bits. If r has lost many
+	// bits to cancellation, the next parts of π/2 are subtracted too.
+
+	f64 r = x - fj * half_pi_1;
+	f64 w = fj * half_pi_1_tail;
+	r_hi = r - w;
+
+	i32 exponent = high >> 20;
+
+	if (exponent - (i32) (high_word(r_hi) >> 20 & 0x7FF) > 16)
+	{
+		f64 t = r;
+		w = fj * half_pi_2;
+		r = t - w;
+		w = fj * half_pi_2_tail - ((t - r) - w);
+		r_hi = r - w;
+
+		if (exponent - (i32) (high_word(r_hi) >> 20 & 0x7FF) > 49)
+		{
+			t = r;
+			w = fj * half_pi_3;
+			r = t - w;
+			w = fj * half_pi_3_tail - ((t - r) - w);
+			r_hi = r - w;
+		}
+	}
+
+	r_lo = (r - r_hi) - w;
+	return j & 3;
+}
+
+/**
+ * Returns the sine of `x + y`, for |x + y| <= π/4, where y is a small
+ * correction of x.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+sin_kernel(f64 x, f64 y)
+{
+	constexpr f64 s1 = -1.66666666666666324348e-01;
+	constexpr f64 s2 = 8.33333333332248946124e-03;
+	constexpr f64 s3 = -1.98412698298579493134e-04;
+	constexpr f64 s4 = 2.75573137070700676789e-06;
+	constexpr f64 s5 = -2.50507602534068634195e-08;
+	constexpr f64 s6 = 1.58969099521155010221e-10;
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 r = s2 + z * (s3 + z * s4) + z * w * (s5 + z * s6);
+	f64 v = z * x;
+
+	// sin(x + y) = sin(x) + y * cos(x), where cos(x) = 1 - x^2/2 is
+	// accurate enough for the correction.
+
+	return x - ((z * (0.5 * y - v * r) - y) - v * s1);
+}
+
+/**
+ * Returns the cosine of `x + y`, for |x + y| <= π/4, where y is a small
+ * correction of x.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+cos_kernel(f64 x, f64 y)
+{
+	constexpr f64 c1 = 4.16666666666666019037e-02;
+	constexpr f64 c2 = -1.38888888888741095749e-03;
+	constexpr f64 c3 = 2.48015872894767294178e-05;
+	constexpr f64 c4 = -2.75573143513906633035e-07;
+	constexpr f64 c5 = 2.08757232129817482790e-09;
+	constexpr f64 c6 = -1.13596475577881948265e-11;
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 r = z * (c1 + z * (c2 + z * c3)) + w * w * (c4 + z * (c5 + z * c6));
+	f64 half_z = 0.5 * z;
+
+	// cos(x + y) = 1 - x^2/2 + x^4 * R(x^2) - x * y, where the rounding
+	// error of 1 - x^2/2 is added back.
+
+	w = 1 - half_z;
+	return w + (((1 - w) - half_z) + (z * r - x * y));
+}
+
+/**
+ * Returns the tangent of `x + y`, for |x + y| <= π/4, where y is a small
+ * correction of x, or its negated reciprocal if `odd` is set.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+tan_kernel(f64 x, f64 y, bool odd)
+{
+	constexpr f64 t[] = {
+		3.33333333333334091986e-01, 1.33333333333201242699e-01,
+		5.39682539762260521377e-02, 2.18694882948595424599e-02,
+		8.86323982359930005737e-03, 3.59207910759131235356e-03,
+		1.45620945432529025516e-03, 5.88041240820264096874e-04,
+		2.46463134818469906812e-04, 7.81794442939557092300e-05,
+		7.14072491382608190305e-05, -1.85586374855275456654e-05,
+		2.59073051863633712884e-05
+	};
+	constexpr f64 quarter_pi = 7.85398163397448278999e-01;
+	constexpr f64 quarter_pi_lo = 3.06161699786838301793e-17;
+
+	// Above 0.6744, tan(x) = tan(π/4 - x') is computed from x' = π/4 - x,
+	// whose tangent is more accurate.
+
+	bool big = (high_word(x) & 0x7FFFFFFF) >= 0x3FE59428;
+	bool negative = high_word(x) >> 31;
+
+	if (big)
+	{
+		if (negative)
+		{
+			x = -x;
+			y = -y;
+		}
+
+		x = (quarter_pi - x) + (quarter_pi_lo - y);
+		y = 0;
+	}
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 r = t[1] + w * (t[3] + w * (t[5] + w * (t[7] + w * (t[9]
+		+ w * t[11]))));
+	f64 v = z * (t[2] + w * (t[4] + w * (t[6] + w * (t[8] + w * (t[10]
+		+ w * t[12])))));
+	f64 s = z * x;
+	r = y + z * (s * (r + v) + y) + s * t[0];
+	w = x + r;
+
+	if (big)
+	{
+		// tan(π/4 - x) = 1 - 2 * tan(x) / (1 + tan(x)), and its negated
+		// reciprocal is the same with 1 replaced by -1.
+
+		s = odd ? -1 : 1;
+		v = s - 2.0 * (x + (r - w * w / (w + s)));
+		return negative ? -v : v;
+	}
+
+	if (!odd)
+	{
+		return w;
+	}
+
+	// -1 / (x + r) is computed with split high parts, whose product is
+	// exact, because the plain division would have up to 2 ULP error.
+
+	f64 w0 = from_words(high_word(w), 0);
+	v = r - (w0 - x);
+	f64 a = -1.0 / w;
+	f64 a0 = from_words(high_word(a), 0);
+
+	return a0 + a * (1.0 + a0 * w0 + a0 * v);
+}
+
+/**
+ * Returns the sine of x, for |x| <= π/4, accurate enough for f32 results.
+ *
+ * The kernels for f32 use the shorter polynomials of the f32 `sinf()`,
+ * `cosf()` and `tanf()` in musl, evaluated in f64.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+sin_kernel_single(f64 x)
+{
+	constexpr f64 s1 = -1.66666666416265235595e-01;
+	constexpr f64 s2 = 8.33332938588946317560e-03;
+	constexpr f64 s3 = -1.98393348360966317347e-04;
+	constexpr f64 s4 = 2.71831149398982190640e-06;
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 s = z * x;
+
+	return (x + s * (s1 + z * s2)) + s * w * (s3 + z * s4);
+}
+
+/**
+ * Returns the cosine of x, for |x| <= π/4, accurate enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+cos_kernel_single(f64 x)
+{
+	constexpr f64 c0 = -4.99999997251031003120e-01;
+	constexpr f64 c1 = 4.16666233237390631894e-02;
+	constexpr f64 c2 = -1.38867637746099294692e-03;
+	constexpr f64 c3 = 2.43904487962774090654e-05;
+
+	f64 z = x * x;
+	f64 w = z * z;
+
+	return ((1 + z * c0) + w * c1) + (w * z) * (c2 + z * c3);
+}
+
+/**
+ * Returns the tangent of x, or its negated reciprocal if `odd` is set, for
+ * |x| <= π/4, accurate enough for f32 results.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+tan_kernel_single(f64 x, bool odd)
+{
+	constexpr f64 t[] = {
+		3.33331395030791399758e-01, 1.33392002712976742718e-01,
+		5.33812378445670393523e-02, 2.45283181166547278873e-02,
+		2.97435743359967304927e-03, 9.46564784943673166728e-03
+	};
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 s = z * x;
+	f64 r = (x + s * (t[0] + z * t[1]))
+		+ (s * w) * ((t[2] + z * t[3]) + w * (t[4] + z * t[5]));
+
+	return odd ? -1 / r : r;
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns the cosine of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+cos(f64 value)
+{
+	SLAW_JS_MATH(detail::js_cos(value));
+
+	u32 high = detail::high_word(value) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		// |x| <= π/4.
+
+		return high < 0x3E46A09E ? 1.0 : detail::cos_kernel(value, 0);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN64;
+	}
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+
+	switch (detail::reduce_angle(value, r_hi, r_lo))
+	{
+	case 0:
+		return detail::cos_kernel(r_hi, r_lo);
+	case 1:
+		return -detail::sin_kernel(r_hi, r_lo);
+	case 2:
+		return -detail::cos_kernel(r_hi, r_lo);
+	default:
+		return detail::sin_kernel(r_hi, r_lo);
+	}
+}
+
+/**
+ * Returns the cosine of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+cos(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_cos(value));
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		// |x| <= π/4.
+
+		return (f32) detail::cos_kernel_single(x);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN32;
+	}
+
+	// The low part of the reduced angle is below the precision of an f32.
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+
+	switch (detail::reduce_angle(x, r_hi, r_lo))
+	{
+	case 0:
+		return (f32) detail::cos_kernel_single(r_hi);
+	case 1:
+		return (f32) -detail::sin_kernel_single(r_hi);
+	case 2:
+		return (f32) -detail::cos_kernel_single(r_hi);
+	default:
+		return (f32) detail::sin_kernel_single(r_hi);
+	}
+}
+
+/**
+ * Returns the sine of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+sin(f64 value)
+{
+	SLAW_JS_MATH(detail::js_sin(value));
+
+	u32 high = detail::high_word(value) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		return high < 0x3E500000 ? value : detail::sin_kernel(value, 0);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN64;
+	}
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+
+	switch (detail::reduce_angle(value, r_hi, r_lo))
+	{
+	case 0:
+		return detail::sin_kernel(r_hi, r_lo);
+	case 1:
+		return detail::cos_kernel(r_hi, r_lo);
+	case 2:
+		return -detail::sin_kernel(r_hi, r_lo);
+	default:
+		return -detail::cos_kernel(r_hi, r_lo);
+	}
+}
+
+/**
+ * Returns the sine of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+sin(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_sin(value));
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		// |x| <= π/4. Below 2^-12, sin(x) rounds to x.
+
+		return high < 0x3F300000 ? value
+			: (f32) detail::sin_kernel_single(x);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN32;
+	}
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+
+	switch (detail::reduce_angle(x, r_hi, r_lo))
+	{
+	case 0:
+		return (f32) detail::sin_kernel_single(r_hi);
+	case 1:
+		return (f32) detail::cos_kernel_single(r_hi);
+	case 2:
+		return (f32) -detail::sin_kernel_single(r_hi);
+	default:
+		return (f32) -detail::cos_kernel_single(r_hi);
+	}
+}
+
+/**
+ * Returns the tangent of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+tan(f64 value)
+{
+	SLAW_JS_MATH(detail::js_tan(value));
+
+	u32 high = detail::high_word(value) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		return high < 0x3E400000 ? value
+			: detail::tan_kernel(value, 0, false);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN64;
+	}
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+	i32 j = detail::reduce_angle(value, r_hi, r_lo);
+
+	return detail::tan_kernel(r_hi, r_lo, j & 1);
+}
+
+/**
+ * Returns the tangent of a floating point number.
+ * Input angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+tan(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_tan(value));
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+
+	if (high <= 0x3FE921FB)
+	{
+		return high < 0x3F300000 ? value
+			: (f32) detail::tan_kernel_single(x, false);
+	}
+
+	if (high >= 0x7FF00000)
+	{
+		return is_nan(value) ? value : NaN32;
+	}
+
+	f64 r_hi = 0;
+	f64 r_lo = 0;
+	i32 j = detail::reduce_angle(x, r_hi, r_lo);
+
+	return (f32) detail::tan_kernel_single(r_hi, j & 1);
+}
+
+namespace detail
+{
+/**
+ * Returns `(asin(√z) - √z) / √z`, for z in [0, 0.25], approximated by a
+ * rational function of z.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+asin_tail(f64 z)
+{
+	constexpr f64 p0 = 1.66666666666666657415e-01;
+	constexpr f64 p1 = -3.25565818622400915405e-01;
+	constexpr f64 p2 = 2.01212532134862925881e-01;
+	constexpr f64 p3 = -4.00555345006794114027e-02;
+	constexpr f64 p4 = 7.91534994289814532176e-04;
+	constexpr f64 p5 = 3.47933107596021167570e-05;
+	constexpr f64 q1 = -2.40339491173441421878e+00;
+	constexpr f64 q2 = 2.02094576023350569471e+00;
+	constexpr f64 q3 = -6.88283971605453293030e-01;
+	constexpr f64 q4 = 7.70381505559019352791e-02;
+
+	f64 p = z * (p0 + z * (p1 + z * (p2 + z * (p3 + z * (p4 + z * p5)))));
+	f64 q = 1 + z * (q1 + z * (q2 + z * (q3 + z * q4)));
+
+	return p / q;
+}
+
+/**
+ * Returns `(asin(√z) - √z) / √z`, for z in [0, 0.25], accurate enough for
+ * f32 results. The rational function is the one of the f32 `asinf()` in
+ * musl, evaluated in f64.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+asin_tail_single(f64 z)
+{
+	constexpr f64 p0 = 1.66665866971015930176e-01;
+	constexpr f64 p1 = -4.27434220910072326660e-02;
+	constexpr f64 p2 = -8.65636300295591354370e-03;
+	constexpr f64 q1 = -7.06629633903503417969e-01;
+
+	return z * (p0 + z * (p1 + z * p2)) / (1 + z * q1);
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns the inverse cosine of a floating point number.
+ * Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+acos(f64 value)
+{
+	SLAW_JS_MATH(detail::js_acos(value));
+
+	constexpr f64 half_pi_hi = 1.57079632679489655800e+00;
+	constexpr f64 half_pi_lo = 6.12323399573676603587e-17;
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+	bool negative = detail::high_word(x) >> 31;
+
+	if (high >= 0x3FF00000)
+	{
+		// |x| >= 1, or NaN.
+
+		if (x == 1)
+		{
+			return 0;
+		}
+
+		if (x == -1)
+		{
+			return 2 * half_pi_hi;
+		}
+
+		return is_nan(x) ? x : NaN64;
+	}
+
+	if (high < 0x3FE00000)
+	{
+		// |x| < 0.5: acos(x) = π/2 - asin(x).
+
+		if (high <= 0x3C600000)
+		{
+			return half_pi_hi;
+		}
+
+		return half_pi_hi - (x - (half_pi_lo - x * detail::asin_tail(x * x)));
+	}
+
+	// |x| >= 0.5: acos(x) = 2 * asin(√((1 - |x|) / 2)), subtracted from π
+	// for negative x.
+
+	if (negative)
+	{
+		f64 z = (1 + x) * 0.5;
+		f64 s = sqrt(z);
+		f64 w = detail::asin_tail(z) * s - half_pi_lo;
+
+		return 2 * (half_pi_hi - (s + w));
+	}
+
+	// √z is split into a high part with 21 bits and a correction, to
+	// keep the result accurate near 1.
+
+	f64 z = (1 - x) * 0.5;
+	f64 s = sqrt(z);
+	f64 s_hi = detail::from_words(detail::high_word(s), 0);
+	f64 c = (z - s_hi * s_hi) / (s + s_hi);
+	f64 w = detail::asin_tail(z) * s + c;
+
+	return 2 * (s_hi + w);
+}
+
+/**
+ * Returns the inverse cosine of a floating point number.
+ * Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+acos(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_acos(value));
+
+	constexpr f64 half_pi = 1.57079632679489655800e+00;
+	constexpr f64 pi = 3.14159265358979311600e+00;
+
+	f64 x = value;
+	f64 ax = abs(x);
+
+	if (is_nan(value) || ax >= 1)
+	{
+		return x == 1 ? 0 : x == -1 ? (f32) pi
+			: is_nan(value) ? value : NaN32;
+	}
+
+	if (ax < 0.5)
+	{
+		f64 y = x + x * detail::asin_tail_single(x * x);
+		return (f32) (half_pi - y);
+	}
+
+	// acos(|x|) = 2 * asin(√((1 - |x|) / 2)), and
+	// acos(-x) = π - acos(x).
+
+	f64 z = (1 - ax) * 0.5;
+	f64 s = sqrt(z);
+	f64 y = 2 * (s + s * detail::asin_tail_single(z));
+
+	return (f32) (x < 0 ? pi - y : y);
+}
+
+/**
+ * Returns the inverse sine of a floating point number.
+ * Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+asin(f64 value)
+{
+	SLAW_JS_MATH(detail::js_asin(value));
+
+	constexpr f64 half_pi_hi = 1.57079632679489655800e+00;
+	constexpr f64 half_pi_lo = 6.12323399573676603587e-17;
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+	bool negative = detail::high_word(x) >> 31;
+
+	if (high >= 0x3FF00000)
+	{
+		// |x| >= 1, or NaN.
+
+		if (x == 1 || x == -1)
+		{
+			return x * half_pi_hi;
+		}
+
+		return is_nan(x) ? x : NaN64;
+	}
+
+	if (high < 0x3FE00000)
+	{
+		// |x| < 0.5.
+
+		if (high < 0x3E500000)
+		{
+			return x;
+		}
+
+		return x + x * detail::asin_tail(x * x);
+	}
+
+	// |x| >= 0.5: asin(x) = π/2 - 2 * asin(√((1 - |x|) / 2)).
+
+	f64 z = (1 - abs(x)) * 0.5;
+	f64 s = sqrt(z);
+	f64 r = detail::asin_tail(z);
+
+	if (high >= 0x3FEF3333)
+	{
+		// |x| > 0.975.
+
+		x = half_pi_hi - (2 * (s + s * r) - half_pi_lo);
+	}
+	else
+	{
+		// √z is split like in `acos()`.
+
+		f64 s_hi = detail::from_words(detail::high_word(s), 0);
+		f64 c = (z - s_hi * s_hi) / (s + s_hi);
+
+		x = 0.5 * half_pi_hi - (2 * s * r - (half_pi_lo - 2 * c)
+			- (0.5 * half_pi_hi - 2 * s_hi));
+	}
+
+	return negative ? -x : x;
+}
+
+/**
+ * Returns the inverse sine of a floating point number.
+ * Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+asin(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_asin(value));
+
+	constexpr f64 half_pi = 1.57079632679489655800e+00;
+
+	f64 x = value;
+	f64 ax = abs(x);
+
+	if (is_nan(value) || ax >= 1)
+	{
+		return ax == 1 ? (f32) (x * half_pi)
+			: is_nan(value) ? value : NaN32;
+	}
+
+	if (ax < 0.5)
+	{
+		// Below 2^-12, asin(x) rounds to x.
+
+		return ax < 0x1p-12 ? value
+			: (f32) (x + x * detail::asin_tail_single(x * x));
+	}
+
+	// asin(|x|) = π/2 - 2 * asin(√((1 - |x|) / 2)).
+
+	f64 z = (1 - ax) * 0.5;
+	f64 s = sqrt(z);
+	f64 y = half_pi - 2 * (s + s * detail::asin_tail_single(z));
+
+	return (f32) (x < 0 ? -y : y);
+}
+
+namespace detail
+{
+/**
+ * Returns `atan(value) + delta`, for a `delta` well below the rounding
+ * error of the result, with `delta` added before the last rounding.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+atan_adjusted(f64 value, f64 delta)
+{
+	// atan(x) = atan(c) + atan((x - c) / (1 + c * x)), for the c in
+	// { 0.5, 1, 1.5, ∞ } closest to |x|, with atan(c) in two parts.
+
+	constexpr f64 atan_hi[] = {
+		4.63647609000806093515e-01, 7.85398163397448278999e-01,
+		9.82793723247329054082e-01, 1.57079632679489655800e+00
+	};
+	constexpr f64 atan_lo[] = {
+		2.26987774529616870924e-17, 3.06161699786838301793e-17,
+		1.39033110312309984516e-17, 6.12323399573676603587e-17
+	};
+	constexpr f64 a[] = {
+		3.33333333333329318027e-01, -1.99999999998764832476e-01,
+		1.42857142725034663711e-01, -1.11111104054623557880e-01,
+		9.09088713343650656196e-02, -7.69187620504482999495e-02,
+		6.66107313738753120669e-02, -5.83357013379057348645e-02,
+		4.97687799461593236017e-02, -3.65315727442169155270e-02,
+		1.62858201153657823623e-02
+	};
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+	bool negative = detail::high_word(x) >> 31;
+	i32 id = -1;
+
+	if (high >= 0x44100000)
+	{
+		// |x| >= 2^66, or NaN.
+
+		if (is_nan(x))
+		{
+			return x;
+		}
+
+		return negative ? -atan_hi[3] : atan_hi[3];
+	}
+
+	if (high < 0x3FDC0000)
+	{
+		// |x| < 0.4375.
+
+		if (high < 0x3E400000)
+		{
+			return delta == 0 ? x : x + delta;
+		}
+	}
+	else
+	{
+		x = abs(x);
+		delta = negative ? -delta : delta;
+
+		if (high < 0x3FE60000)
+		{
+			id = 0;
+			x = (2 * x - 1) / (2 + x);
+		}
+		else if (high < 0x3FF30000)
+		{
+			id = 1;
+			x = (x - 1) / (x + 1);
+		}
+		else if (high < 0x40038000)
+		{
+			id = 2;
+			x = (x - 1.5) / (1 + 1.5 * x);
+		}
+		else
+		{
+			id = 3;
+			x = -1 / x;
+		}
+	}
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 odd = z * (a[0] + w * (a[2] + w * (a[4] + w * (a[6] + w * (a[8]
+		+ w * a[10])))));
+	f64 even = w * (a[1] + w * (a[3] + w * (a[5] + w * (a[7]
+		+ w * a[9]))));
+
+	if (id < 0)
+	{
+		return x - (x * (odd + even) - delta);
+	}
+
+	z = atan_hi[id] - (x * (odd + even) - atan_lo[id] - delta - x);
+	return negative ? -z : z;
+}
 
 /**
- * Returns the tangent of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns the inverse tangent of a finite number, accurate enough for f32
+ * results.
+ *
+ * This works like `atan_adjusted()`, with the shorter polynomial of the f32
+ * `atanf()` in musl, evaluated in f64, where atan(c) needs no low part.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-tan(f32 value)
+constexpr f64
+atan_single(f64 x)
 {
-	return tan((f64) value);
+	constexpr f64 atan_c[] = {
+		4.63647609000806093515e-01, 7.85398163397448278999e-01,
+		9.82793723247329054082e-01, 1.57079632679489655800e+00
+	};
+	constexpr f64 a[] = {
+		3.33333283662796020508e-01, -1.99991583824157714844e-01,
+		1.42536357045173645020e-01, -1.06480173766613006592e-01,
+		6.16876073181629180908e-02
+	};
+
+	u32 high = high_word(x) & 0x7FFFFFFF;
+	bool negative = high_word(x) >> 31;
+	i32 id = -1;
+
+	if (high >= 0x41900000)
+	{
+		// |x| >= 2^26, so atan(x) rounds to ±π/2.
+
+		return negative ? -atan_c[3] : atan_c[3];
+	}
+
+	if (high >= 0x3FDC0000)
+	{
+		// |x| >= 0.4375.
+
+		x = abs(x);
+
+		if (high < 0x3FE60000)
+		{
+			id = 0;
+			x = (2 * x - 1) / (2 + x);
+		}
+		else if (high < 0x3FF30000)
+		{
+			id = 1;
+			x = (x - 1) / (x + 1);
+		}
+		else if (high < 0x40038000)
+		{
+			id = 2;
+			x = (x - 1.5) / (1 + 1.5 * x);
+		}
+		else
+		{
+			id = 3;
+			x = -1 / x;
+		}
+	}
+
+	f64 z = x * x;
+	f64 w = z * z;
+	f64 odd = z * (a[0] + w * (a[2] + w * a[4]));
+	f64 even = w * (a[1] + w * a[3]);
+
+	if (id < 0)
+	{
+		return x - x * (odd + even);
+	}
+
+	z = atan_c[id] + (x - x * (odd + even));
+	return negative ? -z : z;
 }
+}; // namespace slaw::detail
 
 /**
- * Returns the inverse cosine of a floating point number.
+ * Returns the inverse tangent of a floating point number.
  * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("acos")
-f64
-acos(f64 value);
+constexpr f64
+atan(f64 value)
+{
+	SLAW_JS_MATH(detail::js_atan(value));
+
+	return detail::atan_adjusted(value, 0);
+}
 
 /**
- * Returns the inverse cosine of a floating point number.
+ * Returns the inverse tangent of a floating point number.
  * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-acos(f32 value)
+constexpr f32
+atan(f32 value)
 {
-	return acos((f64) value);
+	SLAW_JS_MATH((f32) detail::js_atan(value));
+
+	// Below 2^-12, atan(x) rounds to x.
+
+	if (is_nan(value) || abs(value) < 0x1p-12f)
+	{
+		return value;
+	}
+
+	return (f32) detail::atan_single(value);
 }
 
+namespace detail
+{
 /**
- * Returns the inverse sine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns `a + b`, and stores its rounding error in `error`, exactly.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("asin")
-f64
-asin(f64 value);
+constexpr f64
+two_sum(f64 a, f64 b, f64 &error)
+{
+	f64 sum = a + b;
+	f64 b_virtual = sum - a;
+
+	error = (a - (sum - b_virtual)) + (b - b_virtual);
+	return sum;
+}
 
 /**
- * Returns the inverse sine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns the square root of `hi + lo`, as `s + s_lo`, for a positive
+ * `hi` much larger than `lo`.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-asin(f32 value)
+constexpr f64
+sqrt_extended(f64 hi, f64 lo, f64 &s_lo)
 {
-	return asin((f64) value);
+	f64 s = sqrt(hi);
+	f64 error = 0;
+	f64 square = two_product(s, s, error);
+
+	s_lo = ((hi - square) - error + lo) / (2 * s);
+	return s;
 }
 
 /**
- * Returns the inverse tangent of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns the natural logarithm of a positive, finite number as `hi + lo`,
+ * accurate to about 2^-62 relative.
+ *
+ * This works like `ln()`, with the square in `ln(1 + f) = f - f^2/2 + ...`
+ * computed exactly, and the sums kept in two parts.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+ln_extended(f64 x, f64 &lo)
+{
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+
+	i32 k = 0;
+	f64 f = split_log_argument(x, k);
+	f64 square_lo = 0;
+	f64 square = two_product(f, f, square_lo);
+	f64 tail = log_tail(f, 0.5 * square);
+
+	f64 sum_error = 0;
+	f64 sum = two_sum(f, -0.5 * square, sum_error);
+	f64 sum_lo = sum_error - 0.5 * square_lo + tail;
+
+	f64 dk = k;
+	f64 hi_error = 0;
+	f64 hi = two_sum(dk * ln2_hi, sum, hi_error);
+
+	lo = hi_error + sum_lo + dk * ln2_lo;
+	return hi;
+}
+
+/**
+ * Returns the natural logarithm of `hi + lo`, for a positive, finite `hi`
+ * much larger than `lo`.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("atan")
-f64
-atan(f64 value);
+constexpr f64
+ln_of_sum(f64 hi, f64 lo)
+{
+	f64 ln_lo = 0;
+	f64 ln_hi = ln_extended(hi, ln_lo);
+
+	return ln_hi + (ln_lo + lo / hi);
+}
 
 /**
- * Returns the inverse tangent of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns `e^x` as `hi + lo`, accurate to about 2^-57 relative, for
+ * |x| < 700.
+ *
+ * This works like `exp_scaled()`, with the last additions kept in two
+ * parts.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
-atan(f32 value)
+constexpr f64
+exp_extended(f64 x, f64 &lo)
 {
-	return atan((f64) value);
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+	constexpr f64 inv_ln2 = 1.44269504088896338700e+00;
+	constexpr f64 p1 = 1.66666666666666019037e-01;
+	constexpr f64 p2 = -2.77777777770155933842e-03;
+	constexpr f64 p3 = 6.61375632143793436117e-05;
+	constexpr f64 p4 = -1.65339022054652515390e-06;
+	constexpr f64 p5 = 4.13813679705723846039e-08;
+
+	i32 k = (i32) (inv_ln2 * x + (x < 0 ? -0.5 : 0.5));
+	f64 hi = x - k * ln2_hi;
+	f64 r_lo = k * ln2_lo;
+	f64 r = hi - r_lo;
+	f64 z = r * r;
+	f64 c = r - z * (p1 + z * (p2 + z * (p3 + z * (p4 + z * p5))));
+
+	// e^r = 1 + hi + (r * c / (2 - c) - r_lo), where hi is exact.
+
+	f64 small = r * c / (2 - c) - r_lo;
+	f64 sum_error = 0;
+	f64 sum = two_sum(1, hi, sum_error);
+	f64 result = sum + (sum_error + small);
+	f64 scale = interpret_int_as_float((i64) (k + 1023) << 52);
+
+	lo = ((sum - result) + (sum_error + small)) * scale;
+	return result * scale;
 }
 
 /**
- * Returns the inverse tangent of a given ratio y / x.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns `sinh(x)` as `hi + lo`, for |x| < 1, from its Taylor series
+ * with the x^3 / 6 term in two parts.
  */
-IMPORT("atan2")
-f64
-atan2(f64 y, f64 x);
+constexpr f64
+sinh_small(f64 x, f64 &lo)
+{
+	f64 z_lo = 0;
+	f64 z = two_product(x, x, z_lo);
+	f64 cube_lo = 0;
+	f64 cube = two_product(x, z, cube_lo);
+	cube_lo += x * z_lo;
+
+	f64 sixth = cube / 6;
+	f64 product_error = 0;
+	f64 product = two_product(sixth, 6, product_error);
+	f64 sixth_lo = ((cube - product) - product_error + cube_lo) / 6;
+
+	f64 rest = cube * z * (8.333333333333333e-03 + z
+		* (1.984126984126984e-04 + z * (2.7557319223985893e-06
+		+ z * (2.505210838544172e-08 + z * (1.6059043836821613e-10
+		+ z * (7.647163731819816e-13 + z * (2.8114572543455206e-15
+		+ z * 8.22063524662433e-18)))))));
+
+	f64 tail_error = 0;
+	f64 tail = two_sum(sixth, rest, tail_error);
+	f64 error = 0;
+	f64 hi = two_sum(x, tail, error);
+	f64 sum = hi + (error + tail_error + sixth_lo);
+
+	lo = (hi - sum) + (error + tail_error + sixth_lo);
+	return sum;
+}
 
 /**
- * Returns the inverse tangent of a given ratio y / x.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ * Returns `cosh(x)` as `hi + lo`, for |x| < 1, from its Taylor series
+ * with the x^2 / 2 term in two parts.
+ */
+constexpr f64
+cosh_small(f64 x, f64 &lo)
+{
+	f64 z_lo = 0;
+	f64 z = two_product(x, x, z_lo);
+	f64 rest = z * z * (4.1666666666666664e-02 + z
+		* (1.388888888888889e-03 + z * (2.48015873015873e-05
+		+ z * (2.755731922398589e-07 + z * (2.08767569878681e-09
+		+ z * (1.1470745597729725e-11 + z * (4.779477332387385e-14
+		+ z * 1.5619206968586225e-16)))))));
+
+	f64 tail_error = 0;
+	f64 tail = two_sum(0.5 * z, rest, tail_error);
+	f64 error = 0;
+	f64 hi = two_sum(1, tail, error);
+	f64 sum = hi + (error + tail_error + 0.5 * z_lo);
+
+	lo = (hi - sum) + (error + tail_error + 0.5 * z_lo);
+	return sum;
+}
+
+/**
+ * Returns `e^x + sign * e^-x` as `hi + lo`, for 1 <= |x| < 22.
+ */
+constexpr f64
+exp_pair(f64 x, f64 sign, f64 &lo)
+{
+	f64 e_lo = 0;
+	f64 e = exp_extended(x, e_lo);
+
+	// 1 / (e + e_lo), with the error of the division added back.
+
+	f64 inverse = 1 / e;
+	f64 product_error = 0;
+	f64 product = two_product(inverse, e, product_error);
+	f64 inverse_lo = ((1 - product) - product_error - inverse * e_lo) / e;
+
+	f64 error = 0;
+	f64 hi = two_sum(e, sign * inverse, error);
+
+	lo = error + e_lo + sign * inverse_lo;
+	return hi;
+}
+
+/**
+ * Returns `atan(a / b)`, for positive a and b, with the rounding error of
+ * the division added back through the derivative of atan.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+atan_of_quotient(f64 a, f64 b)
+{
+	f64 t = a / b;
+
+	if (t < 0x1p-900)
+	{
+		return atan_adjusted(t, 0);
+	}
+
+	// The residual of the division is kept away from overflow and
+	// underflow.
+
+	if (b > 0x1p900)
+	{
+		a *= 0x1p-200;
+		b *= 0x1p-200;
+	}
+	else if (b < 0x1p-900)
+	{
+		a *= 0x1p200;
+		b *= 0x1p200;
+	}
+
+	f64 error = 0;
+	f64 product = two_product(t, b, error);
+
+	return atan_adjusted(t, ((a - product) - error) / b / (1 + t * t));
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns the angle between the positive x-axis and the point (x, y), in
+ * (-π, π]. Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+atan2(f64 y, f64 x)
+{
+	SLAW_JS_MATH(detail::js_atan2(y, x));
+
+	constexpr f64 pi = 3.1415926535897931160e+00;
+	constexpr f64 pi_lo = 1.2246467991473531772e-16;
+	constexpr f64 half_pi_lo = 6.12323399573676603587e-17;
+
+	if (is_nan(x) || is_nan(y))
+	{
+		return x + y;
+	}
+
+	u32 ix = detail::high_word(x) & 0x7FFFFFFF;
+	u32 iy = detail::high_word(y) & 0x7FFFFFFF;
+	bool x_negative = detail::high_word(x) >> 31;
+	f64 sign = detail::high_word(y) >> 31 ? -1 : 1;
+
+	if (y == 0)
+	{
+		return x_negative ? sign * pi : y;
+	}
+
+	if (x == 0)
+	{
+		return sign * (pi / 2);
+	}
+
+	if (ix == 0x7FF00000)
+	{
+		// x = ±∞.
+
+		if (iy == 0x7FF00000)
+		{
+			return sign * (x_negative ? 3 * pi / 4 : pi / 4);
+		}
+
+		return x_negative ? sign * pi : sign * 0.0;
+	}
+
+	if (iy == 0x7FF00000 || ix + (64 << 20) < iy)
+	{
+		// |y / x| > 2^64.
+
+		return sign * (pi / 2);
+	}
+
+	f64 ax = abs(x);
+	f64 ay = abs(y);
+
+	if (!x_negative)
+	{
+		return sign * detail::atan_of_quotient(ay, ax);
+	}
+
+	// Left of the y-axis, the angle is taken from the closer axis, so
+	// the smaller angle is the one with the rounding error.
+
+	if (ay > ax)
+	{
+		return sign * (pi / 2 + (detail::atan_of_quotient(ax, ay)
+			+ half_pi_lo));
+	}
+
+	// Quotients below 2^-64 are absorbed by π.
+
+	f64 z = iy + (64 << 20) < ix ? 0 : detail::atan_of_quotient(ay, ax);
+	return sign * (pi - (z - pi_lo));
+}
+
+/**
+ * Returns the angle between the positive x-axis and the point (x, y), in
+ * (-π, π]. Output angle is measured in radians.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 atan2(f32 y, f32 x)
 {
-	return atan2((f64) y, (f64) x);
+	SLAW_JS_MATH((f32) detail::js_atan2(y, x));
+
+	constexpr f64 pi = 3.14159265358979311600e+00;
+
+	// Zeros, infinities and NaNs follow the rules of the f64 version,
+	// which returns exact results for them.
+
+	if (x == 0 || y == 0 || is_nan(x) || is_nan(y)
+		|| abs(x) == Infinity32 || abs(y) == Infinity32)
+	{
+		return (f32) atan2((f64) y, (f64) x);
+	}
+
+	// The quotient of two f32 values is accurate to 2^-53 in f64, and
+	// neither overflows nor underflows.
+
+	f64 angle = detail::atan_single(abs((f64) y / x));
+
+	if (x < 0)
+	{
+		angle = pi - angle;
+	}
+
+	return (f32) (y < 0 ? -angle : angle);
 }
 
 /**
  * Returns the hyperbolic cosine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f64
+cosh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_cosh(value));
+
+	f64 x = abs(value);
+	u32 high = detail::high_word(x);
+
+	if (high < 0x3FF00000)
+	{
+		// |x| < 1.
+
+		f64 lo = 0;
+		f64 hi = detail::cosh_small(x, lo);
+		return hi + lo;
+	}
+
+	if (high < 0x40360000)
+	{
+		// |x| < 22: cosh(x) = (e^x + e^-x) / 2.
+
+		f64 lo = 0;
+		f64 hi = detail::exp_pair(x, 1, lo);
+		return 0.5 * (hi + lo);
+	}
+
+	// e^-|x| is below the rounding error of e^|x|, and e^|x| / 2 is
+	// computed without overflowing first.
+
+	if (is_nan(x) || x > 710.4758600739439)
+	{
+		return x * Infinity64;
+	}
+
+	return detail::exp_scaled(x, -1);
+}
+
+/**
+ * Returns the hyperbolic cosine of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+constexpr f32
+cosh(f32 value)
+{
+	SLAW_JS_MATH((f32) detail::js_cosh(value));
+
+	f64 x = abs((f64) value);
+
+	if (is_nan(value) || x > 90)
+	{
+		return is_nan(value) ? value : Infinity32;
+	}
+
+	f64 e = detail::exp_single(x);
+	return (f32) (0.5 * (e + 1 / e));
+}
+
+/**
+ * Returns the hyperbolic sine of a floating point number.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("cosh")
-f64
-cosh(f64 value);
+constexpr f64
+sinh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_sinh(value));
+
+	f64 x = abs(value);
+	u32 high = detail::high_word(x);
+	f64 result = 0;
+
+	if (high < 0x3E300000)
+	{
+		// |x| < 2^-28, so sinh(x) rounds to x.
+
+		return value;
+	}
+
+	if (high < 0x3FF00000)
+	{
+		// |x| < 1.
+
+		f64 lo = 0;
+		f64 hi = detail::sinh_small(value, lo);
+		return hi + lo;
+	}
+
+	if (high < 0x40360000)
+	{
+		// |x| < 22: sinh(x) = (e^x - e^-x) / 2.
+
+		f64 lo = 0;
+		f64 hi = detail::exp_pair(x, -1, lo);
+		result = 0.5 * (hi + lo);
+	}
+	else if (is_nan(x) || x > 710.4758600739439)
+	{
+		result = x * Infinity64;
+	}
+	else
+	{
+		result = detail::exp_scaled(x, -1);
+	}
 
-/**
- * Returns the hyperbolic cosine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
- */
-inline f32
-cosh(f32 value)
-{
-	return cosh((f64) value);
+	return detail::high_word(value) >> 31 ? -result : result;
 }
 
 /**
  * Returns the hyperbolic sine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
- */
-IMPORT("sinh")
-f64
-sinh(f64 value);
-
-/**
- * Returns the hyperbolic sine of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 sinh(f32 value)
 {
-	return sinh((f64) value);
+	SLAW_JS_MATH((f32) detail::js_sinh(value));
+
+	f64 x = abs((f64) value);
+
+	// Below 2^-12, sinh(x) rounds to x.
+
+	if (is_nan(value) || x < 0x1p-12)
+	{
+		return value;
+	}
+
+	if (x > 90)
+	{
+		return value < 0 ? -Infinity32 : Infinity32;
+	}
+
+	// sinh(x) = (e^x - 1 + (e^x - 1) / e^x) / 2, which does not cancel
+	// for small x.
+
+	f64 e = detail::expm1_single(x);
+	x = 0.5 * (e + e / (e + 1));
+
+	return (f32) (value < 0 ? -x : x);
 }
 
 /**
  * Returns the hyperbolic tangent of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("tanh")
-f64
-tanh(f64 value);
+constexpr f64
+tanh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_tanh(value));
+
+	f64 x = abs(value);
+	u32 high = detail::high_word(x);
+
+	if (is_nan(x) || high < 0x3E300000)
+	{
+		// NaN, or |x| < 2^-28.
+
+		return value;
+	}
+
+	// tanh(x) = sinh(x) / cosh(x), with both in two parts.
+
+	f64 numerator = 0;
+	f64 numerator_lo = 0;
+	f64 denominator = 0;
+	f64 denominator_lo = 0;
+
+	if (high >= 0x40360000)
+	{
+		// |x| >= 22, so tanh(x) rounds to ±1.
+
+		return detail::high_word(value) >> 31 ? -1 : 1;
+	}
+	else if (high >= 0x3FF00000)
+	{
+		numerator = detail::exp_pair(x, -1, numerator_lo);
+		denominator = detail::exp_pair(x, 1, denominator_lo);
+	}
+	else
+	{
+		numerator = detail::sinh_small(x, numerator_lo);
+		denominator = detail::cosh_small(x, denominator_lo);
+	}
+
+	f64 full_denominator = denominator + denominator_lo;
+	f64 t = (numerator + numerator_lo) / full_denominator;
+	f64 error = 0;
+	f64 product = detail::two_product(t, denominator, error);
+	t += ((numerator - product) - error + numerator_lo - t * denominator_lo)
+		/ full_denominator;
+
+	return detail::high_word(value) >> 31 ? -t : t;
+}
 
 /**
  * Returns the hyperbolic tangent of a floating point number.
- * Input angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 tanh(f32 value)
 {
-	return tanh((f64) value);
+	SLAW_JS_MATH((f32) detail::js_tanh(value));
+
+	f64 x = abs((f64) value);
+
+	if (is_nan(value) || x < 0x1p-12)
+	{
+		return value;
+	}
+
+	if (x > 10)
+	{
+		// tanh(x) rounds to ±1.
+
+		return value < 0 ? -1 : 1;
+	}
+
+	// tanh(x) = (e^2x - 1) / (e^2x - 1 + 2).
+
+	f64 e = detail::expm1_single(2 * x);
+	x = e / (e + 2);
+
+	return (f32) (value < 0 ? -x : x);
 }
 
 /**
  * Returns the inverse hyperbolic cosine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("acosh")
-f64
-acosh(f64 value);
+constexpr f64
+acosh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_acosh(value));
+
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+
+	f64 x = value;
+
+	if (is_nan(x) || x < 1)
+	{
+		return is_nan(x) ? x : NaN64;
+	}
+
+	if (x == 1)
+	{
+		return 0;
+	}
+
+	if (x < 0x1p26)
+	{
+		// acosh(x) = ln(x + √(x^2 - 1)), where x^2 - 1 is exact in two
+		// parts.
+
+		f64 square_lo = 0;
+		f64 square = detail::two_product(x, x, square_lo);
+		f64 root_lo = 0;
+		f64 root = detail::sqrt_extended(square - 1, square_lo, root_lo);
+		f64 sum_error = 0;
+		f64 sum = detail::two_sum(x, root, sum_error);
+
+		return detail::ln_of_sum(sum, sum_error + root_lo);
+	}
+
+	// x >= 2^26: acosh(x) = ln(2x) to within the rounding error.
+
+	if (x == Infinity64)
+	{
+		return x;
+	}
+
+	f64 lo = 0;
+	f64 hi = detail::ln_extended(x, lo);
+	f64 error = 0;
+	f64 sum = detail::two_sum(hi, ln2_hi, error);
+	return sum + (error + lo + ln2_lo);
+}
 
 /**
  * Returns the inverse hyperbolic cosine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 acosh(f32 value)
 {
-	return acosh((f64) value);
+	SLAW_JS_MATH((f32) detail::js_acosh(value));
+
+	f64 x = value;
+
+	if (is_nan(value) || x < 1)
+	{
+		return is_nan(value) ? value : NaN32;
+	}
+
+	if (value == Infinity32)
+	{
+		return value;
+	}
+
+	// acosh(x) = ln(x + √(x^2 - 1)), where x^2 of an f32 is exact in f64.
+
+	return (f32) detail::ln_single(x + sqrt(x * x - 1));
 }
 
 /**
  * Returns the inverse hyperbolic sine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("asinh")
-f64
-asinh(f64 value);
+constexpr f64
+asinh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_asinh(value));
+
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10;
+
+	f64 x = abs(value);
+
+	if (is_nan(x) || x == Infinity64 || x < 0x1p-26)
+	{
+		return value;
+	}
+
+	if (x < 0x1p26)
+	{
+		// asinh(x) = ln(x + √(x^2 + 1)), where x^2 + 1 is exact in two
+		// parts.
+
+		f64 square_lo = 0;
+		f64 square = detail::two_product(x, x, square_lo);
+		f64 one_error = 0;
+		f64 one_sum = detail::two_sum(square, 1, one_error);
+		f64 root_lo = 0;
+		f64 root = detail::sqrt_extended(one_sum, one_error + square_lo,
+			root_lo);
+		f64 sum_error = 0;
+		f64 sum = detail::two_sum(x, root, sum_error);
+
+		x = detail::ln_of_sum(sum, sum_error + root_lo);
+	}
+	else
+	{
+		// |x| >= 2^26: asinh(x) = ln(2|x|) to within the rounding
+		// error.
+
+		f64 lo = 0;
+		f64 hi = detail::ln_extended(x, lo);
+		f64 error = 0;
+		f64 sum = detail::two_sum(hi, ln2_hi, error);
+		x = sum + (error + lo + ln2_lo);
+	}
+
+	return detail::high_word(value) >> 31 ? -x : x;
+}
 
 /**
  * Returns the inverse hyperbolic sine of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 asinh(f32 value)
 {
-	return asinh((f64) value);
+	SLAW_JS_MATH((f32) detail::js_asinh(value));
+
+	f64 x = abs((f64) value);
+
+	if (is_nan(value) || value == Infinity32 || value == -Infinity32
+		|| x < 0x1p-12)
+	{
+		return value;
+	}
+
+	// asinh(x) = ln(1 + x + x^2 / (1 + √(x^2 + 1))), which does not
+	// cancel for small x.
+
+	x = detail::ln1p_single(x + x * x / (1 + sqrt(x * x + 1)));
+	return (f32) (value < 0 ? -x : x);
 }
 
 /**
  * Returns the inverse hyperbolic tangent of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("atanh")
-f64
-atanh(f64 value);
+constexpr f64
+atanh(f64 value)
+{
+	SLAW_JS_MATH(detail::js_atanh(value));
+
+	f64 x = abs(value);
+
+	if (is_nan(x) || x >= 1)
+	{
+		return is_nan(x) ? x : x == 1 ? value * Infinity64 : NaN64;
+	}
+
+	if (x < 0x1p-28)
+	{
+		return value;
+	}
+
+	// atanh(x) = ln((1 + x) / (1 - x)) / 2, where 1 + x and 1 - x are
+	// exact in two parts, and the rounding error of the quotient is
+	// added back.
+
+	f64 plus_lo = 0;
+	f64 plus = detail::two_sum(1, x, plus_lo);
+	f64 minus_lo = 0;
+	f64 minus = detail::two_sum(1, -x, minus_lo);
+
+	f64 quotient = plus / minus;
+	f64 error = 0;
+	f64 product = detail::two_product(quotient, minus, error);
+	f64 quotient_lo = ((plus - product) - error + plus_lo
+		- quotient * minus_lo) / minus;
+
+	x = 0.5 * detail::ln_of_sum(quotient, quotient_lo);
+	return detail::high_word(value) >> 31 ? -x : x;
+}
 
 /**
  * Returns the inverse hyperbolic tangent of a floating point number.
- * Output angle is measured in radians.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 atanh(f32 value)
 {
-	return atanh((f64) value);
-}
-
-/**
- * Returns the exponential of a floating point number (e^x).
- * TODO: Make constexpr.
- */
-IMPORT("exp")
-f64
-exp(f64 value);
+	SLAW_JS_MATH((f32) detail::js_atanh(value));
 
-/**
- * Returns the exponential of a floating point number (e^x).
- * TODO: Make constexpr.
- */
-inline f32
-exp(f32 value)
-{
-	return exp((f64) value);
-}
+	f64 x = abs((f64) value);
 
-/**
- * Returns x raised to the power y.
- */
-IMPORT("pow")
-f64
-pow(f64 x, f64 y);
+	if (is_nan(value) || x < 0x1p-12)
+	{
+		return value;
+	}
 
-/**
- * Returns x raised to the power y.
- */
-inline f32
-pow(f32 x, f32 y)
-{
-	return pow((f64) x, (f64) y);
-}
+	if (x >= 1)
+	{
+		return x > 1 ? NaN32 : value < 0 ? -Infinity32 : Infinity32;
+	}
 
-/**
- * Returns the exponential of a floating point number, minus one (e^x - 1).
- * TODO: Make constexpr.
- */
-IMPORT("expm1")
-f64
-expm1(f64 value);
+	// atanh(x) = ln(1 + 2x / (1 - x)) / 2, where 1 - x is exact in f64.
 
-/**
- * Returns the exponential of a floating point number, minus one (e^x - 1).
- * TODO: Make constexpr.
- */
-inline f32
-expm1(f32 value)
-{
-	return expm1((f64) value);
+	x = 0.5 * detail::ln1p_single(2 * x / (1 - x));
+	return (f32) (value < 0 ? -x : x);
 }
 
 /**
  * Returns the cube root of a floating point number.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("cbrt")
-f64
-cbrt(f64 value);
+constexpr f64
+cbrt(f64 value)
+{
+	SLAW_JS_MATH(detail::js_cbrt(value));
+
+	// 1 / cbrt(r) is approximated by a polynomial P(r), with an error of
+	// 2^-23.5.
+
+	constexpr f64 p0 = 1.87595182427177009643;
+	constexpr f64 p1 = -1.88497979543377169875;
+	constexpr f64 p2 = 1.621429720105354466140;
+	constexpr f64 p3 = -0.758397934778766047437;
+	constexpr f64 p4 = 0.145996192886612446982;
+
+	f64 x = value;
+	u32 high = detail::high_word(x) & 0x7FFFFFFF;
+	u64 sign = (u64) detail::interpret_float_as_int(x)
+		& 0x8000000000000000;
+
+	if (high >= 0x7FF00000 || x == 0)
+	{
+		return x;
+	}
+
+	// A first estimate with 5 bits is taken from dividing the exponent
+	// by 3, and corrected for the bias of the exponent.
+
+	if (high < 0x00100000)
+	{
+		high = (detail::high_word(x * 0x1p54) & 0x7FFFFFFF) / 3
+			+ 696219795;
+	}
+	else
+	{
+		high = high / 3 + 715094163;
+	}
+
+	f64 t = detail::interpret_int_as_float((i64) (sign
+		| (u64) high << 32));
+
+	// One step of a polynomial iteration gives 23 bits. t is then
+	// rounded to 22 bits, so that t * t is exact.
+
+	f64 r = (t * t) * (t / x);
+	t = t * ((p0 + r * (p1 + r * p2)) + ((r * r) * r) * (p3 + r * p4));
+	t = detail::interpret_int_as_float((i64) (((u64)
+		detail::interpret_float_as_int(t) + 0x80000000)
+		& 0xFFFFFFFFC0000000));
+
+	// One Newton step gives 53 bits.
+
+	f64 s = t * t;
+	r = x / s;
+	f64 w = t + t;
+	r = (r - t) / (w + r);
+
+	return t + t * r;
+}
 
 /**
  * Returns the cube root of a floating point number.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 cbrt(f32 value)
 {
-	return cbrt((f64) value);
+	SLAW_JS_MATH((f32) detail::js_cbrt(value));
+
+	u32 bits = detail::interpret_float_as_int(value);
+	u32 high = bits & 0x7FFFFFFF;
+
+	if (high >= 0x7F800000 || high == 0)
+	{
+		return value + value;
+	}
+
+	// The exponent is divided by 3 for a first estimate to 5 bits.
+	// Subnormal numbers are normalised first.
+
+	if (high < 0x00800000)
+	{
+		high = detail::interpret_float_as_int(value * 0x1p24f)
+			& 0x7FFFFFFF;
+		high = high / 3 + 642849266;
+	}
+	else
+	{
+		high = high / 3 + 709958130;
+	}
+
+	// Two Newton steps for t^3 = x, in f64, are accurate to 47 bits.
+
+	f64 x = value;
+	f64 t = detail::interpret_int_as_float(
+		(i32) ((bits & 0x80000000) | high));
+	f64 r = t * t * t;
+	t = t * (x + x + r) / (x + r + r);
+	r = t * t * t;
+	t = t * (x + x + r) / (x + r + r);
+
+	return (f32) t;
 }
 
 /**
  * Returns the hypothenuse of two floating point numbers.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-IMPORT("hypot")
-f64
-hypot(f64 x, f64 y);
+constexpr f64
+hypot(f64 x, f64 y)
+{
+	SLAW_JS_MATH(detail::js_hypot(x, y));
+
+	f64 a = abs(x);
+	f64 b = abs(y);
+
+	// Infinities win over NaNs.
+
+	if (a == Infinity64 || b == Infinity64)
+	{
+		return Infinity64;
+	}
+
+	if (is_nan(a) || is_nan(b))
+	{
+		return a + b;
+	}
+
+	if (a < b)
+	{
+		f64 t = a;
+		a = b;
+		b = t;
+	}
+
+	// If b is below the rounding error of a, the result is a.
+
+	u32 high_a = detail::high_word(a);
+	u32 high_b = detail::high_word(b);
+
+	if (b == 0 || high_a - high_b > (60 << 20))
+	{
+		return a + b;
+	}
+
+	// The squares are kept away from overflow and underflow by scaling
+	// by a power of two.
+
+	f64 scale = 1;
+
+	if (high_a > 0x5F300000)
+	{
+		// a > 2^500.
+
+		a *= 0x1p-600;
+		b *= 0x1p-600;
+		scale = 0x1p600;
+	}
+	else if (high_b < 0x20B00000)
+	{
+		// b < 2^-500.
+
+		a *= 0x1p600;
+		b *= 0x1p600;
+		scale = 0x1p-600;
+	}
+
+	// h = √(a^2 + b^2), corrected by one Newton step with the exact
+	// residual a^2 + b^2 - h^2.
+
+	f64 a_error = 0;
+	f64 b_error = 0;
+	f64 h_error = 0;
+	f64 a_square = detail::two_product(a, a, a_error);
+	f64 b_square = detail::two_product(b, b, b_error);
+	f64 h = sqrt(a_square + b_square);
+	f64 h_square = detail::two_product(h, h, h_error);
+	f64 residual = ((a_square - h_square) + b_square) + (a_error + b_error
+		- h_error);
+
+	return (h + residual / (2 * h)) * scale;
+}
 
 /**
  * Returns the hypothenuse of two floating point numbers.
- * TODO: Make constexpr.
+ *
+ * - Error: below 1 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
  */
-inline f32
+constexpr f32
 hypot(f32 x, f32 y)
 {
-	return hypot((f64) x, (f64) y);
+	SLAW_JS_MATH((f32) detail::js_hypot(x, y));
+
+	if (abs(x) == Infinity32 || abs(y) == Infinity32)
+	{
+		return Infinity32;
+	}
+
+	// The squares of f32 values are exact in f64, so the sum is rounded
+	// only once.
+
+	f64 a = x;
+	f64 b = y;
+	return (f32) sqrt(a * a + b * b);
 }
 
 }; // namespace slaw
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,295 @@
+#ifndef SLAW_MATH_TABLE_H
+#define SLAW_MATH_TABLE_H
+
+#include "types.hpp"
+#include "math.hpp"
+
+// Lookup tables generated at compile time, and approximations of sin, cos
+// and exp that start from the entries of such tables.
+//
+// Every function of math.hpp can be evaluated at compile time, so a table
+// declared `constexpr` is filled in by the compiler and lands in the data
+// segment of the module: no work at startup and no calls into JS. For
+// example, a gamma correction table:
+//
+//     constexpr auto gamma = slaw::make_table<u8, 256>([](usize i)
+//     {
+//         return (u8) slaw::round(255 * slaw::pow(i / 255.0, 1 / 2.2));
+//     });
+//
+// Compilers limit the number of steps of a compile time evaluation. Clang
+// allows about a million by default, enough for a few thousand entries of
+// a transcendental function; `-fconstexpr-steps` raises the limit.
+
+namespace slaw
+{
+/**
+ * A fixed-size table of values, which can be generated at compile time.
+ */
+template <typename T, usize N>
+struct Table
+{
+	static constexpr usize size = N;
+
+	T values[N];
+
+	constexpr const T &
+	operator[](usize i) const
+	{
+		return values[i];
+	}
+};
+
+/**
+ * Returns a table whose `i`-th entry is `f(i)`.
+ *
+ * - Time complexity: O(n), where n is the size of the table.
+ * - Space complexity: O(n).
+ */
+template <typename T, usize N, typename F>
+constexpr Table<T, N>
+make_table(F f)
+{
+	Table<T, N> table = {};
+
+	for (usize i = 0; i < N; i++)
+	{
+		table.values[i] = f(i);
+	}
+
+	return table;
+}
+
+/**
+ * Returns a table of `f` at N evenly spaced points of [low, high], both
+ * included.
+ *
+ * - Time complexity: O(n), where n is the size of the table.
+ * - Space complexity: O(n).
+ */
+template <typename T, usize N, typename F>
+constexpr Table<T, N>
+sample_table(F f, f64 low, f64 high)
+{
+	static_assert(N >= 2, "A sampled table needs at least two points.");
+
+	return make_table<T, N>([&](usize i)
+	{
+		return (T) f(low + (high - low) * i / (N - 1));
+	});
+}
+
+/**
+ * Linearly interpolates a table made by `sample_table()` over [low, high]
+ * at `x`. Arguments outside [low, high] are clamped to it.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <typename T, usize N>
+constexpr f64
+interpolate(const Table<T, N> &table, f64 low, f64 high, f64 x)
+{
+	f64 position = (x - low) * ((N - 1) / (high - low));
+	position = min(max(position, 0.0), (f64) (N - 1));
+
+	usize i = min((usize) position, N - 2);
+	f64 t = position - i;
+
+	return table[i] + ((f64) table[i + 1] - table[i]) * t;
+}
+
+namespace detail
+{
+// sin(2π i / SIN_TABLE_SIZE). The cosines are the same entries, a quarter
+// of the table further.
+constexpr const usize SIN_TABLE_SIZE = 256;
+
+constexpr const Table<f64, SIN_TABLE_SIZE> SIN_TABLE =
+	make_table<f64, SIN_TABLE_SIZE>([](usize i)
+	{
+		return sin(TWO_PI * i / SIN_TABLE_SIZE);
+	});
+
+// 2^(i / EXP_TABLE_SIZE).
+constexpr const usize EXP_TABLE_SIZE = 64;
+
+constexpr const Table<f64, EXP_TABLE_SIZE> EXP_TABLE =
+	make_table<f64, EXP_TABLE_SIZE>([](usize i)
+	{
+		return pow(2.0, (f64) i / EXP_TABLE_SIZE);
+	});
+
+/**
+ * Computes sin(x) if `cosine` is false, or cos(x) otherwise, for
+ * non-negative x below 2^20.
+ */
+constexpr f64
+table_sin_cos(f64 x, bool cosine)
+{
+	// x = 2π (k + t) / SIN_TABLE_SIZE, with an integer k and t in [0, 1).
+	// Then sin(x) = sin(a) cos(d) + cos(a) sin(d), where a = 2π k / size
+	// is looked up in the table and d = 2π t / size is below 0.025, so
+	// short Taylor series of sin(d) and cos(d) are accurate to 1e-15.
+
+	constexpr usize mask = SIN_TABLE_SIZE - 1;
+	constexpr usize quarter = SIN_TABLE_SIZE / 4;
+
+	f64 r = x * (SIN_TABLE_SIZE / TWO_PI);
+	f64 k = floor(r);
+	f64 d = (r - k) * (TWO_PI / SIN_TABLE_SIZE);
+	f64 d2 = d * d;
+
+	f64 sin_d = d - d * d2 * (1.0 / 6 - d2 * (1.0 / 120));
+	f64 cos_d = 1 - d2 * (0.5 - d2 * (1.0 / 24 - d2 * (1.0 / 720)));
+
+	usize i = (usize) k + (cosine ? quarter : 0);
+	f64 sin_a = SIN_TABLE[i & mask];
+	f64 cos_a = SIN_TABLE[(i + quarter) & mask];
+
+	return sin_a * cos_d + cos_a * sin_d;
+}
+}; // namespace slaw::detail
+
+/**
+ * Returns an approximation of the sine of a number.
+ * The number is split into a multiple of 2π / 256, whose sine and cosine
+ * are looked up in a 256-entry table, and a remainder below 0.025, whose
+ * sine and cosine are short Taylor series. The angle addition formula
+ * combines the two.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 2.5e-15 absolute for |x| < 10. Rounding the split of the
+ *   number adds about 1.5e-16 |x|, to 1.6e-10 at 2^20. Larger arguments,
+ *   infinities and NaNs are passed on to `sin()`.
+ */
+constexpr f64
+fast_sin(f64 value)
+{
+	f64 x = abs(value);
+
+	if (!(x < 0x1p20))
+	{
+		return sin(value);
+	}
+
+	// The sign is copied with bit operations, since a branch on it would be
+	// mispredicted for random arguments.
+
+	u64 sign = detail::interpret_float_as_int(value) & 0x8000000000000000;
+	f64 result = detail::table_sin_cos(x, false);
+	return detail::interpret_int_as_float(
+		(i64) (detail::interpret_float_as_int(result) ^ sign));
+}
+
+/**
+ * Returns an approximation of the sine of a number, computed by the f64
+ * `fast_sin()` and rounded.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 0.51 ULP for results above 1e-3 and |x| < 1e4, and 1.7 ULP
+ *   for |x| up to 2^20. Smaller results have the absolute error of the
+ *   f64 version.
+ */
+constexpr f32
+fast_sin(f32 value)
+{
+	return (f32) fast_sin((f64) value);
+}
+
+/**
+ * Returns an approximation of the cosine of a number, by the same table
+ * lookup and angle addition as `fast_sin()`, a quarter of the table
+ * further.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 2.5e-15 absolute for |x| < 10. Rounding the split of the
+ *   number adds about 1.5e-16 |x|, to 1.6e-10 at 2^20. Larger arguments,
+ *   infinities and NaNs are passed on to `cos()`.
+ */
+constexpr f64
+fast_cos(f64 value)
+{
+	f64 x = abs(value);
+
+	if (!(x < 0x1p20))
+	{
+		return cos(value);
+	}
+
+	return detail::table_sin_cos(x, true);
+}
+
+/**
+ * Returns an approximation of the cosine of a number, computed by the f64
+ * `fast_cos()` and rounded.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 0.51 ULP for results above 1e-3 and |x| < 1e4, and 1.7 ULP
+ *   for |x| up to 2^20. Smaller results have the absolute error of the
+ *   f64 version.
+ */
+constexpr f32
+fast_cos(f32 value)
+{
+	return (f32) fast_cos((f64) value);
+}
+
+/**
+ * Returns an approximation of e raised to the power of a number, from a
+ * 64-entry table of powers of two.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 5e-14 relative, for x in (-708, 709.7). Other arguments, whose
+ *   results overflow or are subnormal, are passed on to `exp()`.
+ */
+constexpr f64
+fast_exp(f64 value)
+{
+	if (!(value > -708 && value < 709.7))
+	{
+		return exp(value);
+	}
+
+	// e^x = 2^(n / size) e^r, with an integer n and |r| <= ln(2) / 2size.
+	// 2^(n / size) is 2^(n / size rounded down) times a table entry. The
+	// high part of ln(2) has trailing zeros, so n times it is exact.
+
+	constexpr i64 size = detail::EXP_TABLE_SIZE;
+	constexpr f64 ln2_hi = 6.93147180369123816490e-01 / size;
+	constexpr f64 ln2_lo = 1.90821492927058770002e-10 / size;
+
+	f64 k = floor(value * (size / LN_2) + 0.5);
+	f64 r = (value - k * ln2_hi) - k * ln2_lo;
+	f64 p = 1 + r * (1 + r * (0.5 + r * (1.0 / 6 + r * (1.0 / 24))));
+
+	i64 n = (i64) k;
+	i64 i = n & (size - 1);
+	i64 exponent = (n - i) / size;
+	f64 scale = detail::interpret_int_as_float((exponent + 1023) << 52);
+
+	return detail::EXP_TABLE[i] * p * scale;
+}
+
+/**
+ * Returns an approximation of e raised to the power of a number, from a
+ * 64-entry table of powers of two.
+ *
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ * - Error: 1 ULP, for results that are normal numbers. Other arguments are
+ *   passed on to `exp()`.
+ */
+constexpr f32
+fast_exp(f32 value)
+{
+	return (f32) fast_exp((f64) value);
+}
+}; // namespace slaw
+
+#endif
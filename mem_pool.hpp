@@ -0,0 +1,175 @@
+#ifndef SLAW_MEM_POOL_H
+#define SLAW_MEM_POOL_H
+
+#include "types.hpp"
+#include "mem.hpp"
+#include "util.hpp"
+
+namespace slaw::mem
+{
+/**
+ * Pool of fixed-size memory slots for objects of type `T`.
+ *
+ * Slots are carved out of chunks that each hold `ChunkSize` objects, so
+ * allocating many small objects costs one heap allocation per chunk instead
+ * of one per object. Freed slots are kept in an intrusive free list and
+ * reused by the next allocation, in O(1). All chunks are returned to the
+ * heap at once when the pool is cleared or destroyed.
+ *
+ * The pool hands out uninitialised memory and never runs constructors or
+ * destructors, so it is meant for trivially destructible types that are
+ * initialised by assignment.
+ */
+template <typename T, usize ChunkSize = 64>
+struct Pool
+{
+	/**
+	 * A slot that is not in use. Its first bytes link to the next free slot.
+	 */
+	struct FreeSlot
+	{
+		FreeSlot *next;
+	};
+
+	/**
+	 * The header at the start of each chunk, linking all chunks together.
+	 */
+	struct Chunk
+	{
+		Chunk *next;
+	};
+
+	// The size of a slot. Slots must be able to hold a free list link,
+	// and are rounded up to 8 bytes to keep every slot aligned.
+	static const constexpr usize slot_size =
+		((sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot))
+			+ 7) & ~(usize) 7;
+
+	// The offset of the first slot in a chunk.
+	static const constexpr usize chunk_header_size = 16;
+
+	// The most recently allocated chunk.
+	Chunk *chunks = nullptr;
+
+	// The first slot of the free list.
+	FreeSlot *free_slots = nullptr;
+
+	// The number of slots that are currently handed out.
+	usize allocated = 0;
+
+	Pool() {}
+
+	Pool(const Pool &) = delete;
+
+	Pool &
+	operator=(const Pool &) = delete;
+
+	/**
+	 * Constructs a pool by taking over the chunks of another pool.
+	 * The other pool will be emptied.
+	 */
+	Pool(Pool &&source)
+		: chunks(source.chunks), free_slots(source.free_slots),
+		  allocated(source.allocated)
+	{
+		source.chunks = nullptr;
+		source.free_slots = nullptr;
+		source.allocated = 0;
+	}
+
+	/**
+	 * Returns all chunks to the heap.
+	 */
+	~Pool()
+	{
+		clear();
+	}
+
+	/**
+	 * Returns an uninitialised slot for an object of type `T`.
+	 *
+	 * - Time complexity: O(1) on average.
+	 * - Space complexity: O(1) on average.
+	 */
+	T *
+	alloc()
+	{
+		if (free_slots == nullptr)
+		{
+			grow();
+		}
+
+		FreeSlot *slot = free_slots;
+		free_slots = slot->next;
+		allocated++;
+
+		return (T *) slot;
+	}
+
+	/**
+	 * Puts a slot back on the free list. The object in it is not destroyed.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the slot was not handed out by this pool, or has already
+	 * been freed, BEHAVIOUR IS UNDEFINED.
+	 */
+	void
+	free(T *ptr)
+	{
+		FreeSlot *slot = (FreeSlot *) ptr;
+		slot->next = free_slots;
+		free_slots = slot;
+		allocated--;
+	}
+
+	/**
+	 * Returns all chunks to the heap. All slots handed out by this pool
+	 * become invalid.
+	 *
+	 * - Time complexity: O(c), where c is the number of chunks.
+	 * - Space complexity: O(1).
+	 */
+	void
+	clear()
+	{
+		while (chunks != nullptr)
+		{
+			Chunk *next = chunks->next;
+			delete[] (u8 *) chunks;
+			chunks = next;
+		}
+
+		free_slots = nullptr;
+		allocated = 0;
+	}
+
+	/**
+	 * Allocates a new chunk and puts all of its slots on the free list.
+	 */
+	void
+	grow()
+	{
+		u8 *memory = new u8[chunk_header_size + ChunkSize * slot_size];
+
+		Chunk *chunk = (Chunk *) memory;
+		chunk->next = chunks;
+		chunks = chunk;
+
+		// Link the slots in address order, so consecutive allocations
+		// are next to each other in memory.
+
+		u8 *first = memory + chunk_header_size;
+
+		for (usize i = ChunkSize; i-- > 0;)
+		{
+			FreeSlot *slot = (FreeSlot *) (first + i * slot_size);
+			slot->next = free_slots;
+			free_slots = slot;
+		}
+	}
+};
+}; // namespace slaw::mem
+
+#endif
\ No newline at end of file
@@ -0,0 +1,469 @@
+#ifndef SLAW_MULTI_SEARCH_H
+#define SLAW_MULTI_SEARCH_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+/**
+ * Searches a text for many patterns at once.
+ * The patterns are compiled once, after which each search finds all
+ * occurrences of all patterns in a single pass over the text, instead of
+ * one pass per pattern.
+ *
+ * Two engines are used, depending on the number of patterns:
+ *
+ * - Up to 8 patterns are searched with a Teddy-style prefilter. Each pattern
+ *   gets its own bit. For each of the first (at most 3) bytes of the
+ *   patterns, two 16-entry tables map the low and high nibble of a text byte
+ *   to the set of patterns that have a byte with that nibble at that
+ *   position. Looking up 16 text bytes takes one swizzle per table, and
+ *   ANDing the results leaves, for each position, the patterns whose prefix
+ *   might start there. Only those are compared in full.
+ *
+ * - More patterns are searched with an Aho-Corasick automaton. The automaton
+ *   is stored as a flat transition table, indexed by state and byte class.
+ *   Bytes that do not occur in any pattern share a single class, which
+ *   keeps the table small. Each text byte costs one table lookup.
+ *
+ * All occurrences are reported, including overlapping ones. Empty patterns
+ * never match. If a pattern occurs more than once in the pattern list,
+ * its matches are only reported for its first index.
+ */
+struct MultiSearcher
+{
+	/**
+	 * An occurrence of a pattern in the text.
+	 */
+	struct Match
+	{
+		// The index of the pattern in the pattern list.
+		usize pattern;
+
+		// The index in the text at which the occurrence starts.
+		usize start;
+	};
+
+	// The maximum number of patterns searched with the Teddy prefilter.
+	static const constexpr usize max_teddy_patterns = 8;
+
+	// The patterns that are searched for.
+	Vector<String> patterns;
+
+	// Whether the Teddy prefilter is used instead of Aho-Corasick.
+	bool use_teddy;
+
+	// The number of leading bytes of each pattern that the Teddy
+	// prefilter looks at.
+	usize teddy_prefix_size = 0;
+
+	// The Teddy nibble tables. Entry `2 * k` holds the table for the low
+	// nibbles of byte `k` of the patterns, entry `2 * k + 1` the table for
+	// the high nibbles.
+	u8x16 teddy_masks[6];
+
+	// Maps each byte to its class in the Aho-Corasick automaton. There
+	// are up to 257 classes: one for each byte that occurs in a pattern,
+	// and class 0 for the bytes that do not.
+	u16 byte_classes[256];
+
+	// The number of byte classes.
+	usize class_count = 0;
+
+	// The transition table of the automaton. The next state after reading
+	// a byte of class `c` in state `s` is `transitions[s * class_count + c]`.
+	// State 0 is the start state.
+	Vector<u32> transitions;
+
+	// For each state, the index of the pattern that ends in that state,
+	// or -1 if no pattern ends there.
+	Vector<isize> state_pattern;
+
+	// For each state, the closest state on its chain of failure links in
+	// which a pattern ends, or 0 if there is none.
+	Vector<u32> output_links;
+
+	/**
+	 * Compiles a list of patterns.
+	 *
+	 * - Time complexity: O(m * k), where m is the total length of the
+	 *   patterns and k is the number of distinct bytes in them.
+	 * - Space complexity: O(m * k).
+	 */
+	MultiSearcher(const Vector<String> &patterns)
+		: patterns(patterns),
+		  use_teddy(patterns.size <= max_teddy_patterns)
+	{
+		if (use_teddy)
+		{
+			build_teddy();
+		}
+		else
+		{
+			build_automaton();
+		}
+	}
+
+	/**
+	 * Finds all occurrences of all patterns in a text and appends them to
+	 * a vector. Reusing the vector between searches avoids allocations.
+	 * Matches are appended in the order in which the single pass over the
+	 * text finds them.
+	 *
+	 * - Time complexity: O(n + z), where z is the number of matches.
+	 * - Space complexity: O(z).
+	 */
+	void
+	find_all(StringView text, Vector<Match> &out)
+	const
+	{
+		if (use_teddy)
+		{
+			find_all_teddy(text, out);
+		}
+		else
+		{
+			find_all_automaton(text, out);
+		}
+	}
+
+	/**
+	 * Finds all occurrences of all patterns in a text.
+	 *
+	 * - Time complexity: O(n + z), where z is the number of matches.
+	 * - Space complexity: O(z).
+	 */
+	Vector<Match>
+	find_all(StringView text)
+	const
+	{
+		Vector<Match> out;
+		find_all(text, out);
+		return out;
+	}
+
+	/**
+	 * Checks if pattern `p` occurs in the text at a given index.
+	 */
+	bool
+	matches_at(StringView text, usize p, usize start)
+	const
+	{
+		const String &pattern = patterns[p];
+
+		if (pattern.size == 0 || start + pattern.size > text.size)
+		{
+			return false;
+		}
+
+		for (usize i = 0; i < pattern.size; i++)
+		{
+			if (text[start + i] != pattern[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Checks if pattern `p` is the first occurrence of its contents in the
+	 * pattern list.
+	 */
+	bool
+	is_first_occurrence(usize p)
+	const
+	{
+		for (usize q = 0; q < p; q++)
+		{
+			if (patterns[q] == patterns[p])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Builds the nibble tables of the Teddy prefilter.
+	 */
+	void
+	build_teddy()
+	{
+		// The prefilter can only look at bytes that all patterns have.
+
+		teddy_prefix_size = 3;
+
+		for (usize p = 0; p < patterns.size; p++)
+		{
+			if (patterns[p].size > 0)
+			{
+				teddy_prefix_size = min(teddy_prefix_size,
+					patterns[p].size);
+			}
+		}
+
+		for (usize k = 0; k < 6; k++)
+		{
+			teddy_masks[k] = (u8x16) {};
+		}
+
+		for (usize p = 0; p < patterns.size; p++)
+		{
+			if (patterns[p].size == 0 || !is_first_occurrence(p))
+			{
+				continue;
+			}
+
+			for (usize k = 0; k < teddy_prefix_size; k++)
+			{
+				u8 byte = patterns[p][k];
+
+				teddy_masks[2 * k][byte & 0x0F] |= 1 << p;
+				teddy_masks[2 * k + 1][byte >> 4] |= 1 << p;
+			}
+		}
+	}
+
+	/**
+	 * Searches a text using the Teddy prefilter.
+	 */
+	void
+	find_all_teddy(StringView text, Vector<Match> &out)
+	const
+	{
+		if (teddy_prefix_size == 0)
+		{
+			// All patterns are empty.
+
+			return;
+		}
+
+		usize i = 0;
+		usize last = teddy_prefix_size - 1;
+
+		// Each block looks at 16 starting positions, and needs the
+		// prefix bytes of the last one.
+
+		for (; i + 16 + last <= text.size; i += 16)
+		{
+			u8x16 candidates = simd::splat<u8x16>(0xFF);
+
+			for (usize k = 0; k < teddy_prefix_size; k++)
+			{
+				u8x16 v = simd::load<u8x16>(text.data + i + k);
+
+				candidates &= simd::swizzle(teddy_masks[2 * k],
+					v & 0x0F);
+				candidates &= simd::swizzle(teddy_masks[2 * k + 1],
+					v >> 4);
+			}
+
+			u32 positions = ~simd::bitmask((u8x16) (candidates
+				== simd::splat<u8x16>(0))) & 0xFFFF;
+
+			while (positions)
+			{
+				usize j = ctz(positions);
+				positions &= positions - 1;
+
+				u32 bucket = candidates[j];
+
+				while (bucket)
+				{
+					usize p = ctz(bucket);
+					bucket &= bucket - 1;
+
+					if (matches_at(text, p, i + j))
+					{
+						out.push_back({ p, i + j });
+					}
+				}
+			}
+		}
+
+		// Check the remaining positions one by one.
+
+		for (; i < text.size; i++)
+		{
+			for (usize p = 0; p < patterns.size; p++)
+			{
+				if (matches_at(text, p, i) && is_first_occurrence(p))
+				{
+					out.push_back({ p, i });
+				}
+			}
+		}
+	}
+
+	/**
+	 * Builds the Aho-Corasick automaton.
+	 */
+	void
+	build_automaton()
+	{
+		// Give every byte that occurs in a pattern its own class.
+		// All other bytes share class 0.
+
+		for (usize b = 0; b < 256; b++)
+		{
+			byte_classes[b] = 0;
+		}
+
+		usize max_states = 1;
+		class_count = 1;
+
+		for (usize p = 0; p < patterns.size; p++)
+		{
+			max_states += patterns[p].size;
+
+			for (usize i = 0; i < patterns[p].size; i++)
+			{
+				u8 byte = patterns[p][i];
+
+				if (byte_classes[byte] == 0)
+				{
+					byte_classes[byte] = class_count++;
+				}
+			}
+		}
+
+		// Allocate the tables. Transition 0 means that there is no edge
+		// in the trie yet. No trie edge points back to the start state,
+		// so this is unambiguous while building the trie.
+
+		transitions = Vector<u32>(max_states * class_count);
+		transitions.size = max_states * class_count;
+		state_pattern = Vector<isize>(max_states);
+		state_pattern.size = max_states;
+		output_links = Vector<u32>(max_states);
+		output_links.size = max_states;
+
+		for (usize i = 0; i < transitions.size; i++)
+		{
+			transitions[i] = 0;
+		}
+
+		for (usize s = 0; s < max_states; s++)
+		{
+			state_pattern[s] = -1;
+			output_links[s] = 0;
+		}
+
+		// Insert the patterns into the trie.
+
+		usize state_count = 1;
+
+		for (usize p = 0; p < patterns.size; p++)
+		{
+			if (patterns[p].size == 0)
+			{
+				continue;
+			}
+
+			u32 state = 0;
+
+			for (usize i = 0; i < patterns[p].size; i++)
+			{
+				u32 &next = transitions[state * class_count
+					+ byte_classes[(u8) patterns[p][i]]];
+
+				if (next == 0)
+				{
+					next = state_count++;
+				}
+
+				state = next;
+			}
+
+			if (state_pattern[state] == -1)
+			{
+				state_pattern[state] = p;
+			}
+		}
+
+		// Compute the failure links in breadth-first order and turn the
+		// trie into a complete automaton, by replacing each missing edge
+		// with the edge of the failure state. States are visited in
+		// order of depth, so the failure state is always complete before
+		// it is used.
+
+		Vector<u32> failure(state_count);
+		failure.size = state_count;
+		Vector<u32> queue(state_count);
+		usize head = 0;
+
+		for (usize c = 0; c < class_count; c++)
+		{
+			u32 child = transitions[c];
+
+			if (child != 0)
+			{
+				failure[child] = 0;
+				queue.push_back(child);
+			}
+		}
+
+		while (head < queue.size)
+		{
+			u32 state = queue[head++];
+
+			for (usize c = 0; c < class_count; c++)
+			{
+				u32 &next = transitions[state * class_count + c];
+				u32 fallback = transitions[failure[state]
+					* class_count + c];
+
+				if (next == 0)
+				{
+					next = fallback;
+					continue;
+				}
+
+				failure[next] = fallback;
+				output_links[next] = state_pattern[fallback] != -1
+					? fallback : output_links[fallback];
+				queue.push_back(next);
+			}
+		}
+	}
+
+	/**
+	 * Searches a text using the Aho-Corasick automaton.
+	 */
+	void
+	find_all_automaton(StringView text, Vector<Match> &out)
+	const
+	{
+		u32 state = 0;
+
+		for (usize i = 0; i < text.size; i++)
+		{
+			state = transitions[state * class_count
+				+ byte_classes[(u8) text[i]]];
+
+			// Report the pattern that ends in this state, and the
+			// patterns that end in its failure states.
+
+			u32 output = state_pattern[state] != -1
+				? state : output_links[state];
+
+			while (output != 0)
+			{
+				usize p = state_pattern[output];
+				out.push_back({ p, i + 1 - patterns[p].size });
+				output = output_links[output];
+			}
+		}
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,950 @@
+#ifndef SLAW_RADIX_TREE_H
+#define SLAW_RADIX_TREE_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+#include "mem_pool.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+/**
+ * Adaptive radix tree that maps byte string keys to values of type `V`.
+ *
+ * Every inner node branches on one byte of the key. To keep the tree small,
+ * inner nodes come in four sizes and grow into the next size when they are
+ * full:
+ *
+ * - `Node4` and `Node16` hold up to 4 or 16 children in sorted arrays of
+ *   key bytes. A `Node16` is searched with a single `u8x16` comparison.
+ * - `Node48` holds up to 48 children, with a 256-entry table that maps each
+ *   byte to the slot of its child.
+ * - `Node256` holds a child for every possible byte.
+ *
+ * Chains of nodes with a single child are collapsed into a prefix that is
+ * stored in the node below them (path compression). Only the first
+ * `max_prefix_size` bytes of a prefix are stored, the rest are read from a
+ * key below the node when needed. A key that has no siblings below some
+ * node is stored as a leaf directly in that node (lazy expansion).
+ *
+ * The nodes are allocated from one `slaw::mem::Pool` per node size, and the
+ * entries are stored in a vector, so building a tree of many keys makes
+ * very few heap allocations.
+ *
+ * Children are referenced by a tagged pointer-sized integer: node pointers
+ * are stored as they are, entries as their index shifted left by one with
+ * the lowest bit set. Zero means that there is no child.
+ */
+template <typename V>
+struct RadixTree
+{
+	/**
+	 * A key and its value.
+	 */
+	struct Entry
+	{
+		String key;
+		V value;
+	};
+
+	// The number of prefix bytes that are stored in a node.
+	static const constexpr usize max_prefix_size = 8;
+
+	// A reference to a node or an entry, or 0 if there is none.
+	// This is a pointer-sized integer, so it can hold a node pointer.
+	using Ref = __UINTPTR_TYPE__;
+
+	/**
+	 * The types of inner nodes.
+	 */
+	enum class NodeType : u8
+	{
+		Node4,
+		Node16,
+		Node48,
+		Node256
+	};
+
+	/**
+	 * The fields that all inner nodes start with.
+	 */
+	struct Node
+	{
+		NodeType type;
+
+		// The number of children.
+		u16 child_count;
+
+		// The size of the compressed prefix.
+		u32 prefix_size;
+
+		// The first bytes of the compressed prefix.
+		u8 prefix[max_prefix_size];
+
+		// The entry whose key ends at this node, after the prefix.
+		Ref end;
+	};
+
+	struct Node4
+	{
+		Node header;
+		u8 keys[4];
+		Ref children[4];
+	};
+
+	struct Node16
+	{
+		Node header;
+		u8 keys[16];
+		Ref children[16];
+	};
+
+	struct Node48
+	{
+		Node header;
+
+		// The slot of the child for each byte, plus one, or 0 if there
+		// is no child.
+		u8 child_index[256];
+		Ref children[48];
+	};
+
+	struct Node256
+	{
+		Node header;
+		Ref children[256];
+	};
+
+	// The entries of the tree, in insertion order.
+	Vector<Entry> entries;
+
+	// The root of the tree.
+	Ref root = 0;
+
+	// The node pools.
+	mem::Pool<Node4> node4_pool;
+	mem::Pool<Node16> node16_pool;
+	mem::Pool<Node48, 16> node48_pool;
+	mem::Pool<Node256, 4> node256_pool;
+
+	RadixTree() {}
+
+	RadixTree(const RadixTree &) = delete;
+
+	RadixTree &
+	operator=(const RadixTree &) = delete;
+
+	/**
+	 * Returns the number of keys in the tree.
+	 */
+	usize
+	size()
+	const
+	{
+		return entries.size;
+	}
+
+	/**
+	 * Inserts a key with a value, or replaces the value if the key is
+	 * already in the tree.
+	 * Returns true if the key was not in the tree yet.
+	 *
+	 * - Time complexity: O(k), where k is the size of the key.
+	 * - Space complexity: O(k).
+	 */
+	bool
+	insert(StringView key, const V &value)
+	{
+		return insert(root, key, 0, value);
+	}
+
+	/**
+	 * Returns a pointer to the value of a key, or nullptr if the key is
+	 * not in the tree.
+	 *
+	 * - Time complexity: O(k), where k is the size of the key.
+	 * - Space complexity: O(1).
+	 */
+	V *
+	find(StringView key)
+	{
+		Ref ref = root;
+		usize depth = 0;
+
+		while (ref != 0 && !is_entry(ref))
+		{
+			Node *node = (Node *) ref;
+
+			// Only the stored part of the prefix is checked here.
+			// The entry at the end is compared in full.
+
+			if (stored_prefix_mismatch(node, key, depth)
+				< min(node->prefix_size, (u32) max_prefix_size))
+			{
+				return nullptr;
+			}
+
+			depth += node->prefix_size;
+
+			if (depth >= key.size)
+			{
+				ref = depth == key.size ? node->end : 0;
+				break;
+			}
+
+			Ref *child = find_child(node, key[depth]);
+			ref = child != nullptr ? *child : 0;
+			depth++;
+		}
+
+		if (ref == 0 || StringView(entry(ref).key) != key)
+		{
+			return nullptr;
+		}
+
+		return &entry(ref).value;
+	}
+
+	/**
+	 * Checks if a key is in the tree.
+	 *
+	 * - Time complexity: O(k), where k is the size of the key.
+	 * - Space complexity: O(1).
+	 */
+	bool
+	contains(StringView key)
+	{
+		return find(key) != nullptr;
+	}
+
+	/**
+	 * Returns the entry with the longest key that is a prefix of a text,
+	 * or nullptr if no key is a prefix of the text.
+	 * This is the lookup used for routing tables.
+	 *
+	 * - Time complexity: O(k), where k is the size of the text.
+	 * - Space complexity: O(1).
+	 */
+	const Entry *
+	longest_prefix(StringView text)
+	const
+	{
+		const Entry *best = nullptr;
+		Ref ref = root;
+		usize depth = 0;
+
+		// Every entry on the path is a candidate. Since only the stored
+		// part of node prefixes is checked on the way down, candidates
+		// are verified against the text before they are accepted.
+
+		while (ref != 0 && !is_entry(ref))
+		{
+			const Node *node = (const Node *) ref;
+
+			if (stored_prefix_mismatch(node, text, depth)
+				< min(node->prefix_size, (u32) max_prefix_size))
+			{
+				break;
+			}
+
+			depth += node->prefix_size;
+
+			if (depth > text.size)
+			{
+				break;
+			}
+
+			if (node->end != 0
+				&& text.starts_with(entry(node->end).key))
+			{
+				best = &entry(node->end);
+			}
+
+			if (depth == text.size)
+			{
+				ref = 0;
+				break;
+			}
+
+			const Ref *child = find_child((Node *) node, text[depth]);
+			ref = child != nullptr ? *child : 0;
+			depth++;
+		}
+
+		if (ref != 0 && is_entry(ref) && text.starts_with(entry(ref).key))
+		{
+			best = &entry(ref);
+		}
+
+		return best;
+	}
+
+	/**
+	 * Calls a function for every entry whose key starts with a prefix,
+	 * in lexicographic order of the keys.
+	 * The function is called with a `const Entry &`.
+	 *
+	 * - Time complexity: O(p + m), where p is the size of the prefix and
+	 *   m is the size of the subtree of matching keys.
+	 * - Space complexity: O(h), where h is the height of that subtree.
+	 */
+	template <typename F>
+	void
+	for_each_with_prefix(StringView prefix, F f)
+	const
+	{
+		Ref ref = root;
+		usize depth = 0;
+
+		// Find the subtree in which all keys start with the prefix.
+
+		while (ref != 0 && !is_entry(ref) && depth < prefix.size)
+		{
+			const Node *node = (const Node *) ref;
+
+			if (stored_prefix_mismatch(node, prefix, depth)
+				< min(min((usize) node->prefix_size, max_prefix_size),
+					prefix.size - depth))
+			{
+				return;
+			}
+
+			depth += node->prefix_size;
+
+			if (depth >= prefix.size)
+			{
+				break;
+			}
+
+			const Ref *child = find_child((Node *) node, prefix[depth]);
+			ref = child != nullptr ? *child : 0;
+			depth++;
+		}
+
+		// All keys below the subtree share their first bytes, so if one
+		// of them starts with the prefix, they all do.
+
+		if (ref == 0 || !StringView(entry(minimum(ref)).key)
+			.starts_with(prefix))
+		{
+			return;
+		}
+
+		for_each(ref, f);
+	}
+
+	/**
+	 * Calls a function for every entry in the tree, in lexicographic order
+	 * of the keys.
+	 * The function is called with a `const Entry &`.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(h), where h is the height of the tree.
+	 */
+	template <typename F>
+	void
+	for_each(F f)
+	const
+	{
+		if (root != 0)
+		{
+			for_each(root, f);
+		}
+	}
+
+	/**
+	 * Checks if a reference points to an entry.
+	 */
+	static bool
+	is_entry(Ref ref)
+	{
+		return ref & 1;
+	}
+
+	/**
+	 * Returns the entry of a reference.
+	 */
+	Entry &
+	entry(Ref ref)
+	{
+		return entries[ref >> 1];
+	}
+
+	/**
+	 * Returns the entry of a reference.
+	 */
+	const Entry &
+	entry(Ref ref)
+	const
+	{
+		return entries[ref >> 1];
+	}
+
+	/**
+	 * Adds a new entry and returns a reference to it.
+	 */
+	Ref
+	add_entry(StringView key, const V &value)
+	{
+		entries.push_back({ key.to_string(), value });
+		return ((entries.size - 1) << 1) | 1;
+	}
+
+	/**
+	 * Returns the entry with the smallest key below a reference.
+	 */
+	Ref
+	minimum(Ref ref)
+	const
+	{
+		while (!is_entry(ref))
+		{
+			const Node *node = (const Node *) ref;
+
+			if (node->end != 0)
+			{
+				return node->end;
+			}
+
+			switch (node->type)
+			{
+			case NodeType::Node4:
+				ref = ((const Node4 *) node)->children[0];
+				break;
+
+			case NodeType::Node16:
+				ref = ((const Node16 *) node)->children[0];
+				break;
+
+			case NodeType::Node48:
+			{
+				const Node48 *n = (const Node48 *) node;
+				usize b = 0;
+
+				while (n->child_index[b] == 0)
+				{
+					b++;
+				}
+
+				ref = n->children[n->child_index[b] - 1];
+				break;
+			}
+
+			case NodeType::Node256:
+			{
+				const Node256 *n = (const Node256 *) node;
+				usize b = 0;
+
+				while (n->children[b] == 0)
+				{
+					b++;
+				}
+
+				ref = n->children[b];
+				break;
+			}
+			}
+		}
+
+		return ref;
+	}
+
+	/**
+	 * Returns the number of leading bytes of the stored part of a node's
+	 * prefix that match a key, starting at a given depth.
+	 */
+	static usize
+	stored_prefix_mismatch(const Node *node, StringView key, usize depth)
+	{
+		usize limit = min(min((usize) node->prefix_size, max_prefix_size),
+			key.size - min(depth, key.size));
+		usize i = 0;
+
+		while (i < limit && node->prefix[i] == (u8) key[depth + i])
+		{
+			i++;
+		}
+
+		return i;
+	}
+
+	/**
+	 * Returns the number of leading bytes of the full prefix of a node
+	 * that match a key, starting at a given depth. Bytes beyond the stored
+	 * part are read from the smallest key below the node.
+	 */
+	usize
+	prefix_mismatch(const Node *node, StringView key, usize depth)
+	const
+	{
+		usize i = stored_prefix_mismatch(node, key, depth);
+
+		if (i < max_prefix_size || node->prefix_size <= max_prefix_size)
+		{
+			return i;
+		}
+
+		const String &other = entry(minimum((Ref) node)).key;
+		usize limit = min((usize) node->prefix_size, key.size - depth);
+
+		while (i < limit && other[depth + i] == key[depth + i])
+		{
+			i++;
+		}
+
+		return i;
+	}
+
+	/**
+	 * Returns a pointer to the child of a node for a given byte, or
+	 * nullptr if there is none.
+	 */
+	static Ref *
+	find_child(Node *node, u8 byte)
+	{
+		switch (node->type)
+		{
+		case NodeType::Node4:
+		{
+			Node4 *n = (Node4 *) node;
+
+			for (usize i = 0; i < node->child_count; i++)
+			{
+				if (n->keys[i] == byte)
+				{
+					return &n->children[i];
+				}
+			}
+
+			return nullptr;
+		}
+
+		case NodeType::Node16:
+		{
+			// Compare the byte against all 16 keys at once. Unused
+			// keys are masked out by the child count.
+
+			Node16 *n = (Node16 *) node;
+			u8x16 keys = simd::load<u8x16>(n->keys);
+			u32 found = simd::bitmask((u8x16) (keys
+				== simd::splat<u8x16>(byte)))
+				& ((1u << node->child_count) - 1);
+
+			return found ? &n->children[ctz(found)] : nullptr;
+		}
+
+		case NodeType::Node48:
+		{
+			Node48 *n = (Node48 *) node;
+			u8 index = n->child_index[byte];
+			return index ? &n->children[index - 1] : nullptr;
+		}
+
+		case NodeType::Node256:
+		{
+			Node256 *n = (Node256 *) node;
+			return n->children[byte] ? &n->children[byte] : nullptr;
+		}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Allocates an empty `Node4` with a given prefix.
+	 */
+	Node4 *
+	new_node4(const char *prefix, usize prefix_size)
+	{
+		Node4 *n = node4_pool.alloc();
+		*n = Node4();
+		n->header.type = NodeType::Node4;
+		n->header.prefix_size = prefix_size;
+
+		for (usize i = 0; i < min(prefix_size, max_prefix_size); i++)
+		{
+			n->header.prefix[i] = prefix[i];
+		}
+
+		return n;
+	}
+
+	/**
+	 * Adds a child to a node that does not have a child for the given byte
+	 * yet. If the node is full, it is replaced by a larger node, and the
+	 * reference to it is updated.
+	 */
+	void
+	add_child(Ref &ref, u8 byte, Ref child)
+	{
+		Node *node = (Node *) ref;
+
+		switch (node->type)
+		{
+		case NodeType::Node4:
+		{
+			Node4 *n = (Node4 *) node;
+
+			if (node->child_count == 4)
+			{
+				grow_node4(ref);
+				add_child(ref, byte, child);
+				return;
+			}
+
+			insert_sorted(n->keys, n->children, node->child_count,
+				byte, child);
+			return;
+		}
+
+		case NodeType::Node16:
+		{
+			Node16 *n = (Node16 *) node;
+
+			if (node->child_count == 16)
+			{
+				grow_node16(ref);
+				add_child(ref, byte, child);
+				return;
+			}
+
+			insert_sorted(n->keys, n->children, node->child_count,
+				byte, child);
+			return;
+		}
+
+		case NodeType::Node48:
+		{
+			Node48 *n = (Node48 *) node;
+
+			if (node->child_count == 48)
+			{
+				grow_node48(ref);
+				add_child(ref, byte, child);
+				return;
+			}
+
+			n->children[node->child_count] = child;
+			n->child_index[byte] = ++node->child_count;
+			return;
+		}
+
+		case NodeType::Node256:
+		{
+			Node256 *n = (Node256 *) node;
+			n->children[byte] = child;
+			node->child_count++;
+			return;
+		}
+		}
+	}
+
+	/**
+	 * Inserts a child into the sorted key and child arrays of a `Node4`
+	 * or `Node16`.
+	 */
+	static void
+	insert_sorted(u8 *keys, Ref *children, u16 &child_count, u8 byte,
+		Ref child)
+	{
+		usize i = child_count;
+
+		while (i > 0 && keys[i - 1] > byte)
+		{
+			keys[i] = keys[i - 1];
+			children[i] = children[i - 1];
+			i--;
+		}
+
+		keys[i] = byte;
+		children[i] = child;
+		child_count++;
+	}
+
+	/**
+	 * Replaces a full `Node4` with a `Node16`.
+	 */
+	void
+	grow_node4(Ref &ref)
+	{
+		Node4 *old = (Node4 *) ref;
+		Node16 *n = node16_pool.alloc();
+		*n = Node16();
+		n->header = old->header;
+		n->header.type = NodeType::Node16;
+
+		for (usize i = 0; i < 4; i++)
+		{
+			n->keys[i] = old->keys[i];
+			n->children[i] = old->children[i];
+		}
+
+		node4_pool.free(old);
+		ref = (Ref) n;
+	}
+
+	/**
+	 * Replaces a full `Node16` with a `Node48`.
+	 */
+	void
+	grow_node16(Ref &ref)
+	{
+		Node16 *old = (Node16 *) ref;
+		Node48 *n = node48_pool.alloc();
+		*n = Node48();
+		n->header = old->header;
+		n->header.type = NodeType::Node48;
+
+		for (usize i = 0; i < 16; i++)
+		{
+			n->children[i] = old->children[i];
+			n->child_index[old->keys[i]] = i + 1;
+		}
+
+		node16_pool.free(old);
+		ref = (Ref) n;
+	}
+
+	/**
+	 * Replaces a full `Node48` with a `Node256`.
+	 */
+	void
+	grow_node48(Ref &ref)
+	{
+		Node48 *old = (Node48 *) ref;
+		Node256 *n = node256_pool.alloc();
+		*n = Node256();
+		n->header = old->header;
+		n->header.type = NodeType::Node256;
+
+		for (usize b = 0; b < 256; b++)
+		{
+			if (old->child_index[b])
+			{
+				n->children[b] = old->children[old->child_index[b] - 1];
+			}
+		}
+
+		node48_pool.free(old);
+		ref = (Ref) n;
+	}
+
+	/**
+	 * Stores an entry in a node, either as the entry that ends at the node
+	 * or as the child for the next byte of its key.
+	 */
+	void
+	attach(Ref &ref, StringView key, usize depth, Ref child)
+	{
+		if (depth == key.size)
+		{
+			((Node *) ref)->end = child;
+		}
+		else
+		{
+			add_child(ref, key[depth], child);
+		}
+	}
+
+	/**
+	 * Inserts a key below a reference, at a given depth of the key.
+	 */
+	bool
+	insert(Ref &ref, StringView key, usize depth, const V &value)
+	{
+		if (ref == 0)
+		{
+			ref = add_entry(key, value);
+			return true;
+		}
+
+		if (is_entry(ref))
+		{
+			Entry &existing = entry(ref);
+
+			if (StringView(existing.key) == key)
+			{
+				existing.value = value;
+				return false;
+			}
+
+			// Split the leaf into a node holding the common part of
+			// both keys, with both entries below it.
+
+			StringView other = existing.key;
+			usize common = 0;
+
+			while (depth + common < key.size
+				&& depth + common < other.size
+				&& key[depth + common] == other[depth + common])
+			{
+				common++;
+			}
+
+			Ref old = ref;
+			ref = (Ref) new_node4(key.data + depth, common);
+			attach(ref, other, depth + common, old);
+			attach(ref, key, depth + common, add_entry(key, value));
+			return true;
+		}
+
+		Node *node = (Node *) ref;
+
+		if (node->prefix_size > 0)
+		{
+			usize match = prefix_mismatch(node, key, depth);
+
+			if (match < node->prefix_size)
+			{
+				split_prefix(ref, key, depth, match, value);
+				return true;
+			}
+
+			depth += node->prefix_size;
+		}
+
+		if (depth == key.size)
+		{
+			if (node->end != 0)
+			{
+				entry(node->end).value = value;
+				return false;
+			}
+
+			node->end = add_entry(key, value);
+			return true;
+		}
+
+		Ref *child = find_child(node, key[depth]);
+
+		if (child != nullptr)
+		{
+			return insert(*child, key, depth + 1, value);
+		}
+
+		add_child(ref, key[depth], add_entry(key, value));
+		return true;
+	}
+
+	/**
+	 * Splits the prefix of a node at the first byte that does not match a
+	 * new key. A new node holding the matching part of the prefix takes the
+	 * place of the node, with the node and the new key below it.
+	 */
+	void
+	split_prefix(Ref &ref, StringView key, usize depth, usize match,
+		const V &value)
+	{
+		Node *node = (Node *) ref;
+
+		// Bytes beyond the stored prefix are read from a key below the
+		// node, which has the full prefix.
+
+		StringView full = entry(minimum(ref)).key;
+		const char *prefix = full.data + depth;
+
+		Node4 *parent = new_node4(prefix, match);
+		Ref parent_ref = (Ref) parent;
+
+		// The node keeps the part of its prefix after the byte that now
+		// selects it in the parent.
+
+		u8 byte = prefix[match];
+		node->prefix_size -= match + 1;
+
+		for (usize i = 0; i < min((usize) node->prefix_size,
+			max_prefix_size); i++)
+		{
+			node->prefix[i] = prefix[match + 1 + i];
+		}
+
+		add_child(parent_ref, byte, ref);
+		attach(parent_ref, key, depth + match, add_entry(key, value));
+		ref = parent_ref;
+	}
+
+	/**
+	 * Calls a function for every entry below a reference, in order.
+	 */
+	template <typename F>
+	void
+	for_each(Ref ref, F &f)
+	const
+	{
+		if (is_entry(ref))
+		{
+			f(entry(ref));
+			return;
+		}
+
+		const Node *node = (const Node *) ref;
+
+		if (node->end != 0)
+		{
+			f(entry(node->end));
+		}
+
+		switch (node->type)
+		{
+		case NodeType::Node4:
+		{
+			const Node4 *n = (const Node4 *) node;
+
+			for (usize i = 0; i < node->child_count; i++)
+			{
+				for_each(n->children[i], f);
+			}
+
+			break;
+		}
+
+		case NodeType::Node16:
+		{
+			const Node16 *n = (const Node16 *) node;
+
+			for (usize i = 0; i < node->child_count; i++)
+			{
+				for_each(n->children[i], f);
+			}
+
+			break;
+		}
+
+		case NodeType::Node48:
+		{
+			const Node48 *n = (const Node48 *) node;
+
+			for (usize b = 0; b < 256; b++)
+			{
+				if (n->child_index[b])
+				{
+					for_each(n->children[n->child_index[b] - 1], f);
+				}
+			}
+
+			break;
+		}
+
+		case NodeType::Node256:
+		{
+			const Node256 *n = (const Node256 *) node;
+
+			for (usize b = 0; b < 256; b++)
+			{
+				if (n->children[b])
+				{
+					for_each(n->children[b], f);
+				}
+			}
+
+			break;
+		}
+		}
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,1067 @@
+#ifndef SLAW_REGEX_H
+#define SLAW_REGEX_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * The kinds of nodes in a compiled regular expression.
+ */
+enum class RegexNodeKind
+{
+	// Matches a single given character.
+	Char,
+
+	// Matches a single character from a set of characters.
+	Class,
+
+	// Matches any single character.
+	Any,
+
+	// Matches the empty string at the start of the text (`^`).
+	Start,
+
+	// Matches the empty string at the end of the text (`$`).
+	End,
+
+	// Matches its child and records the span as a capture group.
+	Group,
+
+	// Matches one of its branches. The branches are a linked list of
+	// `Branch` nodes, starting at the child.
+	Alternation,
+
+	// One branch of an alternation. The child is the first node of the
+	// branch, or -1 if the branch is empty.
+	Branch,
+
+	// Matches its child a number of times.
+	Repeat
+};
+
+/**
+ * A node of a compiled regular expression.
+ * Nodes that follow each other form a sequence, which is a linked list
+ * through the `next` indices. A sequence ends at index -1.
+ */
+struct RegexNode
+{
+	RegexNodeKind kind = RegexNodeKind::Char;
+
+	// The character matched by `Char` nodes.
+	char c = 0;
+
+	// The set of characters matched by `Class` nodes. Bit `c % 64` of
+	// entry `c / 64` is set if the (unsigned) character `c` is in the set.
+	u64 set[4] = {};
+
+	// The first node of the child sequence of `Group`, `Repeat` and
+	// `Branch` nodes, or the first branch of `Alternation` nodes.
+	i32 child = -1;
+
+	// The next node in the sequence.
+	i32 next = -1;
+
+	// The next branch of a `Branch` node.
+	i32 alt = -1;
+
+	// The index of the capture group of `Group` nodes.
+	usize group = 0;
+
+	// The minimum and maximum number of repetitions of `Repeat` nodes.
+	usize min = 0;
+	usize max = 0;
+
+	// Whether a `Repeat` node matches as few repetitions as possible.
+	bool lazy = false;
+};
+
+/**
+ * A compiled regular expression.
+ * Holds at most `Capacity` nodes.
+ */
+template <usize Capacity>
+struct RegexProgram
+{
+	RegexNode nodes[Capacity] = {};
+
+	// The number of nodes in use.
+	usize node_count = 0;
+
+	// The first node of the expression.
+	i32 root = -1;
+
+	// The number of capture groups, not counting the implicit group 0
+	// that spans the entire match.
+	usize group_count = 0;
+};
+
+/**
+ * Reports a syntax error in a regular expression.
+ * This function is deliberately not `constexpr`. Calling it while compiling
+ * a regular expression at compile time is therefore a compile error, which
+ * shows the message in the compiler output.
+ */
+inline void
+regex_syntax_error(const char *message)
+{
+	(void) message;
+}
+
+/**
+ * Returns an upper bound for the number of nodes that a pattern compiles
+ * into. Every character creates at most one node, except for alternations
+ * and quantifiers, which create at most two.
+ */
+constexpr usize
+regex_capacity(const char *pattern)
+{
+	usize size = 0;
+
+	while (pattern[size] != '\0')
+	{
+		size++;
+	}
+
+	return size * 2 + 2;
+}
+
+/**
+ * Adds a character or a range of characters to a character set.
+ */
+constexpr void
+regex_set_add(u64 (&set)[4], u8 first, u8 last)
+{
+	for (usize c = first; c <= last; c++)
+	{
+		set[c / 64] |= (u64) 1 << (c % 64);
+	}
+}
+
+/**
+ * Adds the characters of a class escape (`\d`, `\w` or `\s`) to a set.
+ * Returns false if the character is not a class escape.
+ * Uppercase escapes are handled by the caller, by inverting the set.
+ */
+constexpr bool
+regex_class_escape(u64 (&set)[4], char c)
+{
+	switch (c)
+	{
+	case 'd':
+		regex_set_add(set, '0', '9');
+		return true;
+
+	case 'w':
+		regex_set_add(set, 'a', 'z');
+		regex_set_add(set, 'A', 'Z');
+		regex_set_add(set, '0', '9');
+		regex_set_add(set, '_', '_');
+		return true;
+
+	case 's':
+		regex_set_add(set, ' ', ' ');
+		regex_set_add(set, '\t', '\r');
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * Returns the character that a single-character escape stands for,
+ * e.g. 'n' for a newline. Other characters stand for themselves.
+ */
+constexpr char
+regex_escaped_char(char c)
+{
+	switch (c)
+	{
+	case 'n': return '\n';
+	case 'r': return '\r';
+	case 't': return '\t';
+	case 'f': return '\f';
+	case 'v': return '\v';
+	case '0': return '\0';
+	default:  return c;
+	}
+}
+
+/**
+ * Recursive descent parser that compiles a pattern into a `RegexProgram`.
+ * Runs at compile time.
+ *
+ * Supported syntax: literal characters, `.`, `^`, `$`, character classes
+ * like `[a-z_]` and `[^0-9]`, the escapes `\d`, `\w`, `\s`, `\D`, `\W`,
+ * `\S`, `\n`, `\r`, `\t`, `\f`, `\v` and escaped metacharacters, capturing
+ * groups `(...)`, non-capturing groups `(?:...)`, alternation `|`, and the
+ * quantifiers `*`, `+`, `?`, `{n}`, `{n,}` and `{n,m}`, optionally
+ * followed by `?` to make them lazy.
+ */
+template <usize Capacity>
+struct RegexParser
+{
+	const char *pattern;
+	usize pos = 0;
+	RegexProgram<Capacity> program = {};
+
+	constexpr RegexParser(const char *pattern)
+		: pattern(pattern) {}
+
+	constexpr char
+	peek()
+	const
+	{
+		return pattern[pos];
+	}
+
+	constexpr bool
+	at_end()
+	const
+	{
+		return pattern[pos] == '\0';
+	}
+
+	constexpr i32
+	add_node(RegexNodeKind kind)
+	{
+		i32 index = program.node_count++;
+		program.nodes[index].kind = kind;
+		return index;
+	}
+
+	/**
+	 * alternation := sequence ('|' sequence)*
+	 * Returns the first node of the resulting sequence.
+	 */
+	constexpr i32
+	parse_alternation()
+	{
+		i32 first = parse_sequence();
+
+		if (peek() != '|')
+		{
+			return first;
+		}
+
+		i32 alternation = add_node(RegexNodeKind::Alternation);
+		i32 branch = add_node(RegexNodeKind::Branch);
+		program.nodes[branch].child = first;
+		program.nodes[alternation].child = branch;
+
+		while (peek() == '|')
+		{
+			pos++;
+
+			i32 next_branch = add_node(RegexNodeKind::Branch);
+			program.nodes[next_branch].child = parse_sequence();
+			program.nodes[branch].alt = next_branch;
+			branch = next_branch;
+		}
+
+		return alternation;
+	}
+
+	/**
+	 * sequence := (atom quantifier?)*
+	 * Returns the first node of the sequence, or -1 if it is empty.
+	 */
+	constexpr i32
+	parse_sequence()
+	{
+		i32 first = -1;
+		i32 last = -1;
+
+		while (!at_end() && peek() != '|' && peek() != ')')
+		{
+			i32 node = parse_quantifier(parse_atom());
+
+			if (first == -1)
+			{
+				first = node;
+			}
+			else
+			{
+				program.nodes[last].next = node;
+			}
+
+			last = node;
+		}
+
+		return first;
+	}
+
+	/**
+	 * Parses a decimal number in a `{n,m}` quantifier.
+	 */
+	constexpr usize
+	parse_number()
+	{
+		if (peek() < '0' || peek() > '9')
+		{
+			regex_syntax_error("Expected a number in quantifier.");
+		}
+
+		usize n = 0;
+
+		while (peek() >= '0' && peek() <= '9')
+		{
+			n = n * 10 + (pattern[pos++] - '0');
+		}
+
+		return n;
+	}
+
+	/**
+	 * quantifier := ('*' | '+' | '?' | '{' n (',' m?)? '}') '?'?
+	 * Wraps the atom in a `Repeat` node if it is followed by a quantifier.
+	 */
+	constexpr i32
+	parse_quantifier(i32 atom)
+	{
+		usize min = 0;
+		usize max = 0;
+
+		switch (peek())
+		{
+		case '*':
+			pos++;
+			min = 0;
+			max = max_value<usize>();
+			break;
+
+		case '+':
+			pos++;
+			min = 1;
+			max = max_value<usize>();
+			break;
+
+		case '?':
+			pos++;
+			min = 0;
+			max = 1;
+			break;
+
+		case '{':
+			pos++;
+			min = parse_number();
+			max = min;
+
+			if (peek() == ',')
+			{
+				pos++;
+				max = peek() == '}'
+					? max_value<usize>() : parse_number();
+			}
+
+			if (peek() != '}' || max < min)
+			{
+				regex_syntax_error("Invalid quantifier.");
+			}
+
+			pos++;
+			break;
+
+		default:
+			return atom;
+		}
+
+		RegexNodeKind kind = program.nodes[atom].kind;
+
+		if (kind == RegexNodeKind::Start || kind == RegexNodeKind::End)
+		{
+			regex_syntax_error("Anchors cannot be repeated.");
+		}
+
+		i32 repeat = add_node(RegexNodeKind::Repeat);
+		program.nodes[repeat].child = atom;
+		program.nodes[repeat].min = min;
+		program.nodes[repeat].max = max;
+
+		if (peek() == '?')
+		{
+			pos++;
+			program.nodes[repeat].lazy = true;
+		}
+
+		return repeat;
+	}
+
+	/**
+	 * atom := '(' ('?:')? alternation ')' | '[' class ']' | '.' | '^'
+	 *       | '$' | '\' escape | character
+	 */
+	constexpr i32
+	parse_atom()
+	{
+		char c = pattern[pos++];
+
+		switch (c)
+		{
+		case '(':
+		{
+			bool capturing = true;
+
+			if (peek() == '?')
+			{
+				if (pattern[pos + 1] != ':')
+				{
+					regex_syntax_error("Unsupported group type.");
+				}
+
+				pos += 2;
+				capturing = false;
+			}
+
+			i32 group = add_node(RegexNodeKind::Group);
+
+			if (capturing)
+			{
+				program.nodes[group].group = ++program.group_count;
+			}
+
+			program.nodes[group].child = parse_alternation();
+
+			if (peek() != ')')
+			{
+				regex_syntax_error("Missing closing parenthesis.");
+			}
+
+			pos++;
+			return group;
+		}
+
+		case '[':
+			return parse_class();
+
+		case '.':
+			return add_node(RegexNodeKind::Any);
+
+		case '^':
+			return add_node(RegexNodeKind::Start);
+
+		case '$':
+			return add_node(RegexNodeKind::End);
+
+		case '*':
+		case '+':
+		case '?':
+		case '{':
+			regex_syntax_error("Quantifier without an atom.");
+			return add_node(RegexNodeKind::Any);
+
+		case '\\':
+		{
+			if (at_end())
+			{
+				regex_syntax_error("Trailing backslash.");
+			}
+
+			char escaped = pattern[pos++];
+			u64 set[4] = {};
+
+			if (regex_class_escape(set, escaped | 0x20))
+			{
+				i32 node = add_node(RegexNodeKind::Class);
+
+				for (usize i = 0; i < 4; i++)
+				{
+					// Uppercase escapes match the complement.
+
+					program.nodes[node].set[i] =
+						escaped & 0x20 ? set[i] : ~set[i];
+				}
+
+				return node;
+			}
+
+			i32 node = add_node(RegexNodeKind::Char);
+			program.nodes[node].c = regex_escaped_char(escaped);
+			return node;
+		}
+
+		default:
+		{
+			i32 node = add_node(RegexNodeKind::Char);
+			program.nodes[node].c = c;
+			return node;
+		}
+		}
+	}
+
+	/**
+	 * class := '^'? (character ('-' character)? | '\' escape)* ']'
+	 * The opening bracket has already been consumed.
+	 */
+	constexpr i32
+	parse_class()
+	{
+		i32 node = add_node(RegexNodeKind::Class);
+		u64 set[4] = {};
+		bool negated = false;
+
+		if (peek() == '^')
+		{
+			pos++;
+			negated = true;
+		}
+
+		// A closing bracket right at the start is a literal.
+
+		bool first = true;
+
+		while (first || peek() != ']')
+		{
+			first = false;
+
+			if (at_end())
+			{
+				regex_syntax_error("Missing closing bracket.");
+				break;
+			}
+
+			char c = pattern[pos++];
+
+			if (c == '\\')
+			{
+				char escaped = pattern[pos++];
+				u64 escape_set[4] = {};
+
+				if (regex_class_escape(escape_set, escaped | 0x20))
+				{
+					for (usize i = 0; i < 4; i++)
+					{
+						set[i] |= escaped & 0x20
+							? escape_set[i] : ~escape_set[i];
+					}
+
+					continue;
+				}
+
+				c = regex_escaped_char(escaped);
+			}
+
+			// Handle ranges like `a-z`. A dash at the end of the class
+			// is a literal.
+
+			char last = c;
+
+			if (peek() == '-' && pattern[pos + 1] != ']'
+				&& pattern[pos + 1] != '\0')
+			{
+				pos++;
+				last = pattern[pos++];
+
+				if (last == '\\')
+				{
+					last = regex_escaped_char(pattern[pos++]);
+				}
+
+				if ((u8) last < (u8) c)
+				{
+					regex_syntax_error("Invalid range in class.");
+				}
+			}
+
+			regex_set_add(set, c, last);
+		}
+
+		pos++;
+
+		for (usize i = 0; i < 4; i++)
+		{
+			program.nodes[node].set[i] = negated ? ~set[i] : set[i];
+		}
+
+		return node;
+	}
+};
+
+/**
+ * Compiles a pattern into a `RegexProgram` at compile time.
+ */
+template <usize Capacity>
+constexpr RegexProgram<Capacity>
+compile_regex(const char *pattern)
+{
+	RegexParser<Capacity> parser(pattern);
+	parser.program.root = parser.parse_alternation();
+
+	if (!parser.at_end())
+	{
+		regex_syntax_error("Unmatched closing parenthesis.");
+	}
+
+	return parser.program;
+}
+}; // namespace slaw::detail
+
+/**
+ * Regular expression that is compiled at compile time.
+ *
+ * The pattern is parsed by the compiler, and every node of the expression
+ * becomes a specialised piece of code: characters become comparisons
+ * against constants, character classes become lookups in constant bitsets,
+ * and sequences, alternations and repetitions become nested function calls
+ * that the compiler can inline. Nothing is parsed at run time and matching
+ * never allocates memory.
+ *
+ * C++17 does not allow string literals as template arguments, so the
+ * pattern has to be declared as a `constexpr` character array first:
+ *
+ *     static constexpr char date_pattern[] = "(\\d{4})-(\\d\\d)-(\\d\\d)";
+ *     using Date = slaw::Regex<date_pattern>;
+ *
+ *     auto m = Date::match(text);
+ *
+ *     if (m)
+ *     {
+ *         slaw::StringView year = m[1];
+ *     }
+ *
+ * An invalid pattern is a compile error.
+ * Matching uses backtracking, so patterns with nested quantifiers can take
+ * exponential time on some inputs. Repetitions of a single character,
+ * character class or `.` are matched with a loop instead of recursion.
+ */
+template <const char *Pattern>
+struct Regex
+{
+	// The compiled pattern.
+	static constexpr detail::RegexProgram<detail::regex_capacity(Pattern)>
+		program = detail::compile_regex<detail::regex_capacity(Pattern)>(
+			Pattern);
+
+	// The number of capture groups in the pattern.
+	static constexpr usize group_count = program.group_count;
+
+	/**
+	 * The result of a match.
+	 * Group 0 is the entire match, the other groups are the capture groups
+	 * in the order of their opening parentheses. Groups that did not take
+	 * part in the match are empty views with a null data pointer.
+	 */
+	struct Match
+	{
+		// Whether the pattern matched.
+		bool matched = false;
+
+		// The spans of the groups.
+		StringView groups[group_count + 1];
+
+		/**
+		 * Returns true if the pattern matched.
+		 */
+		explicit
+		operator bool()
+		const
+		{
+			return matched;
+		}
+
+		/**
+		 * Returns the span of a group.
+		 */
+		StringView
+		operator[](usize group)
+		const
+		{
+			return groups[group];
+		}
+	};
+
+	/**
+	 * Checks if the entire text matches the pattern.
+	 *
+	 * - Time complexity: O(n) for patterns without nested quantifiers.
+	 * - Space complexity: O(1).
+	 */
+	static Match
+	match(StringView text)
+	{
+		State state(text);
+		return state.result(run<program.root>(state, 0,
+			[&](usize end)
+			{
+				state.match_end = end;
+				return end == text.size;
+			}), 0);
+	}
+
+	/**
+	 * Finds the leftmost match of the pattern in the text, starting the
+	 * search at a given index.
+	 *
+	 * - Time complexity: O(n * m) for patterns without nested quantifiers,
+	 *   where m is the length of the longest match.
+	 * - Space complexity: O(1).
+	 */
+	static Match
+	search(StringView text, usize start = 0)
+	{
+		State state(text);
+
+		for (usize i = start; i <= text.size; i++)
+		{
+			// If the pattern starts with a fixed character, skip the
+			// positions that cannot start a match.
+
+			if constexpr (first_char_is_fixed())
+			{
+				constexpr char first = program.nodes[program.root].c;
+
+				while (i < text.size && text[i] != first)
+				{
+					i++;
+				}
+
+				if (i == text.size)
+				{
+					break;
+				}
+			}
+
+			bool matched = run<program.root>(state, i,
+				[&](usize end)
+				{
+					state.match_end = end;
+					return true;
+				});
+
+			if (matched)
+			{
+				return state.result(true, i);
+			}
+		}
+
+		return Match();
+	}
+
+	/**
+	 * Checks if the pattern matches anywhere in the text.
+	 *
+	 * - Time complexity: O(n * m) for patterns without nested quantifiers,
+	 *   where m is the length of the longest match.
+	 * - Space complexity: O(1).
+	 */
+	static bool
+	contains(StringView text)
+	{
+		return search(text).matched;
+	}
+
+	/**
+	 * The state of a match in progress.
+	 */
+	struct State
+	{
+		StringView text;
+		usize match_end = 0;
+
+		// The start and end of each capture group, or -1 if the group
+		// did not take part in the match.
+		isize starts[group_count + 1];
+		isize ends[group_count + 1];
+
+		State(StringView text)
+			: text(text)
+		{
+			for (usize g = 0; g <= group_count; g++)
+			{
+				starts[g] = -1;
+				ends[g] = -1;
+			}
+		}
+
+		/**
+		 * Converts the state into a match result.
+		 */
+		Match
+		result(bool matched, usize match_start)
+		{
+			Match m;
+
+			if (!matched)
+			{
+				return m;
+			}
+
+			m.matched = true;
+			m.groups[0] = text.substr(match_start,
+				match_end - match_start);
+
+			for (usize g = 1; g <= group_count; g++)
+			{
+				if (starts[g] != -1)
+				{
+					m.groups[g] = text.substr(starts[g],
+						ends[g] - starts[g]);
+				}
+			}
+
+			return m;
+		}
+	};
+
+	/**
+	 * Returns true if every match starts with a fixed character.
+	 */
+	static constexpr bool
+	first_char_is_fixed()
+	{
+		return program.root != -1
+			&& program.nodes[program.root].kind
+				== detail::RegexNodeKind::Char;
+	}
+
+	/**
+	 * Checks if a character matches a single-character node.
+	 */
+	template <i32 N>
+	static bool
+	matches_char(char c)
+	{
+		constexpr detail::RegexNode node = program.nodes[N];
+
+		if constexpr (node.kind == detail::RegexNodeKind::Char)
+		{
+			return c == node.c;
+		}
+		else if constexpr (node.kind == detail::RegexNodeKind::Class)
+		{
+			u8 b = c;
+			return (node.set[b / 64] >> (b % 64)) & 1;
+		}
+		else
+		{
+			return true;
+		}
+	}
+
+	/**
+	 * Matches the sequence starting at node `N` at index `i` of the text.
+	 * On success, the continuation `k` is called with the index after the
+	 * sequence, to match the rest of the pattern. If the continuation
+	 * fails, the sequence backtracks and tries other ways to match.
+	 */
+	template <i32 N, typename K>
+	static bool
+	run(State &s, usize i, const K &k)
+	{
+		if constexpr (N == -1)
+		{
+			return k(i);
+		}
+		else
+		{
+			constexpr detail::RegexNode node = program.nodes[N];
+			using Kind = detail::RegexNodeKind;
+
+			if constexpr (node.kind == Kind::Char
+				|| node.kind == Kind::Class
+				|| node.kind == Kind::Any)
+			{
+				return i < s.text.size && matches_char<N>(s.text[i])
+					&& run<node.next>(s, i + 1, k);
+			}
+			else if constexpr (node.kind == Kind::Start)
+			{
+				return i == 0 && run<node.next>(s, i, k);
+			}
+			else if constexpr (node.kind == Kind::End)
+			{
+				return i == s.text.size && run<node.next>(s, i, k);
+			}
+			else if constexpr (node.kind == Kind::Group)
+			{
+				return run_group<N>(s, i, k);
+			}
+			else if constexpr (node.kind == Kind::Alternation)
+			{
+				auto rest = [&](usize j)
+				{
+					return run<node.next>(s, j, k);
+				};
+
+				return run_branches<node.child>(s, i, rest);
+			}
+			else if constexpr (node.kind == Kind::Repeat)
+			{
+				auto rest = [&](usize j)
+				{
+					return run<node.next>(s, j, k);
+				};
+
+				constexpr detail::RegexNode child =
+					program.nodes[node.child];
+
+				if constexpr (child.next == -1
+					&& (child.kind == Kind::Char
+					|| child.kind == Kind::Class
+					|| child.kind == Kind::Any))
+				{
+					return run_char_repeat<N>(s, i, rest);
+				}
+				else
+				{
+					return run_repeat<N>(s, i, 0, rest);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Matches a capture group. The span of the group is recorded before
+	 * the rest of the pattern is matched, and restored if the rest fails.
+	 */
+	template <i32 N, typename K>
+	static bool
+	run_group(State &s, usize i, const K &k)
+	{
+		constexpr detail::RegexNode node = program.nodes[N];
+
+		if constexpr (node.group == 0)
+		{
+			return run<node.child>(s, i, [&](usize j)
+			{
+				return run<node.next>(s, j, k);
+			});
+		}
+		else
+		{
+			return run<node.child>(s, i, [&](usize j)
+			{
+				isize old_start = s.starts[node.group];
+				isize old_end = s.ends[node.group];
+
+				s.starts[node.group] = i;
+				s.ends[node.group] = j;
+
+				if (run<node.next>(s, j, k))
+				{
+					return true;
+				}
+
+				s.starts[node.group] = old_start;
+				s.ends[node.group] = old_end;
+				return false;
+			});
+		}
+	}
+
+	/**
+	 * Tries the branches of an alternation from left to right.
+	 */
+	template <i32 B, typename K>
+	static bool
+	run_branches(State &s, usize i, const K &k)
+	{
+		if constexpr (B == -1)
+		{
+			return false;
+		}
+		else
+		{
+			constexpr detail::RegexNode branch = program.nodes[B];
+
+			return run<branch.child>(s, i, k)
+				|| run_branches<branch.alt>(s, i, k);
+		}
+	}
+
+	/**
+	 * Matches a repetition of a single-character node with a loop.
+	 * The longest (or, if lazy, the shortest) run of matching characters
+	 * is tried first, without recursing for every repetition.
+	 */
+	template <i32 N, typename K>
+	static bool
+	run_char_repeat(State &s, usize i, const K &k)
+	{
+		constexpr detail::RegexNode node = program.nodes[N];
+
+		// Count the characters that match, up to the maximum.
+
+		usize limit = min(node.max, s.text.size - i);
+		usize count = 0;
+
+		while (count < limit && matches_char<node.child>(s.text[i + count]))
+		{
+			count++;
+		}
+
+		if (count < node.min)
+		{
+			return false;
+		}
+
+		if constexpr (node.lazy)
+		{
+			for (usize n = node.min; n <= count; n++)
+			{
+				if (k(i + n))
+				{
+					return true;
+				}
+			}
+		}
+		else
+		{
+			for (usize n = count + 1; n-- > node.min;)
+			{
+				if (k(i + n))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Matches a repetition of an arbitrary sequence by recursion.
+	 * Repetitions that match the empty string are not counted beyond the
+	 * minimum, to prevent infinite loops.
+	 */
+	template <i32 N, typename K>
+	static bool
+	run_repeat(State &s, usize i, usize count, const K &k)
+	{
+		constexpr detail::RegexNode node = program.nodes[N];
+
+		auto again = [&](usize j)
+		{
+			return (j != i || count < node.min)
+				&& run_repeat<N>(s, j, count + 1, k);
+		};
+
+		if constexpr (node.lazy)
+		{
+			if (count >= node.min && k(i))
+			{
+				return true;
+			}
+
+			return count < node.max && run<node.child>(s, i, again);
+		}
+		else
+		{
+			if (count < node.max && run<node.child>(s, i, again))
+			{
+				return true;
+			}
+
+			return count >= node.min && k(i);
+		}
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,930 @@
+#ifndef SLAW_ROPE_H
+#define SLAW_ROPE_H
+
+#include "types.hpp"
+#include "util.hpp"
+#include "math.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+/**
+ * Rope for large texts that are edited anywhere, not just at the end.
+ *
+ * The text is split into chunks of at most `max_leaf_size` bytes, which are
+ * the leaves of a B-tree. Every inner node stores, for each of its
+ * children, the number of bytes and the number of newlines below it. This
+ * allows finding the chunk that holds a given byte offset or line in
+ * O(log n), and inserting or erasing text only touches the chunks and
+ * nodes on the path to the edit, instead of shifting the whole text.
+ *
+ * All leaves are at the same depth. Nodes that overflow are split evenly,
+ * and nodes that fall below a quarter of their capacity are merged with a
+ * neighbour, so every node except the root is at least a quarter full.
+ *
+ * Lines are separated by '\n'. Line `i` starts after the `i`-th newline,
+ * counting from 0.
+ */
+struct Rope
+{
+	// The maximum number of bytes in a leaf.
+	static const constexpr usize max_leaf_size = 1024;
+
+	// Leaves with fewer bytes than this are merged with a neighbour.
+	static const constexpr usize min_leaf_size = max_leaf_size / 4;
+
+	// The maximum number of children of an inner node.
+	static const constexpr usize max_children = 16;
+
+	// Inner nodes with fewer children than this are merged with a
+	// neighbour.
+	static const constexpr usize min_children = max_children / 4;
+
+	// The maximum depth of the tree. Every node below the root is at least
+	// a quarter full, so even a text of 2^32 bytes needs fewer than 16
+	// levels. The rest is headroom.
+	static const constexpr usize max_depth = 32;
+
+	/**
+	 * The fields that leaves and inner nodes start with.
+	 */
+	struct Node
+	{
+		bool is_leaf;
+
+		// The number of bytes below this node.
+		usize bytes;
+
+		// The number of newlines below this node.
+		usize lines;
+	};
+
+	/**
+	 * A leaf, holding a chunk of the text.
+	 */
+	struct Leaf : public Node
+	{
+		char text[max_leaf_size];
+	};
+
+	/**
+	 * An inner node. The byte and newline counts of the children are
+	 * stored next to each other, so a lookup can pick the right child
+	 * without touching the other children.
+	 */
+	struct Inner : public Node
+	{
+		usize child_count;
+		usize child_bytes[max_children];
+		usize child_lines[max_children];
+		Node *children[max_children];
+	};
+
+	// The root of the tree. It is a leaf if the text fits into one chunk.
+	Node *root;
+
+	/**
+	 * Constructs an empty rope.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	Rope()
+		: root(new_leaf(StringView())) {}
+
+	/**
+	 * Constructs a rope holding a copy of a text.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	Rope(StringView text)
+		: Rope()
+	{
+		insert(0, text);
+	}
+
+	Rope(const Rope &) = delete;
+
+	Rope &
+	operator=(const Rope &) = delete;
+
+	/**
+	 * Constructs a rope by taking over the tree of another rope.
+	 * The other rope will be empty.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	Rope(Rope &&source)
+		: root(source.root)
+	{
+		source.root = new_leaf(StringView());
+	}
+
+	/**
+	 * Frees all chunks and nodes.
+	 */
+	~Rope()
+	{
+		free_node(root);
+	}
+
+	/**
+	 * Returns the number of bytes in the text.
+	 */
+	usize
+	size()
+	const
+	{
+		return root->bytes;
+	}
+
+	/**
+	 * Returns the number of lines in the text, which is one more than the
+	 * number of newlines.
+	 */
+	usize
+	line_count()
+	const
+	{
+		return root->lines + 1;
+	}
+
+	/**
+	 * Returns the byte at a given offset.
+	 *
+	 * - Time complexity: O(log n).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the offset is greater than or equal to the size of the
+	 * text, BEHAVIOUR IS UNDEFINED.
+	 */
+	char
+	operator[](usize pos)
+	const
+	{
+		const Node *node = root;
+
+		while (!node->is_leaf)
+		{
+			const Inner *inner = (const Inner *) node;
+			usize i = 0;
+
+			while (pos >= inner->child_bytes[i])
+			{
+				pos -= inner->child_bytes[i++];
+			}
+
+			node = inner->children[i];
+		}
+
+		return ((const Leaf *) node)->text[pos];
+	}
+
+	/**
+	 * Inserts a text at a given byte offset.
+	 *
+	 * - Time complexity: O(log n + m), where m is the size of the text.
+	 * - Space complexity: O(log n + m).
+	 *
+	 * WARNING: If the offset is greater than the size of the text,
+	 * BEHAVIOUR IS UNDEFINED.
+	 */
+	void
+	insert(usize pos, StringView text)
+	{
+		if (text.size == 0)
+		{
+			return;
+		}
+
+		// Find the leaf that holds the offset, and remember the inner
+		// nodes on the way and the child taken at each of them.
+
+		Inner *path[max_depth];
+		usize indices[max_depth];
+		usize depth = 0;
+		Node *node = root;
+
+		while (!node->is_leaf)
+		{
+			Inner *inner = (Inner *) node;
+			usize i = 0;
+
+			while (i + 1 < inner->child_count
+				&& pos > inner->child_bytes[i])
+			{
+				pos -= inner->child_bytes[i++];
+			}
+
+			path[depth] = inner;
+			indices[depth++] = i;
+			node = inner->children[i];
+		}
+
+		Leaf *leaf = (Leaf *) node;
+		usize lines = detail::count_byte(text.data, text.size, '\n');
+
+		if (leaf->bytes + text.size <= max_leaf_size)
+		{
+			// The chunk can absorb the text, so only the counts on the
+			// path change.
+
+			for (usize i = leaf->bytes; i-- > pos;)
+			{
+				leaf->text[i + text.size] = leaf->text[i];
+			}
+
+			for (usize i = 0; i < text.size; i++)
+			{
+				leaf->text[pos + i] = text[i];
+			}
+
+			leaf->bytes += text.size;
+			leaf->lines += lines;
+
+			while (depth-- > 0)
+			{
+				Inner *inner = path[depth];
+				inner->child_bytes[indices[depth]] += text.size;
+				inner->child_lines[indices[depth]] += lines;
+				inner->bytes += text.size;
+				inner->lines += lines;
+			}
+
+			return;
+		}
+
+		// The chunk overflows. Join it with the text and split the result
+		// into new leaves.
+
+		String joined(leaf->bytes + text.size);
+
+		for (usize i = 0; i < pos; i++)
+		{
+			joined.data[joined.size++] = leaf->text[i];
+		}
+
+		for (usize i = 0; i < text.size; i++)
+		{
+			joined.data[joined.size++] = text[i];
+		}
+
+		for (usize i = pos; i < leaf->bytes; i++)
+		{
+			joined.data[joined.size++] = leaf->text[i];
+		}
+
+		delete leaf;
+
+		Vector<Node *> replacements;
+		Vector<Node *> children;
+		build_leaves(joined, replacements);
+
+		// Walk back up the path. At each level, splice the nodes that
+		// replace the child into the children, and split the node if
+		// there are too many. The nodes that replace it take the place of
+		// the child one level up.
+
+		while (depth-- > 0)
+		{
+			Inner *inner = path[depth];
+			usize i = indices[depth];
+
+			if (replacements.size == 1)
+			{
+				inner->children[i] = replacements[0];
+				update_counts(inner);
+				replacements[0] = inner;
+				continue;
+			}
+
+			children.size = 0;
+			children.reserve(inner->child_count + replacements.size);
+
+			for (usize j = 0; j < i; j++)
+			{
+				children.push_back(inner->children[j]);
+			}
+
+			for (usize j = 0; j < replacements.size; j++)
+			{
+				children.push_back(replacements[j]);
+			}
+
+			for (usize j = i + 1; j < inner->child_count; j++)
+			{
+				children.push_back(inner->children[j]);
+			}
+
+			replacements.size = 0;
+
+			if (children.size <= max_children)
+			{
+				set_children(inner, children.data, children.size);
+				replacements.push_back(inner);
+				continue;
+			}
+
+			delete inner;
+			build_inner_nodes(children.data, children.size, replacements);
+		}
+
+		// If the root was split, stack new levels on top until a single
+		// root remains.
+
+		while (replacements.size > 1)
+		{
+			children.size = 0;
+
+			for (usize j = 0; j < replacements.size; j++)
+			{
+				children.push_back(replacements[j]);
+			}
+
+			replacements.size = 0;
+			build_inner_nodes(children.data, children.size, replacements);
+		}
+
+		root = replacements[0];
+	}
+
+	/**
+	 * Appends a text to the end of the rope.
+	 *
+	 * - Time complexity: O(log n + m), where m is the size of the text.
+	 * - Space complexity: O(log n + m).
+	 */
+	void
+	append(StringView text)
+	{
+		insert(size(), text);
+	}
+
+	/**
+	 * Erases a given number of bytes, starting at a given byte offset.
+	 * The range is clamped to the end of the text.
+	 *
+	 * - Time complexity: O(log n + k), where k is the number of chunks
+	 *   that are removed entirely.
+	 * - Space complexity: O(1).
+	 */
+	void
+	erase(usize pos, usize length)
+	{
+		if (pos >= size() || length == 0)
+		{
+			return;
+		}
+
+		erase_from(root, pos, range_end(pos, length));
+
+		// Remove levels that are left with a single child.
+
+		while (!root->is_leaf && ((Inner *) root)->child_count <= 1)
+		{
+			Inner *inner = (Inner *) root;
+			root = inner->child_count == 1 ? inner->children[0]
+				: new_leaf(StringView());
+			delete inner;
+		}
+	}
+
+	/**
+	 * Returns the byte offset at which a line starts.
+	 * If the line is past the last line, the size of the text is returned.
+	 *
+	 * - Time complexity: O(log n).
+	 * - Space complexity: O(1).
+	 */
+	usize
+	line_start(usize line)
+	const
+	{
+		if (line == 0)
+		{
+			return 0;
+		}
+
+		if (line > root->lines)
+		{
+			return size();
+		}
+
+		// Find the chunk with the newline that ends the previous line.
+
+		const Node *node = root;
+		usize offset = 0;
+
+		while (!node->is_leaf)
+		{
+			const Inner *inner = (const Inner *) node;
+			usize i = 0;
+
+			while (line > inner->child_lines[i])
+			{
+				line -= inner->child_lines[i];
+				offset += inner->child_bytes[i++];
+			}
+
+			node = inner->children[i];
+		}
+
+		const Leaf *leaf = (const Leaf *) node;
+		return offset + detail::find_nth_byte(leaf->text, leaf->bytes,
+			'\n', line) + 1;
+	}
+
+	/**
+	 * Returns the line that holds the byte at a given offset.
+	 *
+	 * - Time complexity: O(log n).
+	 * - Space complexity: O(1).
+	 */
+	usize
+	line_of(usize pos)
+	const
+	{
+		const Node *node = root;
+		usize line = 0;
+
+		pos = min(pos, size());
+
+		while (!node->is_leaf)
+		{
+			const Inner *inner = (const Inner *) node;
+			usize i = 0;
+
+			while (i + 1 < inner->child_count
+				&& pos >= inner->child_bytes[i])
+			{
+				pos -= inner->child_bytes[i];
+				line += inner->child_lines[i++];
+			}
+
+			node = inner->children[i];
+		}
+
+		const Leaf *leaf = (const Leaf *) node;
+		return line + detail::count_byte(leaf->text, pos, '\n');
+	}
+
+	/**
+	 * Calls a function with a `StringView` of every chunk of the text that
+	 * overlaps a range of bytes, in order. The views are clipped to the
+	 * range. This allows running the SIMD text kernels over a rope without
+	 * copying it.
+	 * The range is clamped to the end of the text.
+	 *
+	 * - Time complexity: O(log n + m / c), where m is the size of the range
+	 *   and c is the chunk size.
+	 * - Space complexity: O(log n).
+	 */
+	template <typename F>
+	void
+	for_each_chunk(usize start, usize length, F f)
+	const
+	{
+		usize end = range_end(start, length);
+
+		if (start < end)
+		{
+			for_each_chunk(root, start, end, f);
+		}
+	}
+
+	/**
+	 * Calls a function with a `StringView` of every chunk of the text,
+	 * in order.
+	 *
+	 * - Time complexity: O(n / c), where c is the chunk size.
+	 * - Space complexity: O(log n).
+	 */
+	template <typename F>
+	void
+	for_each_chunk(F f)
+	const
+	{
+		for_each_chunk(0, size(), f);
+	}
+
+	/**
+	 * Creates a string holding a copy of a range of bytes.
+	 * The range is clamped to the end of the text.
+	 *
+	 * - Time complexity: O(log n + m), where m is the size of the range.
+	 * - Space complexity: O(m).
+	 */
+	String
+	slice(usize start, usize length)
+	const
+	{
+		usize end = range_end(start, length);
+		String out(max(end - min(start, end), String::min_capacity));
+
+		for_each_chunk(start, length, [&](StringView chunk)
+		{
+			for (usize i = 0; i < chunk.size; i++)
+			{
+				out.data[out.size++] = chunk[i];
+			}
+		});
+
+		return out;
+	}
+
+	/**
+	 * Creates a string holding a copy of a line, without its newline.
+	 *
+	 * - Time complexity: O(log n + m), where m is the size of the line.
+	 * - Space complexity: O(m).
+	 */
+	String
+	line(usize line)
+	const
+	{
+		usize start = line_start(line);
+		usize end = line_start(line + 1);
+
+		if (end > start && line < root->lines)
+		{
+			end--;
+		}
+
+		return slice(start, end - start);
+	}
+
+	/**
+	 * Creates a string holding a copy of the whole text.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_string()
+	const
+	{
+		return slice(0, size());
+	}
+
+	/**
+	 * Returns the end of the range of `length` bytes from `start`, clamped
+	 * to the end of the text. `start + length` would wrap around for huge
+	 * lengths such as `(usize) -1`, so the length is compared against the
+	 * bytes that are left instead.
+	 */
+	usize
+	range_end(usize start, usize length)
+	const
+	{
+		if (start >= size() || length > size() - start)
+		{
+			return size();
+		}
+
+		return start + length;
+	}
+
+	/**
+	 * Allocates a leaf holding a copy of a text of at most
+	 * `max_leaf_size` bytes.
+	 */
+	static Leaf *
+	new_leaf(StringView text)
+	{
+		Leaf *leaf = new Leaf;
+		leaf->is_leaf = true;
+		leaf->bytes = text.size;
+		leaf->lines = detail::count_byte(text.data, text.size, '\n');
+
+		for (usize i = 0; i < text.size; i++)
+		{
+			leaf->text[i] = text[i];
+		}
+
+		return leaf;
+	}
+
+	/**
+	 * Allocates an inner node with the given children.
+	 */
+	static Inner *
+	new_inner(Node **children, usize count)
+	{
+		Inner *inner = new Inner;
+		inner->is_leaf = false;
+		set_children(inner, children, count);
+		return inner;
+	}
+
+	/**
+	 * Replaces the children of an inner node and updates its counts.
+	 */
+	static void
+	set_children(Inner *inner, Node **children, usize count)
+	{
+		inner->child_count = count;
+		inner->bytes = 0;
+		inner->lines = 0;
+
+		for (usize i = 0; i < count; i++)
+		{
+			inner->children[i] = children[i];
+			inner->child_bytes[i] = children[i]->bytes;
+			inner->child_lines[i] = children[i]->lines;
+			inner->bytes += children[i]->bytes;
+			inner->lines += children[i]->lines;
+		}
+	}
+
+	/**
+	 * Updates the counts of an inner node after its children changed.
+	 */
+	static void
+	update_counts(Inner *inner)
+	{
+		set_children(inner, inner->children, inner->child_count);
+	}
+
+	/**
+	 * Frees a node and everything below it.
+	 */
+	static void
+	free_node(Node *node)
+	{
+		if (node->is_leaf)
+		{
+			delete (Leaf *) node;
+			return;
+		}
+
+		Inner *inner = (Inner *) node;
+
+		for (usize i = 0; i < inner->child_count; i++)
+		{
+			free_node(inner->children[i]);
+		}
+
+		delete inner;
+	}
+
+	/**
+	 * Splits a text into leaves of nearly equal size, each at most
+	 * `max_leaf_size` bytes, and appends them to a vector.
+	 */
+	static void
+	build_leaves(StringView text, Vector<Node *> &out)
+	{
+		usize count = max((text.size + max_leaf_size - 1) / max_leaf_size,
+			(usize) 1);
+		usize start = 0;
+
+		for (usize k = 0; k < count; k++)
+		{
+			usize end = (u64) text.size * (k + 1) / count;
+			out.push_back(new_leaf(text.substr(start, end - start)));
+			start = end;
+		}
+	}
+
+	/**
+	 * Groups nodes into inner nodes of nearly equal size, each with at most
+	 * `max_children` children, and appends them to a vector.
+	 */
+	static void
+	build_inner_nodes(Node **nodes, usize n, Vector<Node *> &out)
+	{
+		usize count = (n + max_children - 1) / max_children;
+		usize start = 0;
+
+		for (usize k = 0; k < count; k++)
+		{
+			usize end = (u64) n * (k + 1) / count;
+			out.push_back(new_inner(nodes + start, end - start));
+			start = end;
+		}
+	}
+
+	/**
+	 * Checks if a node is too small and should be merged with a neighbour.
+	 */
+	static bool
+	is_underfull(const Node *node)
+	{
+		if (node->is_leaf)
+		{
+			return node->bytes < min_leaf_size;
+		}
+
+		return ((const Inner *) node)->child_count < min_children;
+	}
+
+	/**
+	 * Merges children `i` and `i + 1` of an inner node. If the merged
+	 * node would overflow, its contents are split evenly over two nodes
+	 * instead.
+	 */
+	static void
+	merge_children(Inner *inner, usize i)
+	{
+		Node *a = inner->children[i];
+		Node *b = inner->children[i + 1];
+		Vector<Node *> merged;
+
+		if (a->is_leaf)
+		{
+			Leaf *left = (Leaf *) a;
+			Leaf *right = (Leaf *) b;
+			String joined(left->bytes + right->bytes + 1);
+
+			for (usize j = 0; j < left->bytes; j++)
+			{
+				joined.data[joined.size++] = left->text[j];
+			}
+
+			for (usize j = 0; j < right->bytes; j++)
+			{
+				joined.data[joined.size++] = right->text[j];
+			}
+
+			delete left;
+			delete right;
+			build_leaves(joined, merged);
+		}
+		else
+		{
+			Inner *left = (Inner *) a;
+			Inner *right = (Inner *) b;
+			Node *grandchildren[2 * max_children];
+			usize count = 0;
+
+			for (usize j = 0; j < left->child_count; j++)
+			{
+				grandchildren[count++] = left->children[j];
+			}
+
+			for (usize j = 0; j < right->child_count; j++)
+			{
+				grandchildren[count++] = right->children[j];
+			}
+
+			delete left;
+			delete right;
+			build_inner_nodes(grandchildren, count, merged);
+
+			// An underfull node may have had a single underfull child,
+			// which could not be merged before. Now it has siblings.
+
+			for (usize k = 0; k < merged.size; k++)
+			{
+				merge_underfull_children((Inner *) merged[k]);
+			}
+		}
+
+		// Put the merged nodes in place of the two children.
+
+		Node *children[max_children + 1];
+		usize count = 0;
+
+		for (usize j = 0; j < inner->child_count; j++)
+		{
+			if (j == i)
+			{
+				for (usize k = 0; k < merged.size; k++)
+				{
+					children[count++] = merged[k];
+				}
+			}
+			else if (j != i + 1)
+			{
+				children[count++] = inner->children[j];
+			}
+		}
+
+		set_children(inner, children, count);
+	}
+
+	/**
+	 * Erases the bytes in the range [start, end) below a node. The node
+	 * stays in place, but may be left underfull, in which case its parent
+	 * merges it with a neighbour.
+	 */
+	static void
+	erase_from(Node *node, usize start, usize end)
+	{
+		if (node->is_leaf)
+		{
+			Leaf *leaf = (Leaf *) node;
+			leaf->lines -= detail::count_byte(leaf->text + start,
+				end - start, '\n');
+
+			for (usize i = end; i < leaf->bytes; i++)
+			{
+				leaf->text[i - (end - start)] = leaf->text[i];
+			}
+
+			leaf->bytes -= end - start;
+			return;
+		}
+
+		Inner *inner = (Inner *) node;
+		usize child_start = 0;
+		usize count = 0;
+
+		// Remove the children inside the range, and erase the parts of
+		// the children that overlap it.
+
+		for (usize i = 0; i < inner->child_count; i++)
+		{
+			Node *child = inner->children[i];
+			usize child_end = child_start + inner->child_bytes[i];
+
+			if (start <= child_start && child_end <= end)
+			{
+				free_node(child);
+			}
+			else
+			{
+				if (start < child_end && child_start < end)
+				{
+					erase_from(child, max(start, child_start)
+						- child_start, min(end, child_end)
+						- child_start);
+				}
+
+				inner->children[count++] = child;
+			}
+
+			child_start = child_end;
+		}
+
+		inner->child_count = count;
+		merge_underfull_children(inner);
+	}
+
+	/**
+	 * Merges the underfull children of an inner node with a neighbour,
+	 * and updates the counts of the node. After an erase, only the
+	 * children at the ends of the erased range can be underfull, so this
+	 * runs a bounded number of merges.
+	 */
+	static void
+	merge_underfull_children(Inner *inner)
+	{
+		usize i = 0;
+
+		while (inner->child_count > 1 && i < inner->child_count)
+		{
+			if (!is_underfull(inner->children[i]))
+			{
+				i++;
+				continue;
+			}
+
+			usize left = i + 1 < inner->child_count ? i : i - 1;
+			merge_children(inner, left);
+			i = left;
+		}
+
+		update_counts(inner);
+	}
+
+	/**
+	 * Calls a function for the chunks below a node that overlap the range
+	 * [start, end), relative to the start of the node.
+	 */
+	template <typename F>
+	static void
+	for_each_chunk(const Node *node, usize start, usize end, F &f)
+	{
+		if (node->is_leaf)
+		{
+			const Leaf *leaf = (const Leaf *) node;
+			f(StringView(leaf->text + start, end - start));
+			return;
+		}
+
+		const Inner *inner = (const Inner *) node;
+		usize child_start = 0;
+
+		for (usize i = 0; i < inner->child_count && child_start < end; i++)
+		{
+			usize child_end = child_start + inner->child_bytes[i];
+
+			if (start < child_end)
+			{
+				for_each_chunk(inner->children[i],
+					max(start, child_start) - child_start,
+					min(end, child_end) - child_start, f);
+			}
+
+			child_start = child_end;
+		}
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,496 @@
+#ifndef SLAW_SHARED_STRING_H
+#define SLAW_SHARED_STRING_H
+
+#include "types.hpp"
+#include "util.hpp"
+#include "math.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+/**
+ * Reference-counted string with copy-on-write semantics.
+ *
+ * The reference count, size, capacity and characters live in a single heap
+ * block. Copying a shared string only copies a pointer and increments the
+ * count, so passing large text through many layers by value never copies
+ * the characters. The characters are only copied when a shared string is
+ * mutated while other copies still refer to the same block, which detaches
+ * it into a block of its own.
+ *
+ * The reference count is not atomic. Shared strings must not be shared
+ * between threads.
+ */
+struct SharedString
+{
+	/**
+	 * The header of a block. The characters follow directly after it.
+	 */
+	struct Block
+	{
+		// The number of shared strings that refer to this block.
+		usize ref_count;
+
+		// The number of characters in the block.
+		usize size;
+
+		// The number of characters the block has room for.
+		usize capacity;
+
+		/**
+		 * Returns a pointer to the characters of the block.
+		 */
+		char *
+		chars()
+		{
+			return (char *) (this + 1);
+		}
+	};
+
+	// The block of this string, or nullptr if the string is empty and has
+	// never allocated.
+	Block *block;
+
+	/**
+	 * Constructs an empty shared string. Does not allocate.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	SharedString()
+		: block(nullptr) {}
+
+	/**
+	 * Constructs a shared string holding a copy of some characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	SharedString(StringView str)
+		: block(nullptr)
+	{
+		if (str.size == 0)
+		{
+			return;
+		}
+
+		block = allocate(str.size);
+		block->size = str.size;
+
+		for (usize i = 0; i < str.size; i++)
+		{
+			block->chars()[i] = str[i];
+		}
+	}
+
+	/**
+	 * Constructs a shared string holding a copy of a string.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	SharedString(const String &str)
+		: SharedString(StringView(str)) {}
+
+	/**
+	 * Constructs a shared string holding a copy of a character array.
+	 * The terminating null character is not copied.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	template <usize N>
+	SharedString(const char (&str)[N])
+		: SharedString(StringView(str)) {}
+
+	/**
+	 * Constructs a shared string that refers to the same characters as
+	 * another shared string. The characters are not copied.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	SharedString(const SharedString &source)
+		: block(source.block)
+	{
+		if (block != nullptr)
+		{
+			block->ref_count++;
+		}
+	}
+
+	/**
+	 * Constructs a shared string by taking over the reference of another
+	 * shared string. The source will be empty.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	SharedString(SharedString &&source)
+		: block(source.block)
+	{
+		source.block = nullptr;
+	}
+
+	/**
+	 * Releases the reference to the characters. The block is freed when
+	 * the last reference is released.
+	 */
+	~SharedString()
+	{
+		release();
+	}
+
+	/**
+	 * Makes this shared string refer to the same characters as another
+	 * shared string. The characters are not copied.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	SharedString &
+	operator=(const SharedString &source)
+	{
+		// Take the new reference before releasing the old one, which
+		// also handles self-assignment.
+
+		Block *new_block = source.block;
+
+		if (new_block != nullptr)
+		{
+			new_block->ref_count++;
+		}
+
+		release();
+		block = new_block;
+		return *this;
+	}
+
+	/**
+	 * Takes over the reference of another shared string.
+	 * The source will be empty.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	SharedString &
+	operator=(SharedString &&source)
+	{
+		if (this != &source)
+		{
+			release();
+			block = source.block;
+			source.block = nullptr;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Returns the number of characters in the string.
+	 */
+	usize
+	size()
+	const
+	{
+		return block != nullptr ? block->size : 0;
+	}
+
+	/**
+	 * Returns a read-only pointer to the characters of the string.
+	 * Reading never copies the characters.
+	 */
+	const char *
+	data()
+	const
+	{
+		return block != nullptr ? block->chars() : nullptr;
+	}
+
+	/**
+	 * Returns the number of shared strings that refer to the same
+	 * characters as this one, including this one.
+	 */
+	usize
+	ref_count()
+	const
+	{
+		return block != nullptr ? block->ref_count : 0;
+	}
+
+	/**
+	 * Returns the character at a given index.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the given index is greater than or equal to the size of
+	 * the string, BEHAVIOUR IS UNDEFINED.
+	 */
+	char
+	operator[](usize index)
+	const
+	{
+		return block->chars()[index];
+	}
+
+	/**
+	 * Returns a view of the characters of the string.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: The view is only valid as long as this string is alive and
+	 * not mutated.
+	 */
+	operator StringView()
+	const
+	{
+		return StringView(data(), size());
+	}
+
+	/**
+	 * Checks if two shared strings contain the same characters.
+	 * Strings that share a block are equal without comparing characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	bool
+	operator==(const SharedString &other)
+	const
+	{
+		return block == other.block
+			|| (StringView) *this == (StringView) other;
+	}
+
+	/**
+	 * Checks if two shared strings do not contain the same characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	bool
+	operator!=(const SharedString &other)
+	const
+	{
+		return !operator==(other);
+	}
+
+	/**
+	 * Returns a writable pointer to the characters of the string.
+	 * If other shared strings refer to the same characters, this string is
+	 * detached first, by giving it its own copy of the characters.
+	 *
+	 * - Time complexity: O(n) if the string is shared, O(1) otherwise.
+	 * - Space complexity: O(n) if the string is shared, O(1) otherwise.
+	 */
+	char *
+	mutable_data()
+	{
+		detach(size());
+		return block != nullptr ? block->chars() : nullptr;
+	}
+
+	/**
+	 * Sets the character at a given index.
+	 *
+	 * - Time complexity: O(n) if the string is shared, O(1) otherwise.
+	 * - Space complexity: O(n) if the string is shared, O(1) otherwise.
+	 *
+	 * WARNING: If the given index is greater than or equal to the size of
+	 * the string, BEHAVIOUR IS UNDEFINED.
+	 */
+	void
+	set(usize index, char c)
+	{
+		mutable_data()[index] = c;
+	}
+
+	/**
+	 * Appends characters to the string.
+	 * If the string is shared, it is detached first.
+	 *
+	 * - Time complexity: O(m) on average, or O(n + m) if the string is
+	 *   shared or has to grow.
+	 * - Space complexity: O(n + m) if the string is shared or has to grow,
+	 *   O(1) otherwise.
+	 */
+	void
+	append(StringView str)
+	{
+		if (str.size == 0)
+		{
+			return;
+		}
+
+		usize old_size = size();
+		usize new_size = old_size + str.size;
+
+		// The characters may come from this string itself, for example
+		// when a string is appended to itself. If a new block is needed,
+		// they are copied before the old block is released. Otherwise
+		// they lie before the end of the string, where nothing is
+		// written.
+
+		Block *target = block;
+
+		if (!is_unique_with_capacity(new_size))
+		{
+			target = copy_block(new_size);
+		}
+
+		for (usize i = 0; i < str.size; i++)
+		{
+			target->chars()[old_size + i] = str[i];
+		}
+
+		target->size = new_size;
+
+		if (target != block)
+		{
+			release();
+			block = target;
+		}
+	}
+
+	/**
+	 * Appends characters to the string.
+	 * If the string is shared, it is detached first.
+	 *
+	 * - Time complexity: O(m) on average, or O(n + m) if the string is
+	 *   shared or has to grow.
+	 * - Space complexity: O(n + m) if the string is shared or has to grow,
+	 *   O(1) otherwise.
+	 */
+	void
+	operator+=(StringView str)
+	{
+		append(str);
+	}
+
+	/**
+	 * Appends a character to the string.
+	 * If the string is shared, it is detached first.
+	 *
+	 * - Time complexity: O(1) on average, or O(n) if the string is shared
+	 *   or has to grow.
+	 * - Space complexity: O(n) if the string is shared or has to grow,
+	 *   O(1) otherwise.
+	 */
+	void
+	operator+=(char c)
+	{
+		append(StringView(&c, 1));
+	}
+
+	/**
+	 * Creates a `String` holding a copy of the characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_string()
+	const
+	{
+		return ((StringView) *this).to_string();
+	}
+
+	/**
+	 * Allocates a block with room for a given number of characters and a
+	 * reference count of one.
+	 */
+	static Block *
+	allocate(usize capacity)
+	{
+		Block *new_block = (Block *) new u8[sizeof(Block) + capacity];
+		new_block->ref_count = 1;
+		new_block->size = 0;
+		new_block->capacity = capacity;
+		return new_block;
+	}
+
+	/**
+	 * Releases the reference to the block, and frees the block if this was
+	 * the last reference.
+	 */
+	void
+	release()
+	{
+		if (block != nullptr && --block->ref_count == 0)
+		{
+			delete[] (u8 *) block;
+		}
+
+		block = nullptr;
+	}
+
+	/**
+	 * Checks if this string is the only one referring to its block, and
+	 * the block has room for a given number of characters.
+	 */
+	bool
+	is_unique_with_capacity(usize needed_capacity)
+	const
+	{
+		return block != nullptr && block->ref_count == 1
+			&& block->capacity >= needed_capacity;
+	}
+
+	/**
+	 * Allocates a new block with room for a given number of characters,
+	 * and copies the characters of this string into it. The old block is
+	 * not released. Growing doubles the capacity.
+	 */
+	Block *
+	copy_block(usize needed_capacity)
+	const
+	{
+		usize old_size = size();
+		usize capacity = needed_capacity;
+
+		if (block != nullptr && needed_capacity > block->capacity)
+		{
+			capacity = max(needed_capacity, block->capacity * 2);
+		}
+
+		Block *new_block = allocate(capacity);
+		new_block->size = old_size;
+
+		for (usize i = 0; i < old_size; i++)
+		{
+			new_block->chars()[i] = block->chars()[i];
+		}
+
+		return new_block;
+	}
+
+	/**
+	 * Makes sure this string is the only one referring to its block, and
+	 * that the block has room for a given number of characters.
+	 * The characters are copied into a new block if the block is shared or
+	 * too small.
+	 */
+	void
+	detach(usize needed_capacity)
+	{
+		if (is_unique_with_capacity(needed_capacity))
+		{
+			return;
+		}
+
+		if (block == nullptr && needed_capacity == 0)
+		{
+			return;
+		}
+
+		Block *new_block = copy_block(needed_capacity);
+		release();
+		block = new_block;
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -5,6 +5,16 @@
 #include "math.hpp"
 #include "util.hpp"
 
+// Checks if the compiler provides a given builtin function. The SIMD
+// operations below use this to pick the builtin that lowers to a single
+// instruction on the target.
+
+#ifdef __has_builtin
+#define SLAW_HAS_BUILTIN(name) __has_builtin(name)
+#else
+#define SLAW_HAS_BUILTIN(name) 0
+#endif
+
 // Below are the SIMD types that are supported by WebAssembly.
 
 typedef i8 i8x16 __attribute__((__vector_size__(16)));
@@ -29,8 +39,10 @@ template <typename T>
 constexpr bool
 is_simd_vector()
 {
-	if constexpr (is_same<T, i8x16>() || is_same<T, i16x8>()
-		|| is_same<T, i32x4>() || is_same<T, i64x2>()
+	if constexpr (is_same<T, i8x16>() || is_same<T, u8x16>()
+		|| is_same<T, i16x8>() || is_same<T, u16x8>()
+		|| is_same<T, i32x4>() || is_same<T, u32x4>()
+		|| is_same<T, i64x2>() || is_same<T, u64x2>()
 		|| is_same<T, f32x4>() || is_same<T, f64x2>())
 	{
 		return true;
@@ -47,22 +59,24 @@ template <typename T>
 constexpr usize
 simd_vector_size()
 {
-	if constexpr (is_same<T, i8x16>())
+	if constexpr (is_same<T, i8x16>() || is_same<T, u8x16>())
 	{
 		return 16;
 	}
 
-	if constexpr (is_same<T, i16x8>())
+	if constexpr (is_same<T, i16x8>() || is_same<T, u16x8>())
 	{
 		return 8;
 	}
 
-	if constexpr (is_same<T, i32x4>() || is_same<T, f32x4>())
+	if constexpr (is_same<T, i32x4>() || is_same<T, u32x4>()
+		|| is_same<T, f32x4>())
 	{
 		return 4;
 	}
 
-	if constexpr (is_same<T, i64x2>() || is_same<T, f64x2>())
+	if constexpr (is_same<T, i64x2>() || is_same<T, u64x2>()
+		|| is_same<T, f64x2>())
 	{
 		return 2;
 	}
@@ -82,9 +96,13 @@ template <typename T>
 struct simd_vector_of_impl {};
 
 template <> struct simd_vector_of_impl<i8> { using type = i8x16; };
+template <> struct simd_vector_of_impl<u8> { using type = u8x16; };
 template <> struct simd_vector_of_impl<i16> { using type = i16x8; };
+template <> struct simd_vector_of_impl<u16> { using type = u16x8; };
 template <> struct simd_vector_of_impl<i32> { using type = i32x4; };
+template <> struct simd_vector_of_impl<u32> { using type = u32x4; };
 template <> struct simd_vector_of_impl<i64> { using type = i64x2; };
+template <> struct simd_vector_of_impl<u64> { using type = u64x2; };
 template <> struct simd_vector_of_impl<f32> { using type = f32x4; };
 template <> struct simd_vector_of_impl<f64> { using type = f64x2; };
 
@@ -96,9 +114,13 @@ template <typename T>
 struct simd_element_type_of_impl {};
 
 template <> struct simd_element_type_of_impl<i8x16> { using type = i8; };
+template <> struct simd_element_type_of_impl<u8x16> { using type = u8; };
 template <> struct simd_element_type_of_impl<i16x8> { using type = i16; };
+template <> struct simd_element_type_of_impl<u16x8> { using type = u16; };
 template <> struct simd_element_type_of_impl<i32x4> { using type = i32; };
+template <> struct simd_element_type_of_impl<u32x4> { using type = u32; };
 template <> struct simd_element_type_of_impl<i64x2> { using type = i64; };
+template <> struct simd_element_type_of_impl<u64x2> { using type = u64; };
 template <> struct simd_element_type_of_impl<f32x4> { using type = f32; };
 template <> struct simd_element_type_of_impl<f64x2> { using type = f64; };
 }; // namespace detail
@@ -118,6 +140,43 @@ template <typename T>
 using simd_element_type_of =
 	typename detail::simd_element_type_of_impl<T>::type;
 
+namespace detail
+{
+/**
+ * A compile-time structure that holds the signed integer type of a given
+ * size in bytes.
+ */
+template <usize Size>
+struct simd_signed_integer_of_impl {};
+
+template <> struct simd_signed_integer_of_impl<1> { using type = i8; };
+template <> struct simd_signed_integer_of_impl<2> { using type = i16; };
+template <> struct simd_signed_integer_of_impl<4> { using type = i32; };
+template <> struct simd_signed_integer_of_impl<8> { using type = i64; };
+
+/**
+ * A compile-time structure that holds the unsigned integer type of a given
+ * size in bytes.
+ */
+template <usize Size>
+struct simd_unsigned_integer_of_impl {};
+
+template <> struct simd_unsigned_integer_of_impl<1> { using type = u8; };
+template <> struct simd_unsigned_integer_of_impl<2> { using type = u16; };
+template <> struct simd_unsigned_integer_of_impl<4> { using type = u32; };
+template <> struct simd_unsigned_integer_of_impl<8> { using type = u64; };
+}; // namespace detail
+
+/**
+ * A compile-time macro that resolves into the mask type of a given SIMD
+ * vector type. A mask is a vector of signed integers with the same number of
+ * elements, where each element is either all ones or all zeroes.
+ * Comparisons return masks.
+ */
+template <typename T>
+using simd_mask_of = simd_vector_of<typename detail::
+	simd_signed_integer_of_impl<sizeof(simd_element_type_of<T>)>::type>;
+
 /**
  * Performs an element-wise user specified operation on an SIMD vector.
  * Each element goes through the user specified operation and the result
@@ -132,7 +191,7 @@ each(const T &v, simd_element_type_of<T> (*op)(simd_element_type_of<T>))
 
 	if constexpr (simd_vector_size<T>() == 16)
 	{
-		return {
+		return T {
 			op(v[0]),  op(v[1]),  op(v[2]),  op(v[3]),
 			op(v[4]),  op(v[5]),  op(v[6]),  op(v[7]),
 			op(v[8]),  op(v[9]),  op(v[10]), op(v[11]),
@@ -142,7 +201,7 @@ each(const T &v, simd_element_type_of<T> (*op)(simd_element_type_of<T>))
 
 	if constexpr (simd_vector_size<T>() == 8)
 	{
-		return {
+		return T {
 			op(v[0]), op(v[1]), op(v[2]), op(v[3]),
 			op(v[4]), op(v[5]), op(v[6]), op(v[7])
 		};
@@ -150,12 +209,12 @@ each(const T &v, simd_element_type_of<T> (*op)(simd_element_type_of<T>))
 
 	if constexpr (simd_vector_size<T>() == 4)
 	{
-		return { op(v[0]), op(v[1]), op(v[2]), op(v[3]) };
+		return T { op(v[0]), op(v[1]), op(v[2]), op(v[3]) };
 	}
 
 	if constexpr (simd_vector_size<T>() == 2)
 	{
-		return { op(v[0]), op(v[1]) };
+		return T { op(v[0]), op(v[1]) };
 	}
 }
 
@@ -174,7 +233,7 @@ each(const T &a, const T &b, simd_element_type_of<T> (*op)(
 
 	if constexpr (simd_vector_size<T>() == 16)
 	{
-		return {
+		return T {
 			op(a[0],  b[0]),  op(a[1],  b[1]),
 			op(a[2],  b[2]),  op(a[3],  b[3]),
 			op(a[4],  b[4]),  op(a[5],  b[5]),
@@ -188,7 +247,7 @@ each(const T &a, const T &b, simd_element_type_of<T> (*op)(
 
 	if constexpr (simd_vector_size<T>() == 8)
 	{
-		return {
+		return T {
 			op(a[0], b[0]), op(a[1], b[1]),
 			op(a[2], b[2]), op(a[3], b[3]),
 			op(a[4], b[4]), op(a[5], b[5]),
@@ -198,7 +257,7 @@ each(const T &a, const T &b, simd_element_type_of<T> (*op)(
 
 	if constexpr (simd_vector_size<T>() == 4)
 	{
-		return {
+		return T {
 			op(a[0], b[0]), op(a[1], b[1]),
 			op(a[2], b[2]), op(a[3], b[3])
 		};
@@ -206,7 +265,7 @@ each(const T &a, const T &b, simd_element_type_of<T> (*op)(
 
 	if constexpr (simd_vector_size<T>() == 2)
 	{
-		return { op(a[0], b[0]), op(a[1], b[1]) };
+		return T { op(a[0], b[0]), op(a[1], b[1]) };
 	}
 }
 
@@ -214,67 +273,168 @@ each(const T &a, const T &b, simd_element_type_of<T> (*op)(
  * Performs an element-wise miniumum operation on two SIMD vectors.
  * The output of each element is the minimum of the corresponding
  * elements of the two input vectors.
+ *
+ * The comparison is written as a vector select, which compiles to a single
+ * `min_s`/`min_u` instruction for 8, 16 and 32-bit integers and to
+ * `pmin` for floats. Like the scalar `min`, `b` is returned if the
+ * elements are unordered.
  */
 template <typename T>
 constexpr T
 min(const T &a, const T &b)
 {
-	return each(a, b, slaw::min);
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(a, b, slaw::min);
+	}
+
+	return a < b ? a : b;
 }
 
 /**
  * Performs an element-wise maximum operation on two SIMD vectors.
  * The output of each element is the maximum of the corresponding
  * elements of the two input vectors.
+ *
+ * The comparison is written as `a < b ? b : a`, which is the definition of
+ * the `pmax` instruction, so it compiles to a single `max_s`/`max_u` or
+ * `pmax` instruction. Unlike the scalar `max`, `a` is returned if the
+ * elements are unordered or both zero.
  */
 template <typename T>
 constexpr T
 max(const T &a, const T &b)
 {
-	return each(a, b, slaw::max);
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(a, b, [](E x, E y) { return x < y ? y : x; });
+	}
+
+	return a < b ? b : a;
 }
 
 /**
  * Performs an element-wise absolute value operation on a SIMD vector.
  * The output of each element is the absolute value of the corresponding
  * element of the input vector.
+ * Compiles to a single `abs` instruction, or to clearing the sign bits.
  */
 template <typename T>
 constexpr T
 abs(const T &v)
 {
-	return each(v, slaw::abs);
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, slaw::abs);
+	}
+
+	if constexpr (is_unsigned_integer<E>())
+	{
+		return v;
+	}
+	else if constexpr (is_float<E>())
+	{
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_abs)
+		return __builtin_elementwise_abs(v);
+#elif defined(__wasm_simd128__)
+		if constexpr (is_same<T, f32x4>())
+		{
+			return __builtin_wasm_abs_f32x4(v);
+		}
+		else
+		{
+			return __builtin_wasm_abs_f64x2(v);
+		}
+#else
+		if constexpr (is_same<T, f32x4>())
+		{
+			return (T) ((u32x4) v & 0x7FFFFFFF);
+		}
+		else
+		{
+			return (T) ((u64x2) v & 0x7FFFFFFFFFFFFFFF);
+		}
+#endif
+	}
+	else
+	{
+		return v < 0 ? -v : v;
+	}
 }
 
 /**
  * Performs an element-wise negation operation on a SIMD vector.
  * The output of each element is the corresponding element of the input
  * vector multiplied by -1.
+ * Compiles to a single `neg` instruction.
  */
 template <typename T>
 constexpr T
 neg(const T &v)
 {
-	return each(v, [](T n) { return -n; });
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, [](E n) -> E { return -n; });
+	}
+
+	return -v;
 }
 
 /**
- * Performs an element-wise rounding operation on a SIMD vector.
- * Each element is rounded to the nearest integer.
+ * Performs an element-wise floor operation on a SIMD vector.
+ * Each element is rounded down to the nearest integer.
+ * Compiles to a single `floor` instruction.
  */
 template <typename T>
 constexpr T
-round(const T &v)
+floor(const T &v)
 {
 	static_assert(is_float<simd_element_type_of<T>>(),
 		"SIMD vector does not hold floating-point types.");
 
-	return each(v, slaw::round);
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, slaw::floor);
+	}
+
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_floor)
+	return __builtin_elementwise_floor(v);
+#elif defined(__wasm_simd128__)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_floor_f32x4(v);
+	}
+	else
+	{
+		return __builtin_wasm_floor_f64x2(v);
+	}
+#elif defined(__SSE4_1__)
+	// Immediate 0x09 rounds towards negative infinity without raising
+	// the inexact exception.
+
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_ia32_roundps(v, 0x09);
+	}
+	else
+	{
+		return __builtin_ia32_roundpd(v, 0x09);
+	}
+#else
+	return each(v, slaw::floor);
+#endif
 }
 
 /**
  * Performs an element-wise ceiling operation on a SIMD vector.
  * Each element is rounded up to the nearest integer.
+ * Compiles to a single `ceil` instruction.
  */
 template <typename T>
 constexpr T
@@ -283,27 +443,67 @@ ceil(const T &v)
 	static_assert(is_float<simd_element_type_of<T>>(),
 		"SIMD vector does not hold floating-point types.");
 
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, slaw::ceil);
+	}
+
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_ceil)
+	return __builtin_elementwise_ceil(v);
+#elif defined(__wasm_simd128__)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_ceil_f32x4(v);
+	}
+	else
+	{
+		return __builtin_wasm_ceil_f64x2(v);
+	}
+#elif defined(__SSE4_1__)
+	// Immediate 0x0A rounds towards positive infinity without raising
+	// the inexact exception.
+
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_ia32_roundps(v, 0x0A);
+	}
+	else
+	{
+		return __builtin_ia32_roundpd(v, 0x0A);
+	}
+#else
 	return each(v, slaw::ceil);
+#endif
 }
 
 /**
- * Performs an element-wise floor operation on a SIMD vector.
- * Each element is rounded down to the nearest integer.
+ * Performs an element-wise rounding operation on a SIMD vector.
+ * Each element is rounded to the nearest integer, with halfway cases
+ * rounded up, like the scalar `round`.
+ * Compiles to an `add` and a `floor` instruction.
  */
 template <typename T>
 constexpr T
-floor(const T &v)
+round(const T &v)
 {
 	static_assert(is_float<simd_element_type_of<T>>(),
 		"SIMD vector does not hold floating-point types.");
 
-	return each(v, slaw::floor);
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, [](E n) { return slaw::floor(n + (E) 0.5); });
+	}
+
+	return floor(v + (E) 0.5);
 }
 
 /**
  * Performs an element-wise square root operation on a SIMD vector.
  * Each element is the square root of the corresponding element of the
  * input vector.
+ * Compiles to a single `sqrt` instruction.
  */
 template <typename T>
 constexpr T
@@ -312,40 +512,1640 @@ sqrt(const T &v)
 	static_assert(is_float<simd_element_type_of<T>>(),
 		"SIMD vector does not hold floating-point types.");
 
+	if (__builtin_is_constant_evaluated())
+	{
+		return each(v, slaw::sqrt);
+	}
+
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_sqrt)
+	return __builtin_elementwise_sqrt(v);
+#elif defined(__wasm_simd128__)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_sqrt_f32x4(v);
+	}
+	else
+	{
+		return __builtin_wasm_sqrt_f64x2(v);
+	}
+#elif defined(__SSE2__) && SLAW_HAS_BUILTIN(__builtin_ia32_sqrtps)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_ia32_sqrtps(v);
+	}
+	else
+	{
+		return __builtin_ia32_sqrtpd(v);
+	}
+#else
 	return each(v, slaw::sqrt);
+#endif
+}
+
+namespace detail
+{
+/**
+ * Wrapper around a SIMD vector that may live at any address.
+ * Accessing a vector through this struct tells the compiler that the address
+ * is not 16-byte aligned, so it emits a single unaligned `v128.load` or
+ * `v128.store` instead of assuming alignment.
+ */
+template <typename T>
+struct __attribute__((__packed__, __may_alias__)) unaligned_vector
+{
+	T v;
+};
+}; // namespace detail
+
+/**
+ * Loads a SIMD vector from a memory address.
+ * The address does not have to be aligned.
+ *
+ * WARNING: 16 bytes are read from the given address. If fewer bytes are
+ * readable, BEHAVIOUR IS UNDEFINED.
+ */
+template <typename T>
+inline T
+load(const void *ptr)
+{
+	return ((const detail::unaligned_vector<T> *) ptr)->v;
 }
 
 /**
- * Sums the elements of a SIMD vector.
+ * Stores a SIMD vector to a memory address.
+ * The address does not have to be aligned.
  */
 template <typename T>
-constexpr typename simd_element_type_of<T>::type
-sum(T v)
+inline void
+store(void *ptr, const T &v)
+{
+	((detail::unaligned_vector<T> *) ptr)->v = v;
+}
+
+/**
+ * Creates a SIMD vector with all elements set to the given value.
+ */
+template <typename T>
+constexpr T
+splat(simd_element_type_of<T> value)
 {
 	static_assert(simd_vector_size<T>() != 0,
 		"Type is not a SIMD vector type.");
 
+	// Setting every element to the same value lowers to a single `splat`
+	// instruction. Adding the value to a zero vector would too, but it
+	// turns -0.0 into 0.0 and quiets signalling NaNs.
+
+	using E = simd_element_type_of<T>;
+	E v = value;
+
 	if constexpr (simd_vector_size<T>() == 16)
 	{
-		return v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7]
-			+ v[8] + v[9] + v[10] + v[11] + v[12] + v[13] + v[14]
-			+ v[15];
+		return T { v, v, v, v, v, v, v, v, v, v, v, v, v, v, v, v };
+	}
+	else if constexpr (simd_vector_size<T>() == 8)
+	{
+		return T { v, v, v, v, v, v, v, v };
+	}
+	else if constexpr (simd_vector_size<T>() == 4)
+	{
+		return T { v, v, v, v };
+	}
+	else
+	{
+		return T { v, v };
 	}
+}
 
-	if constexpr (simd_vector_size<T>() == 8)
+/**
+ * Loads a single element from a memory address and sets all elements of a
+ * SIMD vector to it. Compiles to a single `load_splat` instruction.
+ * The address does not have to be aligned.
+ */
+template <typename T>
+inline T
+load_splat(const void *ptr)
+{
+	simd_element_type_of<T> value;
+	__builtin_memcpy(&value, ptr, sizeof(value));
+	return splat<T>(value);
+}
+
+/**
+ * Loads 4 bytes from a memory address into the first 4 bytes of a SIMD
+ * vector, and sets the rest to zero. Compiles to a single
+ * `v128.load32_zero` instruction.
+ * The address does not have to be aligned.
+ */
+template <typename T>
+inline T
+load32_zero(const void *ptr)
+{
+	u32 value;
+	__builtin_memcpy(&value, ptr, sizeof(value));
+	return (T) (u32x4) { value, 0, 0, 0 };
+}
+
+/**
+ * Loads 8 bytes from a memory address into the first 8 bytes of a SIMD
+ * vector, and sets the rest to zero. Compiles to a single
+ * `v128.load64_zero` instruction.
+ * The address does not have to be aligned.
+ */
+template <typename T>
+inline T
+load64_zero(const void *ptr)
+{
+	u64 value;
+	__builtin_memcpy(&value, ptr, sizeof(value));
+	return (T) (u64x2) { value, 0 };
+}
+
+/**
+ * Loads up to 16 bytes from a memory address into a SIMD vector. Bytes past
+ * `size` are set to zero, and are never read. This is meant for the tail of
+ * a buffer, which cannot be read with a full 16-byte `load()`.
+ * The address does not have to be aligned.
+ */
+template <typename T>
+inline T
+load_partial(const void *ptr, usize size)
+{
+	if (size >= 16)
 	{
-		return v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+		return load<T>(ptr);
 	}
 
-	if constexpr (simd_vector_size<T>() == 4)
+	u8 bytes[16] = {};
+
+	for (usize i = 0; i < size; i++)
 	{
-		return v[0] + v[1] + v[2] + v[3];
+		bytes[i] = ((const u8 *) ptr)[i];
 	}
 
-	if constexpr (simd_vector_size<T>() == 2)
+	return load<T>(bytes);
+}
+
+/**
+ * Stores the first `size` bytes of a SIMD vector to a memory address, and
+ * leaves the memory after them untouched. At most 16 bytes are stored.
+ * The address does not have to be aligned.
+ */
+template <typename T>
+inline void
+store_partial(void *ptr, const T &v, usize size)
+{
+	if (size >= 16)
+	{
+		store(ptr, v);
+		return;
+	}
+
+	u8 bytes[16];
+	store(bytes, v);
+
+	for (usize i = 0; i < size; i++)
+	{
+		((u8 *) ptr)[i] = bytes[i];
+	}
+}
+
+/**
+ * Stores the element of a SIMD vector at a lane that is known at compile
+ * time to a memory address. Compiles to a single `store_lane` instruction.
+ * The address does not have to be aligned.
+ */
+template <usize Lane, typename T>
+inline void
+store_lane(void *ptr, const T &v)
+{
+	static_assert(Lane < simd_vector_size<T>(), "Lane index out of range.");
+
+	simd_element_type_of<T> value = v[Lane];
+	__builtin_memcpy(ptr, &value, sizeof(value));
+}
+
+/**
+ * Compares two SIMD vectors for equality, element by element.
+ * Returns a mask with all bits set in the elements that are equal.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+eq(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a == b);
+}
+
+/**
+ * Compares two SIMD vectors for inequality, element by element.
+ * Returns a mask with all bits set in the elements that are not equal.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+ne(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a != b);
+}
+
+/**
+ * Compares two SIMD vectors element by element.
+ * Returns a mask with all bits set in the elements where `a` is less than
+ * `b`. Unsigned vectors are compared as unsigned numbers.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+lt(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a < b);
+}
+
+/**
+ * Compares two SIMD vectors element by element.
+ * Returns a mask with all bits set in the elements where `a` is less than
+ * or equal to `b`. Unsigned vectors are compared as unsigned numbers.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+le(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a <= b);
+}
+
+/**
+ * Compares two SIMD vectors element by element.
+ * Returns a mask with all bits set in the elements where `a` is greater
+ * than `b`. Unsigned vectors are compared as unsigned numbers.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+gt(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a > b);
+}
+
+/**
+ * Compares two SIMD vectors element by element.
+ * Returns a mask with all bits set in the elements where `a` is greater
+ * than or equal to `b`. Unsigned vectors are compared as unsigned numbers.
+ */
+template <typename T>
+constexpr simd_mask_of<T>
+ge(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	return (simd_mask_of<T>) (a >= b);
+}
+
+/**
+ * Selects the bits of `a` where the mask is set, and the bits of `b`
+ * elsewhere. Compiles to a single `v128.bitselect` instruction.
+ */
+template <typename T>
+constexpr T
+select(const simd_mask_of<T> &mask, const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	using M = simd_mask_of<T>;
+	return (T) (((M) a & mask) | ((M) b & ~mask));
+}
+
+/**
+ * Returns true if any bit of a SIMD vector is set.
+ */
+template <typename T>
+inline bool
+any_true(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+#ifdef __wasm_simd128__
+	return __builtin_wasm_any_true_v128((i8x16) v);
+#else
+	u64x2 bits = (u64x2) v;
+	return (bits[0] | bits[1]) != 0;
+#endif
+}
+
+/**
+ * Gathers the most significant bit of each element of a SIMD vector into
+ * an integer. Bit `i` of the result is set if the sign bit of element `i`
+ * is set.
+ * Combined with comparisons, this turns a 16-byte match into a bitmask
+ * that can be walked with `ctz()`.
+ */
+template <typename T>
+inline u32
+bitmask(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	constexpr usize lanes = simd_vector_size<T>();
+	simd_mask_of<T> m = (simd_mask_of<T>) v;
+
+#ifdef __wasm_simd128__
+	if constexpr (lanes == 16)
+	{
+		return __builtin_wasm_bitmask_i8x16(m);
+	}
+	else if constexpr (lanes == 8)
+	{
+		return __builtin_wasm_bitmask_i16x8(m);
+	}
+	else if constexpr (lanes == 4)
+	{
+		return __builtin_wasm_bitmask_i32x4(m);
+	}
+	else
+	{
+		return __builtin_wasm_bitmask_i64x2(m);
+	}
+#elif defined(__SSE2__)
+	typedef char char16 __attribute__((__vector_size__(16)));
+
+	if constexpr (lanes == 16)
 	{
-		return v[0] + v[1];
+		return __builtin_ia32_pmovmskb128((char16) m);
 	}
+	else if constexpr (lanes == 8)
+	{
+		// Packing with saturation keeps the sign of each element, and
+		// moves the 8 elements into the low 8 bytes.
+
+		return __builtin_ia32_pmovmskb128((char16)
+			__builtin_ia32_packsswb128(m, (i16x8) {})) & 0xFF;
+	}
+	else if constexpr (lanes == 4)
+	{
+		return __builtin_ia32_movmskps((f32x4) m);
+	}
+	else
+	{
+		return __builtin_ia32_movmskpd((f64x2) m);
+	}
+#else
+	u32 mask = 0;
+
+	for (usize i = 0; i < lanes; i++)
+	{
+		mask |= (u32) (m[i] < 0) << i;
+	}
+
+	return mask;
+#endif
+}
+
+/**
+ * Returns true if all elements of a SIMD vector are non-zero.
+ */
+template <typename T>
+inline bool
+all_true(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	constexpr usize lanes = simd_vector_size<T>();
+	simd_mask_of<T> m = (simd_mask_of<T>) v;
+
+#ifdef __wasm_simd128__
+	if constexpr (lanes == 16)
+	{
+		return __builtin_wasm_all_true_i8x16(m);
+	}
+	else if constexpr (lanes == 8)
+	{
+		return __builtin_wasm_all_true_i16x8(m);
+	}
+	else if constexpr (lanes == 4)
+	{
+		return __builtin_wasm_all_true_i32x4(m);
+	}
+	else
+	{
+		return __builtin_wasm_all_true_i64x2(m);
+	}
+#else
+	return bitmask((simd_mask_of<T>) (m != 0)) == (1u << lanes) - 1;
+#endif
+}
+
+/**
+ * Rearranges the elements of two SIMD vectors, using indices that are
+ * known at compile time. Element `i` of the result is element `Indices[i]`
+ * of the concatenation of `a` and `b`. Compiles to a single `i8x16.shuffle`
+ * instruction.
+ *
+ * Example: `shuffle<1, 0, 5, 4>(a, b)` returns `{ a[1], a[0], b[1], b[0] }`.
+ */
+template <int... Indices, typename T>
+constexpr T
+shuffle(const T &a, const T &b)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+	static_assert(sizeof...(Indices) == simd_vector_size<T>(),
+		"The number of indices does not match the number of lanes.");
+	static_assert(((Indices >= 0
+		&& Indices < 2 * (int) simd_vector_size<T>()) && ...),
+		"Lane index out of range.");
+
+#if SLAW_HAS_BUILTIN(__builtin_shufflevector)
+	return (T) __builtin_shufflevector(a, b, Indices...);
+#else
+	return __builtin_shuffle(a, b, simd_mask_of<T> { Indices... });
+#endif
+}
+
+/**
+ * Rearranges the elements of a SIMD vector, using indices that are known at
+ * compile time. Element `i` of the result is element `Indices[i]` of `v`.
+ *
+ * Example: `shuffle<3, 2, 1, 0>(v)` reverses a vector of 4 elements.
+ */
+template <int... Indices, typename T>
+constexpr T
+shuffle(const T &v)
+{
+	static_assert(((Indices < (int) simd_vector_size<T>()) && ...),
+		"Lane index out of range.");
+
+	return shuffle<Indices...>(v, v);
+}
+
+/**
+ * Returns the element of a SIMD vector at a lane that is known at compile
+ * time. Compiles to a single `extract_lane` instruction.
+ */
+template <usize Lane, typename T>
+constexpr simd_element_type_of<T>
+extract_lane(const T &v)
+{
+	static_assert(Lane < simd_vector_size<T>(), "Lane index out of range.");
+	return v[Lane];
+}
+
+/**
+ * Returns a copy of a SIMD vector with the element at a lane that is known
+ * at compile time replaced. Compiles to a single `replace_lane`
+ * instruction.
+ */
+template <usize Lane, typename T>
+constexpr T
+replace_lane(T v, simd_element_type_of<T> value)
+{
+	static_assert(Lane < simd_vector_size<T>(), "Lane index out of range.");
+	v[Lane] = value;
+	return v;
+}
+
+/**
+ * Returns a mask of the bytes of a SIMD vector that lie in the inclusive
+ * range [`first`, `last`].
+ * Subtracting `first` moves the range to [0, `last` - `first`], and bytes
+ * below `first` wrap around to large values, so a single unsigned compare
+ * checks both bounds.
+ */
+inline u8x16
+in_range(u8x16 v, u8 first, u8 last)
+{
+	return (u8x16) (v - splat<u8x16>(first) <= splat<u8x16>(last - first));
+}
+
+/**
+ * Selects bytes from a SIMD vector using a vector of run-time indices.
+ * Byte `i` of the result is byte `indices[i]` of `v`, or 0 if the index is
+ * 16 or above. This makes the function usable as a 16-entry lookup table.
+ */
+inline u8x16
+swizzle(u8x16 v, u8x16 indices)
+{
+#ifdef __wasm_simd128__
+	return (u8x16) __builtin_wasm_swizzle_i8x16((i8x16) v, (i8x16) indices);
+#elif defined(__SSSE3__)
+	// `pshufb` only zeroes bytes whose index has the high bit set, so we
+	// set that bit for all indices of 16 and above.
+
+	typedef char char16 __attribute__((__vector_size__(16)));
+	indices |= (u8x16) (indices > 15);
+	return (u8x16) __builtin_ia32_pshufb128((char16) v, (char16) indices);
+#else
+	u8x16 result;
+
+	for (usize i = 0; i < 16; i++)
+	{
+		result[i] = indices[i] < 16 ? v[indices[i] & 15] : 0;
+	}
+
+	return result;
+#endif
+}
+
+namespace detail
+{
+/**
+ * Combines all elements of a SIMD vector with a given operation, in
+ * log2(N) steps. Each step swaps the halves of ever smaller groups of
+ * elements with a shuffle and combines the vector with the shuffled copy,
+ * like the butterflies of an FFT. Afterwards, every element holds the
+ * combination of all elements.
+ * The steps are independent shuffles instead of a chain of `extract_lane`
+ * instructions, so they pipeline well.
+ */
+template <typename T, typename Op>
+inline T
+reduce_tree(T v, Op op)
+{
+	constexpr usize lanes = simd_vector_size<T>();
+
+	if constexpr (lanes == 16)
+	{
+		v = op(v, shuffle<8, 9, 10, 11, 12, 13, 14, 15,
+			0, 1, 2, 3, 4, 5, 6, 7>(v));
+		v = op(v, shuffle<4, 5, 6, 7, 0, 1, 2, 3,
+			12, 13, 14, 15, 8, 9, 10, 11>(v));
+		v = op(v, shuffle<2, 3, 0, 1, 6, 7, 4, 5,
+			10, 11, 8, 9, 14, 15, 12, 13>(v));
+		v = op(v, shuffle<1, 0, 3, 2, 5, 4, 7, 6,
+			9, 8, 11, 10, 13, 12, 15, 14>(v));
+	}
+	else if constexpr (lanes == 8)
+	{
+		v = op(v, shuffle<4, 5, 6, 7, 0, 1, 2, 3>(v));
+		v = op(v, shuffle<2, 3, 0, 1, 6, 7, 4, 5>(v));
+		v = op(v, shuffle<1, 0, 3, 2, 5, 4, 7, 6>(v));
+	}
+	else if constexpr (lanes == 4)
+	{
+		v = op(v, shuffle<2, 3, 0, 1>(v));
+		v = op(v, shuffle<1, 0, 3, 2>(v));
+	}
+	else
+	{
+		v = op(v, shuffle<1, 0>(v));
+	}
+
+	return v;
+}
+
+/**
+ * Combines all elements of a SIMD vector with a given operation, one
+ * element at a time. Used when the reduction is evaluated at compile time.
+ */
+template <typename T, typename Op>
+constexpr simd_element_type_of<T>
+reduce_each(const T &v, Op op)
+{
+	simd_element_type_of<T> result = v[0];
+
+	for (usize i = 1; i < simd_vector_size<T>(); i++)
+	{
+		result = op(result, v[i]);
+	}
+
+	return result;
+}
+}; // namespace slaw::simd::detail
+
+/**
+ * Sums the elements of a SIMD vector, with log2(N) shuffles and adds.
+ * Integer sums wrap around in the element type, see `widening_sum()` for
+ * sums that do not overflow.
+ * Floating-point elements are added pairwise, in a tree, so the result may
+ * differ from a sequential sum in the last bits.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+sum(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return detail::reduce_each(v, [](E a, E b) -> E { return a + b; });
+	}
+
+	return detail::reduce_tree(v, [](T a, T b) { return a + b; })[0];
+}
+
+/**
+ * Returns the smallest element of a SIMD vector, with log2(N) shuffles and
+ * `min` instructions.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+reduce_min(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return detail::reduce_each(v, slaw::min<simd_element_type_of<T>>);
+	}
+
+	return detail::reduce_tree(v, [](T a, T b) { return min(a, b); })[0];
+}
+
+/**
+ * Returns the largest element of a SIMD vector, with log2(N) shuffles and
+ * `max` instructions.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+reduce_max(const T &v)
+{
+	static_assert(simd_vector_size<T>() != 0,
+		"Type is not a SIMD vector type.");
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return detail::reduce_each(v, slaw::max<simd_element_type_of<T>>);
+	}
+
+	return detail::reduce_tree(v, [](T a, T b) { return max(a, b); })[0];
+}
+
+/**
+ * Returns the bitwise AND of all elements of an integer SIMD vector, with
+ * log2(N) shuffles and `v128.and` instructions.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+reduce_and(const T &v)
+{
+	static_assert(is_integer<simd_element_type_of<T>>(),
+		"SIMD vector does not hold integer types.");
+
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return detail::reduce_each(v, [](E a, E b) -> E { return a & b; });
+	}
+
+	return detail::reduce_tree(v, [](T a, T b) { return a & b; })[0];
+}
+
+/**
+ * Returns the bitwise OR of all elements of an integer SIMD vector, with
+ * log2(N) shuffles and `v128.or` instructions.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+reduce_or(const T &v)
+{
+	static_assert(is_integer<simd_element_type_of<T>>(),
+		"SIMD vector does not hold integer types.");
+
+	using E = simd_element_type_of<T>;
+
+	if (__builtin_is_constant_evaluated())
+	{
+		return detail::reduce_each(v, [](E a, E b) -> E { return a | b; });
+	}
+
+	return detail::reduce_tree(v, [](T a, T b) { return a | b; })[0];
+}
+
+/**
+ * Returns the dot product of two SIMD vectors: the sum of the products of
+ * their elements. Integer products and sums wrap around in the element
+ * type. For `i16x8`, the overload below does not wrap.
+ */
+template <typename T>
+constexpr simd_element_type_of<T>
+dot(const T &a, const T &b)
+{
+	return sum(a * b);
+}
+
+/**
+ * Multiplies the elements of two `i16x8` vectors into 32-bit products, and
+ * adds adjacent pairs of products. Element `i` of the result is
+ * `a[2i] * b[2i] + a[2i + 1] * b[2i + 1]`.
+ * Compiles to a single `i32x4.dot_i16x8_s` or `pmaddwd` instruction.
+ */
+inline i32x4
+dot_pairs(i16x8 a, i16x8 b)
+{
+#ifdef __wasm_simd128__
+	return __builtin_wasm_dot_s_i32x4_i16x8(a, b);
+#elif defined(__SSE2__)
+	return __builtin_ia32_pmaddwd128(a, b);
+#else
+	i32x4 result;
+
+	for (usize i = 0; i < 4; i++)
+	{
+		result[i] = (i32) a[2 * i] * b[2 * i]
+			+ (i32) a[2 * i + 1] * b[2 * i + 1];
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Returns the dot product of two `i16x8` vectors as a 32-bit integer.
+ * The products are computed with `dot_pairs()`, so they do not overflow.
+ */
+inline i32
+dot(i16x8 a, i16x8 b)
+{
+	return sum(dot_pairs(a, b));
+}
+
+namespace detail
+{
+/**
+ * A compile-time structure that holds the types involved in widening the
+ * elements of a SIMD vector: the 64-bit vector that holds half of its
+ * elements, and the 128-bit vector with elements of twice the width.
+ */
+template <typename T>
+struct simd_widen_impl {};
+
+typedef i8 i8x8 __attribute__((__vector_size__(8)));
+typedef u8 u8x8 __attribute__((__vector_size__(8)));
+typedef i16 i16x4 __attribute__((__vector_size__(8)));
+typedef u16 u16x4 __attribute__((__vector_size__(8)));
+typedef i32 i32x2 __attribute__((__vector_size__(8)));
+typedef u32 u32x2 __attribute__((__vector_size__(8)));
+typedef f32 f32x2 __attribute__((__vector_size__(8)));
+
+template <> struct simd_widen_impl<i8x16>
+{
+	using half = i8x8;
+	using wide = i16x8;
+};
+
+template <> struct simd_widen_impl<u8x16>
+{
+	using half = u8x8;
+	using wide = u16x8;
+};
+
+template <> struct simd_widen_impl<i16x8>
+{
+	using half = i16x4;
+	using wide = i32x4;
+};
+
+template <> struct simd_widen_impl<u16x8>
+{
+	using half = u16x4;
+	using wide = u32x4;
+};
+
+template <> struct simd_widen_impl<i32x4>
+{
+	using half = i32x2;
+	using wide = i64x2;
+};
+
+template <> struct simd_widen_impl<u32x4>
+{
+	using half = u32x2;
+	using wide = u64x2;
+};
+
+template <> struct simd_widen_impl<f32x4>
+{
+	using half = f32x2;
+	using wide = f64x2;
+};
+
+/**
+ * Returns the saturated value for each element of a signed SIMD vector that
+ * overflowed: the largest value for non-negative elements of `sign`, and
+ * the smallest value for negative ones.
+ */
+template <typename T>
+inline T
+saturation_of(const T &sign)
+{
+	using E = simd_element_type_of<T>;
+
+	// Shifting the sign bit through gives 0 or -1. XOR with the largest
+	// value turns these into the largest or the smallest value.
+
+	E largest = (E) ((1u << (8 * sizeof(E) - 1)) - 1);
+	return (sign >> (8 * sizeof(E) - 1)) ^ largest;
+}
+
+/**
+ * Returns the lower (`High = 0`) or the upper (`High = 1`) half of the
+ * elements of a SIMD vector, as a 64-bit vector.
+ */
+template <usize High, typename T>
+inline typename simd_widen_impl<T>::half
+half_of(const T &v)
+{
+#if SLAW_HAS_BUILTIN(__builtin_shufflevector)
+	// A shuffle with half as many indices returns a vector with half as
+	// many elements, which widening instructions take directly.
+
+	constexpr usize o = High * 16 / sizeof(simd_element_type_of<T>) / 2;
+
+	if constexpr (simd_vector_size<T>() == 16)
+	{
+		return __builtin_shufflevector(v, v, o, o + 1, o + 2, o + 3,
+			o + 4, o + 5, o + 6, o + 7);
+	}
+	else if constexpr (simd_vector_size<T>() == 8)
+	{
+		return __builtin_shufflevector(v, v, o, o + 1, o + 2, o + 3);
+	}
+	else
+	{
+		return __builtin_shufflevector(v, v, o, o + 1);
+	}
+#else
+	typename simd_widen_impl<T>::half half;
+	__builtin_memcpy(&half, (const u8 *) &v + High * sizeof(half),
+		sizeof(half));
+	return half;
+#endif
+}
+}; // namespace slaw::simd::detail
+
+/**
+ * A compile-time macro that resolves into the SIMD vector type with
+ * elements of twice the width of the elements of a given SIMD vector type.
+ * For example, `simd_widen_of<u8x16>` is `u16x8`.
+ */
+template <typename T>
+using simd_widen_of = typename detail::simd_widen_impl<T>::wide;
+
+/**
+ * Adds the elements of two 8 or 16-bit integer SIMD vectors. Sums that do
+ * not fit are clamped to the smallest or largest value of the element type
+ * instead of wrapping around.
+ * Compiles to a single `add_sat_s` or `add_sat_u` instruction, or to
+ * `padds`/`paddus` on SSE2.
+ */
+template <typename T>
+inline T
+add_sat(const T &a, const T &b)
+{
+	static_assert(is_same<T, i8x16>() || is_same<T, u8x16>()
+		|| is_same<T, i16x8>() || is_same<T, u16x8>(),
+		"SIMD vector does not hold 8 or 16-bit integer types.");
+
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_add_sat)
+	return __builtin_elementwise_add_sat(a, b);
+#elif defined(__wasm_simd128__)
+	if constexpr (is_same<T, i8x16>())
+	{
+		return __builtin_wasm_add_sat_s_i8x16(a, b);
+	}
+	else if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_wasm_add_sat_u_i8x16((i8x16) a, (i8x16) b);
+	}
+	else if constexpr (is_same<T, i16x8>())
+	{
+		return __builtin_wasm_add_sat_s_i16x8(a, b);
+	}
+	else
+	{
+		return (T) __builtin_wasm_add_sat_u_i16x8((i16x8) a, (i16x8) b);
+	}
+#elif SLAW_HAS_BUILTIN(__builtin_ia32_paddusb128)
+	typedef char char16 __attribute__((__vector_size__(16)));
+
+	if constexpr (is_same<T, i8x16>())
+	{
+		return (T) __builtin_ia32_paddsb128((char16) a, (char16) b);
+	}
+	else if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_ia32_paddusb128((char16) a, (char16) b);
+	}
+	else if constexpr (is_same<T, i16x8>())
+	{
+		return __builtin_ia32_paddsw128(a, b);
+	}
+	else
+	{
+		return (T) __builtin_ia32_paddusw128((i16x8) a, (i16x8) b);
+	}
+#else
+	using E = simd_element_type_of<T>;
+
+	if constexpr (is_unsigned_integer<E>())
+	{
+		// The sum wrapped around if it is smaller than an operand.
+
+		T sum = a + b;
+		return sum | (T) (sum < a);
+	}
+	else
+	{
+		// The sum overflowed if both operands have the same sign, and
+		// the sign of the sum differs from it. The sum is computed
+		// without sign, so wrapping around is well-defined.
+
+		using U = simd_vector_of<typename
+			detail::simd_unsigned_integer_of_impl<sizeof(E)>::type>;
+		T sum = (T) ((U) a + (U) b);
+		T overflow = (T) (((a ^ sum) & (b ^ sum)) < 0);
+		return select(overflow, detail::saturation_of(a), sum);
+	}
+#endif
+}
+
+/**
+ * Subtracts the elements of two 8 or 16-bit integer SIMD vectors.
+ * Differences that do not fit are clamped to the smallest or largest value
+ * of the element type instead of wrapping around.
+ * Compiles to a single `sub_sat_s` or `sub_sat_u` instruction, or to
+ * `psubs`/`psubus` on SSE2.
+ */
+template <typename T>
+inline T
+sub_sat(const T &a, const T &b)
+{
+	static_assert(is_same<T, i8x16>() || is_same<T, u8x16>()
+		|| is_same<T, i16x8>() || is_same<T, u16x8>(),
+		"SIMD vector does not hold 8 or 16-bit integer types.");
+
+#if SLAW_HAS_BUILTIN(__builtin_elementwise_sub_sat)
+	return __builtin_elementwise_sub_sat(a, b);
+#elif defined(__wasm_simd128__)
+	if constexpr (is_same<T, i8x16>())
+	{
+		return __builtin_wasm_sub_sat_s_i8x16(a, b);
+	}
+	else if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_wasm_sub_sat_u_i8x16((i8x16) a, (i8x16) b);
+	}
+	else if constexpr (is_same<T, i16x8>())
+	{
+		return __builtin_wasm_sub_sat_s_i16x8(a, b);
+	}
+	else
+	{
+		return (T) __builtin_wasm_sub_sat_u_i16x8((i16x8) a, (i16x8) b);
+	}
+#elif SLAW_HAS_BUILTIN(__builtin_ia32_psubusb128)
+	typedef char char16 __attribute__((__vector_size__(16)));
+
+	if constexpr (is_same<T, i8x16>())
+	{
+		return (T) __builtin_ia32_psubsb128((char16) a, (char16) b);
+	}
+	else if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_ia32_psubusb128((char16) a, (char16) b);
+	}
+	else if constexpr (is_same<T, i16x8>())
+	{
+		return __builtin_ia32_psubsw128(a, b);
+	}
+	else
+	{
+		return (T) __builtin_ia32_psubusw128((i16x8) a, (i16x8) b);
+	}
+#else
+	using E = simd_element_type_of<T>;
+
+	if constexpr (is_unsigned_integer<E>())
+	{
+		// The difference wrapped around if it is larger than `a`.
+
+		T difference = a - b;
+		return difference & (T) (difference <= a);
+	}
+	else
+	{
+		// The difference overflowed if the operands have different
+		// signs, and the sign of the difference differs from `a`.
+
+		using U = simd_vector_of<typename
+			detail::simd_unsigned_integer_of_impl<sizeof(E)>::type>;
+		T difference = (T) ((U) a - (U) b);
+		T overflow = (T) (((a ^ b) & (a ^ difference)) < 0);
+		return select(overflow, detail::saturation_of(a), difference);
+	}
+#endif
+}
+
+/**
+ * Computes the rounding average `(a + b + 1) / 2` of the elements of two
+ * unsigned 8 or 16-bit integer SIMD vectors, without overflowing.
+ * Compiles to a single `avgr_u` instruction, or `pavgb`/`pavgw` on SSE2.
+ */
+template <typename T>
+inline T
+avgr_u(const T &a, const T &b)
+{
+	static_assert(is_same<T, u8x16>() || is_same<T, u16x8>(),
+		"SIMD vector does not hold unsigned 8 or 16-bit integer types.");
+
+#ifdef __wasm_simd128__
+	if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_wasm_avgr_u_i8x16((i8x16) a, (i8x16) b);
+	}
+	else
+	{
+		return (T) __builtin_wasm_avgr_u_i16x8((i16x8) a, (i16x8) b);
+	}
+#elif SLAW_HAS_BUILTIN(__builtin_ia32_pavgb128)
+	typedef char char16 __attribute__((__vector_size__(16)));
+
+	if constexpr (is_same<T, u8x16>())
+	{
+		return (T) __builtin_ia32_pavgb128((char16) a, (char16) b);
+	}
+	else
+	{
+		return (T) __builtin_ia32_pavgw128((i16x8) a, (i16x8) b);
+	}
+#else
+	// `a | b` is the sum of the bits set in either and `a ^ b` is the sum
+	// of the bits set in exactly one, so this is `(a + b + 1) >> 1`.
+
+	return (a | b) - ((a ^ b) >> 1);
+#endif
+}
+
+/**
+ * Multiplies the elements of two `i16x8` vectors as Q15 fixed-point
+ * numbers, rounding to nearest: `(a * b + 0x4000) >> 15`. The only product
+ * that does not fit, `-1 * -1`, is clamped to the largest value.
+ * Compiles to a single `i16x8.q15mulr_sat_s` instruction, or to `pmulhrsw`
+ * and a fix-up on SSSE3.
+ */
+inline i16x8
+q15mulr_sat(i16x8 a, i16x8 b)
+{
+#ifdef __wasm_simd128__
+	return __builtin_wasm_q15mulr_sat_s_i16x8(a, b);
+#elif defined(__SSSE3__)
+	// `pmulhrsw` wraps `-1 * -1` around to -1, which no other product
+	// rounds to, so flipping the bits of those elements saturates them.
+
+	i16x8 product = __builtin_ia32_pmulhrsw128(a, b);
+	return product ^ (i16x8) (product == splat<i16x8>(-32768));
+#else
+	i16x8 result;
+
+	for (usize i = 0; i < 8; i++)
+	{
+		i32 product = ((i32) a[i] * b[i] + 0x4000) >> 15;
+		result[i] = (i16) slaw::min(product, (i32) 32767);
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Narrows the elements of two `i16x8` vectors into a `u8x16` vector,
+ * clamping each element to [0, 255]. The elements of `a` come first.
+ * Compiles to a single `i8x16.narrow_i16x8_u` or `packuswb` instruction.
+ */
+inline u8x16
+narrow_u(i16x8 a, i16x8 b)
+{
+#ifdef __wasm_simd128__
+	return (u8x16) __builtin_wasm_narrow_u_i8x16_i16x8(a, b);
+#elif defined(__SSE2__)
+	return (u8x16) __builtin_ia32_packuswb128(a, b);
+#else
+	u8x16 result;
+
+	for (usize i = 0; i < 8; i++)
+	{
+		result[i] = (u8) slaw::min(slaw::max(a[i], (i16) 0), (i16) 255);
+		result[i + 8] = (u8) slaw::min(slaw::max(b[i], (i16) 0), (i16) 255);
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Narrows the elements of two `i16x8` vectors into an `i8x16` vector,
+ * clamping each element to [-128, 127]. The elements of `a` come first.
+ * Compiles to a single `i8x16.narrow_i16x8_s` or `packsswb` instruction.
+ */
+inline i8x16
+narrow_s(i16x8 a, i16x8 b)
+{
+#ifdef __wasm_simd128__
+	return __builtin_wasm_narrow_s_i8x16_i16x8(a, b);
+#elif defined(__SSE2__)
+	return (i8x16) __builtin_ia32_packsswb128(a, b);
+#else
+	i8x16 result;
+
+	for (usize i = 0; i < 8; i++)
+	{
+		result[i] = (i8) slaw::min(slaw::max(a[i], (i16) -128), (i16) 127);
+		result[i + 8] = (i8) slaw::min(slaw::max(b[i], (i16) -128), (i16) 127);
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Narrows the elements of two `i32x4` vectors into a `u16x8` vector,
+ * clamping each element to [0, 65535]. The elements of `a` come first.
+ * Compiles to a single `i16x8.narrow_i32x4_u` or `packusdw` instruction.
+ */
+inline u16x8
+narrow_u(i32x4 a, i32x4 b)
+{
+#ifdef __wasm_simd128__
+	return (u16x8) __builtin_wasm_narrow_u_i16x8_i32x4(a, b);
+#elif defined(__SSE4_1__)
+	return (u16x8) __builtin_ia32_packusdw128(a, b);
+#else
+	u16x8 result;
+
+	for (usize i = 0; i < 4; i++)
+	{
+		result[i] = (u16) slaw::min(slaw::max(a[i], 0), 65535);
+		result[i + 4] = (u16) slaw::min(slaw::max(b[i], 0), 65535);
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Narrows the elements of two `i32x4` vectors into an `i16x8` vector,
+ * clamping each element to [-32768, 32767]. The elements of `a` come first.
+ * Compiles to a single `i16x8.narrow_i32x4_s` or `packssdw` instruction.
+ */
+inline i16x8
+narrow_s(i32x4 a, i32x4 b)
+{
+#ifdef __wasm_simd128__
+	return __builtin_wasm_narrow_s_i16x8_i32x4(a, b);
+#elif defined(__SSE2__)
+	return __builtin_ia32_packssdw128(a, b);
+#else
+	i16x8 result;
+
+	for (usize i = 0; i < 4; i++)
+	{
+		result[i] = (i16) slaw::min(slaw::max(a[i], -32768), 32767);
+		result[i + 4] = (i16) slaw::min(slaw::max(b[i], -32768), 32767);
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Rounds the elements of two `f64x2` vectors to single precision, into an
+ * `f32x4` vector. The elements of `a` come first.
+ * Compiles to two `f32x4.demote_f64x2_zero` instructions and a shuffle.
+ */
+inline f32x4
+demote(f64x2 a, f64x2 b)
+{
+	using detail::f32x2;
+
+	f32x2 low = __builtin_convertvector(a, f32x2);
+	f32x2 high = __builtin_convertvector(b, f32x2);
+
+#if SLAW_HAS_BUILTIN(__builtin_shufflevector)
+	return __builtin_shufflevector(low, high, 0, 1, 2, 3);
+#else
+	f32x4 result;
+	__builtin_memcpy(&result, &low, sizeof(low));
+	__builtin_memcpy((u8 *) &result + sizeof(low), &high, sizeof(high));
+	return result;
+#endif
+}
+
+/**
+ * Widens the lower half of the elements of an 8, 16 or 32-bit integer SIMD
+ * vector to twice their width, with sign extension for signed elements.
+ * Compiles to a single `extend_low` instruction, or `f64x2.promote_low_f32x4`
+ * for `f32x4` vectors.
+ */
+template <typename T>
+inline simd_widen_of<T>
+extend_low(const T &v)
+{
+	return __builtin_convertvector(detail::half_of<0>(v),
+		simd_widen_of<T>);
+}
+
+/**
+ * Widens the upper half of the elements of an 8, 16 or 32-bit integer SIMD
+ * vector to twice their width, with sign extension for signed elements.
+ * Compiles to a single `extend_high` instruction, or a shuffle and
+ * `f64x2.promote_low_f32x4` for `f32x4` vectors.
+ */
+template <typename T>
+inline simd_widen_of<T>
+extend_high(const T &v)
+{
+	return __builtin_convertvector(detail::half_of<1>(v),
+		simd_widen_of<T>);
+}
+
+/**
+ * Adds adjacent pairs of elements of an 8 or 16-bit integer SIMD vector
+ * into elements of twice the width, so the sums cannot overflow. Element
+ * `i` of the result is `v[2i] + v[2i + 1]`.
+ * Compiles to a single `extadd_pairwise` instruction.
+ */
+template <typename T>
+inline simd_widen_of<T>
+extadd_pairwise(const T &v)
+{
+	static_assert(is_same<T, i8x16>() || is_same<T, u8x16>()
+		|| is_same<T, i16x8>() || is_same<T, u16x8>(),
+		"SIMD vector does not hold 8 or 16-bit integer types.");
+
+	using W = simd_widen_of<T>;
+
+#ifdef __wasm_simd128__
+	if constexpr (is_same<T, i8x16>())
+	{
+		return __builtin_wasm_extadd_pairwise_i8x16_s_i16x8(v);
+	}
+	else if constexpr (is_same<T, u8x16>())
+	{
+		return (W) __builtin_wasm_extadd_pairwise_i8x16_u_i16x8(
+			(i8x16) v);
+	}
+	else if constexpr (is_same<T, i16x8>())
+	{
+		return __builtin_wasm_extadd_pairwise_i16x8_s_i32x4(v);
+	}
+	else
+	{
+		return (W) __builtin_wasm_extadd_pairwise_i16x8_u_i32x4(
+			(i16x8) v);
+	}
+#else
+	// On a little-endian machine, the low half of each wide element is
+	// the even element and the high half is the odd element. Shifting
+	// right extends the odd elements, and shifting left and then right
+	// extends the even ones. Both shifts are arithmetic for signed types.
+
+	constexpr usize bits = 8 * sizeof(simd_element_type_of<T>);
+	return (((W) v << bits) >> bits) + ((W) v >> bits);
+#endif
+}
+
+/**
+ * Sums the elements of a `u8x16` vector into a 32-bit integer, so the sum
+ * cannot overflow. Adjacent elements are added into wider elements twice,
+ * which compiles to two `extadd_pairwise` instructions, or to a single
+ * `psadbw` instruction on SSE2.
+ */
+inline u32
+widening_sum(u8x16 v)
+{
+#ifdef __SSE2__
+	// `psadbw` sums the absolute differences to zero of each half of the
+	// bytes into a 64-bit element.
+
+	typedef char char16 __attribute__((__vector_size__(16)));
+	i64x2 halves = (i64x2) __builtin_ia32_psadbw128((char16) v,
+		(char16) {});
+	return (u32) (halves[0] + halves[1]);
+#else
+	return sum(extadd_pairwise(extadd_pairwise(v)));
+#endif
+}
+
+/**
+ * Sums the elements of an `i8x16` vector into a 32-bit integer, so the sum
+ * cannot overflow.
+ */
+inline i32
+widening_sum(i8x16 v)
+{
+	return sum(extadd_pairwise(extadd_pairwise(v)));
+}
+
+/**
+ * Sums the elements of a `u16x8` vector into a 32-bit integer, so the sum
+ * cannot overflow.
+ */
+inline u32
+widening_sum(u16x8 v)
+{
+	return sum(extadd_pairwise(v));
+}
+
+/**
+ * Sums the elements of an `i16x8` vector into a 32-bit integer, so the sum
+ * cannot overflow.
+ */
+inline i32
+widening_sum(i16x8 v)
+{
+#ifdef __SSE2__
+	// Multiplying by one and adding pairs is a widening pairwise add.
+
+	return sum(dot_pairs(v, splat<i16x8>(1)));
+#else
+	return sum(extadd_pairwise(v));
+#endif
+}
+
+/**
+ * Computes `a * b + c` for each element of floating-point SIMD vectors.
+ *
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_madd`
+ * instruction, which may or may not round the product before the addition,
+ * depending on the hardware. On native builds with FMA, it is always fused.
+ * Otherwise it is computed as a multiplication followed by an addition.
+ */
+template <typename T>
+inline T
+fma(const T &a, const T &b, const T &c)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+#if defined(__wasm_relaxed_simd__) \
+	&& SLAW_HAS_BUILTIN(__builtin_wasm_relaxed_madd_f32x4)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_relaxed_madd_f32x4(a, b, c);
+	}
+	else
+	{
+		return __builtin_wasm_relaxed_madd_f64x2(a, b, c);
+	}
+#elif defined(__FMA__) && SLAW_HAS_BUILTIN(__builtin_elementwise_fma)
+	return __builtin_elementwise_fma(a, b, c);
+#elif defined(__FMA__)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_ia32_vfmaddps(a, b, c);
+	}
+	else
+	{
+		return __builtin_ia32_vfmaddpd(a, b, c);
+	}
+#else
+	return a * b + c;
+#endif
+}
+
+/**
+ * Computes `a * b - c` for each element of floating-point SIMD vectors.
+ * Like `fma()`, the product may or may not be rounded before the
+ * subtraction.
+ */
+template <typename T>
+inline T
+fms(const T &a, const T &b, const T &c)
+{
+	return fma(a, b, -c);
+}
+
+/**
+ * Computes `c - a * b` for each element of floating-point SIMD vectors.
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_nmadd`
+ * instruction. Like `fma()`, the product may or may not be rounded before
+ * the subtraction.
+ */
+template <typename T>
+inline T
+fnma(const T &a, const T &b, const T &c)
+{
+#if defined(__wasm_relaxed_simd__) \
+	&& SLAW_HAS_BUILTIN(__builtin_wasm_relaxed_nmadd_f32x4)
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_relaxed_nmadd_f32x4(a, b, c);
+	}
+	else
+	{
+		return __builtin_wasm_relaxed_nmadd_f64x2(a, b, c);
+	}
+#else
+	return fma(-a, b, c);
+#endif
+}
+
+/**
+ * Evaluates a polynomial with Horner's method, with one `fma()` per
+ * coefficient. The coefficients start at the constant term, so
+ * `polynomial(x, c0, c1, c2)` computes `c0 + c1 * x + c2 * x^2`.
+ */
+template <typename T, typename... Coefficients>
+inline T
+polynomial(const T &x, simd_element_type_of<T> c0, Coefficients... rest)
+{
+	if constexpr (sizeof...(rest) == 0)
+	{
+		return splat<T>(c0);
+	}
+	else
+	{
+		return fma(polynomial(x, rest...), x, splat<T>(c0));
+	}
+}
+
+/**
+ * Returns the dot product of two arrays of floating-point numbers.
+ * Four vectors are accumulated independently with `fma()`, so the loop is
+ * not limited by the latency of a single chain of additions.
+ * The result may differ from a sequential sum in the last bits.
+ *
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+template <typename E>
+inline E
+dot(const E *a, const E *b, usize n)
+{
+	static_assert(is_float<E>(), "Type is not a floating point type.");
+
+	using T = simd_vector_of<E>;
+	constexpr usize lanes = simd_vector_size<T>();
+
+	T acc[4] = {};
+	usize i = 0;
+
+	for (; i + 4 * lanes <= n; i += 4 * lanes)
+	{
+		for (usize j = 0; j < 4; j++)
+		{
+			acc[j] = fma(load<T>(a + i + j * lanes),
+				load<T>(b + i + j * lanes), acc[j]);
+		}
+	}
+
+	for (; i + lanes <= n; i += lanes)
+	{
+		acc[0] = fma(load<T>(a + i), load<T>(b + i), acc[0]);
+	}
+
+	E result = sum((acc[0] + acc[1]) + (acc[2] + acc[3]));
+
+	for (; i < n; i++)
+	{
+		result += a[i] * b[i];
+	}
+
+	return result;
+}
+
+/**
+ * Selects bytes from a SIMD vector using a vector of run-time indices, like
+ * `swizzle()`, but the result for indices of 16 and above depends on the
+ * hardware. Use this when all indices are known to be below 16.
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_swizzle`
+ * instruction. On SSSE3, it skips the index fix-up that `swizzle()` needs.
+ */
+inline u8x16
+relaxed_swizzle(u8x16 v, u8x16 indices)
+{
+#ifdef __wasm_relaxed_simd__
+	return (u8x16) __builtin_wasm_relaxed_swizzle_i8x16((i8x16) v,
+		(i8x16) indices);
+#elif defined(__SSSE3__)
+	typedef char char16 __attribute__((__vector_size__(16)));
+	return (u8x16) __builtin_ia32_pshufb128((char16) v, (char16) indices);
+#else
+	return swizzle(v, indices);
+#endif
+}
+
+/**
+ * Performs an element-wise minimum of two floating-point SIMD vectors,
+ * where the result for NaNs and for zeroes of different signs depends on
+ * the hardware.
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_min`
+ * instruction. Otherwise it is `min()`.
+ */
+template <typename T>
+inline T
+relaxed_min(const T &a, const T &b)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+#ifdef __wasm_relaxed_simd__
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_relaxed_min_f32x4(a, b);
+	}
+	else
+	{
+		return __builtin_wasm_relaxed_min_f64x2(a, b);
+	}
+#else
+	return min(a, b);
+#endif
+}
+
+/**
+ * Performs an element-wise maximum of two floating-point SIMD vectors,
+ * where the result for NaNs and for zeroes of different signs depends on
+ * the hardware.
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_max`
+ * instruction. Otherwise it is `max()`.
+ */
+template <typename T>
+inline T
+relaxed_max(const T &a, const T &b)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+#ifdef __wasm_relaxed_simd__
+	if constexpr (is_same<T, f32x4>())
+	{
+		return __builtin_wasm_relaxed_max_f32x4(a, b);
+	}
+	else
+	{
+		return __builtin_wasm_relaxed_max_f64x2(a, b);
+	}
+#else
+	return max(a, b);
+#endif
+}
+
+/**
+ * Converts the elements of a `f32x4` vector to 32-bit integers, rounding
+ * towards zero. Elements that are NaN or out of range become 0 or the
+ * nearest representable integer.
+ * Compiles to a single `i32x4.trunc_sat_f32x4_s` instruction.
+ */
+inline i32x4
+trunc_sat(f32x4 v)
+{
+#ifdef __wasm_simd128__
+	return __builtin_wasm_trunc_saturate_s_i32x4_f32x4(v);
+#else
+	i32x4 result;
+
+	for (usize i = 0; i < 4; i++)
+	{
+		result[i] = v[i] != v[i] ? 0
+			: v[i] >= 2147483648.0f ? 2147483647
+			: v[i] < -2147483648.0f ? (-2147483647 - 1)
+			: (i32) v[i];
+	}
+
+	return result;
+#endif
+}
+
+/**
+ * Converts the elements of a `f32x4` vector to 32-bit integers, rounding
+ * towards zero, where the result for NaNs and out-of-range elements
+ * depends on the hardware. Use this when all elements are known to be in
+ * range.
+ * With `-mrelaxed-simd`, this compiles to a single `relaxed_trunc`
+ * instruction, which is much cheaper than the saturating conversion on x86.
+ * On SSE2, it is a single `cvttps2dq` instruction.
+ */
+inline i32x4
+relaxed_trunc(f32x4 v)
+{
+#ifdef __wasm_relaxed_simd__
+	return __builtin_wasm_relaxed_trunc_s_i32x4_f32x4(v);
+#elif defined(__SSE2__)
+	return __builtin_ia32_cvttps2dq(v);
+#else
+	return trunc_sat(v);
+#endif
 }
 }; // namespace slaw::simd
 }; // namespace slaw
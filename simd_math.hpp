@@ -0,0 +1,1218 @@
+#ifndef SLAW_SIMD_MATH_H
+#define SLAW_SIMD_MATH_H
+
+#include "types.hpp"
+#include "math.hpp"
+#include "simd.hpp"
+
+// Transcendental functions and reciprocal approximations on `f32x4` and
+// `f64x2` vectors.
+//
+// Every transcendental function reduces its argument to a small range, evaluates a minimax
+// polynomial with `fma()` and undoes the reduction with bit operations, so
+// the whole computation stays in SIMD registers and never calls into the
+// host. The functions take a `Precision` tier as their first template
+// argument:
+//
+// - `Precision::Full` (the default) is accurate to the number of ULPs (units
+//   in the last place) listed for each function, and handles zeroes,
+//   infinities, NaNs and subnormal numbers like the C library does. Angles
+//   too large for the usual reduction are reduced one lane at a time.
+// - `Precision::Fast` uses shorter polynomials and skips the special cases.
+//   Its relative error is listed for each function.
+//
+// The error bounds were measured against a long double reference, see
+// `test/simd_math_bench.cpp`. They hold for IEEE arithmetic. Builds with
+// `-ffast-math` may simplify the compensated steps away, which costs up to a
+// few more ULPs, and do not preserve NaNs.
+
+namespace slaw
+{
+namespace simd
+{
+namespace detail
+{
+/**
+ * A compile-time macro that resolves into the unsigned integer vector type
+ * with elements of the same width as a given floating-point vector type.
+ */
+template <typename T>
+using simd_bits_of = simd_vector_of<typename simd_unsigned_integer_of_impl<
+	sizeof(simd_element_type_of<T>)>::type>;
+
+/**
+ * Returns the number of explicit mantissa bits of a floating-point type.
+ */
+template <typename E>
+constexpr usize
+mantissa_bits()
+{
+	return is_same<E, f32>() ? 23 : 52;
+}
+
+/**
+ * Returns the exponent bias of a floating-point type.
+ */
+template <typename E>
+constexpr usize
+exponent_bias()
+{
+	return is_same<E, f32>() ? 127 : 1023;
+}
+
+/**
+ * Returns 2^n for each element of a floating-point vector of whole numbers.
+ * The exponents must lie within the exponents of normal numbers.
+ */
+template <typename T>
+inline T
+pow2i(const T &n)
+{
+	using E = simd_element_type_of<T>;
+	using U = simd_bits_of<T>;
+
+	// Adding 2^mantissa_bits puts `n + bias` in the lowest bits of the
+	// mantissa, and shifting moves them into the exponent.
+
+	constexpr E offset = (E) ((u64) 1 << mantissa_bits<E>())
+		+ (E) exponent_bias<E>();
+
+	return (T) ((U) (n + offset) << mantissa_bits<E>());
+}
+
+/**
+ * Returns the lowest bits of each element of a floating-point vector of
+ * whole numbers, as an unsigned integer vector. The magnitude of the
+ * numbers must be below 2^(mantissa_bits - 1).
+ */
+template <typename T>
+inline simd_bits_of<T>
+low_bits_of(const T &n)
+{
+	using E = simd_element_type_of<T>;
+	using U = simd_bits_of<T>;
+
+	// After adding 1.5 * 2^mantissa_bits, the mantissa holds the number in
+	// two's complement. Unlike a conversion, this never traps on WASM.
+
+	constexpr E offset = (E) ((u64) 3 << (mantissa_bits<E>() - 1));
+	return (U) (n + offset);
+}
+
+/**
+ * Converts each element of an unsigned integer vector that is smaller than
+ * 2^mantissa_bits to the floating-point vector type of the same width.
+ */
+template <typename T>
+inline T
+to_float(const simd_bits_of<T> &n)
+{
+	using E = simd_element_type_of<T>;
+	using U = simd_bits_of<T>;
+
+	// ORing the number into the mantissa of 2^mantissa_bits gives
+	// 2^mantissa_bits + n, exactly.
+
+	using B = simd_element_type_of<U>;
+
+	constexpr E offset = (E) ((u64) 1 << mantissa_bits<E>());
+	constexpr B offset_bits = slaw::detail::interpret_float_as_int(offset);
+	return (T) (n | offset_bits) - offset;
+}
+
+/**
+ * Returns the sign bits of a floating-point vector.
+ */
+template <typename T>
+inline simd_bits_of<T>
+sign_of(const T &x)
+{
+	using U = simd_bits_of<T>;
+	using B = simd_element_type_of<U>;
+
+	return (U) x & ((B) 1 << (8 * sizeof(B) - 1));
+}
+
+/**
+ * Computes `a + b` exactly, as a rounded sum and its rounding error.
+ */
+template <typename T>
+inline void
+two_sum(const T &a, const T &b, T &sum, T &error)
+{
+	sum = a + b;
+	T b_part = sum - a;
+	error = (a - (sum - b_part)) + (b - b_part);
+}
+
+/**
+ * Computes `a * b` exactly, as a rounded product and its rounding error.
+ * Without a fused multiply-add, the factors are split into halves, and
+ * their magnitude must be below 2^115 (`f32x4`) or 2^995 (`f64x2`).
+ */
+template <typename T>
+inline void
+two_product(const T &a, const T &b, T &product, T &error)
+{
+	product = a * b;
+
+#if defined(__FMA__)
+	// The split below is not exact when the compiler contracts its
+	// products into fused multiply-adds, which it may do on any target
+	// with them.
+
+	error = fma(a, b, -product);
+#else
+	using E = simd_element_type_of<T>;
+
+	constexpr E splitter = (E) (((u64) 1 << (mantissa_bits<E>() / 2 + 1))
+		+ 1);
+
+	T a_scaled = a * splitter;
+	T a_high = a_scaled - (a_scaled - a);
+	T a_low = a - a_high;
+	T b_scaled = b * splitter;
+	T b_high = b_scaled - (b_scaled - b);
+	T b_low = b - b_high;
+
+	error = ((a_high * b_high - product) + a_high * b_low
+		+ a_low * b_high) + a_low * b_low;
+#endif
+}
+
+/**
+ * Computes e^(hi + lo), where `lo` is a small correction to `hi`.
+ */
+template <Precision P, typename T>
+inline T
+exp_of_sum(const T &hi, const T &lo)
+{
+	using E = simd_element_type_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	// Outside of these bounds the result is 0 or infinity. The fast tier
+	// scales the result by a single power of two, so its results below
+	// 2^-125 (f32) or 2^-1021 (f64) flush to 0.
+
+	constexpr E high = single ? 89 : 710;
+	constexpr E low = P == Precision::Full ? (single ? -104 : -746)
+		: (single ? -87.5 : -708.5);
+
+	T x = select(gt(hi, splat<T>(high)), splat<T>(high), hi);
+	x = select(lt(x, splat<T>(low)), splat<T>(low), x);
+
+	// x = n * ln(2) + r, where |r| <= ln(2) / 2, so e^x = 2^n * e^r.
+	// ln(2) is split in two parts. The first part has enough trailing
+	// zeroes that multiplying it by n is exact.
+
+	constexpr E ln2_hi = single ? 0.693359375 : 6.93147180369123816490e-01;
+	constexpr E ln2_lo = single ? -2.12194440e-4
+		: 1.90821492927058770002e-10;
+
+	T n = floor(fma(x, splat<T>((E) LOG_2_E), splat<T>((E) 0.5)));
+	T r = fnma(n, splat<T>(ln2_hi), x);
+	r = fnma(n, splat<T>(ln2_lo), r) + select(eq(x, hi), lo, splat<T>(0));
+
+	// e^r = 1 + r + r^2 * p(r).
+
+	T p;
+
+	if constexpr (P == Precision::Fast)
+	{
+		p = polynomial(r, 5.000512004e-01, 1.675351411e-01,
+			4.127774760e-02);
+	}
+	else if constexpr (single)
+	{
+		p = polynomial(r, 4.999999404e-01, 1.666652113e-01,
+			4.166828841e-02, 8.368615992e-03, 1.382071176e-03);
+	}
+	else
+	{
+		// The Taylor series up to r^13 is accurate to well below
+		// one ULP on this range.
+
+		p = polynomial(r, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120,
+			1.0 / 720, 1.0 / 5040, 1.0 / 40320, 1.0 / 362880,
+			1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600,
+			1.0 / 6227020800);
+	}
+
+	T result = fma(r * r, p, r) + (E) 1;
+
+	if constexpr (P == Precision::Fast)
+	{
+		// 2^n is taken as 2 * 2^(n - 1), so the largest results do not
+		// need an exponent beyond the range of normal numbers.
+
+		return (result + result) * pow2i(n - (E) 1);
+	}
+	else
+	{
+		// Results near the overflow and underflow bounds need an
+		// exponent outside of the range of normal numbers, so the
+		// result is scaled in two steps.
+
+		T half = floor(n * (E) 0.5);
+		return result * pow2i(half) * pow2i(n - half);
+	}
+}
+
+/**
+ * Splits each element of a positive floating-point vector into `2^k * m`,
+ * where √0.5 <= m < √2, and returns `f = m - 1`.
+ */
+template <Precision P, typename T>
+inline T
+split_exponent(const T &x, T &k)
+{
+	using E = simd_element_type_of<T>;
+	using U = simd_bits_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	T v = x;
+	k = splat<T>(-(E) exponent_bias<E>());
+
+	if constexpr (P == Precision::Full)
+	{
+		// Subnormal numbers are scaled into the normal range first.
+
+		constexpr E smallest_normal = single ? 1.17549435e-38
+			: 2.2250738585072014e-308;
+		constexpr E scale = single ? 33554432.0 : 18014398509481984.0;
+		constexpr E scale_exponent = single ? 25 : 54;
+
+		auto subnormal = lt(v, splat<T>(smallest_normal));
+		v = select(subnormal, v * scale, v);
+		k = select(subnormal, k - scale_exponent, k);
+	}
+
+	// Offsetting the bits by the difference between 1 and √0.5 moves
+	// mantissas of √2 and above into the next exponent. After the
+	// exponent is read, the offset is added back to the mantissa.
+
+	using B = simd_element_type_of<U>;
+
+	constexpr B one = slaw::detail::interpret_float_as_int((E) 1);
+	constexpr B sqrt_half = single ? 0x3F3504F3 : 0x3FE6A09E00000000;
+	constexpr B mantissa = ((B) 1 << mantissa_bits<E>()) - 1;
+
+	U bits = (U) v + (one - sqrt_half);
+	k += to_float<T>(bits >> mantissa_bits<E>());
+	bits = (bits & mantissa) + sqrt_half;
+
+	return (T) bits - (E) 1;
+}
+
+/**
+ * Returns ln(1 + f) - 2s - (f^2 / 2 - ...), which is s * R(s^2), where
+ * s = f / (2 + f). See `ln()`.
+ */
+template <Precision P, typename T>
+inline T
+ln_tail(const T &s)
+{
+	using E = simd_element_type_of<T>;
+	T z = s * s;
+
+	if constexpr (P == Precision::Fast)
+	{
+		return z * polynomial(z, 6.665562391e-01, 4.120199680e-01);
+	}
+	else if constexpr (is_same<E, f32>())
+	{
+		return z * polynomial(z, 6.666677594e-01, 3.997779191e-01,
+			2.986555398e-01);
+	}
+	else
+	{
+		return z * polynomial(z, 6.666666666666735130e-01,
+			3.999999999940941908e-01, 2.857142874366239149e-01,
+			2.222219843214978396e-01, 1.818357216161805012e-01,
+			1.531383769920937332e-01, 1.479819860511658591e-01);
+	}
+}
+
+/**
+ * Returns the natural logarithm of each element of a positive, finite
+ * floating-point vector, as a sum `hi + lo` that is accurate to about
+ * twice the precision of the elements.
+ */
+template <typename T>
+inline void
+ln_extended(const T &x, T &hi, T &lo)
+{
+	using E = simd_element_type_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	T k;
+	T f = split_exponent<Precision::Full>(x, k);
+
+	// s = f / (2 + f). The rounding error of s is recovered from the exact
+	// residual `f - s * (2 + f)`.
+
+	T u, u_lo;
+	two_sum(splat<T>(2), f, u, u_lo);
+
+	T s = f / u;
+	T su, su_lo;
+	two_product(s, u, su, su_lo);
+	T s_lo = (((f - su) - su_lo) - s * u_lo) / u;
+
+	constexpr E ln2_hi = single ? 0.693359375 : 6.93147180369123816490e-01;
+	constexpr E ln2_lo = single ? -2.12194440e-4
+		: 1.90821492927058770002e-10;
+
+	// ln(1 + f) = 2s + 2s^3 / 3 + 2s^5 / 5 + ... The first two terms are
+	// kept in two parts. The rest is below 2^-12 of the result, so plain
+	// precision is enough for it.
+
+	T z, z_lo;
+	two_product(s, s, z, z_lo);
+	T cube, cube_lo;
+	two_product(s, z, cube, cube_lo);
+	cube_lo = fma(s, z_lo, cube_lo);
+
+	constexpr E two_thirds_hi = single ? 0.666666687 : 0.66666666666666663;
+	constexpr E two_thirds_lo = single ? -1.98682149e-8
+		: 3.7007434154171886e-17;
+
+	T third, third_lo;
+	two_product(cube, splat<T>(two_thirds_hi), third, third_lo);
+	third_lo += cube_lo * two_thirds_hi + cube * two_thirds_lo;
+
+	T rest = cube * z * polynomial(z, 2.0 / 5, 2.0 / 7, 2.0 / 9, 2.0 / 11,
+		2.0 / 13, 2.0 / 15, 2.0 / 17, 2.0 / 19, 2.0 / 21, 2.0 / 23,
+		2.0 / 25, 2.0 / 27, 2.0 / 29, 2.0 / 31);
+
+	T first, error;
+	two_sum(k * ln2_hi, s + s, first, lo);
+	two_sum(first, third, hi, error);
+	lo += error + ((third_lo + rest) + (s_lo + s_lo) + k * ln2_lo);
+
+	T sum = hi + lo;
+	lo = lo - (sum - hi);
+	hi = sum;
+}
+
+/**
+ * Applies the special cases of `pow()` to an approximation of
+ * e^(y * ln|x|).
+ */
+template <typename T>
+inline T
+pow_special_cases(const T &x, const T &y, T result)
+{
+	using E = simd_element_type_of<T>;
+	using M = simd_mask_of<T>;
+	constexpr usize bits = 8 * sizeof(E);
+
+	T ax = abs(x);
+	T infinity = splat<T>(Infinity<E>());
+	auto y_negative = lt(y, splat<T>(0));
+
+	result = select(eq(ax, splat<T>(0)), select(y_negative, infinity,
+		splat<T>(0)), result);
+	result = select(eq(ax, infinity), select(y_negative, splat<T>(0),
+		infinity), result);
+	result = select(ne(x, x), x, result);
+	result = select(ne(y, y), y, result);
+
+	// Negative x gives a negative result for odd whole y, and NaN for y
+	// that is not whole.
+
+	T half_y = y * (E) 0.5;
+	auto whole = eq(floor(y), y);
+	auto odd = whole & ne(floor(half_y), half_y);
+	auto x_negative = (M) sign_of(x) >> (bits - 1);
+
+	result = select(x_negative & odd, -result, result);
+	result = select(~whole & lt(x, splat<T>(0)) & gt(x, -infinity),
+		splat<T>(is_same<E, f32>() ? NaN32 : NaN64), result);
+
+	// Any power of 1 is 1, and so is any power of -1 with infinite y.
+
+	auto one = eq(y, splat<T>(0)) | eq(x, splat<T>(1))
+		| (eq(ax, splat<T>(1)) & eq(abs(y), infinity));
+
+	return select(one, splat<T>(1), result);
+}
+
+/**
+ * Reduces an angle to `r` in [-π/4, π/4], where `x = j * π/2 + r`, and
+ * returns j, or a number equal to j modulo 4. The full tier also returns
+ * the rounding error of r in `r_lo`. The fast tier sets it to 0.
+ */
+template <Precision P, typename T>
+inline T
+reduce_angle(const T &x, T &r, T &r_lo)
+{
+	using E = simd_element_type_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	if constexpr (single && P == Precision::Full)
+	{
+		// Angles close to a multiple of π/2 lose most of their bits in
+		// the reduction, so floats are reduced in double precision.
+
+		f64x2 r_low, r_high, unused;
+		f64x2 j_low = reduce_angle<P>(extend_low(x), r_low, unused);
+		f64x2 j_high = reduce_angle<P>(extend_high(x), r_high, unused);
+
+		r = demote(r_low, r_high);
+		r_lo = demote(r_low - extend_low(r), r_high - extend_high(r));
+		return demote(j_low, j_high);
+	}
+
+	// π/2 is split in three parts. The first two have enough trailing
+	// zeroes that multiplying them by j is exact below the limit.
+
+	constexpr E part_1 = single ? 1.5703125 : 1.57079632673412561417e+00;
+	constexpr E part_2 = single ? 4.837512969970703125e-4
+		: 6.07710050630396597660e-11;
+	constexpr E part_3 = single ? 7.54978995489188216e-8
+		: 2.02226624871116645580e-21;
+	constexpr E limit = single ? 8192 : 1048576;
+
+	T j = floor(fma(x, splat<T>((E) (2 / PI)), splat<T>((E) 0.5)));
+
+	if constexpr (P == Precision::Fast)
+	{
+		r = fnma(j, splat<T>(part_1), x);
+		r = fnma(j, splat<T>(part_2), r);
+		r = fnma(j, splat<T>(part_3), r);
+		r_lo = splat<T>(0);
+		return j;
+	}
+
+	// The first subtraction is exact. The rounding errors of the other
+	// two are kept in r_lo.
+
+	T r_1 = fnma(j, splat<T>(part_1), x);
+	T r_2, error_2, error_3;
+	two_sum(r_1, -(j * part_2), r_2, error_2);
+	two_sum(r_2, -(j * part_3), r, error_3);
+	r_lo = error_2 + error_3;
+
+	// Larger angles are rare, so their lanes are reduced one at a time
+	// with all the bits of π that they need.
+
+	auto large = gt(abs(x), splat<T>(limit));
+
+	if (any_true(large))
+	{
+		for (usize i = 0; i < sizeof(T) / sizeof(E); i++)
+		{
+			if (large[i])
+			{
+				f64 r_hi = 0, r_lo_lane = 0;
+				j[i] = slaw::detail::reduce_half_pi(x[i], r_hi,
+					r_lo_lane);
+				r[i] = r_hi;
+				r_lo[i] = r_lo_lane;
+			}
+		}
+	}
+
+	return j;
+}
+
+/**
+ * Returns sin(r + r_lo) for r in [-π/4, π/4], where r_lo is a rounding
+ * error of r. The fast tier ignores r_lo.
+ */
+template <Precision P, typename T>
+inline T
+sin_reduced(const T &r, const T &r_lo)
+{
+	using E = simd_element_type_of<T>;
+	T z = r * r;
+	T p;
+
+	if constexpr (P == Precision::Fast)
+	{
+		p = polynomial(z, -1.666339040e-01, 8.163281716e-03);
+	}
+	else if constexpr (is_same<E, f32>())
+	{
+		p = polynomial(z, -1.666665673e-01, 8.332309313e-03,
+			-1.953257306e-04);
+	}
+	else
+	{
+		p = polynomial(z, -1.66666666666666324348e-01,
+			8.33333333332248946124e-03, -1.98412698298579493134e-04,
+			2.75573137070700676789e-06, -2.50507602534068634195e-08,
+			1.58969099521155010221e-10);
+	}
+
+	T result;
+
+	if constexpr (P == Precision::Full)
+	{
+		// sin(r + r_lo) = sin(r) + r_lo * cos(r), and cos(r) = 1 - z/2
+		// is close enough for a term that small.
+
+		result = r + fma(r * z, p, fnma(r_lo, z * (E) 0.5, r_lo));
+	}
+	else
+	{
+		result = fma(r * z, p, r);
+	}
+
+	// The sign of r is ORed back in, which only changes anything for -0.
+
+	return (T) ((simd_bits_of<T>) result | sign_of(r));
+}
+
+/**
+ * Returns cos(r + r_lo) for r in [-π/4, π/4], where r_lo is a rounding
+ * error of r. The fast tier ignores r_lo.
+ */
+template <Precision P, typename T>
+inline T
+cos_reduced(const T &r, const T &r_lo)
+{
+	using E = simd_element_type_of<T>;
+	T z = r * r;
+	T p;
+
+	if constexpr (P == Precision::Fast)
+	{
+		p = polynomial(z, 4.166106880e-02, -1.364871510e-03);
+	}
+	else if constexpr (is_same<E, f32>())
+	{
+		p = polynomial(z, 4.166661203e-02, -1.388603239e-03,
+			2.431668690e-05);
+	}
+	else
+	{
+		p = polynomial(z, 4.16666666666666019037e-02,
+			-1.38888888888741095749e-03, 2.48015872894767294178e-05,
+			-2.75573143513906633035e-07, 2.08757232129817482790e-09,
+			-1.13596475577881948265e-11);
+	}
+
+	// cos(r) = 1 - z/2 + z^2 * p. The rounding error of `1 - z/2` is
+	// added back separately.
+
+	T half_z = z * (E) 0.5;
+	T w = (E) 1 - half_z;
+	T tail = ((E) 1 - w) - half_z;
+
+	// cos(r + r_lo) = cos(r) - r_lo * sin(r), and sin(r) = r is close
+	// enough for a term that small.
+
+	if constexpr (P == Precision::Full)
+	{
+		tail = fnma(r, r_lo, tail);
+	}
+
+	return w + fma(z * z, p, tail);
+}
+
+/**
+ * Returns the magnitude below which atan(t) rounds to t, well above the
+ * magnitudes at which powers of t become subnormal numbers.
+ */
+template <typename E>
+constexpr E
+atan_tiny()
+{
+	return is_same<E, f32>() ? 0x1p-32 : 0x1p-256;
+}
+
+/**
+ * Returns `atan(t + t_lo) - t + tail` for t in [-tan(π/8), tan(π/8)], where
+ * t_lo is a rounding error of t and `tail` is a small correction to the
+ * result.
+ */
+template <Precision P, typename T>
+inline T
+atan_reduced(const T &t, const T &t_lo, const T &tail)
+{
+	using E = simd_element_type_of<T>;
+
+	// atan(t) - t is below the precision of t for tiny t. Flushing them
+	// to 0 keeps the powers of t from becoming subnormal numbers, which
+	// are very slow on x86.
+
+	T u = select(lt(abs(t), splat<T>(atan_tiny<E>())), splat<T>(0), t);
+	T z = u * u;
+	T p;
+
+	if constexpr (P == Precision::Fast)
+	{
+		p = polynomial(z, -3.332550526e-01, 1.971414387e-01,
+			-1.122516394e-01);
+	}
+	else if constexpr (is_same<E, f32>())
+	{
+		p = polynomial(z, -3.333329558e-01, 1.999737471e-01,
+			-1.422224343e-01, 1.043827832e-01, -5.698338896e-02);
+	}
+	else
+	{
+		// A rational approximation converges faster than a
+		// polynomial for atan, and the division runs in parallel with
+		// the polynomials.
+
+		p = polynomial(z, -6.485021904942025371773e1,
+			-1.228866684490136173410e2, -7.500855792314704667340e1,
+			-1.615753718733365076637e1, -8.750608600031904122785e-1)
+			/ polynomial(z, 1.945506571482613964425e2,
+			4.853903996359136964868e2, 4.328810604912902668951e2,
+			1.650270098316988542046e2, 2.485846490142306297962e1,
+			1.0);
+	}
+
+	if constexpr (P == Precision::Full)
+	{
+		// atan(t + t_lo) = atan(t) + t_lo / (1 + t^2).
+
+		return fma(u * z, p, fnma(t_lo, z, t_lo) + tail);
+	}
+	else
+	{
+		return fma(u * z, p, tail);
+	}
+}
+
+/**
+ * Returns atan(a + a_lo) for non-negative a, where a_lo is a rounding error
+ * of a. The fast tier ignores a_lo.
+ */
+template <Precision P, typename T>
+inline T
+atan_positive(const T &a, const T &a_lo)
+{
+	using E = simd_element_type_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	// Above tan(3π/8), atan(a) = π/2 + atan(-1 / a). Above tan(π/8),
+	// atan(a) = π/4 + atan((a - 1) / (a + 1)). The offsets are split in two
+	// parts, so the result is accurate near them.
+
+	auto large = gt(a, splat<T>((E) 2.41421356237309504880));
+	auto medium = gt(a, splat<T>((E) 0.41421356237309504880)) & ~large;
+
+	T sum, sum_lo;
+	two_sum(a, splat<T>(1), sum, sum_lo);
+
+	T numerator = select(large, splat<T>(-1), select(medium,
+		a - (E) 1, a));
+	T denominator = select(large, a, select(medium, sum, splat<T>(1)));
+
+	constexpr E quarter_pi = PI / 4;
+	constexpr E quarter_pi_lo = single ? -2.1855694e-8
+		: 3.061616997868383e-17;
+
+	T offset = select(large, splat<T>(2 * quarter_pi), select(medium,
+		splat<T>(quarter_pi), splat<T>(0)));
+	T offset_lo = select(large, splat<T>(2 * quarter_pi_lo),
+		select(medium, splat<T>(quarter_pi_lo), splat<T>(0)));
+
+	if constexpr (P == Precision::Fast)
+	{
+		T t = numerator / denominator;
+		return offset + (t + atan_reduced<P>(t, a_lo, offset_lo));
+	}
+	else
+	{
+		// The division is replaced by a multiplication with the
+		// reciprocal, since its rounding error is recovered anyway,
+		// together with those of a + 1 and of a. Only the medium
+		// branch needs this: the large branch does not cancel, and the
+		// small one divides by 1. The other lanes are zeroed, so they
+		// cannot produce slow subnormal numbers.
+
+		T reciprocal = (E) 1 / denominator;
+		T t = numerator * reciprocal;
+		T t_medium = select(medium, t, splat<T>(0));
+
+		T product, product_lo;
+		two_product(t_medium, denominator, product, product_lo);
+
+		T residual = (select(medium, numerator, splat<T>(0)) - product)
+			- product_lo + a_lo - t_medium * (sum_lo + a_lo);
+		T t_lo = select(medium, residual * reciprocal,
+			select(large, splat<T>(0), a_lo));
+
+		// The rounding error of the sum of the offset and t is added
+		// back separately.
+
+		T head = offset + t;
+		T error = (offset - head) + t;
+
+		return head + (atan_reduced<P>(t, t_lo, offset_lo) + error);
+	}
+}
+}; // namespace slaw::simd::detail
+
+/**
+ * Returns e^x for each element of a floating-point SIMD vector.
+ *
+ * - Error: 1 ULP. Fast tier: 6e-6 relative, and results below 2^-125
+ *   (`f32x4`) or 2^-1021 (`f64x2`) flush to 0.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+exp(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	return detail::exp_of_sum<P>(x, splat<T>(0));
+}
+
+/**
+ * Returns the natural logarithm of each element of a floating-point SIMD
+ * vector. ln(0) is -infinity, and negative numbers give NaN.
+ *
+ * - Error: 1 ULP. Fast tier: 3e-7 relative, for positive normal numbers
+ *   only.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+ln(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using E = simd_element_type_of<T>;
+	constexpr bool single = is_same<E, f32>();
+
+	T k;
+	T f = detail::split_exponent<P>(x, k);
+
+	// ln(x) = k * ln(2) + ln(1 + f). With s = f / (2 + f),
+	// ln(1 + f) = 2s + s * R(s^2) = f - f^2 / 2 + s * (f^2 / 2 + R(s^2)),
+	// where the last form keeps the rounding error away from the larger
+	// terms.
+
+	T s = f / (f + (E) 2);
+	T half_f2 = f * f * (E) 0.5;
+	T tail = s * (half_f2 + detail::ln_tail<P>(s));
+
+	constexpr E ln2_hi = single ? 6.9313812256e-01
+		: 6.93147180369123816490e-01;
+	constexpr E ln2_lo = single ? 9.0580006145e-06
+		: 1.90821492927058770002e-10;
+
+	T result = fma(k, splat<T>(ln2_hi),
+		(f - (half_f2 - fma(k, splat<T>(ln2_lo), tail))));
+
+	if constexpr (P == Precision::Full)
+	{
+		result = select(eq(x, splat<T>(0)),
+			splat<T>(-Infinity<E>()), result);
+		result = select(eq(x, splat<T>(Infinity<E>())), x, result);
+		result = select(~ge(x, splat<T>(0)),
+			splat<T>(single ? NaN32 : NaN64), result);
+	}
+
+	return result;
+}
+
+/**
+ * Returns the sine of each element of a floating-point SIMD vector, in
+ * radians.
+ *
+ * - Error: 1 ULP. Fast tier: 2e-6 relative, for |x| < 8192 (`f32x4`) or
+ *   |x| < 2^20 (`f64x2`). Its error grows for larger inputs.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+sin(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using U = detail::simd_bits_of<T>;
+	constexpr usize bits = 8 * sizeof(simd_element_type_of<T>);
+
+	// sin(j * π/2 + r) is sin(r), cos(r), -sin(r) or -cos(r), for j modulo
+	// 4 equal to 0, 1, 2 and 3.
+
+	T r, r_lo;
+	U j = detail::low_bits_of(detail::reduce_angle<P>(x, r, r_lo));
+
+	T s = detail::sin_reduced<P>(r, r_lo);
+	T c = detail::cos_reduced<P>(r, r_lo);
+
+	U swap = -(j & 1);
+	U sign = (j & 2) << (bits - 2);
+	return (T) ((((U) s & ~swap) | ((U) c & swap)) ^ sign);
+}
+
+/**
+ * Returns the cosine of each element of a floating-point SIMD vector, in
+ * radians.
+ *
+ * - Error: 1 ULP. Fast tier: 2e-6 relative, for |x| < 8192 (`f32x4`) or
+ *   |x| < 2^20 (`f64x2`). Its error grows for larger inputs.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+cos(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using U = detail::simd_bits_of<T>;
+	constexpr usize bits = 8 * sizeof(simd_element_type_of<T>);
+
+	// cos(j * π/2 + r) is cos(r), -sin(r), -cos(r) or sin(r), for j modulo
+	// 4 equal to 0, 1, 2 and 3.
+
+	T r, r_lo;
+	U j = detail::low_bits_of(detail::reduce_angle<P>(x, r, r_lo));
+
+	T s = detail::sin_reduced<P>(r, r_lo);
+	T c = detail::cos_reduced<P>(r, r_lo);
+
+	U swap = -(j & 1);
+	U sign = ((j + 1) & 2) << (bits - 2);
+	return (T) ((((U) c & ~swap) | ((U) s & swap)) ^ sign);
+}
+
+/**
+ * Returns the tangent of each element of a floating-point SIMD vector, in
+ * radians.
+ *
+ * - Error: 2.5 ULP. Fast tier: 5e-6 relative, for |x| < 8192 (`f32x4`) or
+ *   |x| < 2^20 (`f64x2`). Its error grows for larger inputs.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+tan(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using U = detail::simd_bits_of<T>;
+	using M = simd_mask_of<T>;
+
+	// tan(j * π/2 + r) is tan(r) for even j and -1 / tan(r) for odd j.
+
+	T r, r_lo;
+	U j = detail::low_bits_of(detail::reduce_angle<P>(x, r, r_lo));
+
+	T s = detail::sin_reduced<P>(r, r_lo);
+	T c = detail::cos_reduced<P>(r, r_lo);
+
+	M odd = (M) (-(j & 1));
+	return select(odd, -c, s) / select(odd, s, c);
+}
+
+/**
+ * Returns the inverse tangent of each element of a floating-point SIMD
+ * vector, in radians.
+ *
+ * - Error: 1.5 ULP. Fast tier: 8e-7 relative.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+atan(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using U = detail::simd_bits_of<T>;
+
+	// atan is odd, so the sign is put back after computing atan(|x|).
+
+	U sign = detail::sign_of(x);
+	T result = detail::atan_positive<P>((T) ((U) x ^ sign), splat<T>(0));
+	return (T) ((U) result ^ sign);
+}
+
+/**
+ * Returns the angle between the positive x-axis and the point (x, y), in
+ * radians, for each element of two floating-point SIMD vectors. The result
+ * is in [-π, π].
+ *
+ * - Error: 1.5 ULP. Fast tier: 8e-7 relative.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+atan2(const T &y, const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using E = simd_element_type_of<T>;
+	using U = detail::simd_bits_of<T>;
+	using M = simd_mask_of<T>;
+	constexpr usize bits = 8 * sizeof(E);
+
+	U x_sign = detail::sign_of(x);
+	U y_sign = detail::sign_of(y);
+	T ax = (T) ((U) x ^ x_sign);
+	T ay = (T) ((U) y ^ y_sign);
+
+	// The angle is computed in the first octant, from the smaller over the
+	// larger coordinate, and then mirrored into the right octant.
+
+	auto steep = gt(ay, ax);
+	T small = select(steep, ax, ay);
+	T large = select(steep, ay, ax);
+
+	if constexpr (P == Precision::Fast)
+	{
+		T result = detail::atan_positive<P>(small / large,
+			splat<T>(0));
+		result = select(steep, (E) (PI / 2) - result, result);
+		result = select((M) x_sign >> (bits - 1), (E) PI - result,
+			result);
+		return (T) ((U) result | y_sign);
+	}
+
+	// The rounding error of t is recovered from the residual of the
+	// division, so the division is replaced by a multiplication with the
+	// reciprocal. The coordinates are scaled by a power of two first, so
+	// neither the reciprocal nor the residual overflow.
+
+	constexpr E big = is_same<E, f32>() ? 0x1p100 : 0x1p900;
+	constexpr E tiny = is_same<E, f32>() ? 0x1p-100 : 0x1p-900;
+
+	T scale = select(gt(large, splat<T>(big)), splat<T>(tiny),
+		select(lt(large, splat<T>(tiny)), splat<T>(big), splat<T>(1)));
+	T scaled_small = small * scale;
+	T scaled_large = large * scale;
+
+	T reciprocal = (E) 1 / scaled_large;
+	T t = scaled_small * reciprocal;
+
+	// Below the tiny bound, the rounding error would be a slow subnormal
+	// number, so those lanes are zeroed and skip the recovery.
+
+	auto needed = ge(scaled_small, splat<T>(tiny));
+	T product, product_lo;
+	detail::two_product(select(needed, t, splat<T>(0)), scaled_large,
+		product, product_lo);
+
+	T t_lo = (select(needed, scaled_small, splat<T>(0)) - product)
+		- product_lo;
+	t_lo = select(needed, t_lo * reciprocal, splat<T>(0));
+
+	// 0 / 0 and infinity / infinity give NaN instead of the angles of the
+	// axes and the diagonals.
+
+	auto zero = eq(small, splat<T>(0));
+	auto infinite = eq(small, splat<T>(Infinity<E>()));
+	t = select(zero, splat<T>(0), select(infinite, splat<T>(1), t));
+	t_lo = select(zero | infinite | eq(large, splat<T>(Infinity<E>())),
+		splat<T>(0), t_lo);
+
+	T result = detail::atan_positive<P>(t, t_lo);
+	result = select(steep, (E) (PI / 2) - result, result);
+	result = select((M) x_sign >> (bits - 1), (E) PI - result, result);
+	result = (T) ((U) result | y_sign);
+
+	return select(ne(x, x) | ne(y, y), x + y, result);
+}
+
+/**
+ * Returns x raised to the power y for each element of two floating-point
+ * SIMD vectors. Follows the special cases of the C library: for example,
+ * pow(x, 0) and pow(1, y) are 1, and negative x only gives a number for
+ * whole y.
+ *
+ * `f32x4` vectors are computed in double precision. `f64x2` vectors compute
+ * ln(x) and y * ln(x) with about twice the precision of `f64`.
+ *
+ * - Error: 1 ULP (`f32x4`) or 2.5 ULP (`f64x2`). Fast tier: about
+ *   1e-5 * (1 + |y * ln(x)|) relative, for positive x only.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+pow(const T &x, const T &y)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	using E = simd_element_type_of<T>;
+	using U = detail::simd_bits_of<T>;
+
+	if constexpr (P == Precision::Fast)
+	{
+		return exp<P>(y * ln<P>(x));
+	}
+	else if constexpr (is_same<E, f32>())
+	{
+		// Doubles have enough precision that exp(y * ln(x)) is exact
+		// to the last bit of a float, except for rounding.
+
+		f64x2 low = exp(extend_low(y) * ln(extend_low(abs(x))));
+		f64x2 high = exp(extend_high(y) * ln(extend_high(abs(x))));
+		T result = demote(low, high);
+
+		return detail::pow_special_cases(x, y, result);
+	}
+	else
+	{
+		// The magnitude of y is limited, so the product below stays
+		// finite. Any y that large overflows or underflows anyway.
+
+		T ay = abs(y);
+		T y_limited = select(gt(ay, splat<T>(0x1p900)),
+			(T) (((U) y & (U) splat<T>(-0.0))
+			| (U) splat<T>(0x1p900)), y);
+
+		T ln_hi, ln_lo;
+		detail::ln_extended(abs(x), ln_hi, ln_lo);
+
+		T hi, lo;
+		detail::two_product(y_limited, ln_hi, hi, lo);
+		lo = fma(y_limited, ln_lo, lo);
+
+		// The error of an infinite product is NaN.
+
+		lo = select(lt(abs(hi), splat<T>(Infinity<E>())), lo,
+			splat<T>(0));
+
+		T result = detail::exp_of_sum<P>(hi + lo, lo - ((hi + lo) - hi));
+		return detail::pow_special_cases(x, y, result);
+	}
+}
+
+/**
+ * Returns the reciprocal of each element of a floating-point SIMD vector,
+ * 1 / x. Both tiers divide, since a vector division is not slower than
+ * the Newton steps that would replace it.
+ *
+ * - Error: 0.5 ULP.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+rcp(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	return splat<T>(1) / x;
+}
+
+/**
+ * Returns the reciprocal square root of each element of a floating-point
+ * SIMD vector, 1 / √x.
+ * The full tier takes a square root and divides. The fast tier replaces
+ * both with two Newton steps from a bit-level estimate.
+ *
+ * - Error: 1.5 ULP. Fast tier: 5e-6 relative, for positive normal numbers.
+ * - Time complexity: O(1).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full, typename T>
+inline T
+rsqrt(const T &x)
+{
+	static_assert(is_same<T, f32x4>() || is_same<T, f64x2>(),
+		"SIMD vector does not hold floating-point types.");
+
+	if constexpr (P == Precision::Full)
+	{
+		return splat<T>(1) / sqrt(x);
+	}
+
+	using E = simd_element_type_of<T>;
+	using U = detail::simd_bits_of<T>;
+	using B = simd_element_type_of<U>;
+	constexpr bool single = is_same<E, f32>();
+
+	// Halving the bits of x halves its exponent, which the constant then
+	// negates, to within 3.5% of the result. Each Newton step
+	// y += y * (1 - x * y^2) / 2 about squares the relative error.
+
+	constexpr B magic = single ? 0x5F375A86 : 0x5FE6EB50C7B537A9;
+
+	T y = (T) (splat<U>(magic) - ((U) x >> 1));
+
+	for (usize i = 0; i < slaw::detail::RECIPROCAL_STEPS; i++)
+	{
+		T error = fnma(x * y, y, splat<T>(1));
+		y = fma(y * (E) 0.5, error, y);
+	}
+
+	return y;
+}
+
+/**
+ * Normalises `count` 3D vectors, stored as consecutive x, y, z triples, in
+ * place: each is multiplied by the reciprocal of its length. Zero vectors
+ * stay zero. A `Vector<f32>` of triples is normalised with
+ * `normalize3(vector.data, vector.size / 3)`.
+ * Both tiers take the full `rsqrt()`, since `normalize_bench` measures
+ * the Newton steps of its fast tier as slower here.
+ *
+ * - Error: 2.5 ULP per component.
+ * - Time complexity: O(n).
+ * - Space complexity: O(1).
+ */
+template <Precision P = Precision::Full>
+inline void
+normalize3(f32 *xyz, usize count)
+{
+	usize i = 0;
+
+	// Four triples fill three vectors: {x0 y0 z0 x1}, {y1 z1 x2 y2} and
+	// {z2 x3 y3 z3}. They are transposed to one vector per coordinate for
+	// the lengths, and the reciprocal lengths are spread back out to the
+	// layout of the triples.
+
+	for (; i + 4 <= count; i += 4)
+	{
+		f32 *p = xyz + 3 * i;
+		f32x4 a = load<f32x4>(p);
+		f32x4 b = load<f32x4>(p + 4);
+		f32x4 c = load<f32x4>(p + 8);
+
+		f32x4 x = shuffle<0, 1, 2, 5>(shuffle<0, 3, 6, 0>(a, b), c);
+		f32x4 y = shuffle<0, 1, 2, 6>(shuffle<1, 4, 7, 0>(a, b), c);
+		f32x4 z = shuffle<0, 1, 4, 7>(shuffle<2, 5, 0, 0>(a, b), c);
+
+		f32x4 length_squared = fma(x, x, fma(y, y, z * z));
+		f32x4 inverse = select(gt(length_squared, splat<f32x4>(0)),
+			rsqrt(length_squared), splat<f32x4>(0));
+
+		store(p, a * shuffle<0, 0, 0, 1>(inverse));
+		store(p + 4, b * shuffle<1, 1, 2, 2>(inverse));
+		store(p + 8, c * shuffle<2, 3, 3, 3>(inverse));
+	}
+
+	for (; i < count; i++)
+	{
+		f32 *p = xyz + 3 * i;
+		f32 length_squared = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+		f32 inverse = length_squared > 0
+			? slaw::rsqrt(length_squared) : 0;
+
+		p[0] *= inverse;
+		p[1] *= inverse;
+		p[2] *= inverse;
+	}
+}
+}; // namespace slaw::simd
+}; // namespace slaw
+
+#endif
@@ -0,0 +1,585 @@
+#ifndef SLAW_SIMD_WIDE_H
+#define SLAW_SIMD_WIDE_H
+
+#include "types.hpp"
+#include "util.hpp"
+#include "simd.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * A compile-time structure that holds the compiler vector type of a given
+ * element type and size in bytes.
+ */
+template <typename T, usize Size>
+struct simd_native_of_impl
+{
+	typedef T type __attribute__((__vector_size__(Size)));
+};
+
+// The size in bytes of the widest vector the target can compare in a single
+// instruction.
+#ifdef __AVX2__
+constexpr usize simd_register_size = 32;
+#else
+constexpr usize simd_register_size = 16;
+#endif
+}; // namespace slaw::detail
+
+/**
+ * A SIMD vector of `N` elements of type `T`, that is not tied to a single
+ * 128-bit register.
+ *
+ * The elements are held in a compiler vector of `N * sizeof(T)` bytes, and
+ * the compiler splits it into as many registers as the target needs. With
+ * `-msimd128`, a `Simd<f32, 8>` becomes two `v128` values. On a native AVX2
+ * build it becomes one `ymm` register, on SSE it becomes two `xmm`
+ * registers, and without SIMD support it becomes eight scalars. The same
+ * kernel source compiles to all of these.
+ *
+ * Operators work element-wise. Comparisons return a mask, which is a
+ * `Simd` of signed integers of the same width, with all bits set in the
+ * lanes where the comparison holds. Masks can be combined with `&`, `|` and
+ * `~`, tested with `any()`, `all()` and `bitmask()`, and used in
+ * `select()`.
+ *
+ * Example:
+ *
+ *   using f32x8 = Simd<f32, 8>;
+ *
+ *   for (usize i = 0; i + 8 <= n; i += 8)
+ *   {
+ *       f32x8 x = f32x8::load(in + i);
+ *       select(x < 0, x * 0.01f, x).store(out + i);
+ *   }
+ *
+ * WARNING: `N * sizeof(T)` must be a power of two.
+ */
+template <typename T, usize N = 16 / sizeof(T)>
+struct Simd
+{
+	static_assert(is_integer<T>() || is_float<T>(),
+		"Type is not an integer or floating-point type.");
+	static_assert(N != 0 && (N & (N - 1)) == 0,
+		"The number of lanes is not a power of two.");
+
+	// The number of elements.
+	static const constexpr usize lanes = N;
+
+	// The compiler vector that holds the elements. A `Native` of 16 bytes
+	// is the same type as the matching 128-bit type, such as `f32x4`, so it
+	// can be passed to the functions in `simd.hpp`.
+	using Native = typename detail::simd_native_of_impl<T,
+		N * sizeof(T)>::type;
+
+	// The type of the masks returned by comparisons.
+	using Mask = Simd<typename simd::detail::simd_signed_integer_of_impl<
+		sizeof(T)>::type, N>;
+
+	// The type of either half of the vector.
+	using Half = Simd<T, N / 2>;
+
+	// The elements.
+	Native v;
+
+	/**
+	 * Constructs a vector with all elements set to zero.
+	 */
+	Simd()
+		: v() {}
+
+	/**
+	 * Constructs a vector with all elements set to a given value.
+	 * Compiles to a single `splat` instruction per register.
+	 */
+	Simd(T value)
+	{
+		for (usize i = 0; i < N; i++)
+		{
+			v[i] = value;
+		}
+	}
+
+	/**
+	 * Constructs a vector from a compiler vector.
+	 */
+	Simd(Native native)
+		: v(native) {}
+
+	/**
+	 * Loads `N` elements from a memory address.
+	 * The address does not have to be aligned.
+	 *
+	 * WARNING: If fewer than `N` elements are readable, BEHAVIOUR IS
+	 * UNDEFINED.
+	 */
+	static Simd
+	load(const T *ptr)
+	{
+		Simd result;
+		__builtin_memcpy(&result.v, ptr, sizeof(Native));
+		return result;
+	}
+
+	/**
+	 * Loads up to `N` elements from a memory address. Elements past
+	 * `count` are set to zero, and are never read.
+	 * The address does not have to be aligned.
+	 */
+	static Simd
+	load_partial(const T *ptr, usize count)
+	{
+		Simd result;
+
+		for (usize i = 0; i < count && i < N; i++)
+		{
+			result.v[i] = ptr[i];
+		}
+
+		return result;
+	}
+
+	/**
+	 * Stores the `N` elements to a memory address.
+	 * The address does not have to be aligned.
+	 */
+	void
+	store(T *ptr)
+	const
+	{
+		__builtin_memcpy(ptr, &v, sizeof(Native));
+	}
+
+	/**
+	 * Stores the first `count` elements to a memory address, and leaves
+	 * the memory after them untouched.
+	 * The address does not have to be aligned.
+	 */
+	void
+	store_partial(T *ptr, usize count)
+	const
+	{
+		for (usize i = 0; i < count && i < N; i++)
+		{
+			ptr[i] = v[i];
+		}
+	}
+
+	/**
+	 * Returns the element at a given lane.
+	 *
+	 * WARNING: If the lane is greater than or equal to `N`, BEHAVIOUR IS
+	 * UNDEFINED.
+	 */
+	T
+	operator[](usize lane)
+	const
+	{
+		return v[lane];
+	}
+
+	/**
+	 * Sets the element at a given lane.
+	 *
+	 * WARNING: If the lane is greater than or equal to `N`, BEHAVIOUR IS
+	 * UNDEFINED.
+	 */
+	void
+	set(usize lane, T value)
+	{
+		v[lane] = value;
+	}
+
+	/**
+	 * Returns the lower half of the elements.
+	 */
+	Simd<T, N / 2>
+	low()
+	const
+	{
+		static_assert(N > 1, "A vector of one element cannot be split.");
+
+		Simd<T, N / 2> half;
+		__builtin_memcpy(&half.v, &v, sizeof(half.v));
+		return half;
+	}
+
+	/**
+	 * Returns the upper half of the elements.
+	 */
+	Simd<T, N / 2>
+	high()
+	const
+	{
+		static_assert(N > 1, "A vector of one element cannot be split.");
+
+		Simd<T, N / 2> half;
+		__builtin_memcpy(&half.v, (const u8 *) &v + sizeof(half.v),
+			sizeof(half.v));
+		return half;
+	}
+
+	/**
+	 * Creates a vector from its lower and upper half.
+	 */
+	static Simd
+	join(const Half &low, const Half &high)
+	{
+		Simd result;
+		__builtin_memcpy(&result.v, &low.v, sizeof(low.v));
+		__builtin_memcpy((u8 *) &result.v + sizeof(low.v), &high.v,
+			sizeof(high.v));
+		return result;
+	}
+
+	/**
+	 * Applies an operation that compares the elements of two vectors, and
+	 * returns the result as a vector of type `R`.
+	 * Vectors that are wider than a register are split in halves first.
+	 * GCC compares each element with a branch otherwise.
+	 */
+	template <typename R, typename Op>
+	static R
+	apply_compare(const Simd &a, const Simd &b, Op op)
+	{
+		if constexpr (sizeof(Native) > detail::simd_register_size)
+		{
+			return R::join(
+				Half::template apply_compare<typename R::Half>(
+					a.low(), b.low(), op),
+				Half::template apply_compare<typename R::Half>(
+					a.high(), b.high(), op));
+		}
+		else
+		{
+			return (typename R::Native) op(a.v, b.v);
+		}
+	}
+
+	/**
+	 * Adds all elements together. The halves of the vector are added until
+	 * it fits in a 128-bit register, which is then reduced with shuffles.
+	 * Either way this takes log2(N) steps.
+	 */
+	T
+	sum()
+	const
+	{
+		if constexpr (N == 1)
+		{
+			return v[0];
+		}
+		else if constexpr (sizeof(Native) == 16)
+		{
+			return simd::sum(v);
+		}
+		else
+		{
+			return (low() + high()).sum();
+		}
+	}
+
+	/**
+	 * Returns the smallest element, in log2(N) steps.
+	 */
+	T
+	reduce_min()
+	const
+	{
+		if constexpr (N == 1)
+		{
+			return v[0];
+		}
+		else if constexpr (sizeof(Native) == 16)
+		{
+			return simd::reduce_min(v);
+		}
+		else
+		{
+			return min(low(), high()).reduce_min();
+		}
+	}
+
+	/**
+	 * Returns the largest element, in log2(N) steps.
+	 */
+	T
+	reduce_max()
+	const
+	{
+		if constexpr (N == 1)
+		{
+			return v[0];
+		}
+		else if constexpr (sizeof(Native) == 16)
+		{
+			return simd::reduce_max(v);
+		}
+		else
+		{
+			return max(low(), high()).reduce_max();
+		}
+	}
+
+	/**
+	 * Returns true if any bit of any element is set. For a mask, this
+	 * checks if the comparison held in any lane.
+	 */
+	bool
+	any()
+	const
+	{
+		if constexpr (sizeof(Native) == 16)
+		{
+			return simd::any_true(v);
+		}
+		else if constexpr (sizeof(Native) > 16)
+		{
+			return (low() | high()).any();
+		}
+		else
+		{
+			for (usize i = 0; i < N; i++)
+			{
+				if (((Mask) *this)[i] != 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	}
+
+	/**
+	 * Returns true if all elements are non-zero. For a mask, this checks if
+	 * the comparison held in all lanes.
+	 */
+	bool
+	all()
+	const
+	{
+		if constexpr (sizeof(Native) == 16)
+		{
+			return simd::all_true(v);
+		}
+		else if constexpr (sizeof(Native) > 16)
+		{
+			return low().all() && high().all();
+		}
+		else
+		{
+			for (usize i = 0; i < N; i++)
+			{
+				if (((Mask) *this)[i] == 0)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	/**
+	 * Gathers the most significant bit of each element into an integer.
+	 * Bit `i` of the result is set if the sign bit of element `i` is set.
+	 */
+	u64
+	bitmask()
+	const
+	{
+		static_assert(N <= 64, "Vector has more than 64 lanes.");
+
+		if constexpr (sizeof(Native) == 16)
+		{
+			return simd::bitmask(v);
+		}
+		else if constexpr (sizeof(Native) > 16)
+		{
+			return low().bitmask() | high().bitmask() << (N / 2);
+		}
+		else
+		{
+			u64 mask = 0;
+
+			for (usize i = 0; i < N; i++)
+			{
+				mask |= (u64) (((Mask) *this)[i] < 0) << i;
+			}
+
+			return mask;
+		}
+	}
+
+	/**
+	 * Reinterprets the bits of the vector as another vector of the same
+	 * size.
+	 */
+	template <typename U, usize M>
+	explicit operator Simd<U, M>()
+	const
+	{
+		static_assert(sizeof(typename Simd<U, M>::Native) == sizeof(Native),
+			"Vectors do not have the same size.");
+
+		return (typename Simd<U, M>::Native) v;
+	}
+
+	friend Simd operator+(const Simd &a, const Simd &b) { return a.v + b.v; }
+	friend Simd operator-(const Simd &a, const Simd &b) { return a.v - b.v; }
+	friend Simd operator*(const Simd &a, const Simd &b) { return a.v * b.v; }
+	friend Simd operator/(const Simd &a, const Simd &b) { return a.v / b.v; }
+	friend Simd operator-(const Simd &a) { return -a.v; }
+
+	friend Simd operator<<(const Simd &a, i32 n) { return a.v << n; }
+	friend Simd operator>>(const Simd &a, i32 n) { return a.v >> n; }
+
+	// Bitwise operators go through the mask type, so they also work on
+	// floating-point vectors.
+
+	friend Simd
+	operator&(const Simd &a, const Simd &b)
+	{
+		using M = typename Mask::Native;
+		return (Native) ((M) a.v & (M) b.v);
+	}
+
+	friend Simd
+	operator|(const Simd &a, const Simd &b)
+	{
+		using M = typename Mask::Native;
+		return (Native) ((M) a.v | (M) b.v);
+	}
+
+	friend Simd
+	operator^(const Simd &a, const Simd &b)
+	{
+		using M = typename Mask::Native;
+		return (Native) ((M) a.v ^ (M) b.v);
+	}
+
+	friend Simd
+	operator~(const Simd &a)
+	{
+		using M = typename Mask::Native;
+		return (Native) ~(M) a.v;
+	}
+
+	friend Mask
+	operator==(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x == y; });
+	}
+
+	friend Mask
+	operator!=(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x != y; });
+	}
+
+	friend Mask
+	operator<(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x < y; });
+	}
+
+	friend Mask
+	operator<=(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x <= y; });
+	}
+
+	friend Mask
+	operator>(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x > y; });
+	}
+
+	friend Mask
+	operator>=(const Simd &a, const Simd &b)
+	{
+		return apply_compare<Mask>(a, b,
+			[](auto x, auto y) { return x >= y; });
+	}
+
+	Simd &operator+=(const Simd &other) { return *this = *this + other; }
+	Simd &operator-=(const Simd &other) { return *this = *this - other; }
+	Simd &operator*=(const Simd &other) { return *this = *this * other; }
+	Simd &operator/=(const Simd &other) { return *this = *this / other; }
+	Simd &operator&=(const Simd &other) { return *this = *this & other; }
+	Simd &operator|=(const Simd &other) { return *this = *this | other; }
+	Simd &operator^=(const Simd &other) { return *this = *this ^ other; }
+	Simd &operator<<=(i32 n) { return *this = *this << n; }
+	Simd &operator>>=(i32 n) { return *this = *this >> n; }
+};
+
+/**
+ * Selects the elements of `a` where the mask is set, and the elements of
+ * `b` elsewhere. Compiles to a single `v128.bitselect` per register.
+ */
+template <typename T, usize N>
+inline Simd<T, N>
+select(const typename Simd<T, N>::Mask &mask, const Simd<T, N> &a,
+	const Simd<T, N> &b)
+{
+	return (a & (Simd<T, N>) mask) | (b & ~(Simd<T, N>) mask);
+}
+
+/**
+ * Returns the element-wise minimum of two vectors. Like `simd::min`, this
+ * compiles to a single `min` or `pmin` instruction per register.
+ */
+template <typename T, usize N>
+inline Simd<T, N>
+min(const Simd<T, N> &a, const Simd<T, N> &b)
+{
+	return Simd<T, N>::template apply_compare<Simd<T, N>>(a, b,
+		[](auto x, auto y) { return x < y ? x : y; });
+}
+
+/**
+ * Returns the element-wise maximum of two vectors. Like `simd::max`, this
+ * compiles to a single `max` or `pmax` instruction per register.
+ */
+template <typename T, usize N>
+inline Simd<T, N>
+max(const Simd<T, N> &a, const Simd<T, N> &b)
+{
+	return Simd<T, N>::template apply_compare<Simd<T, N>>(a, b,
+		[](auto x, auto y) { return x < y ? y : x; });
+}
+
+/**
+ * Returns the element-wise absolute value of a vector.
+ */
+template <typename T, usize N>
+inline Simd<T, N>
+abs(const Simd<T, N> &a)
+{
+	if constexpr (is_float<T>())
+	{
+		// Clear the sign bits.
+
+		return a & ~Simd<T, N>((T) -0.0);
+	}
+	else if constexpr (is_unsigned_integer<T>())
+	{
+		return a;
+	}
+	else
+	{
+		return Simd<T, N>::template apply_compare<Simd<T, N>>(a, a,
+			[](auto x, auto) { return x < 0 ? -x : x; });
+	}
+}
+}; // namespace slaw
+
+#endif
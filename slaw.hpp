@@ -4,12 +4,29 @@
 #include "util.hpp"
 #include "types.hpp"
 #include "simd.hpp"
+#include "simd_wide.hpp"
+#include "simd_math.hpp"
 #include "io.hpp"
 #include "mem.hpp"
 #include "mem_debug.hpp"
+#include "mem_pool.hpp"
 #include "export.hpp"
 #include "math.hpp"
+#include "math_table.hpp"
+#include "divider.hpp"
 #include "vector.hpp"
 #include "string.hpp"
+#include "string_view.hpp"
+#include "json.hpp"
+#include "encoding.hpp"
+#include "csv.hpp"
+#include "multi_search.hpp"
+#include "regex.hpp"
+#include "html.hpp"
+#include "radix_tree.hpp"
+#include "string_sort.hpp"
+#include "shared_string.hpp"
+#include "rope.hpp"
+#include "gap_buffer.hpp"
 
 #endif
\ No newline at end of file
@@ -3,11 +3,359 @@
 
 #include "types.hpp"
 #include "math.hpp"
+#include "simd.hpp"
+#include "divider.hpp"
 #include "vector.hpp"
 #include "util.hpp"
 
 namespace slaw
 {
+namespace detail
+{
+/**
+ * Returns a mask of the ASCII whitespace bytes of a SIMD vector.
+ * These are the space and the characters '\t', '\n', '\v', '\f' and '\r'.
+ */
+inline u8x16
+whitespace_mask(u8x16 v)
+{
+	return (u8x16) (v == simd::splat<u8x16>(' '))
+		| simd::in_range(v, '\t', '\r');
+}
+
+/**
+ * Checks if a character is ASCII whitespace.
+ */
+constexpr bool
+is_whitespace(char c)
+{
+	return c == ' ' || (u8) (c - '\t') <= '\r' - '\t';
+}
+
+/**
+ * Converts a character to lowercase if it is an ASCII uppercase letter.
+ */
+constexpr char
+to_lower(char c)
+{
+	return (u8) (c - 'A') < 26 ? c | 0x20 : c;
+}
+
+/**
+ * Converts the ASCII letters in the range [`first`, `first` + 25] to the
+ * other case, copying `size` bytes from `src` to `dst`. All other bytes,
+ * including the bytes of multi-byte UTF-8 sequences, which are all 0x80 or
+ * above, are copied unchanged. `src` and `dst` may be the same.
+ *
+ * Letters are converted 16 at a time by flipping bit 5 of every byte in the
+ * range, which is the only bit in which ASCII upper- and lowercase letters
+ * differ.
+ */
+inline void
+flip_ascii_case(char *dst, const char *src, usize size, char first)
+{
+	const u8x16 case_bit = simd::splat<u8x16>(0x20);
+	usize i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 v = simd::load<u8x16>(src + i);
+		u8x16 letters = simd::in_range(v, first, first + 25);
+		simd::store(dst + i, v ^ (letters & case_bit));
+	}
+
+	for (; i < size; i++)
+	{
+		char c = src[i];
+		dst[i] = (u8) (c - first) < 26 ? c ^ 0x20 : c;
+	}
+}
+
+/**
+ * Checks if two buffers of the same size are equal, ignoring the case of
+ * ASCII letters.
+ */
+inline bool
+equals_ignore_case(const char *a, const char *b, usize size)
+{
+	const u8x16 case_bit = simd::splat<u8x16>(0x20);
+	usize i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 va = simd::load<u8x16>(a + i);
+		u8x16 vb = simd::load<u8x16>(b + i);
+
+		va |= simd::in_range(va, 'A', 'Z') & case_bit;
+		vb |= simd::in_range(vb, 'A', 'Z') & case_bit;
+
+		if (simd::bitmask((u8x16) (va == vb)) != 0xFFFF)
+		{
+			return false;
+		}
+	}
+
+	for (; i < size; i++)
+	{
+		if (to_lower(a[i]) != to_lower(b[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Returns the index of the first character that is not ASCII whitespace,
+ * or `size` if all characters are whitespace.
+ */
+inline usize
+skip_whitespace(const char *str, usize size)
+{
+	usize i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 v = simd::load<u8x16>(str + i);
+		u32 non_whitespace = ~simd::bitmask(whitespace_mask(v)) & 0xFFFF;
+
+		if (non_whitespace)
+		{
+			return i + ctz(non_whitespace);
+		}
+	}
+
+	while (i < size && is_whitespace(str[i]))
+	{
+		i++;
+	}
+
+	return i;
+}
+
+/**
+ * Returns the index after the last character that is not ASCII whitespace,
+ * or 0 if all characters are whitespace.
+ */
+inline usize
+skip_whitespace_backwards(const char *str, usize size)
+{
+	usize end = size;
+
+	for (; end >= 16; end -= 16)
+	{
+		u8x16 v = simd::load<u8x16>(str + end - 16);
+		u32 non_whitespace = ~simd::bitmask(whitespace_mask(v)) & 0xFFFF;
+
+		if (non_whitespace)
+		{
+			return end - 16 + log2i(non_whitespace) + 1;
+		}
+	}
+
+	while (end > 0 && is_whitespace(str[end - 1]))
+	{
+		end--;
+	}
+
+	return end;
+}
+
+/**
+ * Returns the index of the first occurrence of a needle in a haystack,
+ * starting the search at a given index.
+ * Returns -1 if the needle is not found, or if the needle is empty.
+ *
+ * Candidate positions are found 16 at a time by comparing the haystack
+ * against both the first and the last byte of the needle. Only positions
+ * where both bytes match are compared in full, which filters out nearly
+ * all false positives on real text.
+ */
+inline isize
+find(const char *haystack, usize haystack_size, const char *needle,
+	usize needle_size, usize start = 0)
+{
+	if (needle_size == 0 || needle_size > haystack_size)
+	{
+		return -1;
+	}
+
+	usize last = needle_size - 1;
+	usize end = haystack_size - last;
+	const u8x16 first_byte = simd::splat<u8x16>(needle[0]);
+	const u8x16 last_byte = simd::splat<u8x16>(needle[last]);
+	usize i = start;
+
+	for (; i + 16 <= end; i += 16)
+	{
+		u8x16 head = simd::load<u8x16>(haystack + i);
+		u8x16 tail = simd::load<u8x16>(haystack + i + last);
+		u32 mask = simd::bitmask((u8x16) (head == first_byte)
+			& (u8x16) (tail == last_byte));
+
+		while (mask)
+		{
+			usize candidate = i + ctz(mask);
+			usize j = 1;
+
+			while (j < last && haystack[candidate + j] == needle[j])
+			{
+				j++;
+			}
+
+			if (j >= last)
+			{
+				return candidate;
+			}
+
+			mask &= mask - 1;
+		}
+	}
+
+	for (; i < end; i++)
+	{
+		usize j = 0;
+
+		while (j < needle_size && haystack[i + j] == needle[j])
+		{
+			j++;
+		}
+
+		if (j == needle_size)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Returns the number of occurrences of a byte in a buffer.
+ * Compares 16 bytes at a time and counts the matches with a popcount of
+ * the comparison mask.
+ */
+inline usize
+count_byte(const char *str, usize size, char byte)
+{
+	const u8x16 target = simd::splat<u8x16>(byte);
+	usize count = 0;
+	usize i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 v = simd::load<u8x16>(str + i);
+		count += popcnt(simd::bitmask((u8x16) (v == target)));
+	}
+
+	for (; i < size; i++)
+	{
+		count += str[i] == byte;
+	}
+
+	return count;
+}
+
+/**
+ * Returns the index of the n-th occurrence (counting from 1) of a byte in
+ * a buffer, or -1 if the byte occurs fewer than n times.
+ * Blocks of 16 bytes that hold fewer occurrences than are still needed are
+ * skipped with a single popcount.
+ */
+inline isize
+find_nth_byte(const char *str, usize size, char byte, usize n)
+{
+	const u8x16 target = simd::splat<u8x16>(byte);
+	usize i = 0;
+
+	if (n == 0)
+	{
+		return -1;
+	}
+
+	for (; i + 16 <= size; i += 16)
+	{
+		u8x16 v = simd::load<u8x16>(str + i);
+		u32 mask = simd::bitmask((u8x16) (v == target));
+		usize count = popcnt(mask);
+
+		if (count < n)
+		{
+			n -= count;
+			continue;
+		}
+
+		while (--n > 0)
+		{
+			mask &= mask - 1;
+		}
+
+		return i + ctz(mask);
+	}
+
+	for (; i < size; i++)
+	{
+		if (str[i] == byte && --n == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// The decimal digits of the numbers 0 to 99, two characters each.
+constexpr const char DIGIT_PAIRS[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/**
+ * Writes the decimal representation of an unsigned 32 or 64-bit integer
+ * into a buffer. The digits are written backwards, ending right before
+ * `end`. Returns a pointer to the first digit.
+ * The buffer must be able to hold 10 characters for a u32, and 20 for a
+ * u64.
+ *
+ * The digits are produced two at a time from `DIGIT_PAIRS`, which halves
+ * the number of divisions. WASM has no instruction for the upper half of
+ * a 64-bit product, so the compiler keeps 64-bit divisions by constants as
+ * division instructions. A `Divider` multiplies instead.
+ */
+template <typename U>
+inline char *
+write_decimal_backwards(char *end, U value)
+{
+	static_assert(is_unsigned_integer<U>()
+		&& (sizeof(U) == 4 || sizeof(U) == 8),
+		"Expected an unsigned 32 or 64-bit integer type.");
+
+	constexpr Divider<U> by_100(100);
+
+	while (value >= 100)
+	{
+		U quotient = by_100.divide(value);
+		U pair = 2 * (value - quotient * 100);
+
+		*--end = DIGIT_PAIRS[pair + 1];
+		*--end = DIGIT_PAIRS[pair];
+		value = quotient;
+	}
+
+	*--end = DIGIT_PAIRS[2 * value + 1];
+
+	if (value >= 10)
+	{
+		*--end = DIGIT_PAIRS[2 * value];
+	}
+
+	return end;
+}
+}; // namespace slaw::detail
+
 /**
  * String representation. Stores a buffer of characters and its length.
  * Allows constant-time access to the characters in any order.
@@ -617,6 +965,265 @@ struct String : public Vector<char>
 		return false;
 	}
 
+	/**
+	 * Converts the ASCII letters in this string to lowercase.
+	 * The string will be modified in-place.
+	 * Non-ASCII characters are left untouched, so UTF-8 encoded strings
+	 * stay valid.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	to_lower_in_place()
+	{
+		detail::flip_ascii_case(data, data, size, 'A');
+	}
+
+	/**
+	 * Creates a new string with the ASCII letters of this string converted
+	 * to lowercase.
+	 * Non-ASCII characters are left untouched, so UTF-8 encoded strings
+	 * stay valid.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_lower()
+	const
+	{
+		String out(max(size, min_capacity));
+		out.size = size;
+		detail::flip_ascii_case(out.data, data, size, 'A');
+
+		return out;
+	}
+
+	/**
+	 * Converts the ASCII letters in this string to uppercase.
+	 * The string will be modified in-place.
+	 * Non-ASCII characters are left untouched, so UTF-8 encoded strings
+	 * stay valid.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	to_upper_in_place()
+	{
+		detail::flip_ascii_case(data, data, size, 'a');
+	}
+
+	/**
+	 * Creates a new string with the ASCII letters of this string converted
+	 * to uppercase.
+	 * Non-ASCII characters are left untouched, so UTF-8 encoded strings
+	 * stay valid.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_upper()
+	const
+	{
+		String out(max(size, min_capacity));
+		out.size = size;
+		detail::flip_ascii_case(out.data, data, size, 'a');
+
+		return out;
+	}
+
+	/**
+	 * Checks if two strings are equal, ignoring the case of ASCII letters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	bool
+	equals_ignore_case(const String &s)
+	const
+	{
+		return size == s.size
+			&& detail::equals_ignore_case(data, s.data, size);
+	}
+
+	/**
+	 * Checks if this string is equal to a character array, ignoring the
+	 * case of ASCII letters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	template <usize N>
+	bool
+	equals_ignore_case(const char (&s)[N])
+	const
+	{
+		return size == N - 1
+			&& detail::equals_ignore_case(data, s, size);
+	}
+
+	/**
+	 * Removes ASCII whitespace from the start and the end of this string.
+	 * The string will be modified in-place.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	void
+	trim_in_place()
+	{
+		usize start = detail::skip_whitespace(data, size);
+		usize end = start + detail::skip_whitespace_backwards(
+			data + start, size - start);
+
+		// Move the remaining characters to the start of the string.
+
+		if (start != 0)
+		{
+			for (usize i = start; i < end; i++)
+			{
+				data[i - start] = data[i];
+			}
+		}
+
+		size = end - start;
+	}
+
+	/**
+	 * Creates a new string with the ASCII whitespace at the start and the
+	 * end of this string removed.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	trim()
+	const
+	{
+		usize start = detail::skip_whitespace(data, size);
+		usize end = start + detail::skip_whitespace_backwards(
+			data + start, size - start);
+
+		String out(max(end - start, min_capacity));
+		out.size = end - start;
+
+		for (usize i = start; i < end; i++)
+		{
+			out.data[i - start] = data[i];
+		}
+
+		return out;
+	}
+
+	/**
+	 * Creates a new string in which all non-overlapping occurrences of a
+	 * pattern are replaced by a replacement.
+	 * The occurrences are counted first, so the new string is allocated
+	 * exactly once, at its final size.
+	 * If the pattern is empty, a copy of this string is returned.
+	 *
+	 * The text is searched twice with `detail::find()`, which compares
+	 * the pattern in full only at positions where its first and last byte
+	 * match. On typical text that filters out nearly every position, but
+	 * texts and patterns of one repeated character defeat it.
+	 *
+	 * - Time complexity: O(n * m) in the worst case, where m is the size
+	 *   of the pattern, and O(n + m) on typical text.
+	 * - Space complexity: O(n).
+	 */
+	String
+	replace_all(const char *pattern, usize pattern_size,
+		const char *replacement, usize replacement_size)
+	const
+	{
+		// Count the occurrences of the pattern.
+
+		usize count = 0;
+		isize pos = detail::find(data, size, pattern, pattern_size);
+
+		while (pos != -1)
+		{
+			count++;
+			pos = detail::find(data, size, pattern, pattern_size,
+				pos + pattern_size);
+		}
+
+		// Create a new string of the final size.
+
+		usize out_size = size - count * pattern_size
+			+ count * replacement_size;
+		String out(max(out_size, min_capacity));
+		out.size = out_size;
+
+		// Copy the characters in between the occurrences, and the
+		// replacement for each occurrence.
+
+		usize read = 0;
+		usize write = 0;
+
+		for (usize n = 0; n < count; n++)
+		{
+			usize match = detail::find(data, size, pattern,
+				pattern_size, read);
+
+			while (read < match)
+			{
+				out.data[write++] = data[read++];
+			}
+
+			for (usize i = 0; i < replacement_size; i++)
+			{
+				out.data[write++] = replacement[i];
+			}
+
+			read += pattern_size;
+		}
+
+		while (read < size)
+		{
+			out.data[write++] = data[read++];
+		}
+
+		return out;
+	}
+
+	/**
+	 * Creates a new string in which all non-overlapping occurrences of a
+	 * pattern are replaced by a replacement.
+	 * If the pattern is empty, a copy of this string is returned.
+	 *
+	 * - Time complexity: O(n * m) in the worst case, where m is the size
+	 *   of the pattern, and O(n + m) on typical text.
+	 * - Space complexity: O(n).
+	 */
+	String
+	replace_all(const String &pattern, const String &replacement)
+	const
+	{
+		return replace_all(pattern.data, pattern.size,
+			replacement.data, replacement.size);
+	}
+
+	/**
+	 * Creates a new string in which all non-overlapping occurrences of a
+	 * pattern are replaced by a replacement.
+	 * If the pattern is empty, a copy of this string is returned.
+	 *
+	 * - Time complexity: O(n * m) in the worst case, where m is the size
+	 *   of the pattern, and O(n + m) on typical text.
+	 * - Space complexity: O(n).
+	 */
+	template <usize N, usize M>
+	String
+	replace_all(const char (&pattern)[N], const char (&replacement)[M])
+	const
+	{
+		return replace_all(pattern, N - 1, replacement, M - 1);
+	}
+
 	/**
 	 * Pads the start of this string with a given character.
 	 * The string is padded until it reaches a given size.
@@ -682,6 +1289,9 @@ struct String : public Vector<char>
 
 	/**
 	 * Converts an integer to a string.
+	 * The digits are produced two at a time by
+	 * `detail::write_decimal_backwards()`, which halves the number of
+	 * divisions.
 	 * TODO: Make this function more space efficient. Compiling a file
 	 * with just this function exported with `-O3` yields a binary of
 	 * about 3.9kB. `-Os` yields a binary of about 2.2kB.
@@ -692,20 +1302,16 @@ struct String : public Vector<char>
 	{
 		static_assert(is_integer<T>(), "Expected an integer type.");
 
-		if (i == 0)
-		{
-			return "0";
-		}
+		using U = typename simd::detail::simd_unsigned_integer_of_impl<
+			sizeof(T) == 8 ? 8 : 4>::type;
 
-		// If the number is negative, make it positive and remember
+		// If the number is negative, take its magnitude and remember
 		// that we have to add a '-' at the start of the string.
+		// The magnitude is taken in unsigned arithmetic, so the most
+		// negative number does not overflow.
 
 		bool sign = i < 0;
-
-		if (sign)
-		{
-			i = -i;
-		}
+		U value = sign ? 0 - (U) i : (U) i;
 
 		// We reserve enough characters for the given integer type,
 		// plus one for the sign.
@@ -713,29 +1319,27 @@ struct String : public Vector<char>
 		// of the max value of the given integer type, plus one.
 
 		const constexpr usize max_chars = log10i(max_value<T>()) + 2;
-		String s(max_chars);
 
-		// Go through each digit of the integer, from least to most
-		// significant. We add each digit to the string.
+		// Write the digits backwards into a buffer, from least to most
+		// significant, and put the sign in front of them.
+
+		char digits[max_chars];
+		char *end = digits + max_chars;
+		char *start = detail::write_decimal_backwards(end, value);
 
-		while (i > 0)
+		if (sign)
 		{
-			s.push_back('0' + (i % 10));
-			i /= 10;
+			*--start = '-';
 		}
 
-		// Handle the sign.
+		String s(max_chars);
+		s.size = end - start;
 
-		if (sign)
+		for (usize i = 0; i < s.size; i++)
 		{
-			s.push_back('-');
-			i = -i;
+			s.data[i] = start[i];
 		}
 
-		// The order of characters in the string is reversed,
-		// so we reverse it again.
-
-		s.reverse();
 		return s;
 	}
 
@@ -0,0 +1,506 @@
+#ifndef SLAW_STRING_SORT_H
+#define SLAW_STRING_SORT_H
+
+#include "types.hpp"
+#include "util.hpp"
+#include "math.hpp"
+#include "vector.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+
+namespace slaw
+{
+namespace detail
+{
+/**
+ * A string that is being sorted, with a cached copy of 8 of its bytes.
+ */
+struct StringSortItem
+{
+	// The 8 bytes of the string starting at the cache depth, as a
+	// big-endian number, padded with zeroes. Comparing two keys compares
+	// the 8 bytes at once.
+	u64 key;
+
+	// The size of the string.
+	u32 size;
+
+	// The index of the string in the input.
+	u32 index;
+};
+
+// Buckets with fewer strings than this are sorted with multikey quicksort
+// instead of another radix sort pass.
+constexpr usize radix_sort_threshold = 64;
+
+// Buckets with fewer strings than this are sorted with insertion sort.
+constexpr usize insertion_sort_threshold = 8;
+
+/**
+ * Loads the 8 bytes of a string starting at a given depth as a big-endian
+ * number. Bytes past the end of the string are zero.
+ */
+inline u64
+load_sort_key(StringView str, usize depth)
+{
+	if (depth + 8 <= str.size)
+	{
+		u64 key;
+		__builtin_memcpy(&key, str.data + depth, 8);
+		return __builtin_bswap64(key);
+	}
+
+	u64 key = 0;
+
+	for (usize i = 0; i < 8; i++)
+	{
+		key <<= 8;
+
+		if (depth + i < str.size)
+		{
+			key |= (u8) str[depth + i];
+		}
+	}
+
+	return key;
+}
+
+/**
+ * Refreshes the cached keys of a range of items for a new depth.
+ */
+inline void
+refresh_sort_keys(StringSortItem *items, usize n, const StringView *strings,
+	usize depth)
+{
+	for (usize i = 0; i < n; i++)
+	{
+		items[i].key = load_sort_key(strings[items[i].index], depth);
+	}
+}
+
+/**
+ * Returns how many bytes of an item are left after a depth, capped at 9.
+ * Items whose cached keys are equal are ordered by this number: an item
+ * with 8 or fewer bytes left ends within the key and is a prefix of any
+ * longer item with the same key, while two items with more than 8 bytes
+ * left can only be told apart by looking deeper.
+ */
+inline u32
+sort_key_class(const StringSortItem &item, usize depth)
+{
+	return min(item.size - (u32) depth, (u32) 9);
+}
+
+/**
+ * Compares two items by their cached keys and key classes.
+ * Returns a negative number, zero or a positive number.
+ */
+inline i32
+compare_sort_keys(const StringSortItem &a, const StringSortItem &b,
+	usize depth)
+{
+	if (a.key != b.key)
+	{
+		return a.key < b.key ? -1 : 1;
+	}
+
+	return (i32) sort_key_class(a, depth) - (i32) sort_key_class(b, depth);
+}
+
+/**
+ * Compares two strings that are known to be equal up to a given depth.
+ */
+inline i32
+compare_strings_from(StringView a, StringView b, usize depth)
+{
+	usize size = min(a.size, b.size);
+
+	for (usize i = depth; i < size; i++)
+	{
+		if (a[i] != b[i])
+		{
+			return (u8) a[i] < (u8) b[i] ? -1 : 1;
+		}
+	}
+
+	return (i32) (a.size > b.size) - (i32) (a.size < b.size);
+}
+
+/**
+ * Sorts a few items that are equal up to a given depth by insertion sort.
+ * The cached keys must be loaded at that depth.
+ */
+inline void
+insertion_sort_strings(StringSortItem *items, usize n,
+	const StringView *strings, usize depth)
+{
+	for (usize i = 1; i < n; i++)
+	{
+		StringSortItem item = items[i];
+		usize j = i;
+
+		while (j > 0)
+		{
+			i32 order = compare_sort_keys(item, items[j - 1], depth);
+
+			if (order == 0 && sort_key_class(item, depth) == 9)
+			{
+				order = compare_strings_from(strings[item.index],
+					strings[items[j - 1].index], depth + 8);
+			}
+
+			if (order >= 0)
+			{
+				break;
+			}
+
+			items[j] = items[j - 1];
+			j--;
+		}
+
+		items[j] = item;
+	}
+}
+
+/**
+ * Sorts items that are equal up to a given depth by multikey quicksort,
+ * using the cached 8-byte keys as digits. Items are partitioned into those
+ * smaller than, equal to and greater than the pivot key. Only the equal
+ * part moves on to the next 8 bytes.
+ * The cached keys must be loaded at that depth.
+ */
+inline void
+multikey_quicksort_strings(StringSortItem *items, usize n,
+	const StringView *strings, usize depth)
+{
+	while (n >= insertion_sort_threshold)
+	{
+		// Use the median of the first, middle and last item as pivot.
+
+		StringSortItem a = items[0];
+		StringSortItem b = items[n / 2];
+		StringSortItem c = items[n - 1];
+
+		if (compare_sort_keys(a, b, depth) > 0) swap(a, b);
+		if (compare_sort_keys(b, c, depth) > 0) swap(b, c);
+		if (compare_sort_keys(a, b, depth) > 0) swap(a, b);
+
+		StringSortItem pivot = b;
+
+		// Three-way partition: [0, lt) is smaller than the pivot,
+		// [lt, i) is equal and [gt, n) is greater.
+
+		usize lt = 0;
+		usize i = 0;
+		usize gt = n;
+
+		while (i < gt)
+		{
+			i32 order = compare_sort_keys(items[i], pivot, depth);
+
+			if (order < 0)
+			{
+				swap(items[lt++], items[i++]);
+			}
+			else if (order > 0)
+			{
+				swap(items[i], items[--gt]);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		// Items equal to a pivot that ends within the key are identical.
+		// Otherwise they have to be compared from the next 8 bytes on.
+		// If all items are equal, we move on to the next 8 bytes in
+		// this loop rather than recursing, so long common prefixes do
+		// not deepen the recursion. Every other recursion works on
+		// fewer items, which bounds its depth by n.
+
+		if (lt == 0 && gt == n)
+		{
+			if (sort_key_class(pivot, depth) != 9)
+			{
+				return;
+			}
+
+			depth += 8;
+			refresh_sort_keys(items, n, strings, depth);
+			continue;
+		}
+
+		if (sort_key_class(pivot, depth) == 9 && gt - lt > 1)
+		{
+			refresh_sort_keys(items + lt, gt - lt, strings, depth + 8);
+			multikey_quicksort_strings(items + lt, gt - lt, strings,
+				depth + 8);
+		}
+
+		// Recurse into the smaller side and loop on the larger one, to
+		// bound the recursion depth.
+
+		if (lt < n - gt)
+		{
+			multikey_quicksort_strings(items, lt, strings, depth);
+			items += gt;
+			n -= gt;
+		}
+		else
+		{
+			multikey_quicksort_strings(items + gt, n - gt, strings,
+				depth);
+			n = lt;
+		}
+	}
+
+	insertion_sort_strings(items, n, strings, depth);
+}
+
+/**
+ * A bucket of items that still has to be radix sorted: `n` items starting
+ * at `start`, which are equal up to `depth`, with keys cached at
+ * `cache_depth`.
+ */
+struct RadixSortBucket
+{
+	usize start;
+	usize n;
+	usize depth;
+	usize cache_depth;
+};
+
+/**
+ * Sorts items that are equal up to a given depth by MSD radix sort.
+ * Each pass distributes the items into 257 buckets by their byte at the
+ * current depth, with bucket 0 for items that end before it. The bytes are
+ * read from the cached keys, which are refreshed once every 8 passes, so
+ * most passes only touch the contiguous item array and not the strings.
+ * Small buckets are handed to multikey quicksort.
+ *
+ * The buckets that are left to sort are kept on a stack on the heap rather
+ * than the call stack, so long common prefixes cannot overflow the call
+ * stack. The buckets on the stack are disjoint and hold at least 2 items
+ * each, so it never holds more than n / 2 of them.
+ */
+inline void
+radix_sort_strings(StringSortItem *items, StringSortItem *temp, usize n,
+	const StringView *strings, usize depth, usize cache_depth)
+{
+	Vector<RadixSortBucket> stack;
+	stack.push_back({ 0, n, depth, cache_depth });
+
+	while (stack.size > 0)
+	{
+		RadixSortBucket bucket = stack.pop_back();
+		StringSortItem *bucket_items = items + bucket.start;
+		n = bucket.n;
+		depth = bucket.depth;
+		cache_depth = bucket.cache_depth;
+
+		if (n < radix_sort_threshold)
+		{
+			if (cache_depth != depth)
+			{
+				refresh_sort_keys(bucket_items, n, strings, depth);
+			}
+
+			multikey_quicksort_strings(bucket_items, n, strings, depth);
+			continue;
+		}
+
+		usize counts[257];
+		usize shift = 0;
+
+		auto digit = [&](const StringSortItem &item) -> usize
+		{
+			return item.size <= depth
+				? 0 : ((item.key >> shift) & 0xFF) + 1;
+		};
+
+		// While all items fall into the same bucket, there is nothing
+		// to distribute, and we move on to the next byte. If they all
+		// end here, they are identical.
+
+		while (true)
+		{
+			if (depth - cache_depth == 8)
+			{
+				refresh_sort_keys(bucket_items, n, strings, depth);
+				cache_depth = depth;
+			}
+
+			shift = 56 - 8 * (depth - cache_depth);
+
+			for (usize d = 0; d < 257; d++)
+			{
+				counts[d] = 0;
+			}
+
+			for (usize i = 0; i < n; i++)
+			{
+				counts[digit(bucket_items[i])]++;
+			}
+
+			usize first_digit = digit(bucket_items[0]);
+
+			if (counts[first_digit] != n || first_digit == 0)
+			{
+				break;
+			}
+
+			depth++;
+		}
+
+		if (counts[0] == n)
+		{
+			continue;
+		}
+
+		usize offsets[257];
+		usize offset = 0;
+
+		for (usize d = 0; d < 257; d++)
+		{
+			offsets[d] = offset;
+			offset += counts[d];
+		}
+
+		for (usize i = 0; i < n; i++)
+		{
+			temp[offsets[digit(bucket_items[i])]++] = bucket_items[i];
+		}
+
+		for (usize i = 0; i < n; i++)
+		{
+			bucket_items[i] = temp[i];
+		}
+
+		// Bucket 0 holds items that end here, which are all identical.
+
+		usize start = bucket.start + counts[0];
+
+		for (usize d = 1; d < 257; d++)
+		{
+			if (counts[d] > 1)
+			{
+				stack.push_back({ start, counts[d], depth + 1,
+					cache_depth });
+			}
+
+			start += counts[d];
+		}
+	}
+}
+
+/**
+ * Computes the sorted order of a list of strings. After the call,
+ * `order[i]` is the index of the string that belongs at position `i`.
+ */
+inline void
+sort_strings_order(const StringView *strings, usize n, Vector<u32> &order)
+{
+	Vector<StringSortItem> items(max(n, Vector<StringSortItem>::min_capacity));
+	Vector<StringSortItem> temp(max(n, Vector<StringSortItem>::min_capacity));
+	items.size = n;
+
+	for (usize i = 0; i < n; i++)
+	{
+		items[i] = { load_sort_key(strings[i], 0), (u32) strings[i].size,
+			(u32) i };
+	}
+
+	radix_sort_strings(items.data, temp.data, n, strings, 0, 0);
+
+	order.size = 0;
+	order.reserve(n);
+
+	for (usize i = 0; i < n; i++)
+	{
+		order.push_back(items[i].index);
+	}
+}
+
+/**
+ * Rearranges the elements of a vector so that the element at position `i`
+ * is the one that was at position `order[i]`, by following the cycles of
+ * the permutation. Each element is moved once. The order is destroyed.
+ */
+template <typename T>
+void
+apply_order(Vector<T> &values, Vector<u32> &order)
+{
+	for (usize i = 0; i < values.size; i++)
+	{
+		if (order[i] == i)
+		{
+			continue;
+		}
+
+		T value = move(values[i]);
+		usize j = i;
+
+		while (order[j] != i)
+		{
+			usize next = order[j];
+			values[j] = move(values[next]);
+			order[j] = j;
+			j = next;
+		}
+
+		values[j] = move(value);
+		order[j] = j;
+	}
+}
+}; // namespace slaw::detail
+
+/**
+ * Sorts a vector of string views in lexicographic byte order, using MSD
+ * radix sort with a multikey quicksort fallback for small buckets.
+ *
+ * While sorting, each string is represented by a small item that caches
+ * 8 of its bytes as a number. Most work compares and distributes these
+ * items in a contiguous array, and the strings themselves are only read
+ * once every 8 bytes of depth, which keeps the sort cache-friendly.
+ *
+ * - Time complexity: O(n * k / 8 + n * log(n)) on average, where k is the
+ *   average length of the common prefixes.
+ * - Space complexity: O(n).
+ */
+inline void
+sort_strings(Vector<StringView> &strings)
+{
+	Vector<u32> order;
+	detail::sort_strings_order(strings.data, strings.size, order);
+	detail::apply_order(strings, order);
+}
+
+/**
+ * Sorts a vector of strings in lexicographic byte order, using MSD radix
+ * sort with a multikey quicksort fallback for small buckets.
+ * The strings are moved into place, their characters are never copied.
+ *
+ * - Time complexity: O(n * k / 8 + n * log(n)) on average, where k is the
+ *   average length of the common prefixes.
+ * - Space complexity: O(n).
+ */
+inline void
+sort_strings(Vector<String> &strings)
+{
+	Vector<StringView> views(max(strings.size,
+		Vector<StringView>::min_capacity));
+	views.size = strings.size;
+
+	for (usize i = 0; i < strings.size; i++)
+	{
+		views[i] = strings[i];
+	}
+
+	Vector<u32> order;
+	detail::sort_strings_order(views.data, views.size, order);
+	detail::apply_order(strings, order);
+}
+}; // namespace slaw
+
+#endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+#ifndef SLAW_STRING_VIEW_H
+#define SLAW_STRING_VIEW_H
+
+#include "types.hpp"
+#include "string.hpp"
+
+namespace slaw
+{
+/**
+ * Read-only view into a sequence of characters that is owned by something
+ * else, like a `String` or a character array.
+ * Copying a view does not copy the characters.
+ *
+ * WARNING: A view does not keep the characters alive. If the owner of the
+ * characters is destroyed or reallocates, using the view afterwards results
+ * in UNDEFINED BEHAVIOUR.
+ */
+struct StringView
+{
+	// A pointer to the first character of the view.
+	const char *data;
+
+	// The number of characters in the view.
+	usize size;
+
+	/**
+	 * Constructs an empty view.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	constexpr StringView()
+		: data(nullptr), size(0) {}
+
+	/**
+	 * Constructs a view of a given number of characters.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	constexpr StringView(const char *data, usize size)
+		: data(data), size(size) {}
+
+	/**
+	 * Constructs a view of the characters of a string.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	StringView(const String &str)
+		: data(str.data), size(str.size) {}
+
+	/**
+	 * Constructs a view of a character array.
+	 * The terminating null character is not part of the view.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 */
+	template <usize N>
+	constexpr StringView(const char (&str)[N])
+		: data(str), size(N - 1) {}
+
+	/**
+	 * Returns the character at a given index.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the given index is greater than or equal to the size of
+	 * the view, BEHAVIOUR IS UNDEFINED.
+	 */
+	constexpr char
+	operator[](usize index)
+	const
+	{
+		return data[index];
+	}
+
+	/**
+	 * Returns a pointer to the first character of the view.
+	 */
+	constexpr const char *
+	begin()
+	const
+	{
+		return data;
+	}
+
+	/**
+	 * Returns a pointer to the character after the last character of the
+	 * view.
+	 */
+	constexpr const char *
+	end()
+	const
+	{
+		return data + size;
+	}
+
+	/**
+	 * Returns a view of a part of this view, starting at a given index and
+	 * containing at most a given number of characters.
+	 *
+	 * - Time complexity: O(1).
+	 * - Space complexity: O(1).
+	 *
+	 * WARNING: If the start index is greater than the size of the view,
+	 * BEHAVIOUR IS UNDEFINED.
+	 */
+	constexpr StringView
+	substr(usize start, usize length = max_value<usize>())
+	const
+	{
+		return StringView(data + start, min(length, size - start));
+	}
+
+	/**
+	 * Checks if two views contain the same characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	constexpr bool
+	operator==(const StringView &other)
+	const
+	{
+		if (size != other.size)
+		{
+			return false;
+		}
+
+		for (usize i = 0; i < size; i++)
+		{
+			if (data[i] != other.data[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Checks if two views do not contain the same characters.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	constexpr bool
+	operator!=(const StringView &other)
+	const
+	{
+		return !operator==(other);
+	}
+
+	/**
+	 * Checks if this view starts with the characters of another view.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(1).
+	 */
+	constexpr bool
+	starts_with(const StringView &prefix)
+	const
+	{
+		return size >= prefix.size && substr(0, prefix.size) == prefix;
+	}
+
+	/**
+	 * Returns the index of the first occurrence of another view in this
+	 * view, starting the search at a given index.
+	 * Returns -1 if it is not found.
+	 * An empty needle is found at the start index, as long as that index
+	 * is not past the end of this view, like `std::string_view::find()`.
+	 *
+	 * - Time complexity: O(n * m).
+	 * - Space complexity: O(1).
+	 */
+	isize
+	index_of(const StringView &needle, usize start = 0)
+	const
+	{
+		if (needle.size == 0)
+		{
+			return start <= size ? (isize) start : -1;
+		}
+
+		return detail::find(data, size, needle.data, needle.size,
+			start);
+	}
+
+	/**
+	 * Creates a string holding a copy of the characters of this view.
+	 *
+	 * - Time complexity: O(n).
+	 * - Space complexity: O(n).
+	 */
+	String
+	to_string()
+	const
+	{
+		String out(max(size, String::min_capacity));
+		out.size = size;
+
+		for (usize i = 0; i < size; i++)
+		{
+			out.data[i] = data[i];
+		}
+
+		return out;
+	}
+};
+}; // namespace slaw
+
+#endif
\ No newline at end of file
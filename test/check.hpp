@@ -0,0 +1,19 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// The assertion shared by the native tests and benchmarks. A failed check
+// prints its message and ends the program with exit status 1, which fails
+// the `make` target that runs it.
+
+/**
+ * Checks a condition and exits with an error message if it does not hold.
+ */
+void
+check(bool condition, const char *message)
+{
+	if (!condition)
+	{
+		printf("FAIL: %s\n", message);
+		exit(1);
+	}
+}
@@ -0,0 +1,100 @@
+#!/bin/sh
+# Checks the disassembly of wasm_test.cpp. Every function listed below must
+# contain an instruction matching the given pattern and must not contain any
+# calls, which would mean that the operation was done lane by lane.
+# Usage: check_simd_lowering.sh <output of llvm-objdump -d -C> [relaxed]
+# Pass `relaxed` when wasm_test.cpp was compiled with `-mrelaxed-simd`.
+
+DISASSEMBLY="$1"
+RELAXED="$2"
+FAILED=0
+
+check()
+{
+	# The body of a function runs from its label to the next label.
+
+	BODY=$(awk -v label="<$1(" '
+		/^[0-9a-f]+ </ { found = index($0, label) > 0; next }
+		found { print }
+	' "$DISASSEMBLY")
+
+	if [ -z "$BODY" ]
+	then
+		echo "FAIL $1: function not found"
+		FAILED=1
+	elif ! echo "$BODY" | grep -Eq "$2"
+	then
+		echo "FAIL $1: no instruction matching '$2'"
+		FAILED=1
+	elif echo "$BODY" | grep -Eq "\bcall"
+	then
+		echo "FAIL $1: contains a call"
+		FAILED=1
+	else
+		echo "ok   $1"
+	fi
+}
+
+# With `-ffast-math`, float min and max compile to `min` and `max` instead of
+# `pmin` and `pmax`.
+
+check simd_floor_f32x4 'f32x4\.floor'
+check simd_floor_f64x2 'f64x2\.floor'
+check simd_ceil_f32x4 'f32x4\.ceil'
+check simd_ceil_f64x2 'f64x2\.ceil'
+check simd_round_f32x4 'f32x4\.floor'
+check simd_sqrt_f32x4 'f32x4\.sqrt'
+check simd_sqrt_f64x2 'f64x2\.sqrt'
+check simd_min_i8x16 'i8x16\.min_s'
+check simd_min_i16x8 'i16x8\.min_s'
+check simd_min_i32x4 'i32x4\.min_s'
+check simd_min_f32x4 'f32x4\.p?min'
+check simd_max_i32x4 'i32x4\.max_s'
+check simd_max_f32x4 'f32x4\.p?max'
+check simd_max_f64x2 'f64x2\.p?max'
+check simd_abs_i8x16 'i8x16\.abs'
+check simd_abs_i32x4 'i32x4\.abs'
+check simd_abs_f32x4 'f32x4\.abs'
+check simd_neg_i32x4 'i32x4\.neg'
+check simd_neg_f32x4 'f32x4\.neg'
+check simd_min_u8x16 'i8x16\.min_u'
+check simd_lt_u8x16 'i8x16\.lt_u'
+check simd_select_f32x4 'v128\.bitselect'
+check simd_any_true_u8x16 'v128\.any_true'
+check simd_all_true_i16x8 'i16x8\.all_true'
+check simd_bitmask_i32x4 'i32x4\.bitmask'
+check simd_shuffle_f32x4 'i8x16\.shuffle'
+check simd_load_splat_f32x4 'v128\.load32_splat'
+check simd_load64_zero_u8x16 'v128\.load64_zero'
+check simd_wide_leaky_relu 'v128\.bitselect'
+check simd_wide_sum_i32x8 'i32x4\.add'
+check simd_sum_f32x4 'i8x16\.shuffle'
+check simd_reduce_max_i8x16 'i8x16\.max_s'
+check simd_dot_i16x8 'i32x4\.dot_i16x8_s'
+check simd_widening_sum_u8x16 'i16x8\.extadd_pairwise_i8x16_u'
+check simd_add_sat_u8x16 'i8x16\.add_sat_u'
+check simd_sub_sat_i16x8 'i16x8\.sub_sat_s'
+check simd_avgr_u8x16 'i8x16\.avgr_u'
+check simd_q15mulr_sat 'i16x8\.q15mulr_sat_s'
+check simd_narrow_u_i16x8 'i8x16\.narrow_i16x8_u'
+check simd_narrow_s_i32x4 'i16x8\.narrow_i32x4_s'
+check simd_extend_low_i8x16 'i16x8\.extend_low_i8x16_s'
+check simd_extend_high_u16x8 'i32x4\.extend_high_i16x8_u'
+check simd_extadd_pairwise_i16x8 'i32x4\.extadd_pairwise_i16x8_s'
+
+if [ "$RELAXED" = relaxed ]
+then
+	check simd_fma_f32x4 'f32x4\.relaxed_madd'
+	check simd_fnma_f64x2 'f64x2\.relaxed_nmadd'
+	check simd_relaxed_swizzle 'i8x16\.relaxed_swizzle'
+	check simd_relaxed_min_f32x4 'f32x4\.relaxed_min'
+	check simd_relaxed_trunc 'i32x4\.relaxed_trunc_f32x4_s'
+else
+	check simd_fma_f32x4 'f32x4\.mul'
+	check simd_fnma_f64x2 'f64x2\.mul'
+	check simd_relaxed_swizzle 'i8x16\.swizzle'
+	check simd_relaxed_min_f32x4 'f32x4\.p?min'
+	check simd_relaxed_trunc 'i32x4\.trunc_sat_f32x4_s'
+fi
+
+exit $FAILED
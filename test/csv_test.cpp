@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../csv.hpp"
+#include "check.hpp"
+
+// Checks `CsvReader` on quoted fields, "\r\n" line endings and input that is
+// fed in chunks cut at every offset, and the number parsers on the edges of
+// the float exponent.
+// Build natively with `make csv_test`.
+
+using slaw::CsvReader;
+using slaw::String;
+using slaw::StringView;
+using slaw::Vector;
+
+/**
+ * Checks if a view holds the characters of a C string.
+ */
+bool
+equals(StringView view, const char *expected)
+{
+	return view.size == strlen(expected)
+		&& memcmp(view.data, expected, view.size) == 0;
+}
+
+/**
+ * Reads all rows of a reader, joining the fields of each row with '|' and
+ * ending each row with ';', so a whole document can be compared at once.
+ */
+void
+read_rows(CsvReader &reader, String &out)
+{
+	while (reader.next_row())
+	{
+		for (usize i = 0; i < reader.fields.size; i++)
+		{
+			StringView field = reader.fields[i];
+
+			for (usize j = 0; j < field.size; j++)
+			{
+				out.push_back(field[j]);
+			}
+
+			out.push_back(i + 1 < reader.fields.size ? '|' : ';');
+		}
+	}
+}
+
+/**
+ * Reads a document at once, and fed in two chunks that are cut at every
+ * offset, and checks that all readings give the expected rows.
+ */
+void
+check_document(const char *text, const char *expected, const char *message)
+{
+	StringView document(text, strlen(text));
+
+	String whole;
+	CsvReader reader(document);
+	read_rows(reader, whole);
+	check(equals(whole, expected), message);
+
+	for (usize cut = 0; cut <= document.size; cut++)
+	{
+		String streamed;
+		CsvReader stream;
+
+		stream.feed(document.substr(0, cut));
+		read_rows(stream, streamed);
+		stream.feed(document.substr(cut, document.size - cut));
+		read_rows(stream, streamed);
+		stream.finish();
+		read_rows(stream, streamed);
+
+		check(equals(streamed, expected), message);
+	}
+
+	// One byte at a time.
+
+	String bytes;
+	CsvReader stream;
+
+	for (usize i = 0; i < document.size; i++)
+	{
+		stream.feed(document.substr(i, 1));
+		read_rows(stream, bytes);
+	}
+
+	stream.finish();
+	read_rows(stream, bytes);
+	check(equals(bytes, expected), message);
+}
+
+void
+test_documents()
+{
+	check_document("", "", "empty document");
+	check_document("a,b,c\n1,2,3\n", "a|b|c;1|2|3;", "simple rows");
+	check_document("a,b\n1,2", "a|b;1|2;", "no trailing newline");
+	check_document("a,,\n,\n", "a||;|;", "empty fields");
+	check_document("a,b\r\n1,2\r\n", "a|b;1|2;", "CRLF");
+	check_document("a\r\nb", "a;b;", "CRLF without trailing newline");
+
+	// Quoted fields with delimiters, newlines and escaped quotes.
+
+	check_document("\"a,b\",c\n", "a,b|c;", "quoted delimiter");
+	check_document("\"line\nbreak\",x\r\n", "line\nbreak|x;",
+		"quoted newline");
+	check_document("\"say \"\"hi\"\"\",\"\"\"\"\n", "say \"hi\"|\";",
+		"escaped quotes");
+	check_document("\"\",\"x\"\n", "|x;", "empty quoted field");
+	check_document("\"a\"\"\",\"b\"\"\"\"c\"\r\n", "a\"|b\"\"c;",
+		"escaped quotes in several fields");
+
+	// Rows longer than a 16-byte block, with a quoted field that spans
+	// blocks.
+
+	check_document("0123456789,0123456789,\"0123456789,\n0123456789\"\n"
+		"abcdefghijklmnopqrstuvwxyz\n",
+		"0123456789|0123456789|0123456789,\n0123456789;"
+		"abcdefghijklmnopqrstuvwxyz;", "long rows");
+}
+
+void
+test_parse_field()
+{
+	CsvReader reader("1,-2.5e3,x\n");
+	check(reader.next_row(), "row with numbers");
+
+	Vector<i64> integers;
+	Vector<f64> floats;
+	check(reader.parse_field(0, integers) && integers[0] == 1,
+		"integer field");
+	check(reader.parse_field(1, floats) && floats[0] == -2500.0,
+		"float field");
+	check(!reader.parse_field(2, floats) && floats.size == 1,
+		"invalid field");
+	check(!reader.parse_field(3, integers) && integers.size == 1,
+		"missing field");
+}
+
+/**
+ * Parses a float and checks the result against an expected value.
+ */
+void
+check_float(const char *text, f64 expected, const char *message)
+{
+	f64 value = 1.0;
+	check(slaw::detail::parse_float(StringView(text, strlen(text)), value),
+		message);
+	check(value == expected, message);
+
+	// Zeros must keep their sign, which 1 / x tells apart.
+
+	check(value != 0 || 1 / value == 1 / expected, message);
+}
+
+/**
+ * Parses a float that the parser may round off by a few units in the last
+ * place, and checks that it is close to an expected value.
+ */
+void
+check_float_near(const char *text, f64 expected, const char *message)
+{
+	f64 value = 0.0;
+	check(slaw::detail::parse_float(StringView(text, strlen(text)), value),
+		message);
+
+	f64 error = value > expected ? value - expected : expected - value;
+	check(error <= expected * 1e-15, message);
+}
+
+/**
+ * Checks that a text is not accepted as a float.
+ */
+void
+check_invalid_float(const char *text, const char *message)
+{
+	f64 value;
+	check(!slaw::detail::parse_float(StringView(text, strlen(text)), value),
+		message);
+}
+
+void
+test_floats()
+{
+	check_float("0", 0.0, "zero");
+	check_float("-0", -0.0, "negative zero");
+	check_float("1.5", 1.5, "fraction");
+	check_float("+2.5E2", 250.0, "upper case exponent");
+	check_float("1e22", 1e22, "largest exact power");
+	check_float("123456789e-3", 123456.789, "negative exponent");
+	check_float(".5", 0.5, "no integer part");
+	check_float("5.", 5.0, "no fraction part");
+
+	// Exponents that would wrap around in 32 bits saturate instead.
+
+	check_float("1e99999999999", slaw::Infinity64, "huge exponent");
+	check_float("-1e99999999999", -slaw::Infinity64,
+		"huge exponent, negative");
+	check_float("1e-99999999999", 0.0, "huge negative exponent");
+	check_float("-1e-99999999999", -0.0, "huge negative exponent, negative");
+	check_float("1e4294967297", slaw::Infinity64, "exponent above 2^32");
+	check_float("0e999999", 0.0, "zero with a huge exponent");
+	check_float("-1e400", -slaw::Infinity64, "overflow");
+	check_float("1e-400", 0.0, "underflow");
+	check_float_near("1e308", 1e308, "large exponent");
+	check_float_near("0.000001e310", 1e304, "exponent and fraction");
+	check_float_near("1e-300", 1e-300, "small exponent");
+
+	check_invalid_float("", "empty");
+	check_invalid_float("abc", "letters");
+	check_invalid_float("1e", "exponent without digits");
+	check_invalid_float("1e+", "exponent sign without digits");
+	check_invalid_float("1e5x", "trailing characters after the exponent");
+	check_invalid_float("1e--5", "two exponent signs");
+	check_invalid_float("-", "only a sign");
+	check_invalid_float(".", "only a point");
+}
+
+int
+main()
+{
+	test_documents();
+	test_parse_field();
+	test_floats();
+
+	printf("All CSV tests passed.\n");
+}
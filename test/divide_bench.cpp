@@ -0,0 +1,297 @@
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../types.hpp"
+#include "../math.hpp"
+#include "../divider.hpp"
+#include "check.hpp"
+
+// Checks `Divider` against the `/` and `%` operators, for divisors around
+// every power of two and random divisors, and numerators around the edges
+// of each type and random numerators, both scalar and for `u32x4` and
+// `i32x4` vectors. Then compares the time per division of the division
+// instruction, with a divisor the compiler cannot see, against `Divider`.
+// Also checks `ipow()`. Build natively with `make divide_bench`.
+
+constexpr usize sample_count = 1 << 16;
+constexpr usize iterations = 200;
+
+// Powers computed at compile time.
+static_assert(slaw::ipow(3, 4) == 81);
+static_assert(slaw::ipow(10u, 9) == 1000000000u);
+static_assert(slaw::ipow(-2, 31) == -2147483647 - 1);
+static_assert(slaw::ipow(2.0, -2) == 0.25);
+static_assert(slaw::ipow(-1, -3) == -1);
+static_assert(slaw::ipow(5, -1) == 0);
+static_assert(slaw::ipow(7, 0) == 1);
+
+// Divisions computed at compile time.
+static_assert(slaw::Divider<u32>(7).divide(100) == 14);
+static_assert(slaw::Divider<i64>(-3).modulo(-10) == -1);
+
+u64 random_state = 0x9E3779B97F4A7C15;
+
+/**
+ * Returns a pseudo-random 64-bit number, from a xorshift generator.
+ */
+u64
+random_u64()
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state;
+}
+
+/**
+ * Returns the numerators checked for a divisor: the edges of the type, the
+ * neighbours of multiples of the divisor, and random numbers.
+ */
+template <typename T>
+void
+numerators_for(T d, T *out, usize count)
+{
+	// The neighbours wrap around in unsigned arithmetic. The multiples of
+	// -1 at the edges would overflow, so those of 1 are used instead.
+
+	constexpr T low = slaw::min_value<T>();
+	constexpr T high = slaw::max_value<T>();
+	T m = slaw::is_signed_integer<T>() && d == (T) -1 ? 1 : d;
+	u64 u = (u64) d;
+	T edges[] = { 0, 1, (T) -1, low, high, (T) (low + 1), (T) (high - 1),
+		d, (T) (u - 1), (T) (u + 1), (T) (u * 2), (T) (u * 2 - 1),
+		(T) (high / m * m), (T) ((u64) (high / m * m) - 1),
+		(T) (low / m * m), (T) ((u64) (low / m * m) + 1) };
+	usize edge_count = sizeof(edges) / sizeof(T);
+
+	for (usize i = 0; i < count; i++)
+	{
+		out[i] = i < edge_count ? edges[i] : (T) random_u64();
+	}
+}
+
+/**
+ * Checks the scalar and, for 32-bit types, the SIMD quotients and
+ * remainders of one divisor.
+ */
+template <typename T>
+void
+check_divisor(T d)
+{
+	constexpr usize count = 64;
+
+	// The quotient of the minimum value and -1 overflows, so it is
+	// skipped.
+
+	auto skip = [&](T n)
+	{
+		return slaw::is_signed_integer<T>() && d == (T) -1
+			&& n == slaw::min_value<T>();
+	};
+
+	T n[count];
+	numerators_for(d, n, count);
+	slaw::Divider<T> divider(d);
+
+	for (usize i = 0; i < count; i++)
+	{
+		if (!skip(n[i]))
+		{
+			check(divider.divide(n[i]) == n[i] / d, "scalar quotient");
+			check(divider.modulo(n[i]) == n[i] % d, "scalar remainder");
+		}
+	}
+
+	if constexpr (sizeof(T) == 4)
+	{
+		using V = slaw::simd::simd_vector_of<T>;
+
+		for (usize i = 0; i < count; i += 4)
+		{
+			V v = slaw::simd::load<V>(n + i);
+			V q = slaw::simd::divide(v, divider);
+			V r = slaw::simd::modulo(v, divider);
+
+			for (usize j = 0; j < 4; j++)
+			{
+				if (!skip(n[i + j]))
+				{
+					check(q[j] == n[i + j] / d, "SIMD quotient");
+					check(r[j] == n[i + j] % d, "SIMD remainder");
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Checks the divisors 1 to 1000, the neighbours of every power of two and
+ * random divisors, and their negations for signed types.
+ */
+template <typename T>
+void
+check_divisors()
+{
+	constexpr u32 bits = sizeof(T) * 8;
+
+	auto check_both = [](T d)
+	{
+		if (d != 0)
+		{
+			check_divisor(d);
+
+			if constexpr (slaw::is_signed_integer<T>())
+			{
+				check_divisor((T) (0 - (u64) d));
+			}
+		}
+	};
+
+	for (u32 i = 1; i <= 1000; i++)
+	{
+		check_both((T) i);
+	}
+
+	for (u32 shift = 0; shift < bits; shift++)
+	{
+		T power = (T) ((u64) 1 << shift);
+		check_both(power);
+		check_both((T) ((u64) power - 1));
+		check_both((T) ((u64) power + 1));
+	}
+
+	for (usize i = 0; i < 10000; i++)
+	{
+		// Random divisors of random widths.
+
+		u64 d = random_u64() >> (random_u64() % 64);
+		check_both((T) d);
+	}
+
+	check_both(slaw::max_value<T>());
+	check_both(slaw::min_value<T>());
+}
+
+/**
+ * Returns the time per element of a function that divides `sample_count`
+ * elements, in nanoseconds.
+ */
+template <typename F>
+double
+time(F f)
+{
+	f();
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		f();
+
+		// The compiler must assume that memory changed, so it cannot
+		// merge the repeated runs into one.
+
+		__asm__ volatile("" : : : "memory");
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - start).count() * 1e9
+		/ (iterations * sample_count);
+}
+
+/**
+ * Compares the division instruction against `Divider`, scalar and for
+ * 32-bit types SIMD, over random numerators.
+ */
+template <typename T>
+void
+bench(const char *type, T divisor)
+{
+	alignas(16) static T n[sample_count];
+	alignas(16) static T out[sample_count];
+
+	for (usize i = 0; i < sample_count; i++)
+	{
+		n[i] = (T) random_u64();
+	}
+
+	// The divisor is read through a volatile, so the compiler cannot
+	// turn the division into a multiplication by itself.
+
+	volatile T hidden = divisor;
+	T d = hidden;
+	slaw::Divider<T> divider(d);
+
+	double instruction = time([&]()
+	{
+		for (usize i = 0; i < sample_count; i++)
+		{
+			out[i] = n[i] / d;
+		}
+	});
+
+	double scalar = time([&]()
+	{
+		for (usize i = 0; i < sample_count; i++)
+		{
+			out[i] = divider.divide(n[i]);
+		}
+	});
+
+	check(out[0] == n[0] / d, "timed quotient");
+
+	printf("%-4s / %-11lld %8.3f ns division %8.3f ns divider", type,
+		(long long) divisor, instruction, scalar);
+
+	if constexpr (sizeof(T) == 4)
+	{
+		using V = slaw::simd::simd_vector_of<T>;
+
+		double simd = time([&]()
+		{
+			for (usize i = 0; i < sample_count; i += 4)
+			{
+				V v = slaw::simd::load<V>(n + i);
+				slaw::simd::store(out + i, slaw::simd::divide(v, divider));
+			}
+		});
+
+		printf(" %8.3f ns simd", simd);
+	}
+
+	printf("\n");
+}
+
+int
+main()
+{
+	// Integer powers against repeated multiplication.
+
+	for (i64 base = -20; base <= 20; base++)
+	{
+		i64 expected = 1;
+
+		for (u32 exponent = 0; exponent < 64; exponent++)
+		{
+			check(slaw::ipow(base, exponent) == expected, "integer power");
+			check(slaw::ipow((i32) base, exponent) == (i32) expected,
+				"32-bit integer power");
+			expected = (i64) ((u64) expected * (u64) base);
+		}
+	}
+
+	check_divisors<u32>();
+	check_divisors<i32>();
+	check_divisors<u64>();
+	check_divisors<i64>();
+
+	printf("All divisions match.\n");
+
+	bench<u32>("u32", 7);
+	bench<u32>("u32", 1000000007);
+	bench<i32>("i32", -7);
+	bench<i32>("i32", 641);
+	bench<u64>("u64", 7);
+	bench<u64>("u64", 1000000000000000003ull);
+	bench<i64>("i64", -7);
+	bench<i64>("i64", 1000000007);
+}
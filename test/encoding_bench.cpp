@@ -0,0 +1,195 @@
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../encoding.hpp"
+#include "check.hpp"
+
+// Benchmarks the base64 and hex kernels and checks that decoding the encoded
+// data yields the original data again.
+// Build natively with `make encoding_bench`.
+
+constexpr usize data_size = 1 << 20;
+constexpr usize iterations = 200;
+
+/**
+ * Runs a function `iterations` times and prints its throughput in GB/s,
+ * measured over the given number of input bytes per run.
+ */
+template <typename F>
+void
+bench(const char *name, usize bytes, F f)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		f();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("%-24s %8.3f GB/s\n", name,
+		(double) bytes * iterations / seconds / 1e9);
+}
+
+void
+test_base64()
+{
+	// Known answers from RFC 4648.
+
+	const char *inputs[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+	const char *outputs[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==",
+		"Zm9vYmE=", "Zm9vYmFy" };
+
+	for (usize i = 0; i < 7; i++)
+	{
+		char out[16];
+		usize n = slaw::base64::encode(out, (const u8 *) inputs[i],
+			strlen(inputs[i]));
+
+		check(n == strlen(outputs[i]) && memcmp(out, outputs[i], n) == 0,
+			"base64 known answer");
+	}
+
+	// Round trips of every length up to 100, in both alphabets, padded
+	// and unpadded, so every tail case of the SIMD loops is covered.
+
+	u8 in[100];
+	char text[200];
+	u8 back[100];
+
+	for (usize i = 0; i < 100; i++)
+	{
+		in[i] = rand();
+	}
+
+	for (usize size = 0; size <= 100; size++)
+	{
+		for (int url = 0; url < 2; url++)
+		{
+			for (int pad = 0; pad < 2; pad++)
+			{
+				auto alphabet = url ? slaw::base64::Alphabet::Url
+					: slaw::base64::Alphabet::Standard;
+
+				usize n = slaw::base64::encode(text, in, size,
+					alphabet, pad);
+				check(n == slaw::base64::encoded_size(size, pad),
+					"base64 encoded size");
+
+				isize m = slaw::base64::decode(back, text, n,
+					alphabet);
+				check(m == (isize) size
+					&& memcmp(in, back, size) == 0,
+					"base64 round trip");
+			}
+		}
+	}
+
+	// Invalid characters are rejected in both the SIMD and scalar paths.
+
+	usize n = slaw::base64::encode(text, in, 60);
+
+	for (usize i = 0; i < n; i++)
+	{
+		char c = text[i];
+		text[i] = '*';
+		check(slaw::base64::decode(back, text, n) == -1,
+			"base64 rejects invalid characters");
+		text[i] = c;
+	}
+}
+
+void
+test_hex()
+{
+	u8 in[100];
+	char text[200];
+	u8 back[100];
+
+	for (usize i = 0; i < 100; i++)
+	{
+		in[i] = rand();
+	}
+
+	for (usize size = 0; size <= 100; size++)
+	{
+		usize n = slaw::hex::encode(text, in, size, size % 2);
+		check(n == 2 * size, "hex encoded size");
+
+		for (usize i = 0; i < size; i++)
+		{
+			char expected[3];
+			snprintf(expected, 3, size % 2 ? "%02X" : "%02x", in[i]);
+			check(memcmp(text + 2 * i, expected, 2) == 0,
+				"hex encoding");
+		}
+
+		isize m = slaw::hex::decode(back, text, n);
+		check(m == (isize) size && memcmp(in, back, size) == 0,
+			"hex round trip");
+	}
+
+	slaw::hex::encode(text, in, 40);
+
+	for (usize i = 0; i < 80; i++)
+	{
+		char c = text[i];
+		text[i] = 'g';
+		check(slaw::hex::decode(back, text, 80) == -1,
+			"hex rejects invalid characters");
+		text[i] = c;
+	}
+}
+
+int
+main()
+{
+	test_base64();
+	test_hex();
+	printf("All checks passed.\n\n");
+
+	u8 *data = new u8[data_size];
+	char *text = new char[data_size * 2];
+	u8 *back = new u8[data_size];
+
+	for (usize i = 0; i < data_size; i++)
+	{
+		data[i] = rand();
+	}
+
+	usize base64_size = 0;
+
+	bench("base64 encode", data_size, [&]()
+	{
+		base64_size = slaw::base64::encode(text, data, data_size);
+	});
+
+	bench("base64 decode", base64_size, [&]()
+	{
+		slaw::base64::decode(back, text, base64_size);
+	});
+
+	bench("base64 url encode", data_size, [&]()
+	{
+		slaw::base64::encode(text, data, data_size,
+			slaw::base64::Alphabet::Url, false);
+	});
+
+	bench("hex encode", data_size, [&]()
+	{
+		slaw::hex::encode(text, data, data_size);
+	});
+
+	bench("hex decode", data_size * 2, [&]()
+	{
+		slaw::hex::decode(back, text, data_size * 2);
+	});
+
+	delete[] data;
+	delete[] text;
+	delete[] back;
+}
\ No newline at end of file
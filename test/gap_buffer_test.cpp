@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../gap_buffer.hpp"
+#include "check.hpp"
+
+// Checks `GapBuffer` against a plain string that receives the same random
+// inserts, erases and cursor moves, including the cached line starts, which
+// are queried between edits so that only parts of the cache stay valid.
+// Build natively with `make gap_buffer_test`.
+
+using slaw::GapBuffer;
+using slaw::String;
+using slaw::StringView;
+
+/**
+ * Checks the text, the gap and a few random line lookups of a buffer
+ * against the string it should hold.
+ */
+void
+check_buffer(GapBuffer &buffer, const String &expected, usize cursor)
+{
+	check(buffer.size() == expected.size, "size");
+	check(buffer.cursor() == cursor, "cursor");
+	check(buffer.to_string() == expected, "contents");
+
+	StringView before = buffer.before_gap();
+	StringView after = buffer.after_gap();
+	check(before.size == cursor && before.size + after.size == expected.size,
+		"gap position");
+	check(memcmp(before.data, expected.data, before.size) == 0
+		&& memcmp(after.data, expected.data + cursor, after.size) == 0,
+		"spans");
+
+	for (usize i = 0; i < expected.size; i++)
+	{
+		check(buffer[i] == expected[i], "byte");
+	}
+
+	// Line lookups against a scan of the expected text. Only some lines
+	// are looked up, so the cache is left partially filled.
+
+	usize newlines = 0;
+	usize last_start = 0;
+
+	for (usize i = 0; i <= expected.size; i++)
+	{
+		if (rand() % 8 == 0)
+		{
+			check(buffer.line_of(i) == newlines, "line_of");
+		}
+
+		if (i < expected.size && expected[i] == '\n')
+		{
+			newlines++;
+			last_start = i + 1;
+
+			if (rand() % 4 == 0)
+			{
+				check(buffer.line_start(newlines) == last_start,
+					"line_start");
+			}
+		}
+	}
+
+	check(buffer.line_count() == newlines + 1, "line_count");
+	check(buffer.line_start(newlines) == last_start, "last line_start");
+	check(buffer.line_start(newlines + 1) == expected.size,
+		"line_start past the end");
+}
+
+/**
+ * Returns a random text of up to `max_size` bytes, with some newlines.
+ */
+String
+random_text(usize max_size)
+{
+	String s;
+	usize size = rand() % (max_size + 1);
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back(rand() % 5 == 0 ? '\n' : (char) ('a' + rand() % 26));
+	}
+
+	return s;
+}
+
+/**
+ * Replaces `length` bytes of a string at an offset with a text.
+ */
+void
+splice(String &s, usize pos, usize length, const String &text)
+{
+	String out;
+
+	for (usize i = 0; i < pos; i++)
+	{
+		out.push_back(s[i]);
+	}
+
+	for (usize i = 0; i < text.size; i++)
+	{
+		out.push_back(text[i]);
+	}
+
+	for (usize i = pos + length; i < s.size; i++)
+	{
+		out.push_back(s[i]);
+	}
+
+	s = slaw::move(out);
+}
+
+void
+test_random_edits()
+{
+	GapBuffer buffer;
+	String expected;
+	usize cursor = 0;
+	String none;
+
+	check_buffer(buffer, expected, cursor);
+
+	// Short and long inserts, erases on both sides of the cursor, and
+	// cursor moves over short and long distances, with long texts that
+	// make the array grow several times.
+
+	for (usize round = 0; round < 2000; round++)
+	{
+		usize op = rand() % 7;
+		usize pos = rand() % (expected.size + 1);
+
+		if (op == 0)
+		{
+			String text = random_text(rand() % 10 == 0 ? 500 : 20);
+			buffer.insert(pos, text);
+			splice(expected, pos, 0, text);
+			cursor = pos + text.size;
+		}
+		else if (op == 1)
+		{
+			char c = rand() % 3 == 0 ? '\n' : 'x';
+			buffer.insert(c);
+			splice(expected, cursor, 0, String(c == '\n' ? "\n" : "x"));
+			cursor++;
+		}
+		else if (op == 2)
+		{
+			usize count = rand() % 10;
+			buffer.erase_before(count);
+			count = count < cursor ? count : cursor;
+			cursor -= count;
+			splice(expected, cursor, count, none);
+		}
+		else if (op == 3)
+		{
+			usize count = rand() % 10;
+			buffer.erase_after(count);
+			usize left = expected.size - cursor;
+			splice(expected, cursor, count < left ? count : left, none);
+		}
+		else if (op == 4)
+		{
+			usize length = rand() % 4 == 0 ? (usize) -1 : rand() % 50;
+			buffer.erase(pos, length);
+			usize left = expected.size - pos;
+			splice(expected, pos, length < left ? length : left, none);
+			cursor = pos;
+		}
+		else
+		{
+			buffer.move_cursor(pos);
+			cursor = pos;
+		}
+
+		check_buffer(buffer, expected, cursor);
+	}
+}
+
+void
+test_lines()
+{
+	GapBuffer buffer(StringView("one\ntwo\n\nfour", 13));
+	check(buffer.cursor() == 13 && buffer.line_count() == 4, "from text");
+	check(buffer.line_start(3) == 9 && buffer.line_of(9) == 3,
+		"last line");
+
+	// An edit in an earlier line moves the cached lines after it.
+
+	buffer.insert(1, StringView("\n\n", 2));
+	check(buffer.to_string() == String("o\n\nne\ntwo\n\nfour"),
+		"insert newlines");
+	check(buffer.line_start(3) == 6 && buffer.line_start(5) == 11,
+		"lines after an insert");
+	check(buffer.line_of(0) == 0 && buffer.line_of(2) == 1
+		&& buffer.line_of(12) == 5, "line_of after an insert");
+
+	// Erasing the newline in front of a cached line start.
+
+	buffer.move_cursor(6);
+	buffer.erase_before(1);
+	check(buffer.to_string() == String("o\n\nnetwo\n\nfour"),
+		"erase a newline");
+	check(buffer.line_start(3) == 9 && buffer.line_count() == 5,
+		"lines after erasing a newline");
+
+	buffer.erase(0, (usize) -1);
+	check(buffer.size() == 0 && buffer.line_count() == 1
+		&& buffer.line_start(1) == 0, "erase everything");
+}
+
+int
+main()
+{
+	test_random_edits();
+	test_lines();
+
+	printf("All gap buffer tests passed.\n");
+}
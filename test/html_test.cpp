@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../html.hpp"
+#include "check.hpp"
+
+// Checks `escape_html()` and `escaped_html_size()` against a naive escaper,
+// over random texts with special characters at every offset of the 16-byte
+// blocks, and appending many fragments to one string.
+// Build natively with `make html_test`.
+
+using slaw::String;
+using slaw::StringView;
+
+/**
+ * Checks if a string holds the characters of a C string.
+ */
+bool
+equals(const String &s, const char *expected)
+{
+	return s.size == strlen(expected)
+		&& memcmp(s.data, expected, s.size) == 0;
+}
+
+/**
+ * Escapes a text one character at a time.
+ */
+String
+naive_escape(StringView text)
+{
+	String out;
+
+	for (usize i = 0; i < text.size; i++)
+	{
+		const char *entity = slaw::detail::html_entity(text[i]);
+
+		if (entity == nullptr)
+		{
+			out.push_back(text[i]);
+			continue;
+		}
+
+		while (*entity)
+		{
+			out.push_back(*entity++);
+		}
+	}
+
+	return out;
+}
+
+/**
+ * Escapes a text with `escape_html()` and naively, and checks that both
+ * give the same result and that the size is predicted exactly.
+ */
+void
+check_escape(StringView text, const char *message)
+{
+	String expected = naive_escape(text);
+	check(slaw::escaped_html_size(text) == expected.size, message);
+
+	String escaped = slaw::escape_html(text);
+	check(escaped.size == expected.size
+		&& memcmp(escaped.data, expected.data, expected.size) == 0,
+		message);
+}
+
+void
+test_fixed()
+{
+	check(equals(slaw::escape_html(StringView()), ""), "empty text");
+	check(equals(slaw::escape_html("plain text"), "plain text"),
+		"plain text");
+	check(equals(slaw::escape_html("<a href=\"x\">Tom & Jerry's</a>"),
+		"&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&#39;s&lt;/a&gt;"),
+		"all entities");
+	check(equals(slaw::escape_html("&&&&&&&&&&&&&&&&&"),
+		"&amp;&amp;&amp;&amp;&amp;&amp;&amp;&amp;&amp;&amp;&amp;&amp;"
+		"&amp;&amp;&amp;&amp;&amp;"), "only special characters");
+	check(equals(slaw::escape_html("&amp;"), "&amp;amp;"),
+		"entities are escaped again");
+}
+
+void
+test_random()
+{
+	// Texts of every size up to a few blocks, mostly ordinary characters
+	// and some special ones, so runs of both kinds cross block borders.
+
+	const char alphabet[] = "ab<>&\"'\n";
+	char text[200];
+
+	for (usize size = 0; size < 100; size++)
+	{
+		for (usize round = 0; round < 50; round++)
+		{
+			usize specials = rand() % 5;
+
+			for (usize i = 0; i < size; i++)
+			{
+				usize k = rand() % (2 + specials);
+				text[i] = alphabet[k < 2 ? k : rand() % 8];
+			}
+
+			check_escape(StringView(text, size), "random text");
+		}
+	}
+
+	// A single special character at every offset.
+
+	for (usize pos = 0; pos < 48; pos++)
+	{
+		memset(text, 'x', 48);
+		text[pos] = '"';
+		check_escape(StringView(text, 48), "one special character");
+	}
+}
+
+void
+test_append()
+{
+	// Many fragments appended to the same string, through several
+	// reallocations.
+
+	String out;
+	String expected;
+
+	for (usize i = 0; i < 1000; i++)
+	{
+		const char *fragment = i % 3 == 0 ? "<li>" : i % 3 == 1
+			? "Fish & \"Chips\" " : "'quoted'";
+		StringView view(fragment, strlen(fragment));
+
+		slaw::escape_html_append(out, view);
+		String escaped = naive_escape(view);
+
+		for (usize j = 0; j < escaped.size; j++)
+		{
+			expected.push_back(escaped[j]);
+		}
+
+		check(out.size == expected.size && out.size <= out.capacity,
+			"append size");
+	}
+
+	check(memcmp(out.data, expected.data, out.size) == 0, "append");
+}
+
+int
+main()
+{
+	test_fixed();
+	test_random();
+	test_append();
+
+	printf("All HTML tests passed.\n");
+}
@@ -0,0 +1,810 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../json.hpp"
+#include "check.hpp"
+
+// Checks `JsonWriter` by writing random documents and reading them back with
+// a strict JSON reader, which must reproduce every string, integer and
+// nesting level exactly, and every float to the writer's precision. Also
+// checks the exact output for escapes, the integer limits and values JSON
+// cannot represent, and that the reader rejects malformed documents.
+// Build natively with `make json_test`.
+
+using slaw::JsonWriter;
+using slaw::String;
+using slaw::Vector;
+
+/**
+ * Checks if a string holds the characters of a C string.
+ */
+bool
+equals(const String &s, const char *expected)
+{
+	return s.size == strlen(expected)
+		&& memcmp(s.data, expected, s.size) == 0;
+}
+
+/**
+ * A JSON value. Integers and floats are told apart by their syntax: a
+ * number without a fraction or exponent is read as an integer.
+ */
+struct Value
+{
+	enum Kind
+	{
+		NULL_VALUE,
+		BOOLEAN,
+		INTEGER,
+		FLOAT,
+		STRING,
+		ARRAY,
+		OBJECT
+	};
+
+	Kind kind = NULL_VALUE;
+	bool boolean = false;
+	i64 integer = 0;
+	f64 number = 0;
+	String text;
+
+	// The keys of an object, and the elements or member values of an
+	// array or object. A vector allocates all of its elements up front,
+	// so the nested values are held by pointer.
+	Vector<String> keys;
+	Vector<Value *> items;
+
+	Value() = default;
+
+	Value(const Value &) = delete;
+
+	~Value()
+	{
+		for (usize i = 0; i < items.size; i++)
+		{
+			delete items[i];
+		}
+	}
+};
+
+/**
+ * A strict reader for the JSON that the writer produces: RFC 8259 without
+ * whitespace, and without `\u` escapes above U+00FF, which the writer never
+ * writes. Returns false for any other input.
+ */
+struct Reader
+{
+	const char *text;
+	usize size;
+	usize pos = 0;
+
+	Reader(const String &s)
+		: text(s.data), size(s.size) {}
+
+	bool
+	read_document(Value &out)
+	{
+		return read_value(out, 0) && pos == size;
+	}
+
+	bool
+	peek(char c)
+	{
+		return pos < size && text[pos] == c;
+	}
+
+	bool
+	read_literal(const char *literal)
+	{
+		usize length = strlen(literal);
+
+		if (size - pos < length || memcmp(text + pos, literal, length) != 0)
+		{
+			return false;
+		}
+
+		pos += length;
+		return true;
+	}
+
+	bool
+	read_value(Value &out, usize depth)
+	{
+		if (depth > 100 || pos >= size)
+		{
+			return false;
+		}
+
+		char c = text[pos];
+
+		if (c == 'n')
+		{
+			out.kind = Value::NULL_VALUE;
+			return read_literal("null");
+		}
+
+		if (c == 't' || c == 'f')
+		{
+			out.kind = Value::BOOLEAN;
+			out.boolean = c == 't';
+			return read_literal(c == 't' ? "true" : "false");
+		}
+
+		if (c == '"')
+		{
+			out.kind = Value::STRING;
+			return read_string(out.text);
+		}
+
+		if (c == '[' || c == '{')
+		{
+			bool object = c == '{';
+			char close = object ? '}' : ']';
+			out.kind = object ? Value::OBJECT : Value::ARRAY;
+			pos++;
+
+			if (peek(close))
+			{
+				pos++;
+				return true;
+			}
+
+			while (true)
+			{
+				if (object)
+				{
+					String key;
+
+					if (!peek('"') || !read_string(key) || !peek(':'))
+					{
+						return false;
+					}
+
+					pos++;
+					out.keys.push_back(slaw::move(key));
+				}
+
+				Value *item = new Value;
+				out.items.push_back(item);
+
+				if (!read_value(*item, depth + 1))
+				{
+					return false;
+				}
+
+				if (peek(close))
+				{
+					pos++;
+					return true;
+				}
+
+				if (!peek(','))
+				{
+					return false;
+				}
+
+				pos++;
+			}
+		}
+
+		return read_number(out);
+	}
+
+	bool
+	read_string(String &out)
+	{
+		pos++;
+
+		while (pos < size)
+		{
+			u8 c = text[pos++];
+
+			if (c == '"')
+			{
+				return true;
+			}
+
+			if (c < ' ')
+			{
+				return false;
+			}
+
+			if (c != '\\')
+			{
+				out.push_back(c);
+				continue;
+			}
+
+			if (pos >= size)
+			{
+				return false;
+			}
+
+			char e = text[pos++];
+			const char *escapes = "\"\"\\\\//b\bf\fn\nr\rt\t";
+			bool found = false;
+
+			for (usize i = 0; escapes[i]; i += 2)
+			{
+				if (e == escapes[i])
+				{
+					out.push_back(escapes[i + 1]);
+					found = true;
+				}
+			}
+
+			if (found)
+			{
+				continue;
+			}
+
+			if (e != 'u' || size - pos < 4 || text[pos] != '0'
+				|| text[pos + 1] != '0')
+			{
+				return false;
+			}
+
+			u32 code = 0;
+
+			for (usize i = 2; i < 4; i++)
+			{
+				char h = text[pos + i];
+				u32 digit = h >= '0' && h <= '9' ? h - '0'
+					: h >= 'a' && h <= 'f' ? h - 'a' + 10
+					: h >= 'A' && h <= 'F' ? h - 'A' + 10 : 16;
+
+				if (digit == 16)
+				{
+					return false;
+				}
+
+				code = code * 16 + digit;
+			}
+
+			out.push_back((char) code);
+			pos += 4;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Reads a number with the JSON grammar
+	 * `-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?`.
+	 */
+	bool
+	read_number(Value &out)
+	{
+		usize start = pos;
+		bool negative = peek('-');
+		pos += negative;
+
+		auto digits = [&]()
+		{
+			usize first = pos;
+
+			while (pos < size && text[pos] >= '0' && text[pos] <= '9')
+			{
+				pos++;
+			}
+
+			return pos - first;
+		};
+
+		usize integer_digits = digits();
+
+		if (integer_digits == 0
+			|| (integer_digits > 1 && text[pos - integer_digits] == '0'))
+		{
+			return false;
+		}
+
+		bool is_float = false;
+
+		if (peek('.'))
+		{
+			pos++;
+			is_float = true;
+
+			if (digits() == 0)
+			{
+				return false;
+			}
+		}
+
+		if (peek('e') || peek('E'))
+		{
+			pos++;
+			is_float = true;
+			pos += peek('+') || peek('-');
+
+			if (digits() == 0)
+			{
+				return false;
+			}
+		}
+
+		char buffer[64];
+		usize length = pos - start;
+
+		if (length >= sizeof(buffer))
+		{
+			return false;
+		}
+
+		memcpy(buffer, text + start, length);
+		buffer[length] = 0;
+		out.number = strtod(buffer, nullptr);
+
+		if (is_float)
+		{
+			out.kind = Value::FLOAT;
+			return true;
+		}
+
+		// Integers are accumulated as negative numbers, which reach
+		// down to the minimum value of i64.
+
+		out.kind = Value::INTEGER;
+		i64 value = 0;
+
+		for (usize i = start + negative; i < pos; i++)
+		{
+			i64 digit = text[i] - '0';
+
+			if (value < (slaw::min_value<i64>() + digit) / 10)
+			{
+				return false;
+			}
+
+			value = value * 10 - digit;
+		}
+
+		if (!negative && value == slaw::min_value<i64>())
+		{
+			return false;
+		}
+
+		out.integer = negative ? value : -value;
+		return true;
+	}
+};
+
+/**
+ * Checks that two floats are equal up to the rounding of the writer,
+ * which writes `precision` decimal places of numbers in positional
+ * notation, and of the mantissa of numbers in scientific notation.
+ */
+bool
+float_matches(f64 expected, f64 actual, usize precision)
+{
+	f64 magnitude = expected < 0 ? -expected : expected;
+	f64 error = expected > actual ? expected - actual : actual - expected;
+	f64 unit = 0.5;
+
+	for (usize i = 0; i < precision; i++)
+	{
+		unit /= 10;
+	}
+
+	if (magnitude >= 1e-6 && magnitude < 1e15)
+	{
+		return error <= unit * 1.000001 + magnitude * 1e-14;
+	}
+
+	return error <= magnitude * (unit * 1.000001 + 1e-14);
+}
+
+/**
+ * Checks that a value read back from the writer's output equals the value
+ * that was written.
+ */
+bool
+matches(const Value &expected, const Value &actual, usize precision)
+{
+	if (expected.kind == Value::FLOAT)
+	{
+		// Floats with no decimal places left read back as integers.
+
+		return (actual.kind == Value::FLOAT || actual.kind == Value::INTEGER)
+			&& float_matches(expected.number, actual.number, precision);
+	}
+
+	if (expected.kind != actual.kind)
+	{
+		return false;
+	}
+
+	switch (expected.kind)
+	{
+	case Value::BOOLEAN:
+		return expected.boolean == actual.boolean;
+	case Value::INTEGER:
+		return expected.integer == actual.integer;
+	case Value::STRING:
+		return expected.text == actual.text;
+	case Value::ARRAY:
+	case Value::OBJECT:
+		if (expected.items.size != actual.items.size
+			|| expected.keys.size != actual.keys.size)
+		{
+			return false;
+		}
+
+		for (usize i = 0; i < expected.keys.size; i++)
+		{
+			if (!(expected.keys[i] == actual.keys[i]))
+			{
+				return false;
+			}
+		}
+
+		for (usize i = 0; i < expected.items.size; i++)
+		{
+			if (!matches(*expected.items[i], *actual.items[i], precision))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	default:
+		return true;
+	}
+}
+
+/**
+ * Writes a value with a `JsonWriter`.
+ */
+void
+write(JsonWriter &writer, const Value &value)
+{
+	switch (value.kind)
+	{
+	case Value::NULL_VALUE:
+		writer.null();
+		break;
+	case Value::BOOLEAN:
+		writer.value(value.boolean);
+		break;
+	case Value::INTEGER:
+		writer.value(value.integer);
+		break;
+	case Value::FLOAT:
+		writer.value(value.number);
+		break;
+	case Value::STRING:
+		writer.value(value.text);
+		break;
+	case Value::ARRAY:
+		writer.begin_array();
+
+		for (usize i = 0; i < value.items.size; i++)
+		{
+			write(writer, *value.items[i]);
+		}
+
+		writer.end_array();
+		break;
+	case Value::OBJECT:
+		writer.begin_object();
+
+		for (usize i = 0; i < value.items.size; i++)
+		{
+			writer.key(value.keys[i]);
+			write(writer, *value.items[i]);
+		}
+
+		writer.end_object();
+		break;
+	}
+}
+
+u64 random_state = 0x9E3779B97F4A7C15;
+
+/**
+ * Returns a pseudo-random 64-bit number, from a xorshift generator.
+ */
+u64
+random_u64()
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state;
+}
+
+/**
+ * Returns a random string of any bytes, biased towards the characters that
+ * have to be escaped, with sizes around the 16-byte blocks.
+ */
+String
+random_string()
+{
+	const char special[] = "\"\\\b\f\n\r\t\x01\x1F\x7F/";
+	String s;
+	usize size = random_u64() % 40;
+
+	for (usize i = 0; i < size; i++)
+	{
+		u64 r = random_u64();
+		s.push_back(r % 4 == 0 ? special[r / 4 % (sizeof(special) - 1)]
+			: r % 4 == 1 ? (char) (r >> 8) : (char) ('a' + r % 26));
+	}
+
+	return s;
+}
+
+/**
+ * Returns a random float of any sign and magnitude, including exact
+ * integers and subnormal numbers.
+ */
+f64
+random_float()
+{
+	u64 r = random_u64();
+
+	switch (r % 4)
+	{
+	case 0:
+		return (f64) (i64) (random_u64() % 2000000) - 1000000;
+	case 1:
+		return ((f64) (random_u64() % 1000000) - 500000) / 1000;
+	default:
+		// Any finite bit pattern.
+
+		while (true)
+		{
+			u64 bits = random_u64();
+			f64 f;
+			memcpy(&f, &bits, sizeof(f));
+
+			if (!slaw::is_nan(f) && f - f == 0)
+			{
+				return f;
+			}
+		}
+	}
+}
+
+/**
+ * Fills a value with a random value, with arrays and objects up to a given
+ * depth.
+ */
+void
+random_value(Value &v, usize depth)
+{
+	u64 r = random_u64() % (depth > 0 ? 7 : 5);
+
+	switch (r)
+	{
+	case 0:
+		v.kind = random_u64() % 2 ? Value::NULL_VALUE : Value::BOOLEAN;
+		v.boolean = random_u64() % 2;
+		break;
+	case 1:
+		v.kind = Value::INTEGER;
+		v.integer = (i64) random_u64() >> (random_u64() % 64);
+		break;
+	case 2:
+		v.kind = Value::FLOAT;
+		v.number = random_float();
+		break;
+	case 3:
+	case 4:
+		v.kind = Value::STRING;
+		v.text = random_string();
+		break;
+	default:
+		v.kind = r == 5 ? Value::ARRAY : Value::OBJECT;
+		usize count = random_u64() % 5;
+
+		for (usize i = 0; i < count; i++)
+		{
+			if (v.kind == Value::OBJECT)
+			{
+				v.keys.push_back(random_string());
+			}
+
+			v.items.push_back(new Value);
+			random_value(*v.items.back(), depth - 1);
+		}
+	}
+}
+
+void
+test_round_trip()
+{
+	JsonWriter writer;
+	usize precisions[] = { 0, 3, 6, 15 };
+
+	for (usize round = 0; round < 5000; round++)
+	{
+		Value document;
+		random_value(document, 4);
+		writer.reset();
+		writer.precision = precisions[round % 4];
+		write(writer, document);
+
+		Value read;
+		Reader reader(writer.buffer);
+		check(reader.read_document(read), "writer output is valid JSON");
+		check(matches(document, read, writer.precision),
+			"document reads back unchanged");
+	}
+}
+
+void
+test_exact_output()
+{
+	JsonWriter writer;
+
+	writer.begin_object();
+	writer.key("s");
+	writer.value("quote \" backslash \\ slash / tab \t nl \n");
+	writer.key("c");
+	writer.value("\x01\x1F\x7F\b\f\r");
+	writer.key("e");
+	writer.begin_array();
+	writer.begin_object();
+	writer.end_object();
+	writer.begin_array();
+	writer.end_array();
+	writer.value("");
+	writer.end_array();
+	writer.end_object();
+	check(equals(writer.buffer, "{\"s\":\"quote \\\" backslash \\\\ slash / "
+		"tab \\t nl \\n\",\"c\":\"\\u0001\\u001f\x7F\\b\\f\\r\","
+		"\"e\":[{},[],\"\"]}"), "escapes and empty containers");
+
+	// The integer limits.
+
+	writer.reset();
+	writer.begin_array();
+	writer.value(slaw::min_value<i64>());
+	writer.value(slaw::max_value<i64>());
+	writer.value(slaw::max_value<u64>());
+	writer.value(slaw::min_value<i32>());
+	writer.value((i64) 0);
+	writer.value((u8) 255);
+	writer.end_array();
+	check(equals(writer.buffer, "[-9223372036854775808,9223372036854775807,"
+		"18446744073709551615,-2147483648,0,255]"), "integer limits");
+
+	// The reader only holds 64-bit signed integers.
+
+	writer.reset();
+	writer.begin_array();
+	writer.value(slaw::min_value<i64>());
+	writer.value(slaw::max_value<i64>());
+	writer.end_array();
+
+	Value limits;
+	Reader reader(writer.buffer);
+	check(reader.read_document(limits), "integer limits are valid JSON");
+	check(limits.items[0]->integer == slaw::min_value<i64>()
+		&& limits.items[1]->integer == slaw::max_value<i64>(),
+		"integer limits read back");
+
+	// Values that JSON cannot represent become null, and floats are
+	// written with the configured precision.
+
+	writer.reset();
+	writer.begin_array();
+	writer.value(slaw::NaN64);
+	writer.value(slaw::Infinity64);
+	writer.value(-slaw::Infinity64);
+	writer.value(0.5);
+	writer.value(-0.0000001);
+	writer.value(1e300);
+	writer.value(2.0f);
+	writer.end_array();
+	check(equals(writer.buffer, "[null,null,null,0.5,-1e-7,1e300,2]"),
+		"floats");
+
+	// Bytes that are not valid UTF-8 are copied unchanged; the writer
+	// only escapes what JSON requires.
+
+	writer.reset();
+	writer.value("\xFF\xC3");
+	check(equals(writer.buffer, "\"\xFF\xC3\""), "non-UTF-8 bytes");
+}
+
+void
+test_nesting()
+{
+	// 64 levels, each with an element before and after the nested array,
+	// so every level needs its own comma bit.
+
+	JsonWriter writer;
+
+	for (usize i = 0; i < 64; i++)
+	{
+		writer.begin_array();
+		writer.value((i64) i);
+	}
+
+	for (usize i = 0; i < 64; i++)
+	{
+		writer.value(true);
+		writer.end_array();
+	}
+
+	Value read;
+	Reader reader(writer.buffer);
+	check(reader.read_document(read), "64 levels are valid JSON");
+
+	const Value *level = &read;
+
+	for (usize i = 0; i < 64; i++)
+	{
+		usize expected = i == 63 ? 2 : 3;
+		check(level->kind == Value::ARRAY
+			&& level->items.size == expected
+			&& level->items[0]->integer == (i64) i
+			&& level->items[expected - 1]->boolean, "nesting level");
+
+		if (i < 63)
+		{
+			level = level->items[1];
+		}
+	}
+
+	// Objects with keys at every level.
+
+	writer.reset();
+	writer.begin_object();
+	writer.key("a");
+	writer.begin_object();
+	writer.key("b");
+	writer.begin_array();
+	writer.end_array();
+	writer.key("c");
+	writer.null();
+	writer.end_object();
+	writer.key("d");
+	writer.value((i64) 1);
+	writer.end_object();
+	check(equals(writer.buffer, "{\"a\":{\"b\":[],\"c\":null},\"d\":1}"),
+		"nested objects");
+}
+
+void
+test_invalid_documents()
+{
+	// The reader must reject malformed JSON, or the round trip would not
+	// show that the output is valid.
+
+	const char *invalid[] = {
+		"", "[", "]", "[1,]", "[,1]", "{\"a\"}", "{\"a\":}", "{a:1}",
+		"\"abc", "\"a\nb\"", "\"\\x\"", "\"\\u00G0\"", "01", "-", "1.",
+		".5", "1e", "1e+", "+1", "nul", "truex", "[1 2]", "{\"a\":1,}",
+		"9223372036854775808", "-9223372036854775809", "[1]]"
+	};
+
+	for (const char *text : invalid)
+	{
+		String s;
+
+		for (usize i = 0; text[i]; i++)
+		{
+			s.push_back(text[i]);
+		}
+
+		Value value;
+		Reader reader(s);
+		check(!reader.read_document(value), text);
+	}
+}
+
+int
+main()
+{
+	test_invalid_documents();
+	test_exact_output();
+	test_nesting();
+	test_round_trip();
+
+	printf("All JSON tests passed.\n");
+}
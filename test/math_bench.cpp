@@ -0,0 +1,251 @@
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "math_bench.hpp"
+
+// Measures every scalar and SIMD math function over dense and random inputs:
+// the maximum error against a long double reference, and the time per call.
+// Prints one CSV line per function, type, variant and input distribution,
+// in the same format as `math_bench.js`, the WASM version.
+// Build natively with `make math_bench`.
+
+using math_bench::Case;
+using math_bench::Unit;
+
+constexpr usize iterations = 50;
+
+/**
+ * Returns the error of an approximation in units in the last place of the
+ * exact result, rounded to the element type. Exact results beyond the range
+ * of the element type must be approximated by infinity.
+ */
+template <typename E>
+long double
+ulp_error(E approx, long double exact)
+{
+	if (isnan(exact) || isinf((E) exact))
+	{
+		return (isnan(approx) && isnan(exact)) || approx == (E) exact
+			? 0 : INFINITY;
+	}
+
+	// The ULP of subnormal numbers is the ULP of the smallest normal
+	// number.
+
+	int min_exponent = sizeof(E) == 4 ? -126 : -1022;
+	int mantissa_bits = sizeof(E) == 4 ? 23 : 52;
+	int exponent = exact == 0 || ilogbl(exact) < min_exponent
+		? min_exponent : ilogbl(exact);
+
+	return fabsl((long double) approx - exact)
+		/ ldexpl(1, exponent - mantissa_bits);
+}
+
+/**
+ * Returns the error of an approximation in a given unit. Relative errors
+ * turn absolute for exact results below 1e-3.
+ */
+template <typename E>
+long double
+float_error(E approx, long double exact, Unit unit)
+{
+	if (unit == Unit::Ulp || isnan(exact) || isinf((E) exact))
+	{
+		return ulp_error(approx, exact);
+	}
+
+	long double difference = fabsl(approx - exact);
+	return unit == Unit::Absolute || fabsl(exact) < 1e-3 ? difference
+		: difference / fabsl(exact);
+}
+
+/**
+ * Returns the exact result of a floating point function, to long double
+ * precision.
+ */
+long double
+float_reference(const char *function, long double x, long double y)
+{
+	struct Reference
+	{
+		const char *function;
+		long double (*f)(long double x, long double y);
+	};
+
+	static const Reference references[] = {
+		{ "exp", [](long double x, long double) { return expl(x); } },
+		{ "expm1", [](long double x, long double) { return expm1l(x); } },
+		{ "ln", [](long double x, long double) { return logl(x); } },
+		{ "ln1p", [](long double x, long double) { return log1pl(x); } },
+		{ "log2", [](long double x, long double) { return log2l(x); } },
+		{ "log10", [](long double x, long double) { return log10l(x); } },
+		{ "sqrt", [](long double x, long double) { return sqrtl(x); } },
+		{ "cbrt", [](long double x, long double) { return cbrtl(x); } },
+		{ "sin", [](long double x, long double) { return sinl(x); } },
+		{ "cos", [](long double x, long double) { return cosl(x); } },
+		{ "tan", [](long double x, long double) { return tanl(x); } },
+		{ "asin", [](long double x, long double) { return asinl(x); } },
+		{ "acos", [](long double x, long double) { return acosl(x); } },
+		{ "atan", [](long double x, long double) { return atanl(x); } },
+		{ "sinh", [](long double x, long double) { return sinhl(x); } },
+		{ "cosh", [](long double x, long double) { return coshl(x); } },
+		{ "tanh", [](long double x, long double) { return tanhl(x); } },
+		{ "asinh", [](long double x, long double) { return asinhl(x); } },
+		{ "acosh", [](long double x, long double) { return acoshl(x); } },
+		{ "atanh", [](long double x, long double) { return atanhl(x); } },
+		{ "pow", [](long double x, long double y) { return powl(x, y); } },
+		{ "atan2",
+			[](long double x, long double y) { return atan2l(x, y); } },
+		{ "hypot",
+			[](long double x, long double y) { return hypotl(x, y); } },
+		{ "floor", [](long double x, long double) { return floorl(x); } },
+		{ "ceil", [](long double x, long double) { return ceill(x); } },
+		{ "round",
+			[](long double x, long double) { return floorl(x + 0.5L); } },
+		{ "trunc", [](long double x, long double) { return truncl(x); } },
+		{ "rcp", [](long double x, long double) { return 1 / x; } },
+		{ "rsqrt",
+			[](long double x, long double) { return 1 / sqrtl(x); } }
+	};
+
+	for (const Reference &reference : references)
+	{
+		if (strcmp(reference.function, function) == 0)
+		{
+			return reference.f(x, y);
+		}
+	}
+
+	printf("FAIL: no reference for %s\n", function);
+	exit(1);
+}
+
+/**
+ * Returns the exact result of an integer function.
+ */
+u64
+integer_reference(const char *function, u64 x, u64 y)
+{
+	u64 result = 0;
+
+	if (strcmp(function, "gcd") == 0)
+	{
+		while (y != 0)
+		{
+			u64 remainder = x % y;
+			x = y;
+			y = remainder;
+		}
+
+		return x;
+	}
+
+	u64 base = strcmp(function, "log2i") == 0 ? 2 : 10;
+
+	while (x >= base)
+	{
+		x /= base;
+		result++;
+	}
+
+	return result;
+}
+
+/**
+ * Returns the maximum error of a case's outputs.
+ */
+template <typename E>
+long double
+max_error(const Case &c, const E *x, const E *y, const E *out, usize n)
+{
+	long double max = 0;
+
+	for (usize i = 0; i < n; i++)
+	{
+		long double error = 0;
+
+		if constexpr (!slaw::is_float<E>())
+		{
+			u64 exact = integer_reference(c.function, x[i], y[i]);
+			error = exact > out[i] ? exact - out[i] : out[i] - exact;
+		}
+		else
+		{
+			long double exact = float_reference(c.function, x[i], y[i]);
+			error = float_error(out[i], exact, c.unit);
+		}
+
+		if (!(error <= max))
+		{
+			max = error;
+		}
+	}
+
+	return max;
+}
+
+/**
+ * Measures one case over one input distribution, and prints its CSV line.
+ */
+void
+measure(const Case &c, bool dense, u8 *x, u8 *y, u8 *out)
+{
+	constexpr usize n = math_bench::sample_count;
+
+	math_bench::fill_inputs(c, dense, x, y, n);
+	c.run(x, y, out, n);
+
+	long double error = 0;
+	bool single = math_bench::element_size(c) == 4;
+
+	if (math_bench::is_integer(c))
+	{
+		error = single
+			? max_error(c, (u32 *) x, (u32 *) y, (u32 *) out, n)
+			: max_error(c, (u64 *) x, (u64 *) y, (u64 *) out, n);
+	}
+	else
+	{
+		error = single
+			? max_error(c, (f32 *) x, (f32 *) y, (f32 *) out, n)
+			: max_error(c, (f64 *) x, (f64 *) y, (f64 *) out, n);
+	}
+
+	u64 checksum = math_bench::checksum(c, out, n);
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		c.run(x, y, out, n);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double>(end - start).count() * 1e9
+		/ (iterations * n);
+	const char *unit = c.unit == Unit::Ulp ? "ulp"
+		: c.unit == Unit::Relative ? "relative" : "absolute";
+
+	printf("native,%s,%s,%s,%s,%u,%.4Lg,%s,%.3f,%s,%016llx\n",
+		c.function, c.type, c.variant, dense ? "dense" : "random", n,
+		error, unit, ns, math_bench::is_integer(c) ? "exact" : "long_double",
+		(unsigned long long) checksum);
+}
+
+int
+main()
+{
+	constexpr usize size = math_bench::sample_count * sizeof(f64);
+	alignas(16) static u8 x[size];
+	alignas(16) static u8 y[size];
+	alignas(16) static u8 out[size];
+
+	printf("build,function,type,variant,inputs,samples,max_error,unit,"
+		"ns_per_call,reference,checksum\n");
+
+	for (const Case &c : math_bench::cases)
+	{
+		measure(c, true, x, y, out);
+		measure(c, false, x, y, out);
+	}
+}
@@ -0,0 +1,443 @@
+#include "../types.hpp"
+#include "../math.hpp"
+#include "../simd_math.hpp"
+#include "../math_table.hpp"
+
+// The functions measured by the math benchmark, shared by its native build,
+// `math_bench.cpp`, and its WASM build, `math_bench_wasm.cpp`. Both builds
+// generate the same inputs, so the checksums of their outputs show whether
+// they compute the same results.
+
+namespace math_bench
+{
+// The number of inputs each function is measured over, per distribution.
+constexpr usize sample_count = 1 << 16;
+
+// How the error of a function is measured: in units in the last place of
+// the exact result, relative to it, for the fast tier of the vector
+// functions and the table-based functions, or as the absolute difference
+// from it, for functions with integer results. Relative errors turn
+// absolute for exact results below 1e-3, where they stop being meaningful
+// for the fast approximations.
+enum class Unit
+{
+	Ulp,
+	Relative,
+	Absolute
+};
+
+/**
+ * A function to measure, with the ranges of its inputs. `run` applies the
+ * function to `n` elements of the input arrays. Integer functions ignore
+ * the ranges: their dense inputs count up from 1, and their random inputs
+ * have uniformly distributed bit lengths.
+ */
+struct Case
+{
+	const char *function;
+	const char *type;
+	const char *variant;
+	Unit unit;
+	usize arity;
+	f64 low;
+	f64 high;
+	bool log_scale;
+	f64 y_low;
+	f64 y_high;
+	void (*run)(const void *x, const void *y, void *out, usize n);
+};
+
+/**
+ * Returns the size of an element of a case's type.
+ */
+inline usize
+element_size(const Case &c)
+{
+	return c.type[1] == '3' ? 4 : 8;
+}
+
+/**
+ * Returns whether a case's type is an integer type.
+ */
+inline bool
+is_integer(const Case &c)
+{
+	return c.type[0] == 'u';
+}
+
+/**
+ * Applies a scalar function to `n` elements of the input arrays.
+ */
+template <typename E, typename F>
+void
+apply_scalar(F f, const void *x, const void *y, void *out, usize n)
+{
+	const E *a = (const E *) x;
+	const E *b = (const E *) y;
+	E *result = (E *) out;
+
+	for (usize i = 0; i < n; i++)
+	{
+		result[i] = f(a[i], b[i]);
+	}
+}
+
+/**
+ * Applies a vector function to `n` elements of the input arrays, where `n`
+ * is a multiple of the number of lanes.
+ */
+template <typename E, typename F>
+void
+apply_simd(F f, const void *x, const void *y, void *out, usize n)
+{
+	using T = slaw::simd::simd_vector_of<E>;
+	const E *a = (const E *) x;
+	const E *b = (const E *) y;
+	E *result = (E *) out;
+
+	for (usize i = 0; i < n; i += 16 / sizeof(E))
+	{
+		slaw::simd::store(result + i, f(slaw::simd::load<T>(a + i),
+			slaw::simd::load<T>(b + i)));
+	}
+}
+
+// A scalar function of one argument, `x`, over [low, high], in a given
+// variant.
+#define MATH_BENCH_VARIANT_1(name, E, variant, unit, low, high, log_scale, \
+	call) \
+	{ #name, #E, variant, unit, 1, low, high, log_scale, 0, 0, \
+		[](const void *a, const void *b, void *out, usize n) \
+		{ apply_scalar<E>([](E x, E) { return (E) (call); }, a, b, out, \
+			n); } }
+
+// A scalar function of one argument, `x`.
+#define MATH_BENCH_SCALAR_1(name, E, unit, low, high, log_scale, call) \
+	MATH_BENCH_VARIANT_1(name, E, "scalar", unit, low, high, log_scale, \
+		call)
+
+// A table-based scalar function of one argument, `x`.
+#define MATH_BENCH_TABLE_1(name, E, low, high, call) \
+	MATH_BENCH_VARIANT_1(name, E, "table", Unit::Relative, low, high, \
+		false, call)
+
+// A scalar function of two arguments, `x` and `y`.
+#define MATH_BENCH_SCALAR_2(name, E, unit, low, high, log_scale, y_low, \
+	y_high, call) \
+	{ #name, #E, "scalar", unit, 2, low, high, log_scale, y_low, \
+		y_high, [](const void *a, const void *b, void *out, usize n) \
+		{ apply_scalar<E>([](E x, E y) { return (E) (call); }, a, b, out, \
+			n); } }
+
+// A vector function of one argument, `x`, of a given precision tier.
+#define MATH_BENCH_SIMD_1(name, E, variant, unit, low, high, log_scale, call) \
+	{ #name, #E, variant, unit, 1, low, high, log_scale, 0, 0, \
+		[](const void *a, const void *b, void *out, usize n) \
+		{ using T = slaw::simd::simd_vector_of<E>; \
+		apply_simd<E>([](T x, T) { return call; }, a, b, out, n); } }
+
+// A vector function of two arguments, `x` and `y`.
+#define MATH_BENCH_SIMD_2(name, E, variant, unit, low, high, log_scale, \
+	y_low, y_high, call) \
+	{ #name, #E, variant, unit, 2, low, high, log_scale, y_low, \
+		y_high, [](const void *a, const void *b, void *out, usize n) \
+		{ using T = slaw::simd::simd_vector_of<E>; \
+		apply_simd<E>([](T x, T y) { return call; }, a, b, out, n); } }
+
+// The scalar functions of one argument, for one floating point type.
+#define MATH_BENCH_SCALAR_FLOAT(E, exp_low, exp_high, log_range, trig_range, \
+	hyperbolic_range) \
+	MATH_BENCH_SCALAR_1(exp, E, Unit::Ulp, exp_low, exp_high, false, \
+		slaw::exp(x)), \
+	MATH_BENCH_SCALAR_1(expm1, E, Unit::Ulp, -40, exp_high, false, \
+		slaw::expm1(x)), \
+	MATH_BENCH_SCALAR_1(ln, E, Unit::Ulp, 1 / log_range, log_range, true, \
+		slaw::ln(x)), \
+	MATH_BENCH_SCALAR_1(ln1p, E, Unit::Ulp, -0.9, 10, false, \
+		slaw::ln1p(x)), \
+	MATH_BENCH_SCALAR_1(log2, E, Unit::Ulp, 1 / log_range, log_range, \
+		true, slaw::log2(x)), \
+	MATH_BENCH_SCALAR_1(log10, E, Unit::Ulp, 1 / log_range, log_range, \
+		true, slaw::log10(x)), \
+	MATH_BENCH_SCALAR_1(sqrt, E, Unit::Ulp, 1 / log_range, log_range, \
+		true, slaw::sqrt(x)), \
+	MATH_BENCH_SCALAR_1(cbrt, E, Unit::Ulp, -1e3, 1e3, false, \
+		slaw::cbrt(x)), \
+	MATH_BENCH_SCALAR_1(sin, E, Unit::Ulp, -trig_range, trig_range, false, \
+		slaw::sin(x)), \
+	MATH_BENCH_SCALAR_1(cos, E, Unit::Ulp, -trig_range, trig_range, false, \
+		slaw::cos(x)), \
+	MATH_BENCH_SCALAR_1(tan, E, Unit::Ulp, -trig_range, trig_range, false, \
+		slaw::tan(x)), \
+	MATH_BENCH_SCALAR_1(asin, E, Unit::Ulp, -1, 1, false, slaw::asin(x)), \
+	MATH_BENCH_SCALAR_1(acos, E, Unit::Ulp, -1, 1, false, slaw::acos(x)), \
+	MATH_BENCH_SCALAR_1(atan, E, Unit::Ulp, -1e3, 1e3, false, \
+		slaw::atan(x)), \
+	MATH_BENCH_SCALAR_1(sinh, E, Unit::Ulp, -hyperbolic_range, \
+		hyperbolic_range, false, slaw::sinh(x)), \
+	MATH_BENCH_SCALAR_1(cosh, E, Unit::Ulp, -hyperbolic_range, \
+		hyperbolic_range, false, slaw::cosh(x)), \
+	MATH_BENCH_SCALAR_1(tanh, E, Unit::Ulp, -20, 20, false, \
+		slaw::tanh(x)), \
+	MATH_BENCH_SCALAR_1(asinh, E, Unit::Ulp, -1e3, 1e3, false, \
+		slaw::asinh(x)), \
+	MATH_BENCH_SCALAR_1(acosh, E, Unit::Ulp, 1, 1e6, true, \
+		slaw::acosh(x)), \
+	MATH_BENCH_SCALAR_1(atanh, E, Unit::Ulp, -1, 1, false, \
+		slaw::atanh(x)), \
+	MATH_BENCH_SCALAR_2(pow, E, Unit::Ulp, 1e-3, 1e3, true, -10, 10, \
+		slaw::pow(x, y)), \
+	MATH_BENCH_SCALAR_2(atan2, E, Unit::Ulp, -1e3, 1e3, false, -1e3, 1e3, \
+		slaw::atan2(x, y)), \
+	MATH_BENCH_SCALAR_2(hypot, E, Unit::Ulp, -1e3, 1e3, false, -1e3, 1e3, \
+		slaw::hypot(x, y)), \
+	MATH_BENCH_SCALAR_1(floor, E, Unit::Absolute, -1e6, 1e6, false, \
+		slaw::floor(x)), \
+	MATH_BENCH_SCALAR_1(ceil, E, Unit::Absolute, -1e6, 1e6, false, \
+		slaw::ceil(x)), \
+	MATH_BENCH_SCALAR_1(round, E, Unit::Absolute, -1e6, 1e6, false, \
+		slaw::round(x)), \
+	MATH_BENCH_SCALAR_1(trunc, E, Unit::Absolute, -1e6, 1e6, false, \
+		slaw::trunc(x))
+
+// The table-based functions of math_table.hpp, for one floating point type.
+#define MATH_BENCH_TABLE(E, exp_low, exp_high, trig_range) \
+	MATH_BENCH_TABLE_1(exp, E, exp_low, exp_high, slaw::fast_exp(x)), \
+	MATH_BENCH_TABLE_1(sin, E, -trig_range, trig_range, slaw::fast_sin(x)), \
+	MATH_BENCH_TABLE_1(cos, E, -trig_range, trig_range, slaw::fast_cos(x))
+
+// The reciprocal approximations, in both tiers, next to the division and
+// square root they replace, for one floating point type.
+#define MATH_BENCH_RECIPROCAL(E, range) \
+	MATH_BENCH_VARIANT_1(rcp, E, "division", Unit::Ulp, 1 / range, range, \
+		true, 1 / x), \
+	MATH_BENCH_VARIANT_1(rcp, E, "scalar", Unit::Ulp, 1 / range, range, \
+		true, slaw::rcp(x)), \
+	MATH_BENCH_VARIANT_1(rcp, E, "scalar_fast", Unit::Relative, 1 / range, \
+		range, true, slaw::rcp<Precision::Fast>(x)), \
+	MATH_BENCH_SIMD_1(rcp, E, "simd_division", Unit::Ulp, 1 / range, range, \
+		true, (E) 1 / x), \
+	MATH_BENCH_SIMD_1(rcp, E, "simd", Unit::Ulp, 1 / range, range, true, \
+		slaw::simd::rcp(x)), \
+	MATH_BENCH_SIMD_1(rcp, E, "simd_fast", Unit::Relative, 1 / range, \
+		range, true, slaw::simd::rcp<Precision::Fast>(x)), \
+	MATH_BENCH_VARIANT_1(rsqrt, E, "division", Unit::Ulp, 1 / range, range, \
+		true, 1 / slaw::sqrt(x)), \
+	MATH_BENCH_VARIANT_1(rsqrt, E, "scalar", Unit::Ulp, 1 / range, range, \
+		true, slaw::rsqrt(x)), \
+	MATH_BENCH_VARIANT_1(rsqrt, E, "scalar_fast", Unit::Relative, \
+		1 / range, range, true, slaw::rsqrt<Precision::Fast>(x)), \
+	MATH_BENCH_SIMD_1(rsqrt, E, "simd_division", Unit::Ulp, 1 / range, \
+		range, true, (E) 1 / slaw::simd::sqrt(x)), \
+	MATH_BENCH_SIMD_1(rsqrt, E, "simd", Unit::Ulp, 1 / range, range, true, \
+		slaw::simd::rsqrt(x)), \
+	MATH_BENCH_SIMD_1(rsqrt, E, "simd_fast", Unit::Relative, 1 / range, \
+		range, true, slaw::simd::rsqrt<Precision::Fast>(x))
+
+// The vector transcendental functions of one precision tier, for one
+// floating point type.
+#define MATH_BENCH_SIMD_TIER(E, variant, P, unit, exp_low, exp_high, \
+	log_range, trig_range) \
+	MATH_BENCH_SIMD_1(exp, E, variant, unit, exp_low, exp_high, \
+		false, slaw::simd::exp<P>(x)), \
+	MATH_BENCH_SIMD_1(ln, E, variant, unit, 1 / log_range, log_range, \
+		true, slaw::simd::ln<P>(x)), \
+	MATH_BENCH_SIMD_1(sin, E, variant, unit, -trig_range, trig_range, \
+		false, slaw::simd::sin<P>(x)), \
+	MATH_BENCH_SIMD_1(cos, E, variant, unit, -trig_range, trig_range, \
+		false, slaw::simd::cos<P>(x)), \
+	MATH_BENCH_SIMD_1(tan, E, variant, unit, -trig_range, trig_range, \
+		false, slaw::simd::tan<P>(x)), \
+	MATH_BENCH_SIMD_1(atan, E, variant, unit, -1e3, 1e3, false, \
+		slaw::simd::atan<P>(x)), \
+	MATH_BENCH_SIMD_2(pow, E, variant, unit, 1e-3, 1e3, true, -10, 10, \
+		slaw::simd::pow<P>(x, y)), \
+	MATH_BENCH_SIMD_2(atan2, E, variant, unit, -1e3, 1e3, false, -1e3, 1e3, \
+		slaw::simd::atan2<P>(x, y))
+
+// The exact vector functions, for one floating point type.
+#define MATH_BENCH_SIMD_EXACT(E, log_range) \
+	MATH_BENCH_SIMD_1(sqrt, E, "simd", Unit::Ulp, 1 / log_range, \
+		log_range, true, slaw::simd::sqrt(x)), \
+	MATH_BENCH_SIMD_1(floor, E, "simd", Unit::Absolute, -1e6, 1e6, false, \
+		slaw::simd::floor(x)), \
+	MATH_BENCH_SIMD_1(ceil, E, "simd", Unit::Absolute, -1e6, 1e6, false, \
+		slaw::simd::ceil(x)), \
+	MATH_BENCH_SIMD_1(round, E, "simd", Unit::Absolute, -1e6, 1e6, false, \
+		slaw::simd::round(x))
+
+// The integer functions, for one integer type.
+#define MATH_BENCH_INTEGER(E) \
+	MATH_BENCH_SCALAR_2(gcd, E, Unit::Absolute, 0, 0, false, 0, 0, \
+		slaw::gcd(x, y)), \
+	MATH_BENCH_SCALAR_1(log2i, E, Unit::Absolute, 0, 0, false, \
+		slaw::log2i(x)), \
+	MATH_BENCH_SCALAR_1(log10i, E, Unit::Absolute, 0, 0, false, \
+		slaw::log10i(x))
+
+using slaw::Precision;
+
+const Case cases[] = {
+	MATH_BENCH_SCALAR_FLOAT(f32, -104, 89, 1e30, 8192, 89),
+	MATH_BENCH_SCALAR_FLOAT(f64, -745, 709, 1e300, 1e6, 709),
+	MATH_BENCH_TABLE(f32, -87, 88, 8192),
+	MATH_BENCH_TABLE(f64, -708, 709, 1e6),
+	MATH_BENCH_SIMD_TIER(f32, "simd", Precision::Full, Unit::Ulp, -104, 89,
+		1e30, 8192),
+	MATH_BENCH_SIMD_TIER(f64, "simd", Precision::Full, Unit::Ulp, -745, 709,
+		1e300, 1e6),
+	MATH_BENCH_SIMD_TIER(f32, "simd_fast", Precision::Fast, Unit::Relative,
+		-87, 88, 1e30, 8192),
+	MATH_BENCH_SIMD_TIER(f64, "simd_fast", Precision::Fast, Unit::Relative,
+		-708, 709, 1e300, 1e6),
+	MATH_BENCH_SIMD_EXACT(f32, 1e30),
+	MATH_BENCH_SIMD_EXACT(f64, 1e300),
+	MATH_BENCH_RECIPROCAL(f32, 1e30),
+	MATH_BENCH_RECIPROCAL(f64, 1e300),
+	MATH_BENCH_INTEGER(u32),
+	MATH_BENCH_INTEGER(u64)
+};
+
+constexpr usize case_count = sizeof(cases) / sizeof(Case);
+
+/**
+ * Returns the next number of a xorshift generator, which gives both builds
+ * the same random inputs.
+ */
+inline u64
+next_random(u64 &state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+/**
+ * Returns the `i`-th of `n` inputs in [low, high]: evenly spaced if `dense`
+ * is set, random otherwise. Log scale inputs are evenly spaced or uniformly
+ * distributed in their logarithm.
+ */
+inline f64
+float_input(f64 low, f64 high, bool log_scale, bool dense, usize i, usize n,
+	u64 &state)
+{
+	f64 t = dense ? (f64) i / (n - 1)
+		: (f64) (next_random(state) >> 11) * 0x1p-53;
+
+	if (log_scale)
+	{
+		f64 ln_low = slaw::ln(low);
+		return slaw::exp(ln_low + (slaw::ln(high) - ln_low) * t);
+	}
+
+	return low + (high - low) * t;
+}
+
+/**
+ * Returns the `i`-th integer input of a given bit width: counting up from
+ * 1 if `dense` is set, random with a uniformly distributed bit length
+ * otherwise.
+ */
+inline u64
+integer_input(usize bits, bool dense, usize i, u64 &state)
+{
+	if (dense)
+	{
+		return i + 1;
+	}
+
+	u64 value = next_random(state) >> (64 - bits);
+	value >>= next_random(state) % bits;
+	return value == 0 ? 1 : value;
+}
+
+/**
+ * Fills the input arrays of a case with `n` inputs. The second argument of
+ * dense two-argument functions runs through its range in a different order,
+ * so the pairs cover the plane.
+ */
+inline void
+fill_inputs(const Case &c, bool dense, void *x, void *y, usize n)
+{
+	u64 state = 0x9E3779B97F4A7C15;
+	bool single = element_size(c) == 4;
+
+	for (usize i = 0; i < n; i++)
+	{
+		usize j = dense ? i * 7919 % n : i;
+
+		if (is_integer(c))
+		{
+			u64 a = integer_input(single ? 32 : 64, dense, i, state);
+			u64 b = integer_input(single ? 32 : 64, dense, j * 3 + 1,
+				state);
+
+			if (single)
+			{
+				((u32 *) x)[i] = (u32) a;
+				((u32 *) y)[i] = (u32) b;
+			}
+			else
+			{
+				((u64 *) x)[i] = a;
+				((u64 *) y)[i] = b;
+			}
+
+			continue;
+		}
+
+		f64 a = float_input(c.low, c.high, c.log_scale, dense, i, n, state);
+		f64 b = c.arity == 1 ? 0 : float_input(c.y_low, c.y_high, false,
+			dense, j, n, state);
+
+		if (single)
+		{
+			((f32 *) x)[i] = (f32) a;
+			((f32 *) y)[i] = (f32) b;
+		}
+		else
+		{
+			((f64 *) x)[i] = a;
+			((f64 *) y)[i] = b;
+		}
+	}
+}
+
+/**
+ * Returns an FNV-1a hash of the outputs of a case. NaNs are hashed as one
+ * value, because their sign and payload differ between platforms.
+ */
+inline u64
+checksum(const Case &c, const void *out, usize n)
+{
+	u64 hash = 0xCBF29CE484222325;
+	usize size = element_size(c);
+
+	for (usize i = 0; i < n; i++)
+	{
+		u64 bits = 0;
+
+		if (size == 4)
+		{
+			u32 element = ((const u32 *) out)[i];
+			bool nan = !is_integer(c) && (element & 0x7FFFFFFF) > 0x7F800000;
+			bits = nan ? 0x7FC00000 : element;
+		}
+		else
+		{
+			bits = ((const u64 *) out)[i];
+			bool nan = !is_integer(c)
+				&& (bits & 0x7FFFFFFFFFFFFFFF) > 0x7FF0000000000000;
+			bits = nan ? 0x7FF8000000000000 : bits;
+		}
+
+		for (usize byte = 0; byte < size; byte++)
+		{
+			hash = (hash ^ (bits >> byte * 8 & 0xFF)) * 0x100000001B3;
+		}
+	}
+
+	return hash;
+}
+}; // namespace math_bench
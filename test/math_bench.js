@@ -0,0 +1,199 @@
+// Runs the math benchmark of `math_bench_wasm.cpp` in node: the maximum
+// error of every function against JS Math, and the time per call. Prints
+// the same CSV lines as the native build, `math_bench.cpp`, whose
+// checksums show whether both builds compute the same results. JS Math is
+// a double precision reference, so the errors of double precision functions
+// are only measured to about 1 ULP; the native build measures them exactly.
+// Build and run with `make math_bench_wasm`.
+
+const fs = require('fs')
+const path = require('path')
+
+const SlawEnvironment = new Function(fs.readFileSync(
+	path.join(__dirname, '../slaw.js'), 'utf8') + '\nreturn SlawEnvironment')()
+
+const iterations = 50
+
+// The units of math_bench::Unit, in order.
+const units = ['ulp', 'relative', 'absolute']
+
+const bits = new Float64Array(1)
+const bitsHigh = new Uint32Array(bits.buffer, 4, 1)
+
+// Returns the size of the unit in the last place of a number, for a given
+// number of mantissa bits and minimum exponent.
+const ulp = (x, mantissaBits, minExponent) =>
+{
+	bits[0] = x
+	const exponent = Math.max(((bitsHigh[0] >>> 20) & 0x7FF) - 1023,
+		minExponent)
+
+	return Math.pow(2, exponent - mantissaBits)
+}
+
+// Returns the error of an approximation in a given unit, against the result
+// of JS Math, rounded to single or double precision. Relative errors turn
+// absolute for exact results below 1e-3.
+const floatError = (approx, exact, single, unit) =>
+{
+	const rounded = single ? Math.fround(exact) : exact
+
+	if (Number.isNaN(exact) || !Number.isFinite(rounded))
+	{
+		return Object.is(approx, rounded)
+			|| (Number.isNaN(approx) && Number.isNaN(exact)) ? 0 : Infinity
+	}
+
+	const difference = Math.abs(approx - exact)
+
+	if (unit === 'ulp')
+	{
+		return difference / (single
+			? ulp(exact, 23, -126) : ulp(exact, 52, -1022))
+	}
+
+	return unit === 'absolute' || Math.abs(exact) < 1e-3 ? difference
+		: difference / Math.abs(exact)
+}
+
+const floatReferences = {
+	exp: Math.exp,
+	expm1: Math.expm1,
+	ln: Math.log,
+	ln1p: Math.log1p,
+	log2: Math.log2,
+	log10: Math.log10,
+	sqrt: Math.sqrt,
+	cbrt: Math.cbrt,
+	sin: Math.sin,
+	cos: Math.cos,
+	tan: Math.tan,
+	asin: Math.asin,
+	acos: Math.acos,
+	atan: Math.atan,
+	sinh: Math.sinh,
+	cosh: Math.cosh,
+	tanh: Math.tanh,
+	asinh: Math.asinh,
+	acosh: Math.acosh,
+	atanh: Math.atanh,
+	pow: Math.pow,
+	atan2: Math.atan2,
+	hypot: Math.hypot,
+	floor: Math.floor,
+	ceil: Math.ceil,
+	round: Math.round,
+	trunc: Math.trunc,
+	rcp: (x) => 1 / x,
+	rsqrt: (x) => 1 / Math.sqrt(x)
+}
+
+// The integer references work on BigInts, which hold both u32 and u64
+// elements.
+const integerReferences = {
+	gcd: (x, y) =>
+	{
+		while (y !== 0n)
+		{
+			[x, y] = [y, x % y]
+		}
+
+		return x
+	},
+	log2i: (x) => BigInt(x.toString(2).length - 1),
+	log10i: (x) => BigInt(x.toString().length - 1)
+}
+
+// Returns the time per call of a function over n elements, in nanoseconds.
+const time = (f, n) =>
+{
+	f()
+	const start = performance.now()
+
+	for (let i = 0; i < iterations; i++)
+	{
+		f()
+	}
+
+	return (performance.now() - start) * 1e6 / (iterations * n)
+}
+
+const main = async () =>
+{
+	const data = fs.readFileSync(path.join(__dirname, 'math_bench.wasm'))
+	const wasm = await WebAssembly.instantiate(data, {
+		env: new SlawEnvironment(() => wasm).env
+	})
+
+	const exports = wasm.instance.exports
+	const n = exports.buffer_size()
+	const buffer = () => exports.memory.buffer
+
+	// Reads a NUL-terminated string from WASM memory.
+	const string = (pointer) =>
+	{
+		const bytes = new Uint8Array(buffer(), pointer)
+		return new TextDecoder().decode(bytes.subarray(0, bytes.indexOf(0)))
+	}
+
+	console.log('build,function,type,variant,inputs,samples,max_error,unit,'
+		+ 'ns_per_call,reference,checksum')
+
+	for (let c = 0; c < exports.case_count(); c++)
+	{
+		const fn = string(exports.case_function(c))
+		const type = string(exports.case_type(c))
+		const variant = string(exports.case_variant(c))
+		const unit = units[exports.case_unit(c)]
+		const integer = type[0] === 'u'
+		const single = type[1] === '3'
+		const Array = integer ? (single ? Uint32Array : BigUint64Array)
+			: (single ? Float32Array : Float64Array)
+
+		for (const dense of [true, false])
+		{
+			exports.prepare(c, dense, n)
+			exports.run(c, n)
+
+			const x = new Array(buffer(), exports.buffer_x(), n)
+			const y = new Array(buffer(), exports.buffer_y(), n)
+			const out = new Array(buffer(), exports.buffer_out(), n)
+			let maxError = 0
+
+			for (let i = 0; i < n; i++)
+			{
+				let error = 0
+
+				if (integer)
+				{
+					const exact = integerReferences[fn](BigInt(x[i]),
+						BigInt(y[i]))
+					const approx = BigInt(out[i])
+					error = Number(exact > approx ? exact - approx
+						: approx - exact)
+				}
+				else
+				{
+					const exact = floatReferences[fn](x[i], y[i])
+					error = floatError(out[i], exact, single, unit)
+				}
+
+				if (!(error <= maxError))
+				{
+					maxError = error
+				}
+			}
+
+			const checksum = BigInt.asUintN(64, exports.checksum(c, n))
+			const ns = time(() => exports.run(c, n), n)
+			const reference = integer ? 'exact' : 'js_math'
+
+			console.log(['wasm', fn, type, variant,
+				dense ? 'dense' : 'random', n, maxError.toPrecision(4),
+				unit, ns.toFixed(3), reference,
+				checksum.toString(16).padStart(16, '0')].join(','))
+		}
+	}
+}
+
+main()
@@ -0,0 +1,59 @@
+#include "../slaw.hpp"
+#include "math_bench.hpp"
+
+// The WASM side of the math benchmark, which is driven by `math_bench.js`.
+// The exports describe the cases of `math_bench.hpp`, fill the input
+// buffers with a case's inputs, and apply its function to them, so the
+// inputs and outputs match those of the native build, `math_bench.cpp`.
+// Build and run with `make math_bench_wasm`.
+
+using math_bench::cases;
+
+constexpr usize buffer_size = math_bench::sample_count;
+
+alignas(16) u8 buffer_x[buffer_size * sizeof(f64)];
+alignas(16) u8 buffer_y[buffer_size * sizeof(f64)];
+alignas(16) u8 buffer_out[buffer_size * sizeof(f64)];
+
+EXPORT("buffer_size") usize get_buffer_size() { return buffer_size; }
+EXPORT("buffer_x") u8 *get_buffer_x() { return buffer_x; }
+EXPORT("buffer_y") u8 *get_buffer_y() { return buffer_y; }
+EXPORT("buffer_out") u8 *get_buffer_out() { return buffer_out; }
+
+EXPORT("case_count") usize case_count() { return math_bench::case_count; }
+EXPORT("case_function") const char *case_function(usize i) { return cases[i].function; }
+EXPORT("case_type") const char *case_type(usize i) { return cases[i].type; }
+EXPORT("case_variant") const char *case_variant(usize i) { return cases[i].variant; }
+EXPORT("case_unit") usize case_unit(usize i) { return (usize) cases[i].unit; }
+
+/**
+ * Fills the input buffers with the first `n` dense or random inputs of a
+ * case.
+ */
+EXPORT("prepare")
+void
+prepare(usize i, bool dense, usize n)
+{
+	math_bench::fill_inputs(cases[i], dense, buffer_x, buffer_y, n);
+}
+
+/**
+ * Applies the function of a case to the first `n` elements of the input
+ * buffers.
+ */
+EXPORT("run")
+void
+run(usize i, usize n)
+{
+	cases[i].run(buffer_x, buffer_y, buffer_out, n);
+}
+
+/**
+ * Returns the checksum of the first `n` elements of the output buffer.
+ */
+EXPORT("checksum")
+u64
+checksum(usize i, usize n)
+{
+	return math_bench::checksum(cases[i], buffer_out, n);
+}
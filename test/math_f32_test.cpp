@@ -0,0 +1,335 @@
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../math.hpp"
+#include "check.hpp"
+
+// Measures the error of the f32 scalar math functions against a long double
+// reference, prints it as a table, and fails if any of them reaches 1 ULP.
+// Also compares their speed with the f64 versions they used to widen to.
+// Build natively with `make math_f32_test`.
+
+constexpr usize sample_count = 1 << 20;
+constexpr usize bench_size = 4096;
+constexpr usize iterations = 200;
+
+/**
+ * Returns the error of an f32 approximation in units in the last place of
+ * the exact result, rounded to an f32. Exact results beyond the range of an
+ * f32 must be approximated by infinity.
+ */
+long double
+ulp_error(f32 approx, long double exact)
+{
+	if (isnan(exact) || isinf((f32) exact))
+	{
+		return (isnan(approx) && isnan(exact)) || approx == (f32) exact
+			? 0 : INFINITY;
+	}
+
+	// The ULP of subnormal numbers is the ULP of the smallest normal
+	// number.
+
+	int exponent = exact == 0 || ilogbl(exact) < -126 ? -126
+		: ilogbl(exact);
+
+	return fabsl((long double) approx - exact) / ldexpl(1, exponent - 23);
+}
+
+/**
+ * A range of inputs: [low, high], or, if `any_magnitude` is set, all
+ * positive f32 values, and their negations when `low` is negative.
+ */
+struct Range
+{
+	long double low;
+	long double high;
+	bool any_magnitude;
+};
+
+/**
+ * Returns a random input from a range.
+ */
+f32
+random_in(Range range)
+{
+	if (range.any_magnitude)
+	{
+		u32 bits = ((u32) rand() << 16 ^ rand()) % 0x7F800000;
+		f32 value;
+		memcpy(&value, &bits, 4);
+		return range.low < 0 && rand() % 2 ? -value : value;
+	}
+
+	return range.low + (range.high - range.low)
+		* ((long double) rand() / RAND_MAX);
+}
+
+/**
+ * Measures the maximum error of an f32 function against a long double
+ * reference over random inputs, the share of correctly rounded results, and
+ * the time per call of the function and of its f64 version. Prints one line
+ * of the table, and returns the maximum error.
+ */
+template <typename F, typename Reference, typename Wide>
+long double
+measure(const char *name, const char *range_name, Range x_range,
+	Range y_range, F f, Reference reference, Wide wide)
+{
+	f32 *x = new f32[sample_count];
+	f32 *y = new f32[sample_count];
+	f32 *out = new f32[sample_count];
+
+	for (usize i = 0; i < sample_count; i++)
+	{
+		x[i] = random_in(x_range);
+		y[i] = random_in(y_range);
+		out[i] = f(x[i], y[i]);
+	}
+
+	long double max_error = 0;
+	usize correctly_rounded = 0;
+	f32 worst_x = 0;
+	f32 worst_y = 0;
+
+	for (usize i = 0; i < sample_count; i++)
+	{
+		long double exact = reference((long double) x[i],
+			(long double) y[i]);
+		long double error = ulp_error(out[i], exact);
+
+		correctly_rounded += out[i] == (f32) exact
+			|| (isnan(out[i]) && isnan(exact));
+
+		if (!(error <= max_error))
+		{
+			max_error = error;
+			worst_x = x[i];
+			worst_y = y[i];
+		}
+	}
+
+	f32 sink = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		for (usize j = 0; j < bench_size; j++)
+		{
+			out[j] = f(x[j], y[j]);
+		}
+
+		sink += out[i % bench_size];
+	}
+
+	auto middle = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		for (usize j = 0; j < bench_size; j++)
+		{
+			out[j] = wide(x[j], y[j]);
+		}
+
+		sink += out[i % bench_size];
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double f32_ns = std::chrono::duration<double>(middle - start).count()
+		* 1e9 / (iterations * bench_size);
+	double f64_ns = std::chrono::duration<double>(end - middle).count()
+		* 1e9 / (iterations * bench_size);
+
+	printf("%-6s %-12s %8.4Lf %8.4f%% %7.2f %7.2f   (x = %.9g, y = %.9g)%s\n",
+		name, range_name, max_error,
+		100.0 * correctly_rounded / sample_count, f32_ns, f64_ns,
+		(double) worst_x, (double) worst_y, sink == 12345 ? " " : "");
+
+	delete[] x;
+	delete[] y;
+	delete[] out;
+	return max_error;
+}
+
+// Measures a function of one argument.
+#define MEASURE_1(name, range_name, range, reference) \
+	max_error = fmaxl(max_error, measure(#name, range_name, range, none, \
+		[](f32 x, f32) { return slaw::name(x); }, \
+		[](long double x, long double) { return reference(x); }, \
+		[](f32 x, f32) { return (f32) slaw::name((f64) x); }))
+
+// Measures a function of two arguments.
+#define MEASURE_2(name, range_name, x_range, y_range, reference) \
+	max_error = fmaxl(max_error, measure(#name, range_name, x_range, \
+		y_range, [](f32 x, f32 y) { return slaw::name(x, y); }, \
+		[](long double x, long double y) { return reference(x, y); }, \
+		[](f32 x, f32 y) { return (f32) slaw::name((f64) x, (f64) y); }))
+
+/**
+ * Checks that the f32 functions agree with the f64 versions, rounded to
+ * f32, on special inputs: bit for bit where those return a zero, an
+ * infinity or a NaN, and within 1 ULP elsewhere.
+ */
+void
+test_special_values()
+{
+	f32 special[] = { 0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -2.0f, 3.0f, -3.0f,
+		INFINITY, -INFINITY, NAN, 1e-40f, -1e-40f, 1e30f, -1e30f };
+	constexpr usize count = sizeof(special) / sizeof(f32);
+
+	auto agrees = [](f32 result, f64 wide)
+	{
+		f32 expected = (f32) wide;
+
+		if (isnan(expected) || isinf(expected) || expected == 0)
+		{
+			return (isnan(result) && isnan(expected))
+				|| (result == expected
+				&& signbit(result) == signbit(expected));
+		}
+
+		return ulp_error(result, wide) < 1;
+	};
+
+	for (usize i = 0; i < count; i++)
+	{
+		f32 x = special[i];
+		f64 wide = x;
+
+		check(agrees(slaw::exp(x), slaw::exp(wide)), "exp special value");
+		check(agrees(slaw::expm1(x), slaw::expm1(wide)),
+			"expm1 special value");
+		check(agrees(slaw::ln(x), slaw::ln(wide)), "ln special value");
+		check(agrees(slaw::ln1p(x), slaw::ln1p(wide)),
+			"ln1p special value");
+		check(agrees(slaw::log2(x), slaw::log2(wide)),
+			"log2 special value");
+		check(agrees(slaw::log10(x), slaw::log10(wide)),
+			"log10 special value");
+		check(agrees(slaw::sin(x), slaw::sin(wide)), "sin special value");
+		check(agrees(slaw::cos(x), slaw::cos(wide)), "cos special value");
+		check(agrees(slaw::tan(x), slaw::tan(wide)), "tan special value");
+		check(agrees(slaw::asin(x), slaw::asin(wide)),
+			"asin special value");
+		check(agrees(slaw::acos(x), slaw::acos(wide)),
+			"acos special value");
+		check(agrees(slaw::atan(x), slaw::atan(wide)),
+			"atan special value");
+		check(agrees(slaw::sinh(x), slaw::sinh(wide)),
+			"sinh special value");
+		check(agrees(slaw::cosh(x), slaw::cosh(wide)),
+			"cosh special value");
+		check(agrees(slaw::tanh(x), slaw::tanh(wide)),
+			"tanh special value");
+		check(agrees(slaw::asinh(x), slaw::asinh(wide)),
+			"asinh special value");
+		check(agrees(slaw::acosh(x), slaw::acosh(wide)),
+			"acosh special value");
+		check(agrees(slaw::atanh(x), slaw::atanh(wide)),
+			"atanh special value");
+		check(agrees(slaw::cbrt(x), slaw::cbrt(wide)),
+			"cbrt special value");
+
+		for (usize j = 0; j < count; j++)
+		{
+			f32 y = special[j];
+
+			check(agrees(slaw::atan2(x, y), slaw::atan2(wide, (f64) y)),
+				"atan2 special value");
+			check(agrees(slaw::pow(x, y), slaw::pow(wide, (f64) y)),
+				"pow special value");
+			check(agrees(slaw::hypot(x, y), slaw::hypot(wide, (f64) y)),
+				"hypot special value");
+		}
+	}
+
+	// Powers of two and ten have exact logarithms.
+
+	for (i32 i = -149; i < 128; i++)
+	{
+		check(slaw::log2(ldexpf(1, i)) == i, "log2 of a power of two");
+	}
+
+	for (i32 i = 0; i <= 10; i++)
+	{
+		check(slaw::log10((f32) pow(10, i)) == i,
+			"log10 of a power of ten");
+	}
+}
+
+/**
+ * Returns x raised to the integer nearest to y.
+ */
+long double
+pow_integer(long double x, long double y)
+{
+	return powl(x, rintl(y));
+}
+
+int
+main()
+{
+	test_special_values();
+	printf("All checks passed.\n\n");
+
+	Range none = { 0, 0, false };
+	Range any = { 0, 0, true };
+	Range any_signed = { -1, 0, true };
+	long double max_error = 0;
+
+	printf("%-6s %-12s %8s %9s %7s %7s\n", "name", "range", "max ulp",
+		"rounded", "ns/f32", "ns/f64");
+
+	MEASURE_1(exp, "[-104, 89]", (Range { -104, 89, false }), expl);
+	MEASURE_1(exp, "[-1, 1]", (Range { -1, 1, false }), expl);
+	MEASURE_1(expm1, "[-20, 89]", (Range { -20, 89, false }), expm1l);
+	MEASURE_1(expm1, "[-1, 1]", (Range { -1, 1, false }), expm1l);
+	MEASURE_1(ln, "all", any, logl);
+	MEASURE_1(ln, "[0.5, 2]", (Range { 0.5, 2, false }), logl);
+	MEASURE_1(ln1p, "all", any_signed, log1pl);
+	MEASURE_1(ln1p, "[-1, 1]", (Range { -1, 1, false }), log1pl);
+	MEASURE_1(log2, "all", any, log2l);
+	MEASURE_1(log2, "[0.5, 2]", (Range { 0.5, 2, false }), log2l);
+	MEASURE_1(log10, "all", any, log10l);
+	MEASURE_1(log10, "[0.5, 2]", (Range { 0.5, 2, false }), log10l);
+	MEASURE_1(sin, "[-8192, 8192]", (Range { -8192, 8192, false }), sinl);
+	MEASURE_1(sin, "all", any_signed, sinl);
+	MEASURE_1(cos, "[-8192, 8192]", (Range { -8192, 8192, false }), cosl);
+	MEASURE_1(cos, "all", any_signed, cosl);
+	MEASURE_1(tan, "[-8192, 8192]", (Range { -8192, 8192, false }), tanl);
+	MEASURE_1(tan, "all", any_signed, tanl);
+	MEASURE_1(asin, "[-1, 1]", (Range { -1, 1, false }), asinl);
+	MEASURE_1(acos, "[-1, 1]", (Range { -1, 1, false }), acosl);
+	MEASURE_1(atan, "all", any_signed, atanl);
+	MEASURE_1(atan, "[-4, 4]", (Range { -4, 4, false }), atanl);
+	MEASURE_1(sinh, "[-90, 90]", (Range { -90, 90, false }), sinhl);
+	MEASURE_1(sinh, "[-1, 1]", (Range { -1, 1, false }), sinhl);
+	MEASURE_1(cosh, "[-90, 90]", (Range { -90, 90, false }), coshl);
+	MEASURE_1(tanh, "[-10, 10]", (Range { -10, 10, false }), tanhl);
+	MEASURE_1(asinh, "all", any_signed, asinhl);
+	MEASURE_1(asinh, "[-2, 2]", (Range { -2, 2, false }), asinhl);
+	MEASURE_1(acosh, "all", any, acoshl);
+	MEASURE_1(acosh, "[1, 2]", (Range { 1, 2, false }), acoshl);
+	MEASURE_1(atanh, "[-1, 1]", (Range { -1, 1, false }), atanhl);
+	MEASURE_1(cbrt, "all", any_signed, cbrtl);
+	MEASURE_2(atan2, "[-1e3, 1e3]", (Range { -1e3, 1e3, false }),
+		(Range { -1e3, 1e3, false }), atan2l);
+	MEASURE_2(atan2, "all", any_signed, any_signed, atan2l);
+	MEASURE_2(hypot, "all", any_signed, any_signed, hypotl);
+	MEASURE_2(pow, "[1e-3, 1e3]", (Range { 1e-3, 1e3, false }),
+		(Range { -10, 10, false }), powl);
+	MEASURE_2(pow, "[0.9, 1.1]", (Range { 0.9, 1.1, false }),
+		(Range { -800, 800, false }), powl);
+
+	// Negative bases need integer exponents.
+
+	max_error = fmaxl(max_error, measure("pow", "x < 0",
+		(Range { -10, -0.1, false }), (Range { -30, 30, false }),
+		[](f32 x, f32 y) { return slaw::pow(x, rintf(y)); }, pow_integer,
+		[](f32 x, f32 y) { return (f32) slaw::pow((f64) x, (f64) rintf(y)); }));
+
+	check(max_error < 1, "f32 functions are accurate to below 1 ULP");
+}
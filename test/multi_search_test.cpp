@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../multi_search.hpp"
+#include "check.hpp"
+
+// Checks `MultiSearcher` on both of its engines, the Teddy prefilter for up
+// to 8 patterns and the Aho-Corasick automaton for more, against a naive
+// search over random texts of small and large alphabets.
+// Build natively with `make multi_search_test`.
+
+using slaw::MultiSearcher;
+using slaw::String;
+using slaw::StringView;
+using slaw::Vector;
+
+/**
+ * Returns a string holding the given bytes.
+ */
+String
+bytes(const u8 *data, usize size)
+{
+	String s;
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back((char) data[i]);
+	}
+
+	return s;
+}
+
+/**
+ * Orders matches by start position, then by pattern index, for `qsort()`.
+ */
+int
+compare_matches(const void *a, const void *b)
+{
+	const MultiSearcher::Match *x = (const MultiSearcher::Match *) a;
+	const MultiSearcher::Match *y = (const MultiSearcher::Match *) b;
+
+	if (x->start != y->start)
+	{
+		return x->start < y->start ? -1 : 1;
+	}
+
+	return (x->pattern > y->pattern) - (x->pattern < y->pattern);
+}
+
+/**
+ * Finds all occurrences of the patterns by comparing every non-empty
+ * pattern at every position. A pattern that occurs more than once in the
+ * list is only reported for its first index.
+ */
+Vector<MultiSearcher::Match>
+naive_find_all(const Vector<String> &patterns, StringView text)
+{
+	Vector<MultiSearcher::Match> out;
+
+	for (usize i = 0; i < text.size; i++)
+	{
+		for (usize p = 0; p < patterns.size; p++)
+		{
+			const String &pattern = patterns[p];
+			bool first = true;
+
+			for (usize q = 0; q < p; q++)
+			{
+				first = first && !(patterns[q] == pattern);
+			}
+
+			if (first && pattern.size > 0
+				&& i + pattern.size <= text.size
+				&& memcmp(text.data + i, pattern.data,
+					pattern.size) == 0)
+			{
+				out.push_back({ p, i });
+			}
+		}
+	}
+
+	return out;
+}
+
+/**
+ * Searches a text with a `MultiSearcher` and naively, and checks that both
+ * find the same matches. The searcher may report them in another order.
+ */
+void
+check_search(const Vector<String> &patterns, StringView text,
+	const char *message)
+{
+	MultiSearcher searcher(patterns);
+	Vector<MultiSearcher::Match> found = searcher.find_all(text);
+	Vector<MultiSearcher::Match> expected = naive_find_all(patterns,
+		text);
+
+	check(searcher.use_teddy == (patterns.size <= 8), message);
+	check(found.size == expected.size, message);
+
+	qsort(found.data, found.size, sizeof(MultiSearcher::Match),
+		compare_matches);
+
+	for (usize i = 0; i < found.size; i++)
+	{
+		check(found[i].pattern == expected[i].pattern
+			&& found[i].start == expected[i].start, message);
+	}
+}
+
+/**
+ * Returns a random string of `min_size` to `max_size` characters from the
+ * first `alphabet` byte values starting at `first`.
+ */
+String
+random_string(usize min_size, usize max_size, usize alphabet, u8 first)
+{
+	String s;
+	usize size = min_size + rand() % (max_size - min_size + 1);
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back((char) (first + rand() % alphabet));
+	}
+
+	return s;
+}
+
+void
+test_random()
+{
+	// Pattern counts on both sides of the Teddy limit, over a two-letter
+	// alphabet, where patterns overlap and repeat a lot, and over all
+	// byte values. Text sizes cover the tail after the 16-byte blocks.
+
+	usize pattern_counts[] = { 1, 2, 3, 8, 9, 20, 100 };
+	usize alphabets[] = { 2, 4, 256 };
+
+	for (usize count : pattern_counts)
+	{
+		for (usize alphabet : alphabets)
+		{
+			u8 first = alphabet == 256 ? 0 : 'a';
+
+			for (usize round = 0; round < 20; round++)
+			{
+				Vector<String> patterns;
+
+				for (usize p = 0; p < count; p++)
+				{
+					patterns.push_back(random_string(1, 6, alphabet,
+						first));
+				}
+
+				String text = random_string(0, 300, alphabet, first);
+				check_search(patterns, text, "random search");
+			}
+		}
+	}
+}
+
+void
+test_edge_cases()
+{
+	// Overlapping patterns, which are prefixes and suffixes of each
+	// other, on both engines.
+
+	Vector<String> overlapping;
+	overlapping.push_back("a");
+	overlapping.push_back("aa");
+	overlapping.push_back("aaa");
+	overlapping.push_back("ab");
+	overlapping.push_back("bab");
+
+	String text = "aaaababaaaabab aaa";
+	check_search(overlapping, text, "overlapping patterns");
+
+	for (usize i = 0; i < 10; i++)
+	{
+		overlapping.push_back("ba");
+	}
+
+	check_search(overlapping, text, "overlapping patterns, automaton");
+
+	// Duplicate and empty patterns.
+
+	Vector<String> duplicates;
+	duplicates.push_back("");
+	duplicates.push_back("ab");
+	duplicates.push_back("ab");
+	duplicates.push_back("b");
+	check_search(duplicates, text, "duplicate and empty patterns");
+
+	Vector<String> empty_patterns;
+	empty_patterns.push_back("");
+	check_search(empty_patterns, text, "only empty patterns");
+
+	// The empty text, on both engines.
+
+	check_search(duplicates, StringView(), "empty text");
+	check_search(overlapping, StringView(), "empty text, automaton");
+
+	Vector<String> none;
+	check_search(none, text, "no patterns");
+}
+
+void
+test_all_byte_classes()
+{
+	// Every byte value occurs in a pattern, so the automaton needs 257
+	// byte classes. A byte must never share a class with the bytes that
+	// occur in no pattern.
+
+	Vector<String> patterns;
+
+	for (usize b = 0; b < 256; b++)
+	{
+		u8 pair[2] = { (u8) b, (u8) b };
+		patterns.push_back(bytes(pair, 2));
+	}
+
+	MultiSearcher searcher(patterns);
+	check(!searcher.use_teddy, "256 patterns use the automaton");
+
+	u8 text[] = { 0xFF, 0x00, 0x7F };
+	Vector<MultiSearcher::Match> matches = searcher.find_all(
+		StringView((const char *) text, 3));
+	check(matches.size == 0, "no false match with 256 byte classes");
+
+	u8 repeated[] = { 0x41, 0xFF, 0xFF, 0x00, 0x00 };
+	matches = searcher.find_all(StringView((const char *) repeated, 5));
+	check(matches.size == 2, "matches with 256 byte classes");
+	check(matches[0].pattern == 0xFF && matches[0].start == 1,
+		"first match with 256 byte classes");
+	check(matches[1].pattern == 0x00 && matches[1].start == 3,
+		"second match with 256 byte classes");
+}
+
+int
+main()
+{
+	test_random();
+	test_edge_cases();
+	test_all_byte_classes();
+
+	printf("All multi search tests passed.\n");
+}
@@ -0,0 +1,129 @@
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../types.hpp"
+#include "../simd_math.hpp"
+#include "check.hpp"
+
+// Compares ways of normalising 3D vectors: dividing by `sqrt()`,
+// multiplying by `1 / sqrt()`, and `normalize3()` in both precision tiers.
+// Prints the time per vector and the maximum error of the components
+// against a long double reference, and checks that zero vectors stay zero.
+// Build natively with `make normalize_bench`.
+
+constexpr usize vector_count = 1 << 16;
+constexpr usize iterations = 200;
+
+using slaw::Precision;
+
+/**
+ * Runs a normalisation over a copy of the input, and prints its time per
+ * vector and its maximum error in units in the last place.
+ */
+template <typename F>
+void
+bench(const char *name, const f32 *input, f32 *work, F f)
+{
+	long double max_error = 0;
+
+	for (usize i = 0; i < 3 * vector_count; i++)
+	{
+		work[i] = input[i];
+	}
+
+	f(work);
+
+	for (usize i = 0; i < vector_count; i++)
+	{
+		const f32 *v = input + 3 * i;
+		long double length = sqrtl((long double) v[0] * v[0]
+			+ (long double) v[1] * v[1] + (long double) v[2] * v[2]);
+
+		for (usize j = 0; j < 3; j++)
+		{
+			long double exact = v[j] / length;
+			int exponent = exact == 0 || ilogbl(exact) < -126
+				? -126 : ilogbl(exact);
+			long double error = fabsl(work[3 * i + j] - exact)
+				/ ldexpl(1, exponent - 23);
+
+			max_error = error > max_error ? error : max_error;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		f(work);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double>(end - start).count() * 1e9
+		/ (iterations * vector_count);
+
+	printf("%-18s %8.3f ns/vector %10.4Lg ulp\n", name, ns, max_error);
+}
+
+int
+main()
+{
+	static f32 input[3 * vector_count];
+	static f32 work[3 * vector_count];
+
+	for (usize i = 0; i < 3 * vector_count; i++)
+	{
+		input[i] = (f32) rand() / RAND_MAX * 200 - 100;
+	}
+
+	// Zero vectors stay zero, in the vector loop and in the tail.
+
+	f32 zeros[15] = {};
+	slaw::simd::normalize3(zeros, 5);
+	slaw::simd::normalize3<Precision::Fast>(zeros, 5);
+
+	for (usize i = 0; i < 15; i++)
+	{
+		check(zeros[i] == 0, "zero vectors stay zero");
+	}
+
+	// Repeated runs normalise vectors that are already normalised, which
+	// costs the same as the first run.
+
+	bench("divide by sqrt", input, work, [](f32 *v)
+	{
+		for (usize i = 0; i < 3 * vector_count; i += 3)
+		{
+			f32 length = slaw::sqrt(v[i] * v[i] + v[i + 1] * v[i + 1]
+				+ v[i + 2] * v[i + 2]);
+
+			v[i] /= length;
+			v[i + 1] /= length;
+			v[i + 2] /= length;
+		}
+	});
+
+	bench("multiply 1/sqrt", input, work, [](f32 *v)
+	{
+		for (usize i = 0; i < 3 * vector_count; i += 3)
+		{
+			f32 inverse = 1 / slaw::sqrt(v[i] * v[i] + v[i + 1] * v[i + 1]
+				+ v[i + 2] * v[i + 2]);
+
+			v[i] *= inverse;
+			v[i + 1] *= inverse;
+			v[i + 2] *= inverse;
+		}
+	});
+
+	bench("normalize3", input, work, [](f32 *v)
+	{
+		slaw::simd::normalize3(v, vector_count);
+	});
+
+	bench("normalize3 fast", input, work, [](f32 *v)
+	{
+		slaw::simd::normalize3<Precision::Fast>(v, vector_count);
+	});
+}
@@ -0,0 +1,442 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../mem_pool.hpp"
+#include "../radix_tree.hpp"
+#include "check.hpp"
+
+// Checks `RadixTree` against a plain list of keys, over random keys with
+// long shared prefixes, and the growth of a node through all four node
+// sizes. Also checks the slot reuse and chunk growth of `mem::Pool`.
+// Build natively with `make radix_tree_test`.
+
+using slaw::RadixTree;
+using slaw::String;
+using slaw::StringView;
+using slaw::Vector;
+
+using Tree = RadixTree<u32>;
+
+/**
+ * Orders strings in lexicographic byte order, for `qsort()`.
+ */
+int
+compare_strings(const void *a, const void *b)
+{
+	const String *x = (const String *) a;
+	const String *y = (const String *) b;
+	int order = memcmp(x->data, y->data,
+		x->size < y->size ? x->size : y->size);
+
+	if (order != 0)
+	{
+		return order;
+	}
+
+	return (x->size > y->size) - (x->size < y->size);
+}
+
+/**
+ * Returns a random string of up to `max_size` characters, from the first
+ * `alphabet` byte values starting at `first`.
+ */
+String
+random_string(usize max_size, usize alphabet, u8 first)
+{
+	String s;
+	usize size = rand() % (max_size + 1);
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back((char) (first + rand() % alphabet));
+	}
+
+	return s;
+}
+
+/**
+ * Returns the index of a key in a list, or -1 if it is not in the list.
+ */
+isize
+index_of(const Vector<String> &keys, StringView key)
+{
+	for (usize i = 0; i < keys.size; i++)
+	{
+		if (StringView(keys[i]) == key)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Checks all lookups of a tree against the keys and values it should hold.
+ */
+void
+check_tree(const Tree &tree, const Vector<String> &keys,
+	const Vector<u32> &values, const Vector<String> &probes)
+{
+	Tree &mutable_tree = (Tree &) tree;
+	check(tree.size() == keys.size, "size");
+
+	for (usize i = 0; i < keys.size; i++)
+	{
+		u32 *value = mutable_tree.find(keys[i]);
+		check(value != nullptr && *value == values[i], "find");
+	}
+
+	// The entries in order, against the sorted keys.
+
+	Vector<String> sorted;
+
+	for (usize i = 0; i < keys.size; i++)
+	{
+		sorted.push_back(keys[i]);
+	}
+
+	qsort(sorted.data, sorted.size, sizeof(String), compare_strings);
+
+	usize visited = 0;
+
+	tree.for_each([&](const Tree::Entry &entry)
+	{
+		check(visited < sorted.size && entry.key == sorted[visited],
+			"for_each order");
+		visited++;
+	});
+
+	check(visited == sorted.size, "for_each visits all keys");
+
+	for (usize p = 0; p < probes.size; p++)
+	{
+		StringView probe = probes[p];
+		isize index = index_of(keys, probe);
+		u32 *value = mutable_tree.find(probe);
+		check(index == -1 ? value == nullptr
+			: value != nullptr && *value == values[index], "find probe");
+		check(mutable_tree.contains(probe) == (index != -1), "contains");
+
+		// The longest key that is a prefix of the probe.
+
+		isize longest = -1;
+
+		for (usize i = 0; i < keys.size; i++)
+		{
+			if (probe.starts_with(keys[i]) && (longest == -1
+				|| keys[i].size > keys[longest].size))
+			{
+				longest = i;
+			}
+		}
+
+		const Tree::Entry *found = tree.longest_prefix(probe);
+		check(longest == -1 ? found == nullptr
+			: found != nullptr && found->key == keys[longest],
+			"longest_prefix");
+
+		// The keys that start with the probe, in order.
+
+		usize next = 0;
+
+		tree.for_each_with_prefix(probe, [&](const Tree::Entry &entry)
+		{
+			while (next < sorted.size
+				&& !StringView(sorted[next]).starts_with(probe))
+			{
+				next++;
+			}
+
+			check(next < sorted.size && entry.key == sorted[next],
+				"for_each_with_prefix order");
+			next++;
+		});
+
+		while (next < sorted.size
+			&& !StringView(sorted[next]).starts_with(probe))
+		{
+			next++;
+		}
+
+		check(next == sorted.size, "for_each_with_prefix visits all keys");
+	}
+}
+
+void
+test_random()
+{
+	// Small alphabets give long shared prefixes, which are longer than
+	// the stored part of node prefixes and are split in their middle.
+	// The full byte range gives wide nodes.
+
+	usize alphabets[] = { 2, 3, 256 };
+	usize max_sizes[] = { 4, 12, 30 };
+
+	for (usize alphabet : alphabets)
+	{
+		for (usize max_size : max_sizes)
+		{
+			Tree tree;
+			Vector<String> keys;
+			Vector<u32> values;
+			Vector<String> probes;
+			u8 first = alphabet == 256 ? 0 : 'a';
+
+			for (usize i = 0; i < 300; i++)
+			{
+				String key = random_string(max_size, alphabet, first);
+				u32 value = rand();
+				isize index = index_of(keys, key);
+
+				check(tree.insert(key, value) == (index == -1),
+					"insert returns whether the key is new");
+
+				if (index == -1)
+				{
+					keys.push_back(key);
+					values.push_back(value);
+				}
+				else
+				{
+					values[index] = value;
+				}
+
+				probes.push_back(random_string(max_size + 2, alphabet,
+					first));
+			}
+
+			check_tree(tree, keys, values, probes);
+			check_tree(tree, keys, values, keys);
+		}
+	}
+}
+
+void
+test_long_prefixes()
+{
+	// Keys that share 20 bytes, then branch, then share 20 more bytes.
+	// Inserted in an order that splits a prefix beyond its stored part.
+
+	const char *texts[] = {
+		"common-prefix-of-20-bytes/left/another-shared-part/x",
+		"common-prefix-of-20-bytes/left/another-shared-part/y",
+		"common-prefix-of-20-bytes/left/another-shared-pa",
+		"common-prefix-of-20-bytes/right",
+		"common-prefix-of-20-bytes/",
+		"common-prefix-of-20-bytes/left/another-shared-part/x/z",
+		"common-prefix-of-20-bytes/left/another-shared-pzzz",
+		"common-prefix-of-20-bytes/lefz",
+		"common-prefix",
+		"",
+		"c",
+	};
+
+	Tree tree;
+	Vector<String> keys;
+	Vector<u32> values;
+
+	for (usize i = 0; i < sizeof(texts) / sizeof(texts[0]); i++)
+	{
+		StringView text(texts[i], strlen(texts[i]));
+		check(tree.insert(text, i), "insert long key");
+		keys.push_back(text.to_string());
+		values.push_back(i);
+	}
+
+	Vector<String> probes;
+
+	for (usize i = 0; i < keys.size; i++)
+	{
+		// Every prefix of every key, and every key with one byte
+		// changed.
+
+		for (usize n = 0; n <= keys[i].size; n++)
+		{
+			probes.push_back(StringView(keys[i]).substr(0, n).to_string());
+		}
+
+		for (usize j = 0; j < keys[i].size; j++)
+		{
+			String changed = keys[i];
+			changed[j] ^= 1;
+			probes.push_back(changed);
+		}
+
+		String longer = keys[i];
+		longer.push_back('!');
+		probes.push_back(longer);
+	}
+
+	check_tree(tree, keys, values, probes);
+
+	// Replacing a value does not add a key.
+
+	check(!tree.insert(StringView("common-prefix", 13), 99),
+		"insert existing key");
+	values[8] = 99;
+	check_tree(tree, keys, values, probes);
+}
+
+/**
+ * Returns the type of the node below the root, which is the node that
+ * branches on the last byte of the keys in `test_node_growth()`.
+ */
+Tree::NodeType
+root_type(const Tree &tree)
+{
+	return ((const Tree::Node *) tree.root)->type;
+}
+
+void
+test_node_growth()
+{
+	// 256 keys that differ only in their last byte, inserted in a random
+	// order, so the node above them grows from a `Node4` through a
+	// `Node16` and a `Node48` into a `Node256`. The shared prefix is
+	// longer than the stored part of a node prefix.
+
+	const char prefix[] = "a-prefix-longer-than-eight-bytes:";
+	usize order[256];
+
+	for (usize i = 0; i < 256; i++)
+	{
+		order[i] = i;
+	}
+
+	for (usize i = 255; i > 0; i--)
+	{
+		usize j = rand() % (i + 1);
+		usize t = order[i];
+		order[i] = order[j];
+		order[j] = t;
+	}
+
+	Tree tree;
+	Vector<String> keys;
+	Vector<u32> values;
+
+	for (usize i = 0; i < 256; i++)
+	{
+		String key = StringView(prefix, sizeof(prefix) - 1).to_string();
+		key.push_back((char) order[i]);
+		check(tree.insert(key, order[i]), "insert byte key");
+		keys.push_back(key);
+		values.push_back(order[i]);
+
+		usize count = i + 1;
+
+		if (count < 2)
+		{
+			continue;
+		}
+
+		Tree::NodeType expected = count <= 4 ? Tree::NodeType::Node4
+			: count <= 16 ? Tree::NodeType::Node16
+			: count <= 48 ? Tree::NodeType::Node48
+			: Tree::NodeType::Node256;
+
+		check(root_type(tree) == expected, "node type");
+		check(((const Tree::Node *) tree.root)->child_count == count,
+			"child count");
+
+		// Check every lookup at each size, and right after each
+		// growth.
+
+		if (count == 4 || count == 5 || count == 16 || count == 17
+			|| count == 48 || count == 49 || count == 256)
+		{
+			Vector<String> probes;
+
+			for (usize b = 0; b < 256; b++)
+			{
+				String probe = StringView(prefix, sizeof(prefix) - 1)
+					.to_string();
+				probe.push_back((char) b);
+				probe.push_back('+');
+				probes.push_back(probe);
+			}
+
+			probes.push_back(StringView(prefix, 10).to_string());
+			check_tree(tree, keys, values, probes);
+		}
+	}
+
+	// The smaller nodes went back to their pools when they grew.
+
+	check(tree.node4_pool.allocated == 0 && tree.node16_pool.allocated == 0
+		&& tree.node48_pool.allocated == 0
+		&& tree.node256_pool.allocated == 1, "grown nodes are freed");
+
+	// A key that ends at the node with 256 children.
+
+	check(tree.insert(StringView(prefix, sizeof(prefix) - 1), 1000),
+		"insert key that ends at a Node256");
+	keys.push_back(StringView(prefix, sizeof(prefix) - 1).to_string());
+	values.push_back(1000);
+	check_tree(tree, keys, values, keys);
+}
+
+void
+test_pool()
+{
+	slaw::mem::Pool<u64, 4> pool;
+	u64 *slots[10];
+
+	for (usize i = 0; i < 10; i++)
+	{
+		slots[i] = pool.alloc();
+		*slots[i] = i;
+	}
+
+	check(pool.allocated == 10, "allocated count");
+
+	// Slots are distinct, 8-byte aligned, and consecutive allocations
+	// from the same chunk are next to each other.
+
+	for (usize i = 0; i < 10; i++)
+	{
+		check(*slots[i] == i, "slots do not overlap");
+		check(((usize) (__UINTPTR_TYPE__) slots[i] & 7) == 0, "alignment");
+	}
+
+	check(slots[1] == slots[0] + 1 && slots[3] == slots[2] + 1,
+		"slots of a chunk are consecutive");
+
+	// Freed slots are reused, the last freed first.
+
+	pool.free(slots[3]);
+	pool.free(slots[7]);
+	check(pool.allocated == 8, "allocated count after free");
+	check(pool.alloc() == slots[7] && pool.alloc() == slots[3],
+		"freed slots are reused");
+
+	// Moving takes over the chunks, clearing returns them.
+
+	slaw::mem::Pool<u64, 4> moved = slaw::move(pool);
+	check(pool.allocated == 0 && pool.chunks == nullptr, "moved from");
+	check(moved.allocated == 10 && moved.chunks != nullptr, "moved to");
+
+	moved.clear();
+	check(moved.allocated == 0 && moved.chunks == nullptr, "cleared");
+	check(moved.alloc() != nullptr && moved.allocated == 1,
+		"alloc after clear");
+
+	// Slots hold at least a free list link, rounded up to 8 bytes.
+
+	check(slaw::mem::Pool<u8>::slot_size == 8, "small slot size");
+	check(slaw::mem::Pool<Tree::Node48>::slot_size % 8 == 0,
+		"node slot size");
+}
+
+int
+main()
+{
+	test_pool();
+	test_random();
+	test_long_prefixes();
+	test_node_growth();
+
+	printf("All radix tree tests passed.\n");
+}
@@ -0,0 +1,185 @@
+#include <chrono>
+#include <regex>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../types.hpp"
+#include "../regex.hpp"
+#include "check.hpp"
+
+// Checks the compile-time regular expressions against `std::regex` and
+// compares their speed.
+// Build natively with `make regex_bench`.
+
+constexpr usize iterations = 20;
+
+/**
+ * Runs a function `iterations` times and prints its throughput in MB/s,
+ * measured over the given number of input bytes per run.
+ */
+template <typename F>
+void
+bench(const char *name, usize bytes, F f)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		f();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("%-32s %10.1f MB/s\n", name,
+		(double) bytes * iterations / seconds / 1e6);
+}
+
+/**
+ * Checks that `slaw::Regex<Pattern>` agrees with `std::regex` on whether a
+ * text matches, and on the spans of all groups, for both full matches and
+ * searches.
+ */
+template <const char *Pattern>
+void
+compare(const char *text)
+{
+	using R = slaw::Regex<Pattern>;
+	std::regex reference(Pattern);
+	std::string str(text);
+	std::smatch expected;
+
+	auto m = R::match(slaw::StringView(str.data(), str.size()));
+	bool matched = std::regex_match(str, expected, reference);
+	check(m.matched == matched, Pattern);
+
+	for (usize g = 0; matched && g <= R::group_count; g++)
+	{
+		check(m[g].size == (usize) expected[g].length(), Pattern);
+		check(!expected[g].matched
+			|| m[g].data - str.data() == expected.position(g), Pattern);
+	}
+
+	auto s = R::search(slaw::StringView(str.data(), str.size()));
+	matched = std::regex_search(str, expected, reference);
+	check(s.matched == matched, Pattern);
+
+	for (usize g = 0; matched && g <= R::group_count; g++)
+	{
+		check(s[g].size == (usize) expected[g].length(), Pattern);
+		check(!expected[g].matched
+			|| s[g].data - str.data() == expected.position(g), Pattern);
+	}
+}
+
+static constexpr char date[] = "(\\d{4})-(\\d\\d)-(\\d\\d)";
+static constexpr char ident[] = "[a-zA-Z_][a-zA-Z0-9_]*";
+static constexpr char alt[] = "(foo|foobar|ba[rz])+x?";
+static constexpr char lazy[] = "<(.+?)>";
+static constexpr char anchors[] = "^a(b|c)*d$";
+static constexpr char nested[] = "((a|b)c)*(?:ab)?";
+static constexpr char classes[] = "[^\\s,]+,\\s*[-+]?\\d+(\\.\\d*)?";
+static constexpr char email[] = "[\\w.+-]+@[\\w-]+\\.[\\w.-]+";
+
+void
+test_regex()
+{
+	const char *texts[] = {
+		"", "2024-01-31", "x2024-01-31y", "2024-1-31", "hello_world42",
+		"42abc", "foobarbazx", "foofoo", "bax", "a <b> <c>", "<>",
+		"abd", "acbcbd", "abcd", "ad", "acbcabc", "acac", "ab",
+		"name, -12.5", "name,3", ", 3", "mail user.name+tag@example.co.uk",
+		"@x.y", "a@b.c",
+	};
+
+	for (const char *text : texts)
+	{
+		compare<date>(text);
+		compare<ident>(text);
+		compare<alt>(text);
+		compare<lazy>(text);
+		compare<anchors>(text);
+		compare<nested>(text);
+		compare<classes>(text);
+		compare<email>(text);
+	}
+
+	// Unmatched groups are reported as empty views without data.
+
+	auto m = slaw::Regex<nested>::match("ab");
+	check(m && m[1].data == nullptr && m[2].data == nullptr,
+		"unmatched groups");
+}
+
+int
+main()
+{
+	test_regex();
+	printf("All checks passed.\n\n");
+
+	// A log-like text with a date in every line.
+
+	std::string text;
+
+	while (text.size() < (1 << 20))
+	{
+		text += "INFO request handled in 12ms by worker_";
+		text += std::to_string(rand() % 100);
+		text += " on 2024-";
+		text += std::to_string(10 + rand() % 3);
+		text += "-";
+		text += std::to_string(10 + rand() % 20);
+		text += " for user@example.com\n";
+	}
+
+	slaw::StringView view(text.data(), text.size());
+	usize count = 0;
+
+	bench("slaw::Regex search all (date)", text.size(), [&]()
+	{
+		using Date = slaw::Regex<date>;
+		usize start = 0;
+
+		while (auto m = Date::search(view, start))
+		{
+			count++;
+			start = m[0].data - view.data + m[0].size;
+		}
+	});
+
+	bench("std::regex search all (date)", text.size(), [&]()
+	{
+		std::regex reference(date);
+
+		for (auto it = std::sregex_iterator(text.begin(), text.end(),
+			reference); it != std::sregex_iterator(); ++it)
+		{
+			count++;
+		}
+	});
+
+	bench("slaw::Regex search all (email)", text.size(), [&]()
+	{
+		using Email = slaw::Regex<email>;
+		usize start = 0;
+
+		while (auto m = Email::search(view, start))
+		{
+			count++;
+			start = m[0].data - view.data + m[0].size;
+		}
+	});
+
+	bench("std::regex search all (email)", text.size(), [&]()
+	{
+		std::regex reference(email);
+
+		for (auto it = std::sregex_iterator(text.begin(), text.end(),
+			reference); it != std::sregex_iterator(); ++it)
+		{
+			count++;
+		}
+	});
+
+	printf("\n%zu matches\n", (size_t) count);
+}
\ No newline at end of file
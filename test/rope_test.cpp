@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../rope.hpp"
+#include "check.hpp"
+
+// Checks `Rope` against a plain string that receives the same random
+// inserts and erases, including ranges with huge lengths, and checks the
+// shape of the B-tree after every edit.
+// Build natively with `make rope_test`.
+
+using slaw::Rope;
+using slaw::String;
+using slaw::StringView;
+
+/**
+ * Checks if a string holds the given bytes.
+ */
+bool
+equals(const String &s, const char *data, usize size)
+{
+	return s.size == size && memcmp(s.data, data, size) == 0;
+}
+
+/**
+ * Checks the counts of a node and everything below it, that all leaves
+ * are at the same depth, and that every node except the root is at least
+ * a quarter full. Returns the height of the node.
+ */
+usize
+check_node(const Rope::Node *node, bool is_root)
+{
+	if (node->is_leaf)
+	{
+		const Rope::Leaf *leaf = (const Rope::Leaf *) node;
+		check(leaf->bytes <= Rope::max_leaf_size, "leaf size");
+		check(is_root || leaf->bytes >= Rope::min_leaf_size, "leaf fill");
+		check(leaf->lines == slaw::detail::count_byte(leaf->text,
+			leaf->bytes, '\n'), "leaf lines");
+		return 0;
+	}
+
+	const Rope::Inner *inner = (const Rope::Inner *) node;
+	check(inner->child_count <= Rope::max_children, "child count");
+	check(inner->child_count >= (is_root ? 2 : Rope::min_children),
+		"inner fill");
+
+	usize bytes = 0;
+	usize lines = 0;
+	usize height = 0;
+
+	for (usize i = 0; i < inner->child_count; i++)
+	{
+		const Rope::Node *child = inner->children[i];
+		check(inner->child_bytes[i] == child->bytes, "child bytes");
+		check(inner->child_lines[i] == child->lines, "child lines");
+		bytes += child->bytes;
+		lines += child->lines;
+
+		usize child_height = check_node(child, false);
+		check(i == 0 || child_height == height, "leaf depth");
+		height = child_height;
+	}
+
+	check(inner->bytes == bytes && inner->lines == lines, "inner counts");
+	return height + 1;
+}
+
+/**
+ * Checks a rope against the string it should hold: its size, lines,
+ * bytes, slices and chunks.
+ */
+void
+check_rope(const Rope &rope, const String &expected)
+{
+	check_node(rope.root, true);
+	check(rope.size() == expected.size, "size");
+
+	String text = rope.to_string();
+	check(equals(text, expected.data, expected.size), "contents");
+
+	usize newlines = 0;
+
+	for (usize i = 0; i < expected.size; i++)
+	{
+		check(rope[i] == expected[i], "byte");
+		check(rope.line_of(i) == newlines, "line of offset");
+
+		if (expected[i] == '\n')
+		{
+			newlines++;
+			check(rope.line_start(newlines) == i + 1, "line start");
+		}
+	}
+
+	check(rope.line_count() == newlines + 1, "line count");
+	check(rope.line_of(expected.size) == newlines, "line of end");
+	check(rope.line_start(newlines + 1) == expected.size,
+		"line start past the end");
+
+	// Chunks, clipped to random ranges, and ranges with huge lengths.
+
+	usize start = expected.size == 0 ? 0 : rand() % expected.size;
+	usize length = rand() % 3000;
+	usize end = start + length < expected.size ? start + length
+		: expected.size;
+	usize offset = start;
+
+	rope.for_each_chunk(start, length, [&](StringView chunk)
+	{
+		check(chunk.size > 0, "empty chunk");
+		check(memcmp(chunk.data, expected.data + offset, chunk.size) == 0,
+			"chunk");
+		offset += chunk.size;
+	});
+
+	check(offset == end, "chunks cover the range");
+
+	String slice = rope.slice(start, length);
+	check(equals(slice, expected.data + start, end - start), "slice");
+
+	slice = rope.slice(start, (usize) -1);
+	check(equals(slice, expected.data + start, expected.size - start),
+		"slice with a huge length");
+
+	slice = rope.slice(expected.size + 1, (usize) -1);
+	check(slice.size == 0, "slice past the end");
+}
+
+/**
+ * Returns a random text of up to `max_size` bytes, with some newlines.
+ */
+String
+random_text(usize max_size)
+{
+	String s;
+	usize size = rand() % (max_size + 1);
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back(rand() % 10 == 0 ? '\n' : (char) ('a' + rand() % 26));
+	}
+
+	return s;
+}
+
+/**
+ * Inserts a text into a string at an offset.
+ */
+void
+insert_into(String &s, usize pos, const String &text)
+{
+	String out;
+
+	for (usize i = 0; i < pos; i++)
+	{
+		out.push_back(s[i]);
+	}
+
+	for (usize i = 0; i < text.size; i++)
+	{
+		out.push_back(text[i]);
+	}
+
+	for (usize i = pos; i < s.size; i++)
+	{
+		out.push_back(s[i]);
+	}
+
+	s = slaw::move(out);
+}
+
+/**
+ * Erases up to `length` bytes from a string at an offset.
+ */
+void
+erase_from(String &s, usize pos, usize length)
+{
+	String out;
+
+	for (usize i = 0; i < s.size; i++)
+	{
+		if (i < pos || i - pos >= length)
+		{
+			out.push_back(s[i]);
+		}
+	}
+
+	s = slaw::move(out);
+}
+
+void
+test_random_edits()
+{
+	Rope rope;
+	String expected;
+	check_rope(rope, expected);
+
+	// Small and large inserts grow the tree over several levels, and
+	// erases shrink it again, some with lengths past the end.
+
+	for (usize round = 0; round < 400; round++)
+	{
+		usize pos = rand() % (expected.size + 1);
+		usize op = rand() % 10;
+
+		if (op < 5 || expected.size < 1000)
+		{
+			String text = random_text(op == 0 ? 20000 : 300);
+			rope.insert(pos, text);
+			insert_into(expected, pos, text);
+		}
+		else
+		{
+			usize length = op == 9 ? (usize) -1 : rand() % 5000;
+			rope.erase(pos, length);
+			erase_from(expected, pos, length);
+		}
+
+		check_rope(rope, expected);
+	}
+
+	rope.erase(0, (usize) -1);
+	expected.size = 0;
+	check_rope(rope, expected);
+}
+
+void
+test_deep_tree()
+{
+	// Many inserts at random offsets split leaves and inner nodes on
+	// every level, until the tree is at least four levels deep.
+
+	Rope rope;
+	String expected;
+
+	while (check_node(rope.root, true) < 3)
+	{
+		usize pos = rand() % (expected.size + 1);
+		String text = random_text(2000);
+		rope.insert(pos, text);
+		insert_into(expected, pos, text);
+	}
+
+	check_rope(rope, expected);
+
+	// Erasing most of it in the middle merges nodes on every level.
+
+	usize pos = expected.size / 10;
+	rope.erase(pos, expected.size - 2 * pos);
+	erase_from(expected, pos, expected.size - 2 * pos);
+	check_rope(rope, expected);
+}
+
+void
+test_lines()
+{
+	Rope rope("first\nsecond\n\nfourth");
+	check(rope.line_count() == 4, "line count");
+	check(equals(rope.line(0), "first", 5), "first line");
+	check(equals(rope.line(1), "second", 6), "second line");
+	check(rope.line(2).size == 0, "empty line");
+	check(equals(rope.line(3), "fourth", 6), "last line");
+	check(rope.line(4).size == 0, "line past the end");
+
+	// A rope that is moved from is left empty.
+
+	Rope moved = slaw::move(rope);
+	check(rope.size() == 0 && rope.line_count() == 1, "moved from");
+	check(moved.line_of(13) == 2, "moved to");
+
+	// Erasing with a huge length from an offset keeps what is before it.
+
+	moved.erase(6, (usize) -1);
+	check(equals(moved.to_string(), "first\n", 6), "erase to the end");
+	moved.erase(6, 10);
+	check(moved.size() == 6, "erase at the end");
+}
+
+int
+main()
+{
+	test_random_edits();
+	test_deep_tree();
+	test_lines();
+
+	printf("All rope tests passed.\n");
+}
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../shared_string.hpp"
+#include "check.hpp"
+
+// Checks the sharing and copy-on-write behaviour of `SharedString`, and
+// appending a string to itself. Run it with `-fsanitize=address` to catch
+// reads of freed blocks.
+// Build natively with `make shared_string_test`.
+
+using slaw::SharedString;
+using slaw::StringView;
+
+/**
+ * Checks if a shared string holds the characters of a C string.
+ */
+bool
+equals(const SharedString &s, const char *expected)
+{
+	return s.size() == strlen(expected)
+		&& memcmp(s.data(), expected, s.size()) == 0;
+}
+
+void
+test_sharing()
+{
+	SharedString empty;
+	check(empty.size() == 0 && empty.ref_count() == 0, "empty string");
+
+	SharedString a("hello");
+	SharedString b = a;
+	check(a.data() == b.data() && a.ref_count() == 2, "copies share");
+
+	// Writing to a shared string detaches it.
+
+	b.set(0, 'j');
+	check(equals(a, "hello") && equals(b, "jello"), "copy on write");
+	check(a.ref_count() == 1 && b.ref_count() == 1, "detached");
+
+	SharedString c = a;
+	c += " world";
+	check(equals(a, "hello") && equals(c, "hello world"),
+		"append detaches");
+
+	SharedString d = slaw::move(c);
+	check(c.size() == 0 && equals(d, "hello world"), "move");
+	check(a == SharedString("hello") && a != b, "equality");
+}
+
+void
+test_self_append()
+{
+	// A string that is the only reference to its block, which has to
+	// grow for the append.
+
+	SharedString a("abc");
+	a.append(a);
+	check(equals(a, "abcabc"), "self append");
+
+	// Appending again until the block has room to spare, then appending
+	// a part of the string that fits without growing.
+
+	a.append(a);
+	a.append(a);
+	check(a.size() == 24, "repeated self append");
+
+	SharedString b("0123456789");
+	b.append(StringView(b.data() + 2, 3));
+	check(equals(b, "0123456789234"), "append a view of itself");
+
+	b.append(StringView(b.data() + 10, 3));
+	check(equals(b, "0123456789234234"), "append without growing");
+
+	// A shared string appended to itself, so the block is copied.
+
+	SharedString c("xyz");
+	SharedString d = c;
+	c.append(c);
+	check(equals(c, "xyzxyz") && equals(d, "xyz"), "shared self append");
+
+	c += c[0];
+	check(equals(c, "xyzxyzx"), "append own character");
+}
+
+int
+main()
+{
+	test_sharing();
+	test_self_append();
+
+	printf("All shared string tests passed.\n");
+}
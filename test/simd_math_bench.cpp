@@ -0,0 +1,379 @@
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../simd_math.hpp"
+#include "check.hpp"
+
+// Measures the error of the SIMD transcendental functions against a long
+// double reference, checks their special inputs against the C library, and
+// compares their speed with the C library.
+// Build natively with `make simd_math_bench`.
+
+constexpr usize sample_count = 1 << 20;
+constexpr usize bench_size = 4096;
+constexpr usize iterations = 500;
+
+using slaw::Precision;
+
+/**
+ * Returns the error of an approximation in units in the last place of the
+ * exact result, rounded to the element type. Exact results beyond the range
+ * of the element type must be approximated by infinity.
+ */
+template <typename E>
+long double
+ulp_error(E approx, long double exact)
+{
+	if (isnan(exact) || isinf((E) exact))
+	{
+		return (isnan(approx) && isnan(exact)) || approx == (E) exact
+			? 0 : INFINITY;
+	}
+
+	// The ULP of subnormal numbers is the ULP of the smallest normal
+	// number.
+
+	int min_exponent = sizeof(E) == 4 ? -126 : -1022;
+	int mantissa_bits = sizeof(E) == 4 ? 23 : 52;
+	int exponent = exact == 0 ? min_exponent
+		: ilogbl(exact) < min_exponent ? min_exponent : ilogbl(exact);
+
+	return fabsl((long double) approx - exact)
+		/ ldexpl(1, exponent - mantissa_bits);
+}
+
+/**
+ * Returns the relative error of an approximation, or its absolute error
+ * when the exact result is below 1e-3, where relative errors stop being
+ * meaningful for the fast tier. Exact results beyond the range of the
+ * element type must be approximated by infinity.
+ */
+template <typename E>
+long double
+relative_error(E approx, long double exact)
+{
+	if (isnan(exact) || isinf((E) exact))
+	{
+		return ulp_error(approx, exact);
+	}
+
+	long double difference = fabsl(approx - exact);
+	return fabsl(exact) < 1e-3 ? difference : difference / fabsl(exact);
+}
+
+/**
+ * Returns a random number in [low, high].
+ */
+long double
+random_in(long double low, long double high)
+{
+	return low + (high - low) * ((long double) rand() / RAND_MAX);
+}
+
+/**
+ * Returns a random positive number of a floating-point type, with a
+ * uniformly distributed exponent, including subnormal numbers.
+ */
+template <typename E>
+E
+random_positive()
+{
+	if constexpr (sizeof(E) == 4)
+	{
+		u32 bits = ((u32) rand() << 16 ^ rand()) % 0x7F800000;
+		E value;
+		memcpy(&value, &bits, 4);
+		return value;
+	}
+	else
+	{
+		u64 bits = ((u64) rand() << 42 ^ (u64) rand() << 21 ^ rand())
+			% 0x7FF0000000000000;
+		E value;
+		memcpy(&value, &bits, 8);
+		return value;
+	}
+}
+
+/**
+ * Fills an array with random inputs, drawn from [low, high], or, if
+ * `any_magnitude` is set, from all positive numbers and their negations
+ * when `low` is negative. The fast tier does not support subnormal inputs,
+ * so `normal_only` leaves them out.
+ */
+template <typename E>
+void
+fill(E *values, usize size, long double low, long double high,
+	bool any_magnitude, bool normal_only)
+{
+	for (usize i = 0; i < size; i++)
+	{
+		if (any_magnitude)
+		{
+			do
+			{
+				values[i] = random_positive<E>();
+			}
+			while (normal_only && !isnormal(values[i]));
+
+			if (low < 0 && rand() % 2)
+			{
+				values[i] = -values[i];
+			}
+		}
+		else
+		{
+			values[i] = random_in(low, high);
+		}
+	}
+}
+
+/**
+ * Applies a vector function to arrays of inputs.
+ */
+template <typename E, typename F>
+void
+apply(F f, const E *x, const E *y, E *out, usize size)
+{
+	using T = slaw::simd::simd_vector_of<E>;
+	constexpr usize lanes = 16 / sizeof(E);
+
+	for (usize i = 0; i < size; i += lanes)
+	{
+		slaw::simd::store(out + i, f(slaw::simd::load<T>(x + i),
+			slaw::simd::load<T>(y + i)));
+	}
+}
+
+/**
+ * Measures the maximum error of a vector function against a long double
+ * reference over random inputs, and its time per element against the C
+ * library. Prints one line of results.
+ */
+template <typename E, typename F, typename Reference, typename Libm>
+void
+measure(const char *name, Precision tier, long double low,
+	long double high, bool any_magnitude, long double y_low,
+	long double y_high, F f, Reference reference, Libm libm)
+{
+	E *x = new E[sample_count];
+	E *y = new E[sample_count];
+	E *out = new E[sample_count];
+
+	fill(x, sample_count, low, high, any_magnitude,
+		tier == Precision::Fast);
+	fill(y, sample_count, y_low, y_high, false, false);
+	apply(f, x, y, out, sample_count);
+
+	long double max_error = 0;
+	E worst_x = 0;
+	E worst_y = 0;
+
+	for (usize i = 0; i < sample_count; i++)
+	{
+		long double exact = reference((long double) x[i],
+			(long double) y[i]);
+		long double error = tier == Precision::Full
+			? ulp_error(out[i], exact)
+			: relative_error(out[i], exact);
+
+		if (!(error <= max_error))
+		{
+			max_error = error;
+			worst_x = x[i];
+			worst_y = y[i];
+		}
+	}
+
+	// The time per element, of the SIMD function and of a scalar loop
+	// over the C library.
+
+	E sink = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		apply(f, x, y, out, bench_size);
+		sink += out[i % bench_size];
+	}
+
+	auto middle = std::chrono::steady_clock::now();
+
+	for (usize i = 0; i < iterations; i++)
+	{
+		for (usize j = 0; j < bench_size; j++)
+		{
+			out[j] = libm(x[j], y[j]);
+		}
+
+		sink += out[i % bench_size];
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double simd_ns = std::chrono::duration<double>(middle - start).count()
+		* 1e9 / (iterations * bench_size);
+	double libm_ns = std::chrono::duration<double>(end - middle).count()
+		* 1e9 / (iterations * bench_size);
+
+	printf("%-6s %-4s %-4s %12.4Lg %-5s %7.2f %7.2f   (x = %.9g, y = %.9g)%s\n",
+		name, sizeof(E) == 4 ? "f32" : "f64",
+		tier == Precision::Full ? "full" : "fast", max_error,
+		tier == Precision::Full ? "ulp" : "rel", simd_ns, libm_ns,
+		(double) worst_x, (double) worst_y, sink == 12345 ? " " : "");
+
+	delete[] x;
+	delete[] y;
+	delete[] out;
+}
+
+/**
+ * Measures all functions of one element type and one precision tier.
+ */
+template <typename E, Precision P>
+void
+measure_all()
+{
+	using T = slaw::simd::simd_vector_of<E>;
+	namespace simd = slaw::simd;
+
+	constexpr bool single = sizeof(E) == 4;
+	long double exp_low = single ? -104 : -746;
+	long double exp_high = single ? 89 : 710;
+	long double trig_range = single ? 8192 : 1e6;
+
+	measure<E>("exp", P, exp_low, exp_high, false, 0, 0,
+		[](T x, T) { return simd::exp<P>(x); },
+		[](long double x, long double) { return expl(x); },
+		[](E x, E) { return (E) exp(x); });
+
+	measure<E>("ln", P, 0, 0, true, 0, 0,
+		[](T x, T) { return simd::ln<P>(x); },
+		[](long double x, long double) { return logl(x); },
+		[](E x, E) { return (E) log(x); });
+
+	measure<E>("sin", P, -trig_range, trig_range, false, 0, 0,
+		[](T x, T) { return simd::sin<P>(x); },
+		[](long double x, long double) { return sinl(x); },
+		[](E x, E) { return (E) sin(x); });
+
+	measure<E>("cos", P, -trig_range, trig_range, false, 0, 0,
+		[](T x, T) { return simd::cos<P>(x); },
+		[](long double x, long double) { return cosl(x); },
+		[](E x, E) { return (E) cos(x); });
+
+	measure<E>("tan", P, -trig_range, trig_range, false, 0, 0,
+		[](T x, T) { return simd::tan<P>(x); },
+		[](long double x, long double) { return tanl(x); },
+		[](E x, E) { return (E) tan(x); });
+
+	measure<E>("atan", P, -1, 1, true, 0, 0,
+		[](T x, T) { return simd::atan<P>(x); },
+		[](long double x, long double) { return atanl(x); },
+		[](E x, E) { return (E) atan(x); });
+
+	measure<E>("atan2", P, -1e3, 1e3, false, -1e3, 1e3,
+		[](T x, T y) { return simd::atan2<P>(y, x); },
+		[](long double x, long double y) { return atan2l(y, x); },
+		[](E x, E y) { return (E) atan2(y, x); });
+
+	measure<E>("pow", P, 1e-3, 1e3, false, -10, 10,
+		[](T x, T y) { return simd::pow<P>(x, y); },
+		[](long double x, long double y) { return powl(x, y); },
+		[](E x, E y) { return (E) pow(x, y); });
+
+	if constexpr (P == Precision::Full)
+	{
+		// Bases near 1 with large exponents need the extra precision
+		// of the logarithm.
+
+		measure<E>("pow", P, 0.9, 1.1, false, -5000, 5000,
+			[](T x, T y) { return simd::pow<P>(x, y); },
+			[](long double x, long double y) { return powl(x, y); },
+			[](E x, E y) { return (E) pow(x, y); });
+	}
+}
+
+/**
+ * Checks that the full tier agrees with the C library on special inputs:
+ * bit for bit where the C library returns a zero, an infinity or a NaN, and
+ * within a given number of ULPs of the exact result elsewhere.
+ */
+template <typename E>
+void
+test_special_values()
+{
+	using T = slaw::simd::simd_vector_of<E>;
+	namespace simd = slaw::simd;
+
+	E special[] = { 0.0, -0.0, 1.0, -1.0, 0.5, -2.0, 3.0, -3.0, INFINITY,
+		-INFINITY, NAN, sizeof(E) == 4 ? 1e-40 : 1e-310, 1e30, -1e30 };
+	constexpr usize count = sizeof(special) / sizeof(E);
+
+	auto agrees = [](E result, E expected, long double exact,
+		long double max_error)
+	{
+		if (isnan(expected) || isinf(expected) || expected == 0)
+		{
+			return (isnan(result) && isnan(expected))
+				|| (result == expected
+				&& signbit(result) == signbit(expected));
+		}
+
+		return ulp_error(result, exact) <= max_error;
+	};
+
+	for (usize i = 0; i < count; i++)
+	{
+		E x = special[i];
+		T v = slaw::simd::splat<T>(x);
+
+		check(agrees(simd::exp(v)[0], exp(x), expl(x), 1),
+			"exp special value");
+		check(agrees(simd::ln(v)[0], log(x), logl(x), 1),
+			"ln special value");
+		check(agrees(simd::sin(v)[0], sin(x), sinl(x), 1),
+			"sin special value");
+		check(agrees(simd::cos(v)[0], cos(x), cosl(x), 1),
+			"cos special value");
+		check(agrees(simd::tan(v)[0], tan(x), tanl(x), 2),
+			"tan special value");
+		check(agrees(simd::atan(v)[0], atan(x), atanl(x), 1),
+			"atan special value");
+
+		for (usize j = 0; j < count; j++)
+		{
+			E y = special[j];
+			T w = slaw::simd::splat<T>(y);
+
+			check(agrees(simd::atan2(v, w)[0], atan2(x, y),
+				atan2l(x, y), 2), "atan2 special value");
+
+			// The C library rounds pow(1e30, 3) and the like to
+			// infinity in single precision, so overflowing
+			// results are compared with the exact result.
+
+			check(agrees(simd::pow(v, w)[0], pow(x, y), powl(x, y), 1)
+				|| agrees(simd::pow(v, w)[0], (E) powl(x, y),
+				powl(x, y), 1), "pow special value");
+		}
+	}
+}
+
+int
+main()
+{
+	test_special_values<f32>();
+	test_special_values<f64>();
+	printf("All checks passed.\n\n");
+
+	printf("%-6s %-4s %-4s %12s %-5s %7s %7s\n", "name", "type", "tier",
+		"max error", "unit", "ns/elem", "libm");
+
+	measure_all<f32, Precision::Full>();
+	measure_all<f64, Precision::Full>();
+	measure_all<f32, Precision::Fast>();
+	measure_all<f64, Precision::Fast>();
+}
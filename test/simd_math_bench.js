@@ -0,0 +1,146 @@
+// Compares the SIMD transcendental functions of simd_math.hpp, compiled to
+// WASM, with JS Math: the maximum error against Math, in units in the last
+// place, and the time per element of the SIMD functions, of the scalar
+// functions of math.hpp, which call into JS Math, and of a plain JS loop.
+// Build and run with `make simd_math_bench_wasm`.
+
+const fs = require('fs')
+const path = require('path')
+
+const SlawEnvironment = new Function(fs.readFileSync(
+	path.join(__dirname, '../slaw.js'), 'utf8') + '\nreturn SlawEnvironment')()
+
+const iterations = 200
+
+const bits = new Float64Array(1)
+const bitsHigh = new Uint32Array(bits.buffer, 4, 1)
+
+// Returns the size of the unit in the last place of a number, for a given
+// number of mantissa bits and minimum exponent.
+const ulp = (x, mantissaBits, minExponent) =>
+{
+	bits[0] = x
+	const exponent = Math.max(((bitsHigh[0] >>> 20) & 0x7FF) - 1023,
+		minExponent)
+
+	return Math.pow(2, exponent - mantissaBits)
+}
+
+// Returns the error of an approximation in units in the last place of the
+// result of JS Math, rounded to single or double precision.
+const ulpError = (approx, exact, single) =>
+{
+	const rounded = single ? Math.fround(exact) : exact
+
+	if (Number.isNaN(exact) || !Number.isFinite(rounded))
+	{
+		return Object.is(approx, rounded)
+			|| (Number.isNaN(approx) && Number.isNaN(exact)) ? 0 : Infinity
+	}
+
+	return Math.abs(approx - exact) / (single
+		? ulp(exact, 23, -126) : ulp(exact, 52, -1022))
+}
+
+const functions = [
+	{ name: 'exp', low: -87, high: 88, math: (x) => Math.exp(x) },
+	{ name: 'ln', low: 1e-30, high: 1e30, log: true, math: (x) => Math.log(x) },
+	{ name: 'sin', low: -8192, high: 8192, math: (x) => Math.sin(x) },
+	{ name: 'cos', low: -8192, high: 8192, math: (x) => Math.cos(x) },
+	{ name: 'tan', low: -8192, high: 8192, math: (x) => Math.tan(x) },
+	{ name: 'atan', low: -1e3, high: 1e3, math: (x) => Math.atan(x) },
+	{ name: 'atan2', low: -1e3, high: 1e3, yLow: -1e3, yHigh: 1e3,
+		math: (x, y) => Math.atan2(y, x) },
+	{ name: 'pow', low: 1e-3, high: 1e3, yLow: -10, yHigh: 10,
+		math: (x, y) => Math.pow(x, y) }
+]
+
+// Returns a random number in [low, high], uniformly distributed, or with a
+// uniformly distributed exponent if `log` is set.
+const randomIn = (low, high, log) => log
+	? Math.exp(Math.log(low) + (Math.log(high) - Math.log(low)) * Math.random())
+	: low + (high - low) * Math.random()
+
+// Returns the time per element of a function, in nanoseconds.
+const time = (f, n) =>
+{
+	f()
+	const start = performance.now()
+
+	for (let i = 0; i < iterations; i++)
+	{
+		f()
+	}
+
+	return (performance.now() - start) * 1e6 / (iterations * n)
+}
+
+const main = async () =>
+{
+	const data = fs.readFileSync(path.join(__dirname, 'simd_math.wasm'))
+	const wasm = await WebAssembly.instantiate(data, {
+		env: new SlawEnvironment(() => wasm).env
+	})
+
+	const exports = wasm.instance.exports
+	const n = exports.buffer_size()
+	const buffer = () => exports.memory.buffer
+
+	console.log('name   type tier    max ulp   ns/elem  host ns    JS ns')
+
+	for (const fn of functions)
+	{
+		const xs = new Float64Array(n)
+		const ys = new Float64Array(n)
+		const expected = new Float64Array(n)
+
+		for (let i = 0; i < n; i++)
+		{
+			xs[i] = randomIn(fn.low, fn.high, fn.log)
+			ys[i] = fn.yLow === undefined ? 0 : randomIn(fn.yLow, fn.yHigh)
+		}
+
+		// The time of a plain JS loop over Math, and of the scalar
+		// functions of math.hpp.
+
+		const jsNs = time(() =>
+		{
+			for (let i = 0; i < n; i++)
+			{
+				expected[i] = fn.math(xs[i], ys[i])
+			}
+		}, n)
+
+		new Float64Array(buffer(), exports.buffer_x(), n).set(xs)
+		new Float64Array(buffer(), exports.buffer_y(), n).set(ys)
+		const hostNs = time(() => exports[fn.name + '_host_f64'](n), n)
+
+		for (const [suffix, single, tier] of [['f32x4', true, 'full'],
+			['f64x2', false, 'full'], ['fast_f32x4', true, 'fast']])
+		{
+			const Array = single ? Float32Array : Float64Array
+			const x = new Array(buffer(), exports.buffer_x(), n)
+			const y = new Array(buffer(), exports.buffer_y(), n)
+			const out = new Array(buffer(), exports.buffer_out(), n)
+			x.set(xs)
+			y.set(ys)
+
+			const f = exports[fn.name + '_' + suffix]
+			const ns = time(() => f(n), n)
+			let maxError = 0
+
+			for (let i = 0; i < n; i++)
+			{
+				const exact = fn.math(x[i], y[i])
+				maxError = Math.max(maxError, ulpError(out[i], exact, single))
+			}
+
+			console.log(fn.name.padEnd(6), (single ? 'f32' : 'f64').padEnd(4),
+				tier.padEnd(4), maxError.toPrecision(4).padStart(10),
+				ns.toFixed(2).padStart(9), hostNs.toFixed(2).padStart(8),
+				jsNs.toFixed(2).padStart(8))
+		}
+	}
+}
+
+main()
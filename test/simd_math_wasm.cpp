@@ -0,0 +1,98 @@
+#include "../slaw.hpp"
+
+// The WASM side of the transcendental function benchmark, which is driven by
+// `simd_math_bench.js`. Each export applies one function to the first `n`
+// elements of the input buffers and writes the results to the output
+// buffer. The `_host` exports do the same with the scalar functions of
+// math.hpp, which call into JS Math once per element.
+// Build and run with `make simd_math_bench_wasm`.
+
+constexpr usize buffer_size = 1 << 16;
+
+alignas(16) u8 buffer_x[buffer_size * sizeof(f64)];
+alignas(16) u8 buffer_y[buffer_size * sizeof(f64)];
+alignas(16) u8 buffer_out[buffer_size * sizeof(f64)];
+
+EXPORT("buffer_size") usize get_buffer_size() { return buffer_size; }
+EXPORT("buffer_x") u8 *get_buffer_x() { return buffer_x; }
+EXPORT("buffer_y") u8 *get_buffer_y() { return buffer_y; }
+EXPORT("buffer_out") u8 *get_buffer_out() { return buffer_out; }
+
+/**
+ * Applies a vector function to the first `n` elements of the input buffers.
+ */
+template <typename T, typename F>
+void
+apply(F f, usize n)
+{
+	using E = slaw::simd::simd_element_type_of<T>;
+	const E *x = (const E *) buffer_x;
+	const E *y = (const E *) buffer_y;
+	E *out = (E *) buffer_out;
+
+	for (usize i = 0; i < n; i += sizeof(T) / sizeof(E))
+	{
+		slaw::simd::store(out + i, f(slaw::simd::load<T>(x + i),
+			slaw::simd::load<T>(y + i)));
+	}
+}
+
+/**
+ * Applies a scalar function to the first `n` elements of the input buffers.
+ */
+template <typename E, typename F>
+void
+apply_scalar(F f, usize n)
+{
+	const E *x = (const E *) buffer_x;
+	const E *y = (const E *) buffer_y;
+	E *out = (E *) buffer_out;
+
+	for (usize i = 0; i < n; i++)
+	{
+		out[i] = f(x[i], y[i]);
+	}
+}
+
+using slaw::Precision;
+namespace simd = slaw::simd;
+
+EXPORT("exp_f32x4") void exp_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::exp(x); }, n); }
+EXPORT("exp_f64x2") void exp_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::exp(x); }, n); }
+EXPORT("exp_fast_f32x4") void exp_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::exp<Precision::Fast>(x); }, n); }
+EXPORT("exp_host_f64") void exp_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::exp(x); }, n); }
+
+EXPORT("ln_f32x4") void ln_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::ln(x); }, n); }
+EXPORT("ln_f64x2") void ln_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::ln(x); }, n); }
+EXPORT("ln_fast_f32x4") void ln_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::ln<Precision::Fast>(x); }, n); }
+EXPORT("ln_host_f64") void ln_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::ln(x); }, n); }
+
+EXPORT("sin_f32x4") void sin_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::sin(x); }, n); }
+EXPORT("sin_f64x2") void sin_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::sin(x); }, n); }
+EXPORT("sin_fast_f32x4") void sin_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::sin<Precision::Fast>(x); }, n); }
+EXPORT("sin_host_f64") void sin_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::sin(x); }, n); }
+
+EXPORT("cos_f32x4") void cos_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::cos(x); }, n); }
+EXPORT("cos_f64x2") void cos_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::cos(x); }, n); }
+EXPORT("cos_fast_f32x4") void cos_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::cos<Precision::Fast>(x); }, n); }
+EXPORT("cos_host_f64") void cos_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::cos(x); }, n); }
+
+EXPORT("tan_f32x4") void tan_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::tan(x); }, n); }
+EXPORT("tan_f64x2") void tan_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::tan(x); }, n); }
+EXPORT("tan_fast_f32x4") void tan_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::tan<Precision::Fast>(x); }, n); }
+EXPORT("tan_host_f64") void tan_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::tan(x); }, n); }
+
+EXPORT("atan_f32x4") void atan_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::atan(x); }, n); }
+EXPORT("atan_f64x2") void atan_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2) { return simd::atan(x); }, n); }
+EXPORT("atan_fast_f32x4") void atan_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4) { return simd::atan<Precision::Fast>(x); }, n); }
+EXPORT("atan_host_f64") void atan_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64) { return slaw::atan(x); }, n); }
+
+EXPORT("atan2_f32x4") void atan2_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4 y) { return simd::atan2(y, x); }, n); }
+EXPORT("atan2_f64x2") void atan2_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2 y) { return simd::atan2(y, x); }, n); }
+EXPORT("atan2_fast_f32x4") void atan2_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4 y) { return simd::atan2<Precision::Fast>(y, x); }, n); }
+EXPORT("atan2_host_f64") void atan2_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64 y) { return slaw::atan2(y, x); }, n); }
+
+EXPORT("pow_f32x4") void pow_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4 y) { return simd::pow(x, y); }, n); }
+EXPORT("pow_f64x2") void pow_f64x2(usize n) { apply<f64x2>([](f64x2 x, f64x2 y) { return simd::pow(x, y); }, n); }
+EXPORT("pow_fast_f32x4") void pow_fast_f32x4(usize n) { apply<f32x4>([](f32x4 x, f32x4 y) { return simd::pow<Precision::Fast>(x, y); }, n); }
+EXPORT("pow_host_f64") void pow_host_f64(usize n) { apply_scalar<f64>([](f64 x, f64 y) { return slaw::pow(x, y); }, n); }
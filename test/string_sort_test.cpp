@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../string_sort.hpp"
+#include "check.hpp"
+
+// Checks `sort_strings()` against `qsort()`, over random strings of small
+// and large alphabets, duplicates, and strings with long common prefixes,
+// which must not overflow the call stack.
+// Build natively with `make string_sort_test`.
+
+using slaw::String;
+using slaw::StringView;
+using slaw::Vector;
+
+/**
+ * Compares two string views in lexicographic byte order, for `qsort()`.
+ */
+int
+compare_views(const void *a, const void *b)
+{
+	const StringView *x = (const StringView *) a;
+	const StringView *y = (const StringView *) b;
+	int order = memcmp(x->data, y->data,
+		x->size < y->size ? x->size : y->size);
+
+	if (order != 0)
+	{
+		return order;
+	}
+
+	return (x->size > y->size) - (x->size < y->size);
+}
+
+/**
+ * Sorts views with `sort_strings()` and with `qsort()`, and checks that
+ * the results hold the same strings in the same order.
+ */
+void
+check_sort(const StringView *views, usize n, const char *message)
+{
+	Vector<StringView> sorted;
+
+	for (usize i = 0; i < n; i++)
+	{
+		sorted.push_back(views[i]);
+	}
+
+	StringView *expected = new StringView[n + 1];
+	memcpy(expected, views, n * sizeof(StringView));
+	qsort(expected, n, sizeof(StringView), compare_views);
+
+	slaw::sort_strings(sorted);
+	check(sorted.size == n, message);
+
+	for (usize i = 0; i < n; i++)
+	{
+		check(compare_views(&sorted[i], &expected[i]) == 0, message);
+	}
+
+	delete[] expected;
+}
+
+/**
+ * Returns a random string of up to `max_size` characters from the first
+ * `alphabet` byte values starting at `first`.
+ */
+String
+random_string(usize max_size, usize alphabet, u8 first)
+{
+	String s;
+	usize size = rand() % (max_size + 1);
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back((char) (first + rand() % alphabet));
+	}
+
+	return s;
+}
+
+void
+test_random()
+{
+	usize sizes[] = { 0, 1, 2, 7, 8, 9, 63, 64, 65, 500, 5000 };
+	usize alphabets[] = { 2, 26, 256 };
+
+	for (usize n : sizes)
+	{
+		for (usize alphabet : alphabets)
+		{
+			Vector<String> strings;
+
+			for (usize i = 0; i < n; i++)
+			{
+				strings.push_back(random_string(20, alphabet,
+					alphabet == 256 ? 0 : 'a'));
+			}
+
+			Vector<StringView> views;
+
+			for (usize i = 0; i < n; i++)
+			{
+				views.push_back(strings[i]);
+			}
+
+			check_sort(views.data, n, "random strings");
+
+			// Sorting the strings themselves moves them into the same
+			// order as the views.
+
+			slaw::sort_strings(strings);
+			slaw::sort_strings(views);
+
+			for (usize i = 0; i < n; i++)
+			{
+				check(strings[i].size == views[i].size
+					&& memcmp(strings[i].data, views[i].data,
+						views[i].size) == 0, "sorted strings");
+			}
+		}
+	}
+}
+
+void
+test_long_prefixes()
+{
+	// 100 strings that share a 4000-byte prefix, with random suffixes.
+
+	Vector<String> strings;
+
+	for (usize i = 0; i < 100; i++)
+	{
+		String s;
+
+		for (usize j = 0; j < 4000; j++)
+		{
+			s.push_back('x');
+		}
+
+		String suffix = random_string(10, 3, 'a');
+
+		for (usize j = 0; j < suffix.size; j++)
+		{
+			s.push_back(suffix[j]);
+		}
+
+		strings.push_back(slaw::move(s));
+	}
+
+	Vector<StringView> views;
+
+	for (usize i = 0; i < strings.size; i++)
+	{
+		views.push_back(strings[i]);
+	}
+
+	check_sort(views.data, views.size, "4000-byte common prefix");
+
+	// Prefixes of one long text share all but their last bytes, with
+	// both the radix sort and the multikey quicksort. Copies of the same
+	// long text are identical all the way.
+
+	constexpr usize text_size = 100000;
+	char *text = new char[text_size];
+
+	for (usize i = 0; i < text_size; i++)
+	{
+		text[i] = (char) ('a' + rand() % 2);
+	}
+
+	usize counts[] = { 10, 40, 200 };
+
+	for (usize n : counts)
+	{
+		Vector<StringView> prefixes;
+		Vector<StringView> copies;
+
+		for (usize i = 0; i < n; i++)
+		{
+			prefixes.push_back(StringView(text, text_size - i * 7));
+			copies.push_back(StringView(text, text_size));
+		}
+
+		check_sort(prefixes.data, n, "prefixes of a long text");
+		check_sort(copies.data, n, "copies of a long text");
+	}
+
+	delete[] text;
+}
+
+int
+main()
+{
+	test_random();
+	test_long_prefixes();
+
+	printf("All string sort tests passed.\n");
+}
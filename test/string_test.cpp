@@ -0,0 +1,391 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../types.hpp"
+#include "../string.hpp"
+#include "../string_view.hpp"
+#include "check.hpp"
+
+// Checks the case conversion, trimming, case-insensitive comparison and
+// `replace_all()` of `String` against byte-by-byte versions, over every
+// byte value and sizes around the 16-byte blocks, and `from_int()` against
+// `snprintf()`.
+// Build natively with `make string_test`.
+
+using slaw::String;
+using slaw::StringView;
+
+/**
+ * Checks if a string holds the characters of a C string.
+ */
+bool
+equals(const String &s, const char *expected)
+{
+	return s.size == strlen(expected)
+		&& memcmp(s.data, expected, s.size) == 0;
+}
+
+/**
+ * Returns a string holding the given bytes.
+ */
+String
+bytes(const char *data, usize size)
+{
+	String s;
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back(data[i]);
+	}
+
+	return s;
+}
+
+/**
+ * Returns a random string of `size` bytes of any value.
+ */
+String
+random_bytes(usize size)
+{
+	String s;
+
+	for (usize i = 0; i < size; i++)
+	{
+		s.push_back((char) (rand() % 256));
+	}
+
+	return s;
+}
+
+void
+test_case_conversion()
+{
+	// Every byte value, at every offset of a block.
+
+	for (usize size = 0; size < 70; size++)
+	{
+		String s = random_bytes(size);
+		String lower = s.to_lower();
+		String upper = s.to_upper();
+		check(lower.size == size && upper.size == size, "case size");
+
+		for (usize i = 0; i < size; i++)
+		{
+			u8 c = s[i];
+			u8 l = c >= 'A' && c <= 'Z' ? c + 32 : c;
+			u8 u = c >= 'a' && c <= 'z' ? c - 32 : c;
+			check((u8) lower[i] == l, "to_lower");
+			check((u8) upper[i] == u, "to_upper");
+		}
+
+		check(lower.equals_ignore_case(s) && upper.equals_ignore_case(s),
+			"case-insensitive equality after conversion");
+
+		s.to_lower_in_place();
+		check(s == lower, "to_lower_in_place");
+		s.to_upper_in_place();
+		check(s == upper, "to_upper_in_place");
+	}
+
+	String all;
+
+	for (usize c = 0; c < 256; c++)
+	{
+		all.push_back((char) c);
+	}
+
+	String lower = all.to_lower();
+
+	for (usize c = 0; c < 256; c++)
+	{
+		check((u8) lower[c] == (c - 'A' < 26 ? c + 32 : c),
+			"to_lower of every byte");
+	}
+
+	check(equals(String("Hello, WORLD! \xC3\x84").to_lower(),
+		"hello, world! \xC3\x84"), "UTF-8 bytes are kept");
+	check(equals(String("Hello, world! \xC3\xA4").to_upper(),
+		"HELLO, WORLD! \xC3\xA4"), "UTF-8 bytes are kept");
+
+	// An empty result can still grow.
+
+	String empty = String("").to_upper();
+	empty.push_back('x');
+	check(equals(empty, "x") && empty.size <= empty.capacity,
+		"push onto an empty conversion");
+}
+
+void
+test_equals_ignore_case()
+{
+	check(String("Content-Type").equals_ignore_case("content-type"),
+		"equal ignoring case");
+	check(!String("Content-Type").equals_ignore_case("content-typ"),
+		"different sizes");
+	check(String("").equals_ignore_case(""), "empty strings");
+
+	// Pairs that differ only in bit 5 but are not letters.
+
+	check(!String("@").equals_ignore_case("`"), "@ and `");
+	check(!String("[").equals_ignore_case("{"), "[ and {");
+	check(!String("\xC0").equals_ignore_case("\xE0"), "Latin-1 letters");
+
+	for (usize size = 1; size < 50; size++)
+	{
+		String a = random_bytes(size);
+		String b = a.to_upper();
+		usize i = rand() % size;
+		check(a.equals_ignore_case(b), "random equal ignoring case");
+
+		// A byte that differs in another bit, at every offset.
+
+		b[i] ^= 0x40;
+		check(!a.equals_ignore_case(b), "random difference");
+	}
+}
+
+void
+test_trim()
+{
+	check(equals(String("  \t hello world \r\n").trim(), "hello world"),
+		"trim");
+	check(equals(String("hello").trim(), "hello"), "nothing to trim");
+	check(equals(String(" \t\n\v\f\r ").trim(), ""), "only whitespace");
+	check(equals(String("\x85 a \xA0").trim(), "\x85 a \xA0"),
+		"non-ASCII whitespace is kept");
+
+	// Runs of whitespace of every length around the blocks.
+
+	for (usize before = 0; before < 40; before += 3)
+	{
+		for (usize after = 0; after < 40; after += 5)
+		{
+			String s;
+			s.pad_end(' ', before);
+			s.push_back('a');
+			s.push_back(' ');
+			s.push_back('b');
+			s.pad_end('\t', before + 3 + after);
+
+			check(equals(s.trim(), "a b"), "trim runs");
+
+			s.trim_in_place();
+			check(equals(s, "a b"), "trim_in_place runs");
+		}
+	}
+
+	String empty = String("   ").trim();
+	empty.push_back('x');
+	check(equals(empty, "x") && empty.size <= empty.capacity,
+		"push onto an empty trim");
+}
+
+/**
+ * Replaces the non-overlapping occurrences of a pattern from left to right,
+ * one position at a time.
+ */
+String
+naive_replace_all(const String &s, const String &pattern,
+	const String &replacement)
+{
+	String out;
+	usize i = 0;
+
+	while (i < s.size)
+	{
+		if (pattern.size > 0 && i + pattern.size <= s.size
+			&& memcmp(s.data + i, pattern.data, pattern.size) == 0)
+		{
+			for (usize j = 0; j < replacement.size; j++)
+			{
+				out.push_back(replacement[j]);
+			}
+
+			i += pattern.size;
+			continue;
+		}
+
+		out.push_back(s[i++]);
+	}
+
+	return out;
+}
+
+void
+test_replace_all()
+{
+	check(equals(String("a-b-c").replace_all("-", "+"), "a+b+c"),
+		"same size");
+	check(equals(String("a-b-c").replace_all("-", "--"), "a--b--c"),
+		"grow");
+	check(equals(String("a--b--c").replace_all("--", ""), "abc"),
+		"shrink");
+	check(equals(String("aaaaa").replace_all("aa", "b"), "bba"),
+		"overlapping occurrences");
+	check(equals(String("abc").replace_all("", "x"), "abc"),
+		"empty pattern");
+	check(equals(String("abc").replace_all("d", "x"), "abc"), "no match");
+	check(equals(String("").replace_all("a", "b"), ""), "empty string");
+	check(equals(String("abc").replace_all("abc", "xyz"), "xyz"),
+		"whole string");
+
+	String empty = String("aa").replace_all("a", "");
+	check(empty.size == 0, "everything replaced");
+	empty.push_back('x');
+	check(equals(empty, "x") && empty.size <= empty.capacity,
+		"push onto an empty replacement");
+
+	// Random texts over small alphabets, so patterns occur often and
+	// overlap, with matches across the 16-byte blocks.
+
+	for (usize round = 0; round < 2000; round++)
+	{
+		usize alphabet = 2 + rand() % 3;
+		String s;
+		String pattern;
+		String replacement;
+		usize size = rand() % 80;
+		usize pattern_size = 1 + rand() % 4;
+		usize replacement_size = rand() % 5;
+
+		for (usize i = 0; i < size; i++)
+		{
+			s.push_back((char) ('a' + rand() % alphabet));
+		}
+
+		for (usize i = 0; i < pattern_size; i++)
+		{
+			pattern.push_back((char) ('a' + rand() % alphabet));
+		}
+
+		for (usize i = 0; i < replacement_size; i++)
+		{
+			replacement.push_back((char) ('x' + rand() % 3));
+		}
+
+		String expected = naive_replace_all(s, pattern, replacement);
+		check(s.replace_all(pattern, replacement) == expected,
+			"random replace_all");
+	}
+
+	// A long run of one character, the worst case of the search.
+
+	String run = bytes("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", 40);
+	check(equals(run.replace_all("aaaaaaaaaaaaaaaaaaaaaaaaaaaaab", "x"),
+		"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"), "no match in a run");
+}
+
+/**
+ * Checks `String::from_int()` for a number against `snprintf()`.
+ */
+template <typename T>
+void
+check_from_int(T n)
+{
+	char expected[32];
+
+	if constexpr (slaw::is_signed_integer<T>())
+	{
+		snprintf(expected, sizeof(expected), "%lld", (long long) n);
+	}
+	else
+	{
+		snprintf(expected, sizeof(expected), "%llu",
+			(unsigned long long) n);
+	}
+
+	String s = String::from_int(n);
+	check(equals(s, expected) && s.size <= s.capacity, "from_int");
+}
+
+/**
+ * Checks `String::from_int()` for the limits of an integer type, the
+ * numbers around every power of ten, and random numbers.
+ */
+template <typename T>
+void
+check_from_int_type()
+{
+	check_from_int<T>(0);
+	check_from_int(slaw::min_value<T>());
+	check_from_int(slaw::max_value<T>());
+
+	for (T power = 1; power <= slaw::max_value<T>() / 10; power *= 10)
+	{
+		check_from_int<T>(power - 1);
+		check_from_int<T>(power * 10);
+
+		if constexpr (slaw::is_signed_integer<T>())
+		{
+			check_from_int<T>(-power);
+			check_from_int<T>(1 - power * 10);
+		}
+	}
+
+	for (usize i = 0; i < 1000; i++)
+	{
+		u64 bits = (u64) rand() << 40 ^ (u64) rand() << 20 ^ rand();
+		check_from_int((T) (bits >> rand() % 64));
+	}
+}
+
+void
+test_from_int()
+{
+	check_from_int_type<i8>();
+	check_from_int_type<u8>();
+	check_from_int_type<i16>();
+	check_from_int_type<u16>();
+	check_from_int_type<i32>();
+	check_from_int_type<u32>();
+	check_from_int_type<i64>();
+	check_from_int_type<u64>();
+}
+
+void
+test_view_to_string()
+{
+	String s = StringView("hello", 5).to_string();
+	check(equals(s, "hello"), "view to string");
+
+	String empty = StringView().to_string();
+	empty.push_back('x');
+	check(equals(empty, "x") && empty.size <= empty.capacity,
+		"push onto an empty view copy");
+}
+
+void
+test_view_index_of()
+{
+	StringView view("abcabc", 6);
+	check(view.index_of(StringView("bc", 2)) == 1, "first occurrence");
+	check(view.index_of(StringView("bc", 2), 2) == 4, "from a start index");
+	check(view.index_of(StringView("bd", 2)) == -1, "not found");
+	check(view.index_of(StringView("abcabcd", 7)) == -1,
+		"needle longer than the view");
+
+	// An empty needle is found at the start index, up to the end.
+
+	check(view.index_of(StringView()) == 0, "empty needle");
+	check(view.index_of(StringView(), 4) == 4,
+		"empty needle from a start index");
+	check(view.index_of(StringView(), 6) == 6, "empty needle at the end");
+	check(view.index_of(StringView(), 7) == -1,
+		"empty needle past the end");
+	check(StringView().index_of(StringView()) == 0,
+		"empty needle in an empty view");
+}
+
+int
+main()
+{
+	test_case_conversion();
+	test_equals_ignore_case();
+	test_trim();
+	test_replace_all();
+	test_from_int();
+	test_view_to_string();
+	test_view_index_of();
+
+	printf("All string tests passed.\n");
+}
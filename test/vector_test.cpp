@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../types.hpp"
+#include "../vector.hpp"
+#include "../string.hpp"
+#include "check.hpp"
+
+// Checks that `Vector::pop_back()` returns the removed elements, through
+// the shrinking of the array, and that the vector grows again afterwards.
+// Build natively with `make vector_test`.
+
+using slaw::String;
+using slaw::Vector;
+
+void
+test_pop_back()
+{
+	Vector<u32> v;
+
+	for (u32 i = 0; i < 100; i++)
+	{
+		v.push_back(i);
+	}
+
+	usize full_capacity = v.capacity;
+
+	for (u32 i = 100; i > 0; i--)
+	{
+		check(v.pop_back() == i - 1, "pop_back returns the last element");
+		check(v.size == i - 1 && v.size <= v.capacity, "size after pop");
+	}
+
+	check(v.capacity < full_capacity, "popping shrinks the array");
+
+	// The shrunk vector still grows.
+
+	for (u32 i = 0; i < 100; i++)
+	{
+		v.push_back(i * 3);
+		check(v.size <= v.capacity, "push after popping");
+	}
+
+	for (u32 i = 0; i < 100; i++)
+	{
+		check(v[i] == i * 3, "elements after growing again");
+	}
+}
+
+void
+test_pop_back_moves()
+{
+	// Popped elements that own memory come back intact.
+
+	Vector<String> v;
+
+	for (usize i = 0; i < 40; i++)
+	{
+		String s;
+		s.pad_end('a' + i % 26, i + 1);
+		v.push_back(s);
+	}
+
+	for (usize i = 40; i > 0; i--)
+	{
+		String s = v.pop_back();
+		check(s.size == i, "popped string size");
+
+		for (usize j = 0; j < s.size; j++)
+		{
+			check(s[j] == (char) ('a' + (i - 1) % 26), "popped string");
+		}
+	}
+
+	check(v.size == 0, "all popped");
+}
+
+int
+main()
+{
+	test_pop_back();
+	test_pop_back_moves();
+
+	printf("All vector tests passed.\n");
+}
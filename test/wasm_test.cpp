@@ -5,4 +5,344 @@ f32x4
 simd_test(f32x4 v)
 {
 	return slaw::simd::floor(v);
-}
\ No newline at end of file
+}
+
+// Each function below should compile to the WASM SIMD instruction that is
+// listed for it in `check_simd_lowering.sh`, without any calls.
+
+EXPORT("simd_floor_f32x4")
+f32x4
+simd_floor_f32x4(f32x4 v)
+{
+	return slaw::simd::floor(v);
+}
+
+EXPORT("simd_floor_f64x2")
+f64x2
+simd_floor_f64x2(f64x2 v)
+{
+	return slaw::simd::floor(v);
+}
+
+EXPORT("simd_ceil_f32x4")
+f32x4
+simd_ceil_f32x4(f32x4 v)
+{
+	return slaw::simd::ceil(v);
+}
+
+EXPORT("simd_ceil_f64x2")
+f64x2
+simd_ceil_f64x2(f64x2 v)
+{
+	return slaw::simd::ceil(v);
+}
+
+EXPORT("simd_round_f32x4")
+f32x4
+simd_round_f32x4(f32x4 v)
+{
+	return slaw::simd::round(v);
+}
+
+EXPORT("simd_sqrt_f32x4")
+f32x4
+simd_sqrt_f32x4(f32x4 v)
+{
+	return slaw::simd::sqrt(v);
+}
+
+EXPORT("simd_sqrt_f64x2")
+f64x2
+simd_sqrt_f64x2(f64x2 v)
+{
+	return slaw::simd::sqrt(v);
+}
+
+EXPORT("simd_min_i8x16")
+i8x16
+simd_min_i8x16(i8x16 a, i8x16 b)
+{
+	return slaw::simd::min(a, b);
+}
+
+EXPORT("simd_min_i16x8")
+i16x8
+simd_min_i16x8(i16x8 a, i16x8 b)
+{
+	return slaw::simd::min(a, b);
+}
+
+EXPORT("simd_min_i32x4")
+i32x4
+simd_min_i32x4(i32x4 a, i32x4 b)
+{
+	return slaw::simd::min(a, b);
+}
+
+EXPORT("simd_min_f32x4")
+f32x4
+simd_min_f32x4(f32x4 a, f32x4 b)
+{
+	return slaw::simd::min(a, b);
+}
+
+EXPORT("simd_max_i32x4")
+i32x4
+simd_max_i32x4(i32x4 a, i32x4 b)
+{
+	return slaw::simd::max(a, b);
+}
+
+EXPORT("simd_max_f32x4")
+f32x4
+simd_max_f32x4(f32x4 a, f32x4 b)
+{
+	return slaw::simd::max(a, b);
+}
+
+EXPORT("simd_max_f64x2")
+f64x2
+simd_max_f64x2(f64x2 a, f64x2 b)
+{
+	return slaw::simd::max(a, b);
+}
+
+EXPORT("simd_abs_i8x16")
+i8x16
+simd_abs_i8x16(i8x16 v)
+{
+	return slaw::simd::abs(v);
+}
+
+EXPORT("simd_abs_i32x4")
+i32x4
+simd_abs_i32x4(i32x4 v)
+{
+	return slaw::simd::abs(v);
+}
+
+EXPORT("simd_abs_f32x4")
+f32x4
+simd_abs_f32x4(f32x4 v)
+{
+	return slaw::simd::abs(v);
+}
+
+EXPORT("simd_neg_i32x4")
+i32x4
+simd_neg_i32x4(i32x4 v)
+{
+	return slaw::simd::neg(v);
+}
+
+EXPORT("simd_neg_f32x4")
+f32x4
+simd_neg_f32x4(f32x4 v)
+{
+	return slaw::simd::neg(v);
+}
+
+EXPORT("simd_min_u8x16")
+u8x16
+simd_min_u8x16(u8x16 a, u8x16 b)
+{
+	return slaw::simd::min(a, b);
+}
+
+EXPORT("simd_lt_u8x16")
+i8x16
+simd_lt_u8x16(u8x16 a, u8x16 b)
+{
+	return slaw::simd::lt(a, b);
+}
+
+EXPORT("simd_select_f32x4")
+f32x4
+simd_select_f32x4(i32x4 m, f32x4 a, f32x4 b)
+{
+	return slaw::simd::select(m, a, b);
+}
+
+EXPORT("simd_any_true_u8x16")
+bool
+simd_any_true_u8x16(u8x16 v)
+{
+	return slaw::simd::any_true(v);
+}
+
+EXPORT("simd_all_true_i16x8")
+bool
+simd_all_true_i16x8(i16x8 v)
+{
+	return slaw::simd::all_true(v);
+}
+
+EXPORT("simd_bitmask_i32x4")
+u32
+simd_bitmask_i32x4(i32x4 v)
+{
+	return slaw::simd::bitmask(v);
+}
+
+EXPORT("simd_shuffle_f32x4")
+f32x4
+simd_shuffle_f32x4(f32x4 a, f32x4 b)
+{
+	return slaw::simd::shuffle<1, 0, 5, 4>(a, b);
+}
+
+EXPORT("simd_load_splat_f32x4")
+f32x4
+simd_load_splat_f32x4(const f32 *p)
+{
+	return slaw::simd::load_splat<f32x4>(p);
+}
+
+EXPORT("simd_load64_zero_u8x16")
+u8x16
+simd_load64_zero_u8x16(const u8 *p)
+{
+	return slaw::simd::load64_zero<u8x16>(p);
+}
+
+EXPORT("simd_wide_leaky_relu")
+void
+simd_wide_leaky_relu(const f32 *in, f32 *out)
+{
+	slaw::Simd<f32, 8> x = slaw::Simd<f32, 8>::load(in);
+	slaw::select(x < 0, x * 0.01f, x).store(out);
+}
+
+EXPORT("simd_wide_sum_i32x8")
+i32
+simd_wide_sum_i32x8(const i32 *in)
+{
+	return slaw::Simd<i32, 8>::load(in).sum();
+}
+
+EXPORT("simd_sum_f32x4")
+f32
+simd_sum_f32x4(f32x4 v)
+{
+	return slaw::simd::sum(v);
+}
+
+EXPORT("simd_reduce_max_i8x16")
+i8
+simd_reduce_max_i8x16(i8x16 v)
+{
+	return slaw::simd::reduce_max(v);
+}
+
+EXPORT("simd_dot_i16x8")
+i32
+simd_dot_i16x8(i16x8 a, i16x8 b)
+{
+	return slaw::simd::dot(a, b);
+}
+
+EXPORT("simd_widening_sum_u8x16")
+u32
+simd_widening_sum_u8x16(u8x16 v)
+{
+	return slaw::simd::widening_sum(v);
+}
+
+EXPORT("simd_fma_f32x4")
+f32x4
+simd_fma_f32x4(f32x4 a, f32x4 b, f32x4 c)
+{
+	return slaw::simd::fma(a, b, c);
+}
+
+EXPORT("simd_fnma_f64x2")
+f64x2
+simd_fnma_f64x2(f64x2 a, f64x2 b, f64x2 c)
+{
+	return slaw::simd::fnma(a, b, c);
+}
+
+EXPORT("simd_relaxed_swizzle")
+u8x16
+simd_relaxed_swizzle(u8x16 v, u8x16 i)
+{
+	return slaw::simd::relaxed_swizzle(v, i);
+}
+
+EXPORT("simd_relaxed_min_f32x4")
+f32x4
+simd_relaxed_min_f32x4(f32x4 a, f32x4 b)
+{
+	return slaw::simd::relaxed_min(a, b);
+}
+
+EXPORT("simd_relaxed_trunc")
+i32x4
+simd_relaxed_trunc(f32x4 v)
+{
+	return slaw::simd::relaxed_trunc(v);
+}
+
+EXPORT("simd_add_sat_u8x16")
+u8x16
+simd_add_sat_u8x16(u8x16 a, u8x16 b)
+{
+	return slaw::simd::add_sat(a, b);
+}
+
+EXPORT("simd_sub_sat_i16x8")
+i16x8
+simd_sub_sat_i16x8(i16x8 a, i16x8 b)
+{
+	return slaw::simd::sub_sat(a, b);
+}
+
+EXPORT("simd_avgr_u8x16")
+u8x16
+simd_avgr_u8x16(u8x16 a, u8x16 b)
+{
+	return slaw::simd::avgr_u(a, b);
+}
+
+EXPORT("simd_q15mulr_sat")
+i16x8
+simd_q15mulr_sat(i16x8 a, i16x8 b)
+{
+	return slaw::simd::q15mulr_sat(a, b);
+}
+
+EXPORT("simd_narrow_u_i16x8")
+u8x16
+simd_narrow_u_i16x8(i16x8 a, i16x8 b)
+{
+	return slaw::simd::narrow_u(a, b);
+}
+
+EXPORT("simd_narrow_s_i32x4")
+i16x8
+simd_narrow_s_i32x4(i32x4 a, i32x4 b)
+{
+	return slaw::simd::narrow_s(a, b);
+}
+
+EXPORT("simd_extend_low_i8x16")
+i16x8
+simd_extend_low_i8x16(i8x16 v)
+{
+	return slaw::simd::extend_low(v);
+}
+
+EXPORT("simd_extend_high_u16x8")
+u32x4
+simd_extend_high_u16x8(u16x8 v)
+{
+	return slaw::simd::extend_high(v);
+}
+
+EXPORT("simd_extadd_pairwise_i16x8")
+i32x4
+simd_extadd_pairwise_i16x8(i16x8 v)
+{
+	return slaw::simd::extadd_pairwise(v);
+}
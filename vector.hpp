@@ -457,6 +457,8 @@ struct Vector
 		{
 			realloc(capacity / 2);
 		}
+
+		return popped_value;
 	}
 
 	/**
@@ -687,9 +689,19 @@ struct Vector
 	void
 	rotate(isize shift)
 	{
+		if (size == 0)
+		{
+			return;
+		}
+
 		// Ensure the shift is within bounds of the size of the array.
+		// The size is converted to a signed number first, otherwise the
+		// shift would be converted to an unsigned number, and negative
+		// shifts would wrap around before the modulo.
+		// This is the only division, so there is nothing to gain from
+		// a `Divider` here: the rings below wrap with a subtraction.
 
-		shift %= size;
+		shift %= (isize) size;
 
 		// Since the modulo operator might return a negative number,
 		// we need to make sure that the shift is positive.